@@ -645,6 +645,49 @@ PS_OUTPUT ps_yuv(PS_INPUT input)
 }
 #endif
 
+#if defined(__ps_convert_rgba_nv12__)
+float3 rgb_to_yuv_bt601(float3 rgb)
+{
+	float Y = dot(rgb, float3(0.299f, 0.587f, 0.114f));
+	float U = dot(rgb, float3(-0.168736f, -0.331264f, 0.5f));
+	float V = dot(rgb, float3(0.5f, -0.418688f, -0.081312f));
+	return float3(float(0xDB) / 255.0f * Y + float(0x10) / 255.0f,
+		float(0xE0) / 255.0f * U + float(0x80) / 255.0f,
+		float(0xE0) / 255.0f * V + float(0x80) / 255.0f);
+}
+
+PS_OUTPUT ps_convert_rgba_nv12(PS_INPUT input)
+{
+	// Packs the source into NV12 for video capture. The target is a quarter of the width, and 1.5x the height.
+	// The top part holds four luma samples per texel, the bottom two interleaved chroma pairs, each from a 2x2 block.
+	uint width, height;
+	Texture.GetDimensions(width, height);
+
+	int2 pos = int2(input.p.xy);
+	int x = pos.x * 4;
+
+	PS_OUTPUT output;
+	if (pos.y < int(height))
+	{
+		output.o.r = rgb_to_yuv_bt601(Texture.Load(int3(x + 0, pos.y, 0)).rgb).x;
+		output.o.g = rgb_to_yuv_bt601(Texture.Load(int3(x + 1, pos.y, 0)).rgb).x;
+		output.o.b = rgb_to_yuv_bt601(Texture.Load(int3(x + 2, pos.y, 0)).rgb).x;
+		output.o.a = rgb_to_yuv_bt601(Texture.Load(int3(x + 3, pos.y, 0)).rgb).x;
+	}
+	else
+	{
+		int y = (pos.y - int(height)) * 2;
+		float3 c0 = Texture.Load(int3(x + 0, y, 0)).rgb + Texture.Load(int3(x + 1, y, 0)).rgb +
+			Texture.Load(int3(x + 0, y + 1, 0)).rgb + Texture.Load(int3(x + 1, y + 1, 0)).rgb;
+		float3 c1 = Texture.Load(int3(x + 2, y, 0)).rgb + Texture.Load(int3(x + 3, y, 0)).rgb +
+			Texture.Load(int3(x + 2, y + 1, 0)).rgb + Texture.Load(int3(x + 3, y + 1, 0)).rgb;
+		output.o = float4(rgb_to_yuv_bt601(c0 * 0.25f).yz, rgb_to_yuv_bt601(c1 * 0.25f).yz);
+	}
+
+	return output;
+}
+#endif
+
 #if defined(__ps_primid_image_init_0__)
 float ps_primid_image_init_0(PS_INPUT input) : SV_Target
 {
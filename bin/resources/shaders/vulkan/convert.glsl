@@ -624,6 +624,44 @@ void ps_yuv()
 }
 #endif
 
+#ifdef ps_convert_rgba_nv12
+vec3 rgb_to_yuv_bt601(vec3 rgb)
+{
+	float Y = dot(rgb, vec3(0.299f, 0.587f, 0.114f));
+	float U = dot(rgb, vec3(-0.168736f, -0.331264f, 0.5f));
+	float V = dot(rgb, vec3(0.5f, -0.418688f, -0.081312f));
+	return vec3(float(0xDB)/255.0f * Y + float(0x10)/255.0f,
+		float(0xE0)/255.0f * U + float(0x80)/255.0f,
+		float(0xE0)/255.0f * V + float(0x80)/255.0f);
+}
+
+void ps_convert_rgba_nv12()
+{
+	// Packs the source into NV12 for video capture. The target is a quarter of the width, and 1.5x the height.
+	// The top part holds four luma samples per texel, the bottom two interleaved chroma pairs, each from a 2x2 block.
+	int height = textureSize(samp0, 0).y;
+	ivec2 pos = ivec2(gl_FragCoord.xy);
+	int x = pos.x * 4;
+
+	if (pos.y < height)
+	{
+		o_col0.r = rgb_to_yuv_bt601(texelFetch(samp0, ivec2(x + 0, pos.y), 0).rgb).x;
+		o_col0.g = rgb_to_yuv_bt601(texelFetch(samp0, ivec2(x + 1, pos.y), 0).rgb).x;
+		o_col0.b = rgb_to_yuv_bt601(texelFetch(samp0, ivec2(x + 2, pos.y), 0).rgb).x;
+		o_col0.a = rgb_to_yuv_bt601(texelFetch(samp0, ivec2(x + 3, pos.y), 0).rgb).x;
+	}
+	else
+	{
+		int y = (pos.y - height) * 2;
+		vec3 c0 = texelFetch(samp0, ivec2(x + 0, y), 0).rgb + texelFetch(samp0, ivec2(x + 1, y), 0).rgb +
+			texelFetch(samp0, ivec2(x + 0, y + 1), 0).rgb + texelFetch(samp0, ivec2(x + 1, y + 1), 0).rgb;
+		vec3 c1 = texelFetch(samp0, ivec2(x + 2, y), 0).rgb + texelFetch(samp0, ivec2(x + 3, y), 0).rgb +
+			texelFetch(samp0, ivec2(x + 2, y + 1), 0).rgb + texelFetch(samp0, ivec2(x + 3, y + 1), 0).rgb;
+		o_col0 = vec4(rgb_to_yuv_bt601(c0 * 0.25f).yz, rgb_to_yuv_bt601(c1 * 0.25f).yz);
+	}
+}
+#endif
+
 #if defined(ps_primid_image_init_0) || defined(ps_primid_image_init_1) || defined(ps_primid_image_init_2) || defined(ps_primid_image_init_3)
 
 void main()
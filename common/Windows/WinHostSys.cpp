@@ -13,6 +13,7 @@
 #include "fmt/format.h"
 
 #include <mutex>
+#include <sddl.h>
 
 static DWORD ConvertToWinApi(const PageProtectionMode& mode)
 {
@@ -51,8 +52,18 @@ std::string HostSys::GetFileMappingName(const char* prefix)
 
 void* HostSys::CreateSharedMemory(const char* name, size_t size)
 {
-	return static_cast<void*>(CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
-		static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), StringUtil::UTF8StringToWideString(name).c_str()));
+	// Other processes may only open the mapping by name for reading. The handle we get back from
+	// creating it isn't access checked, so our own views can still be writable. The OWNER RIGHTS
+	// entry stops the owner from using its implicit WRITE_DAC to loosen this later.
+	PSECURITY_DESCRIPTOR sd;
+	if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(L"D:P(A;;GR;;;OW)", SDDL_REVISION_1, &sd, nullptr))
+		return nullptr;
+
+	SECURITY_ATTRIBUTES sa = {sizeof(sa), sd, FALSE};
+	HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE,
+		static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), StringUtil::UTF8StringToWideString(name).c_str());
+	LocalFree(sd);
+	return static_cast<void*>(handle);
 }
 
 void HostSys::DestroySharedMemory(void* ptr)
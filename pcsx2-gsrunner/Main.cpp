@@ -78,6 +78,7 @@ static MemorySettingsInterface s_settings_interface;
 
 static std::string s_output_prefix;
 static s32 s_loop_count = 1;
+static u32 s_start_frame = 0;
 static std::optional<bool> s_use_window;
 static bool s_no_console = false;
 
@@ -502,7 +503,8 @@ static void PrintCommandLineHelp(const char* progname)
 		"Defaults to 0,-1,1 (all draws). Only used if -dump used.\n");
 	std::fprintf(stderr, "  -dumprangef NF[,LF,BF]: Start dumping from frame NF (base 0), stops after LF frames, "
 		"and only those frames that are multiples of BF (intersection of -dumprange and -dumprangef used).\n"
-		"Defaults to 0,-1,1 (all frames). Only used if -dump is used.\n");
+		"Defaults to 0,-1,1 (all frames). Only used if -dump is used. Playback of indexed dumps starts from the "
+		"closest keyframe before NF, in which case draws are counted from the keyframe.\n");
 	std::fprintf(stderr, "  -loop <count>: Loops dump playback N times. Defaults to 1. 0 will loop infinitely.\n");
 	std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Defaults to Auto.\n");
 	std::fprintf(stderr, "  -swthreads <threads>: Sets the number of threads for the software renderer.\n");
@@ -639,6 +641,7 @@ bool GSRunner::ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& pa
 				s_settings_interface.SetIntValue("EmuCore/GS", "SaveFrameStart", start);
 				s_settings_interface.SetIntValue("EmuCore/GS", "SaveFrameCount", num);
 				s_settings_interface.SetIntValue("EmuCore/GS", "SaveFrameBy", by);
+				s_start_frame = static_cast<u32>(std::max(start, 0));
 				continue;
 			}
 			else if (CHECK_ARG_PARAM("-dumpdirhw"))
@@ -949,6 +952,7 @@ static void CPUThreadMain(VMBootParameters* params, std::atomic<int>* ret)
 		// apply new settings (e.g. pick up renderer change)
 		VMManager::ApplySettings();
 		GSDumpReplayer::SetIsDumpRunner(true);
+		GSDumpReplayer::SetStartFrame(s_start_frame);
 
 		if (VMManager::Initialize(*params) == VMBootResult::StartupSuccess)
 		{
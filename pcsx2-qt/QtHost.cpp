@@ -16,6 +16,7 @@
 #include "pcsx2/Achievements.h"
 #include "pcsx2/BuildVersion.h"
 #include "pcsx2/CDVD/CDVD.h"
+#include "pcsx2/CDVD/IsoHasher.h"
 #include "pcsx2/Counters.h"
 #include "pcsx2/DebugTools/Debug.h"
 #include "pcsx2/GS.h"
@@ -79,6 +80,7 @@ namespace QtHost
 	static void RegisterTypes();
 	static void InitializeClipboard();
 	static bool RunSetupWizard();
+	static bool VerifyLibrary(const std::string& path);
 	std::optional<bool> DownloadFile(QWidget* parent, const QString& title, std::string url, std::vector<u8>* data);
 } // namespace QtHost
 
@@ -96,6 +98,7 @@ static bool s_test_config_and_exit = false;
 static bool s_run_setup_wizard = false;
 static bool s_cleanup_after_update = false;
 static bool s_boot_and_debug = false;
+static std::string s_verify_library_path;
 static std::atomic_int s_vm_locked_with_dialog = 0;
 static std::string s_clipboard_cache;
 static std::mutex s_clipboard_cache_mutex;
@@ -2149,6 +2152,7 @@ void QtHost::PrintCommandLineHelp(const std::string_view progname)
 	std::fprintf(stderr, "  -bigpicture: Forces PCSX2 to use the Big Picture mode (useful for controller-only and couch play).\n");
 	std::fprintf(stderr, "  -earlyconsolelog: Forces logging of early console messages to console.\n");
 	std::fprintf(stderr, "  -testconfig: Initializes configuration and checks version, then exits.\n");
+	std::fprintf(stderr, "  -verifylibrary <path>: Verifies every disc image in the directory against the redump database, then exits.\n");
 	std::fprintf(stderr, "  -setupwizard: Forces initial setup wizard to run.\n");
 	std::fprintf(stderr, "  -debugger: Open debugger and break on entry point.\n");
 	std::fprintf(stderr, "  -turbo: Enters turbo (fast forward) mode after starting.\n");
@@ -2291,6 +2295,11 @@ bool QtHost::ParseCommandLineOptions(const QStringList& args, std::shared_ptr<VM
 				s_test_config_and_exit = true;
 				continue;
 			}
+			else if (CHECK_ARG_PARAM(QStringLiteral("-verifylibrary")))
+			{
+				s_verify_library_path = (++it)->toStdString();
+				continue;
+			}
 			else if (CHECK_ARG(QStringLiteral("-setupwizard")))
 			{
 				s_run_setup_wizard = true;
@@ -2360,7 +2369,7 @@ bool QtHost::ParseCommandLineOptions(const QStringList& args, std::shared_ptr<VM
 
 	// if we don't have autoboot, we definitely don't want batch mode (because that'll skip
 	// scanning the game list).
-	if (s_batch_mode && !s_start_big_picture_mode && !autoboot)
+	if (s_batch_mode && !s_start_big_picture_mode && !autoboot && s_verify_library_path.empty())
 	{
 		QMessageBox::critical(nullptr, QStringLiteral("Error"),
 			s_nogui_mode ? QStringLiteral("Cannot use no-gui mode, because no boot filename was specified.") :
@@ -2440,6 +2449,27 @@ bool QtHost::RunSetupWizard()
 	return true;
 }
 
+bool QtHost::VerifyLibrary(const std::string& path)
+{
+	const std::vector<IsoHasher::VerifyResult> results = IsoHasher::VerifyDirectory(path, true);
+	u32 num_verified = 0;
+	for (const IsoHasher::VerifyResult& result : results)
+	{
+		if (result.verified)
+		{
+			fmt::print(stdout, "OK       {} [{}] {}\n", result.path, result.serial, result.name);
+			num_verified++;
+		}
+		else
+		{
+			fmt::print(stdout, "FAILED   {}: {}\n", result.path, result.error.empty() ? "Tracks do not match." : result.error);
+		}
+	}
+
+	fmt::print(stdout, "{} of {} images verified.\n", num_verified, results.size());
+	return (num_verified == results.size());
+}
+
 class PCSX2MainApplication : public QApplication
 {
 public:
@@ -2495,6 +2525,10 @@ int main(int argc, char* argv[])
 	if (s_test_config_and_exit)
 		return EXIT_SUCCESS;
 
+	// Library verification is meant for scripts, so doesn't need any windows.
+	if (!s_verify_library_path.empty())
+		return QtHost::VerifyLibrary(s_verify_library_path) ? EXIT_SUCCESS : EXIT_FAILURE;
+
 	// Remove any previous-version remanants.
 	if (s_cleanup_after_update)
 		AutoUpdaterDialog::cleanupAfterUpdate();
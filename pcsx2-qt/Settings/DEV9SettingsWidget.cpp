@@ -20,6 +20,7 @@
 
 #include "HddCreateQt.h"
 
+#include "DEV9/ATA/HddBlockImage.h"
 #include "DEV9/pcap_io.h"
 #ifdef _WIN32
 #include "DEV9/Win32/tap.h"
@@ -35,6 +36,15 @@ static const char* s_api_name[] = {
 	nullptr,
 };
 
+// Order of the hddFormat items.
+enum class HddFormat
+{
+	Raw,
+	Block,
+	ConvertRaw,
+	Overlay,
+};
+
 static const char* s_dns_name[] = {
 	QT_TRANSLATE_NOOP("DEV9SettingsWidget", "Manual"),
 	QT_TRANSLATE_NOOP("DEV9SettingsWidget", "Auto"),
@@ -189,6 +199,7 @@ DEV9SettingsWidget::DEV9SettingsWidget(SettingsWindow* settings_dialog, QWidget*
 	connect(m_ui.hddSizeSlider, &QSlider::valueChanged, this, &DEV9SettingsWidget::onHddSizeSlide);
 	SettingWidgetBinder::SettingAccessor<QSpinBox>::connectValueChanged(m_ui.hddSizeSpinBox, [&]() { onHddSizeAccessorSpin(); });
 
+	connect(m_ui.hddFormat, &QComboBox::currentIndexChanged, this, &DEV9SettingsWidget::UpdateHddSizeUIEnabled);
 	connect(m_ui.hddCreate, &QPushButton::clicked, this, &DEV9SettingsWidget::onHddCreateClicked);
 }
 
@@ -599,6 +610,8 @@ void DEV9SettingsWidget::onHddEnabledChanged(Qt::CheckState state)
 	m_ui.hddFileLabel->setEnabled(enabled);
 	m_ui.hddBrowseFile->setEnabled(enabled);
 	m_ui.hddCreate->setEnabled(enabled);
+	m_ui.hddFormat->setEnabled(enabled);
+	m_ui.hddFormatLabel->setEnabled(enabled);
 
 	UpdateHddSizeUIEnabled();
 }
@@ -683,6 +696,27 @@ void DEV9SettingsWidget::onHddCreateClicked()
 	if (!Path::IsAbsolute(hddPath))
 		hddPath = Path::Combine(EmuFolders::Settings, hddPath);
 
+	// Converted images and overlays are made from an existing image, which also sets their size.
+	const HddFormat format = static_cast<HddFormat>(m_ui.hddFormat->currentIndex());
+	std::string sourcePath;
+	if (format == HddFormat::ConvertRaw || format == HddFormat::Overlay)
+	{
+		const QString path = QDir::toNativeSeparators(QFileDialog::getOpenFileName(QtUtils::GetRootWidget(this),
+			(format == HddFormat::ConvertRaw) ? tr("Raw HDD Image to Convert") : tr("Base HDD Image"),
+			QString::fromStdString(Path::GetDirectory(hddPath)), tr("HDD (*.raw)")));
+		if (path.isEmpty())
+			return;
+
+		sourcePath = path.toStdString();
+		if (FileSystem::FileExists(hddPath.c_str()) && Path::RealPath(sourcePath) == Path::RealPath(hddPath))
+		{
+			QMessageBox::warning(this, QObject::tr("HDD Creator"),
+				tr("The new HDD image can't replace the image it's made from."),
+				QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+			return;
+		}
+	}
+
 	if (FileSystem::FileExists(hddPath.c_str()))
 	{
 		QMessageBox::StandardButton selection =
@@ -700,10 +734,16 @@ void DEV9SettingsWidget::onHddCreateClicked()
 	HddCreateQt hddCreator(this);
 	hddCreator.filePath = std::move(hddPath);
 	hddCreator.neededSize = sizeBytes;
+	hddCreator.blockImage = (format != HddFormat::Raw);
+	if (format == HddFormat::ConvertRaw)
+		hddCreator.sourcePath = std::move(sourcePath);
+	else if (format == HddFormat::Overlay)
+		hddCreator.basePath = std::move(sourcePath);
 	hddCreator.Start();
 
 	if (!hddCreator.errored)
 	{
+		UpdateHddSizeUIValues();
 		QMessageBox::information(this, tr("HDD Creator"),
 			tr("HDD image created"),
 			QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
@@ -721,6 +761,12 @@ void DEV9SettingsWidget::UpdateHddSizeUIEnabled()
 		enableSizeUI = m_ui.hddFile->isEnabled();
 
 	m_ui.hddLBA48->setEnabled(enableSizeUI);
+
+	// Converted images and overlays keep the size of the image they're made from.
+	const HddFormat format = static_cast<HddFormat>(m_ui.hddFormat->currentIndex());
+	if (format == HddFormat::ConvertRaw || format == HddFormat::Overlay)
+		enableSizeUI = false;
+
 	m_ui.hddSizeLabel->setEnabled(enableSizeUI);
 	m_ui.hddSizeSlider->setEnabled(enableSizeUI);
 	m_ui.hddSizeMaxLabel->setEnabled(enableSizeUI);
@@ -741,16 +787,17 @@ void DEV9SettingsWidget::UpdateHddSizeUIValues()
 	if (!FileSystem::FileExists(hddPath.c_str()))
 		return;
 
-	const s64 size = FileSystem::GetPathFileSize(hddPath.c_str());
-	if (size < 0)
+	// Block allocated images are smaller than the disk they hold, so read the size from the image.
+	const std::optional<u64> size = HddBlockImage::GetImageSize(hddPath);
+	if (!size.has_value())
 		return;
 
-	if (size > static_cast<s64>(120) * 1024 * 1024 * 1024)
+	if (size.value() > static_cast<u64>(120) * 1024 * 1024 * 1024)
 		m_ui.hddLBA48->setChecked(true);
 	else
 		m_ui.hddLBA48->setChecked(false);
 
-	const int sizeGB = size / 1024 / 1024 / 1024;
+	const int sizeGB = size.value() / 1024 / 1024 / 1024;
 	QSignalBlocker sb1(m_ui.hddSizeSpinBox);
 	QSignalBlocker sb2(m_ui.hddSizeSlider);
 	m_ui.hddSizeSpinBox->setValue(sizeGB);
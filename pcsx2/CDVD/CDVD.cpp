@@ -577,8 +577,14 @@ static std::string ExecutablePathToSerial(const std::string& path)
 void cdvdGetDiscInfo(std::string* out_serial, std::string* out_elf_path, std::string* out_version, u32* out_crc,
 	CDVDDiscType* out_disc_type)
 {
-	Error error;
 	IsoReader isor;
+	cdvdGetDiscInfo(isor, out_serial, out_elf_path, out_version, out_crc, out_disc_type);
+}
+
+void cdvdGetDiscInfo(IsoReader& isor, std::string* out_serial, std::string* out_elf_path, std::string* out_version,
+	u32* out_crc, CDVDDiscType* out_disc_type)
+{
+	Error error;
 
 	std::string elfpath, version;
 	CDVDDiscType disc_type = CDVDDiscType::Other;
@@ -69,9 +69,8 @@ static void CheckNullCDVD()
 //////////////////////////////////////////////////////////////////////////////////////////
 // Disk Type detection stuff (from cdvdGigaherz)
 //
-static int CheckDiskTypeFS(int baseType)
+static int CheckDiskTypeFS(IsoReader& isor, int baseType)
 {
-	IsoReader isor;
 	if (isor.Open())
 	{
 		std::vector<u8> data;
@@ -109,6 +108,12 @@ static int CheckDiskTypeFS(int baseType)
 	return CDVD_TYPE_ILLEGAL; // << Only for discs which aren't ps2 at all.
 }
 
+static int CheckDiskTypeFS(int baseType)
+{
+	IsoReader isor;
+	return CheckDiskTypeFS(isor, baseType);
+}
+
 static int FindDiskType(int mType)
 {
 	int dataTracks = 0;
@@ -527,6 +532,29 @@ s32 DoCDVDdetectDiskType()
 	return diskTypeCached;
 }
 
+s32 DoCDVDdetectDiskType(InputIsoFile& iso)
+{
+	// Images are always a single data track, so this is FindDiskType() without the TOC queries.
+	int type = -1;
+	if (iso.GetBlockCount() > 452849)
+	{
+		type = CDVD_TYPE_DETCTDVDS;
+	}
+	else
+	{
+		u8 buffer[CD_FRAMESIZE_RAW];
+		if (iso.ReadSync(buffer, 16) >= 0)
+		{
+			// See the comment in FindDiskType() about this hack.
+			const u8* data = buffer + 24;
+			type = (*(u16*)(data + 166) == *(u16*)(data + 171)) ? CDVD_TYPE_DETCTCD : CDVD_TYPE_DETCTDVDS;
+		}
+	}
+
+	IsoReader isor(&iso);
+	return CheckDiskTypeFS(isor, type);
+}
+
 void DoCDVDresetDiskTypeCache()
 {
 	diskTypeCached = -1;
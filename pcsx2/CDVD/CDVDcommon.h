@@ -9,6 +9,7 @@
 #include <string>
 
 class Error;
+class InputIsoFile;
 class ProgressCallback;
 
 struct cdvdTrackIndex
@@ -207,4 +208,7 @@ extern s32 DoCDVDreadSector(u8* buffer, u32 lsn, int mode);
 extern s32 DoCDVDreadTrack(u32 lsn, int mode);
 extern s32 DoCDVDgetBuffer(u8* buffer);
 extern s32 DoCDVDdetectDiskType();
+
+/// Detects the disc type of an image opened outside of the CDVD interface. Safe to call from any thread.
+extern s32 DoCDVDdetectDiskType(InputIsoFile& iso);
 extern void DoCDVDresetDiskTypeCache();
@@ -200,7 +200,10 @@ private:
 	}
 };
 
-ChdFileReader::ChdFileReader() = default;
+ChdFileReader::ChdFileReader()
+{
+	m_cacheChunks = true;
+}
 
 ChdFileReader::~ChdFileReader()
 {
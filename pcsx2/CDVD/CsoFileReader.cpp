@@ -29,7 +29,29 @@ struct CsoHeader
 
 static const u32 CSO_READ_BUFFER_SIZE = 256 * 1024;
 
-CsoFileReader::CsoFileReader() = default;
+namespace
+{
+	/// zlib state for decompression workers, which can't share the reader's stream
+	struct CsoWorkerInflater
+	{
+		z_stream stream = {};
+		bool initialized = false;
+
+		~CsoWorkerInflater()
+		{
+			if (initialized)
+				inflateEnd(&stream);
+		}
+	};
+} // namespace
+
+static thread_local CsoWorkerInflater s_worker_inflater;
+
+CsoFileReader::CsoFileReader()
+{
+	m_cacheChunks = true;
+	m_parallelDecode = true;
+}
 
 CsoFileReader::~CsoFileReader()
 {
@@ -276,35 +298,101 @@ int CsoFileReader::ReadChunk(void* dst, s64 chunkID)
 			readRawBytes = fread(m_readBuffer.get(), 1, frameRawSize, m_src);
 		}
 
-		bool success = false;
+		return DecompressFrame(dst, readBuffer, readRawBytes, &m_z_stream) ? m_frameSize : 0;
+	}
+}
+
+bool CsoFileReader::ReadRawChunk(RawChunk* raw, s64 chunkID)
+{
+	if (chunkID < 0)
+		return false;
+
+	const u32 frame = chunkID;
+	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
+	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
+	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
+	const u64 frameRawPos = (u64)index0 << m_indexShift;
+	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
+
+	raw->chunkID = chunkID;
+	if (m_file_cache)
+	{
+		if (frameRawPos >= m_file_cache_size)
+			return false;
+
+		raw->data = &m_file_cache[frameRawPos];
+		raw->size = static_cast<u32>(std::min<size_t>(m_file_cache_size - frameRawPos, frameRawSize));
+		return true;
+	}
+
+	// Same as ReadChunk(), uncompressed frames read a whole frame regardless of the index.
+	const u32 readSize = compressed ? static_cast<u32>(frameRawSize) : m_frameSize;
+	raw->storage.resize(readSize);
+	if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
+	{
+		Console.Error("Unable to seek to CSO data.");
+		return false;
+	}
+	raw->data = raw->storage.data();
+	raw->size = static_cast<u32>(std::fread(raw->storage.data(), 1, readSize, m_src));
+	return (raw->size > 0);
+}
 
-		if (m_uselz4)
+int CsoFileReader::DecodeRawChunk(void* dst, const RawChunk& raw)
+{
+	const bool compressed = (m_index[raw.chunkID] & 0x80000000) == 0;
+	if (!compressed)
+	{
+		std::memcpy(dst, raw.data, raw.size);
+		return static_cast<int>(raw.size);
+	}
+
+	z_stream* z = nullptr;
+	if (!m_uselz4)
+	{
+		if (!s_worker_inflater.initialized)
 		{
-			const int src_size = static_cast<int>(readRawBytes);
-			const int dst_size = static_cast<int>(m_frameSize);
-			const char* src_buf = reinterpret_cast<const char*>(readBuffer);
-			char* dst_buf = static_cast<char*>(dst);
-			
-			const int res = LZ4_decompress_safe_partial(src_buf, dst_buf, src_size, dst_size, dst_size);
-			success = (res > 0);
+			if (inflateInit2(&s_worker_inflater.stream, -15) != Z_OK)
+			{
+				Console.Error("Unable to initialize zlib for CSO decompression.");
+				return 0;
+			}
+			s_worker_inflater.initialized = true;
 		}
-		else
-		{
-			m_z_stream.next_in = readBuffer;
-			m_z_stream.avail_in = readRawBytes;
-			m_z_stream.next_out = static_cast<Bytef*>(dst);
-			m_z_stream.avail_out = m_frameSize;
+		z = &s_worker_inflater.stream;
+	}
 
-			const int status = inflate(&m_z_stream, Z_FINISH);
-			success = (status == Z_STREAM_END && m_z_stream.total_out == m_frameSize);
-		}
+	return DecompressFrame(dst, raw.data, raw.size, z) ? m_frameSize : 0;
+}
+
+bool CsoFileReader::DecompressFrame(void* dst, const u8* src, u32 srcSize, z_stream* z) const
+{
+	bool success = false;
 
-		if (!success)
-			Console.Error(fmt::format("Unable to decompress CSO frame using {}", (m_uselz4)? "lz4":"zlib"));
-		
-		if (!m_uselz4)
-			inflateReset(&m_z_stream);
+	if (m_uselz4)
+	{
+		const int src_size = static_cast<int>(srcSize);
+		const int dst_size = static_cast<int>(m_frameSize);
+		const char* src_buf = reinterpret_cast<const char*>(src);
+		char* dst_buf = static_cast<char*>(dst);
 
-		return success ? m_frameSize : 0;
+		const int res = LZ4_decompress_safe_partial(src_buf, dst_buf, src_size, dst_size, dst_size);
+		success = (res > 0);
+	}
+	else
+	{
+		z->next_in = const_cast<Bytef*>(src);
+		z->avail_in = srcSize;
+		z->next_out = static_cast<Bytef*>(dst);
+		z->avail_out = m_frameSize;
+
+		const int status = inflate(z, Z_FINISH);
+		success = (status == Z_STREAM_END && z->total_out == m_frameSize);
+		inflateReset(z);
 	}
+
+	if (!success)
+		Console.Error(fmt::format("Unable to decompress CSO frame using {}", (m_uselz4)? "lz4":"zlib"));
+
+	return success;
 }
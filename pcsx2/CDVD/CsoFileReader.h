@@ -22,6 +22,8 @@ public:
 
 	Chunk ChunkForOffset(u64 offset) override;
 	int ReadChunk(void* dst, s64 chunkID) override;
+	bool ReadRawChunk(RawChunk* raw, s64 chunkID) override;
+	int DecodeRawChunk(void* dst, const RawChunk& raw) override;
 
 	void Close2() override;
 
@@ -32,8 +34,7 @@ private:
 	bool ReadFileHeader(Error* error);
 	bool InitializeBuffers(Error* error);
 	int ReadFromFrame(u8* dest, u64 pos, int maxBytes);
-	bool DecompressFrame(Bytef* dst, u32 frame, u32 readBufferSize);
-	bool DecompressFrame(u32 frame, u32 readBufferSize);
+	bool DecompressFrame(void* dst, const u8* src, u32 srcSize, z_stream* z) const;
 
 	u32 m_frameSize = 0;
 	u8 m_frameShift = 0;
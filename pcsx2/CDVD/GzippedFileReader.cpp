@@ -134,7 +134,10 @@ static std::string iso2indexname(const std::string& isoname, Error* error)
 }
 
 
-GzippedFileReader::GzippedFileReader() = default;
+GzippedFileReader::GzippedFileReader()
+{
+	m_cacheChunks = true;
+}
 
 GzippedFileReader::~GzippedFileReader() = default;
 
@@ -3,14 +3,150 @@
 
 #include "CDVD/CDVDcommon.h"
 #include "CDVD/IsoHasher.h"
+#include "GameDatabase.h"
 #include "Host.h"
+#include "VMManager.h"
 
 #include "common/Error.h"
+#include "common/FileSystem.h"
 #include "common/MD5Digest.h"
+#include "common/Threading.h"
 
 #include "fmt/format.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Sectors read in one go, and how many reads can be waiting to be hashed.
+// Reading carries on while the hashing threads catch up, so neither the disk nor the CPU sits idle.
+static constexpr u32 HASH_BATCH_SECTORS = 256;
+static constexpr u32 HASH_BATCH_COUNT = 16;
+
+// Tracks are spread over this many threads, so one can finish hashing while the next is read.
+static constexpr u32 MAX_HASH_THREADS = 4;
+
+namespace
+{
+	class HashPipeline
+	{
+	public:
+		struct Batch
+		{
+			std::unique_ptr<u8[]> data;
+			u32 size;
+			u32 track;
+		};
+
+		HashPipeline(u32 num_tracks, u32 num_threads, u32 batch_size);
+		~HashPipeline();
+
+		Batch* GetFreeBatch();
+		void ReturnBatch(Batch* batch);
+		void Submit(Batch* batch);
+		void WaitForCompletion();
+
+		/// Only valid after WaitForCompletion().
+		MD5Digest& GetDigest(u32 track) { return m_digests[track]; }
+
+	private:
+		void WorkerThread(u32 index);
+
+		std::vector<Batch> m_batches;
+		std::vector<MD5Digest> m_digests;
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_mutex;
+		std::condition_variable m_work_cv;
+		std::condition_variable m_free_cv;
+		std::vector<Batch*> m_free;
+		std::vector<std::deque<Batch*>> m_queues; // one per thread, so each track is hashed in order
+		bool m_quit = false;
+	};
+} // namespace
+
+HashPipeline::HashPipeline(u32 num_tracks, u32 num_threads, u32 batch_size)
+	: m_batches(HASH_BATCH_COUNT)
+	, m_digests(num_tracks)
+	, m_queues(std::max(num_threads, 1u))
+{
+	for (Batch& batch : m_batches)
+	{
+		batch.data = std::make_unique_for_overwrite<u8[]>(batch_size);
+		m_free.push_back(&batch);
+	}
+
+	for (u32 i = 0; i < m_queues.size(); i++)
+		m_threads.emplace_back(&HashPipeline::WorkerThread, this, i);
+}
+
+HashPipeline::~HashPipeline()
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_quit = true;
+		m_work_cv.notify_all();
+	}
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+HashPipeline::Batch* HashPipeline::GetFreeBatch()
+{
+	std::unique_lock lock(m_mutex);
+	m_free_cv.wait(lock, [this]() { return !m_free.empty(); });
+	Batch* batch = m_free.back();
+	m_free.pop_back();
+	return batch;
+}
+
+void HashPipeline::ReturnBatch(Batch* batch)
+{
+	std::unique_lock lock(m_mutex);
+	m_free.push_back(batch);
+	m_free_cv.notify_all();
+}
+
+void HashPipeline::Submit(Batch* batch)
+{
+	std::unique_lock lock(m_mutex);
+	m_queues[batch->track % m_queues.size()].push_back(batch);
+	m_work_cv.notify_all();
+}
+
+void HashPipeline::WaitForCompletion()
+{
+	std::unique_lock lock(m_mutex);
+	m_free_cv.wait(lock, [this]() { return m_free.size() == m_batches.size(); });
+}
+
+void HashPipeline::WorkerThread(u32 index)
+{
+	Threading::SetNameOfCurrentThread("ISO Hasher");
+
+	std::deque<Batch*>& queue = m_queues[index];
+	std::unique_lock lock(m_mutex);
+	for (;;)
+	{
+		m_work_cv.wait(lock, [this, &queue]() { return m_quit || !queue.empty(); });
+		if (m_quit)
+			return;
+
+		Batch* batch = queue.front();
+		queue.pop_front();
+		lock.unlock();
+
+		m_digests[batch->track].Update(batch->data.get(), batch->size);
+
+		lock.lock();
+		m_free.push_back(batch);
+		m_free_cv.notify_all();
+	}
+}
 
 IsoHasher::IsoHasher() = default;
 
@@ -123,71 +259,178 @@ void IsoHasher::Close()
 
 void IsoHasher::ComputeHashes(ProgressCallback* callback)
 {
-	callback->SetProgressRange(GetTrackCount());
-	callback->SetProgressValue(0);
-	callback->SetCancellable(true);
+	// use 2048 byte reads for DVDs, otherwise 2352 raw.
+	const int read_mode = m_is_cd ? CDVD_MODE_2352 : CDVD_MODE_2048;
+	const u32 sector_size = m_is_cd ? 2352 : 2048;
 
+	std::vector<u32> pending;
+	u32 total_sectors = 0;
 	for (u32 index = 0; index < GetTrackCount(); index++)
 	{
-		Track& track = m_tracks[index];
-		if (!track.hash.empty())
+		if (m_tracks[index].hash.empty())
 		{
-			callback->SetProgressValue(index + 1);
-			continue;
+			pending.push_back(index);
+			total_sectors += m_tracks[index].sectors;
 		}
+	}
 
-		callback->PushState();
-		const bool result = ComputeTrackHash(track, callback);
-		callback->PopState();
+	callback->SetProgressRange(std::max(total_sectors, 1u));
+	callback->SetProgressValue(0);
+	callback->SetCancellable(true);
+
+	const u32 update_interval = std::max<u32>(total_sectors / 100u, 1u);
+	u32 sectors_read = 0;
+	size_t tracks_read = 0;
+
+	HashPipeline pipeline(GetTrackCount(), static_cast<u32>(std::min<size_t>(pending.size(), MAX_HASH_THREADS)),
+		HASH_BATCH_SECTORS * sector_size);
+	for (const u32 index : pending)
+	{
+		const Track& track = m_tracks[index];
+		callback->SetStatusText(
+			fmt::format(TRANSLATE_FS("CDVD", "Calculating checksum for track {}..."), track.number).c_str());
+
+		bool ok = true;
+		for (u32 i = 0; i < track.sectors && ok;)
+		{
+			if (callback->IsCancelled())
+			{
+				ok = false;
+				break;
+			}
+
+			HashPipeline::Batch* batch = pipeline.GetFreeBatch();
+			const u32 count = std::min(HASH_BATCH_SECTORS, track.sectors - i);
+			for (u32 j = 0; j < count; j++)
+			{
+				const u32 lsn = track.start_lsn + i + j;
+				if (DoCDVDreadSector(batch->data.get() + j * sector_size, lsn, read_mode) != 0)
+				{
+					callback->DisplayFormattedModalError("Read error at LSN %u", lsn);
+					ok = false;
+					break;
+				}
+			}
+
+			if (!ok)
+			{
+				pipeline.ReturnBatch(batch);
+				break;
+			}
+
+			batch->track = index;
+			batch->size = count * sector_size;
+			pipeline.Submit(batch);
+
+			if (((sectors_read + count) / update_interval) != (sectors_read / update_interval))
+				callback->SetProgressValue(sectors_read + count);
+			sectors_read += count;
+			i += count;
+		}
 
-		if (!result)
+		if (!ok)
 			break;
 
-		callback->SetProgressValue(index + 1);
-		callback->IncrementProgressValue();
+		tracks_read++;
 	}
 
-	callback->SetProgressValue(GetTrackCount());
+	// Tracks which were read completely keep their hash, even if a later one failed.
+	pipeline.WaitForCompletion();
+	for (size_t i = 0; i < tracks_read; i++)
+	{
+		u8 digest[16];
+		pipeline.GetDigest(pending[i]).Final(digest);
+		m_tracks[pending[i]].hash = FormatDigest(digest);
+	}
+
+	callback->SetProgressValue(std::max(total_sectors, 1u));
 }
 
-bool IsoHasher::ComputeTrackHash(Track& track, ProgressCallback* callback)
+std::string IsoHasher::FormatDigest(const u8 digest[16])
 {
-	// use 2048 byte reads for DVDs, otherwise 2352 raw.
-	const int read_mode = m_is_cd ? CDVD_MODE_2352 : CDVD_MODE_2048;
-	const u32 sector_size = m_is_cd ? 2352 : 2048;
-	std::vector<u8> sector_buffer(sector_size);
+	return fmt::format("{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}",
+		digest[0], digest[1], digest[2], digest[3], digest[4], digest[5], digest[6], digest[7], digest[8],
+		digest[9], digest[10], digest[11], digest[12], digest[13], digest[14], digest[15]);
+}
 
-	const u32 update_interval = std::max<u32>(track.sectors / 100u, 1u);
-	callback->SetStatusText(
-		fmt::format(TRANSLATE_FS("CDVD", "Calculating checksum for track {}..."), track.number).c_str());
-	callback->SetProgressRange(track.sectors);
+std::vector<IsoHasher::VerifyResult> IsoHasher::VerifyDirectory(const std::string& path, bool recursive, ProgressCallback* callback)
+{
+	std::vector<VerifyResult> results;
+
+	FileSystem::FindResultsArray files;
+	FileSystem::FindFiles(path.c_str(), "*",
+		recursive ? (FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE | FILESYSTEM_FIND_SORT_BY_NAME) :
+					(FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_SORT_BY_NAME),
+		&files);
+	files.erase(std::remove_if(files.begin(), files.end(),
+					[](const FILESYSTEM_FIND_DATA& ffd) { return !VMManager::IsDiscFileName(ffd.FileName); }),
+		files.end());
+
+	callback->SetProgressRange(static_cast<u32>(files.size()));
+	callback->SetProgressValue(0);
+	callback->SetCancellable(true);
 
-	MD5Digest md5;
-	for (u32 i = 0; i < track.sectors; i++)
+	for (const FILESYSTEM_FIND_DATA& ffd : files)
 	{
 		if (callback->IsCancelled())
-			return false;
+			break;
 
-		const u32 lsn = track.start_lsn + i;
-		if (DoCDVDreadSector(sector_buffer.data(), lsn, read_mode) != 0)
+		VerifyResult& result = results.emplace_back();
+		result.path = ffd.FileName;
+		result.verified = false;
+
+		callback->PushState();
+
+		IsoHasher hasher;
+		Error error;
+		if (!hasher.Open(ffd.FileName, &error))
 		{
-			callback->DisplayFormattedModalError("Read error at LSN %u", lsn);
-			return false;
+			result.error = error.GetDescription();
+			callback->PopState();
+			callback->IncrementProgressValue();
+			continue;
 		}
 
-		md5.Update(sector_buffer.data(), sector_size);
+		hasher.ComputeHashes(callback);
+		callback->PopState();
+		if (callback->IsCancelled())
+		{
+			results.pop_back();
+			break;
+		}
 
-		if ((i % update_interval) == 0)
-			callback->SetProgressValue(i);
-	}
+		// convert to database format
+		std::vector<GameDatabase::TrackHash> thashes;
+		thashes.reserve(hasher.GetTrackCount());
+		for (const Track& track : hasher.GetTracks())
+		{
+			GameDatabase::TrackHash thash;
+			thash.size = track.size;
+			if (track.hash.empty() || !thash.parseHash(track.hash))
+				break;
 
-	u8 digest[16];
-	md5.Final(digest);
-	track.hash =
-		fmt::format("{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}",
-			digest[0], digest[1], digest[2], digest[3], digest[4], digest[5], digest[6], digest[7], digest[8],
-			digest[9], digest[10], digest[11], digest[12], digest[13], digest[14], digest[15]);
+			thashes.push_back(thash);
+		}
 
-	callback->SetProgressValue(track.sectors);
-	return true;
+		if (thashes.size() != hasher.GetTrackCount())
+		{
+			result.error = TRANSLATE_STR("CDVD", "One or more tracks is missing.");
+		}
+		else
+		{
+			std::unique_ptr<bool[]> matched = std::make_unique<bool[]>(thashes.size());
+			const GameDatabase::HashDatabaseEntry* hentry =
+				GameDatabase::lookupHash(thashes.data(), thashes.size(), matched.get(), &result.error);
+			if (hentry)
+			{
+				result.serial = hentry->serial;
+				result.name = hentry->name;
+				result.verified = std::all_of(matched.get(), matched.get() + thashes.size(), [](bool m) { return m; });
+			}
+		}
+
+		callback->IncrementProgressValue();
+	}
+
+	return results;
 }
@@ -24,6 +24,15 @@ public:
 		std::string hash;
 	};
 
+	struct VerifyResult
+	{
+		std::string path;
+		std::string serial;
+		std::string name;
+		std::string error;
+		bool verified;
+	};
+
 public:
 	IsoHasher();
 	~IsoHasher();
@@ -43,8 +52,12 @@ public:
 
 	void ComputeHashes(ProgressCallback* callback = ProgressCallback::NullProgressCallback);
 
+	/// Hashes every disc image in the directory, and matches it against the redump database.
+	static std::vector<VerifyResult> VerifyDirectory(const std::string& path, bool recursive,
+		ProgressCallback* callback = ProgressCallback::NullProgressCallback);
+
 private:
-	bool ComputeTrackHash(Track& track, ProgressCallback* callback);
+	static std::string FormatDigest(const u8 digest[16]);
 
 	std::vector<Track> m_tracks;
 	bool m_is_locked = false;
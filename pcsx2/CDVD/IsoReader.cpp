@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "CDVD/CDVDcommon.h"
+#include "CDVD/IsoFileFormats.h"
 #include "CDVD/IsoReader.h"
 
 #include "common/Assertions.h"
@@ -15,6 +16,11 @@
 
 IsoReader::IsoReader() = default;
 
+IsoReader::IsoReader(InputIsoFile* iso)
+	: m_iso(iso)
+{
+}
+
 IsoReader::~IsoReader() = default;
 
 std::string_view IsoReader::RemoveVersionIdentifierFromPath(const std::string_view path)
@@ -33,6 +39,20 @@ bool IsoReader::Open(Error* error)
 
 bool IsoReader::ReadSector(u8* buf, u32 lsn, Error* error)
 {
+	if (m_iso)
+	{
+		// Same layout as the ISO CDVD backend, user data always starts after the sync/header bytes.
+		u8 raw[CD_FRAMESIZE_RAW];
+		if (lsn >= m_iso->GetBlockCount() || m_iso->ReadSync(raw, lsn) < 0)
+		{
+			Error::SetString(error, fmt::format("Failed to read sector LSN #{}", lsn));
+			return false;
+		}
+
+		std::memcpy(buf, raw + 24, SECTOR_SIZE);
+		return true;
+	}
+
 	if (DoCDVDreadSector(buf, lsn, CDVD_MODE_2048) != 0)
 	{
 		Error::SetString(error, fmt::format("Failed to read sector LSN #{}", lsn));
@@ -11,6 +11,7 @@
 #include <vector>
 
 class Error;
+class InputIsoFile;
 
 class IsoReader
 {
@@ -134,6 +135,10 @@ public:
 #pragma pack(pop)
 
 	IsoReader();
+
+	/// Reads from the specified image instead of the global CDVD interface.
+	explicit IsoReader(InputIsoFile* iso);
+
 	~IsoReader();
 
 	static std::string_view RemoveVersionIdentifierFromPath(const std::string_view path);
@@ -163,4 +168,5 @@ private:
 		u32 directory_record_lba, u32 directory_record_size, Error* error);
 
 	ISOPrimaryVolumeDescriptor m_pvd = {};
+	InputIsoFile* m_iso = nullptr;
 };
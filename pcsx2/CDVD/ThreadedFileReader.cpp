@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "ThreadedFileReader.h"
+#include "Config.h"
 #include "Host.h"
 
 #include "common/Error.h"
@@ -11,12 +12,211 @@
 #include "common/SmallString.h"
 #include "common/Threading.h"
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <list>
+#include <unordered_map>
 
 // Make sure buffer size is bigger than the cutoff where PCSX2 emulates a seek
 // If buffers are smaller than that, we can't keep up with linear reads
 static constexpr u32 MINIMUM_SIZE = 128 * 1024;
 
+// Buffers filled after random accesses (current block, next block)
+static constexpr u32 RANDOM_READAHEAD_DEPTH = 2;
+static constexpr u32 MAX_READAHEAD_DEPTH = 16;
+
+// Requests which have to follow on from each other before the full readahead depth is used
+static constexpr u32 SEQUENTIAL_REQUEST_THRESHOLD = 2;
+
+// Chunk IDs use the low bits of cache keys, and the reader ID the rest
+static constexpr u32 CACHE_ID_SHIFT = 40;
+
+namespace
+{
+	/// Decompressed chunks shared between all readers, evicting the least recently used first
+	class ChunkCache
+	{
+	public:
+		bool Lookup(u64 key, void* dst, int* size);
+		void Insert(u64 key, const void* data, int size);
+		void Purge(u32 cache_id);
+		void SetCapacity(size_t bytes);
+
+	private:
+		struct Entry
+		{
+			u64 key;
+			std::unique_ptr<u8[]> data;
+			int size;
+		};
+
+		void Evict();
+
+		std::mutex m_mutex;
+		std::list<Entry> m_entries; // most recently used first
+		std::unordered_map<u64, std::list<Entry>::iterator> m_lookup;
+		size_t m_size = 0;
+		size_t m_capacity = 0;
+	};
+
+	/// Small pool of threads decoding chunks for readahead, shared between all readers
+	/// The thread which starts a batch works on it too
+	class DecodeWorkers
+	{
+	public:
+		~DecodeWorkers();
+		void Run(u32 count, const std::function<void(u32)>& func);
+
+	private:
+		void WorkerThread();
+
+		std::mutex m_run_mutex; // one batch at a time
+		std::mutex m_mutex;
+		std::condition_variable m_work_cv;
+		std::condition_variable m_done_cv;
+		std::vector<std::thread> m_threads;
+		const std::function<void(u32)>* m_func = nullptr;
+		u32 m_count = 0;
+		u32 m_next = 0;
+		u32 m_active = 0;
+		bool m_quit = false;
+	};
+} // namespace
+
+static ChunkCache s_chunk_cache;
+static DecodeWorkers s_decode_workers;
+static std::atomic<u32> s_next_cache_id{0};
+
+bool ChunkCache::Lookup(u64 key, void* dst, int* size)
+{
+	std::unique_lock lock(m_mutex);
+	const auto it = m_lookup.find(key);
+	if (it == m_lookup.end())
+		return false;
+
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	std::memcpy(dst, it->second->data.get(), it->second->size);
+	*size = it->second->size;
+	return true;
+}
+
+void ChunkCache::Insert(u64 key, const void* data, int size)
+{
+	std::unique_lock lock(m_mutex);
+	if (static_cast<size_t>(size) > m_capacity || m_lookup.find(key) != m_lookup.end())
+		return;
+
+	Entry& entry = m_entries.emplace_front();
+	entry.key = key;
+	entry.data = std::make_unique_for_overwrite<u8[]>(size);
+	entry.size = size;
+	std::memcpy(entry.data.get(), data, size);
+	m_lookup.emplace(key, m_entries.begin());
+	m_size += size;
+	Evict();
+}
+
+void ChunkCache::Purge(u32 cache_id)
+{
+	std::unique_lock lock(m_mutex);
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if ((it->key >> CACHE_ID_SHIFT) == cache_id)
+		{
+			m_size -= it->size;
+			m_lookup.erase(it->key);
+			it = m_entries.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+void ChunkCache::SetCapacity(size_t bytes)
+{
+	std::unique_lock lock(m_mutex);
+	m_capacity = bytes;
+	Evict();
+}
+
+void ChunkCache::Evict()
+{
+	while (m_size > m_capacity)
+	{
+		const Entry& entry = m_entries.back();
+		m_size -= entry.size;
+		m_lookup.erase(entry.key);
+		m_entries.pop_back();
+	}
+}
+
+DecodeWorkers::~DecodeWorkers()
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_quit = true;
+		m_work_cv.notify_all();
+	}
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+void DecodeWorkers::Run(u32 count, const std::function<void(u32)>& func)
+{
+	std::unique_lock run_lock(m_run_mutex);
+	std::unique_lock lock(m_mutex);
+
+	if (m_threads.empty())
+	{
+		// Leave most of the host to the emulator, decoding frames is cheap enough that a few threads keep up.
+		const u32 num_threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+		for (u32 i = 1; i < num_threads; i++)
+			m_threads.emplace_back(&DecodeWorkers::WorkerThread, this);
+	}
+
+	m_func = &func;
+	m_count = count;
+	m_next = 0;
+	m_work_cv.notify_all();
+
+	while (m_next < m_count)
+	{
+		const u32 index = m_next++;
+		lock.unlock();
+		func(index);
+		lock.lock();
+	}
+
+	m_done_cv.wait(lock, [this]() { return m_active == 0; });
+	m_func = nullptr;
+}
+
+void DecodeWorkers::WorkerThread()
+{
+	Threading::SetNameOfCurrentThread("ISO Decompress Worker");
+
+	std::unique_lock lock(m_mutex);
+	for (;;)
+	{
+		m_work_cv.wait(lock, [this]() { return m_quit || (m_func && m_next < m_count); });
+		if (m_quit)
+			return;
+
+		const u32 index = m_next++;
+		const std::function<void(u32)>* func = m_func;
+		m_active++;
+		lock.unlock();
+		(*func)(index);
+		lock.lock();
+		if (--m_active == 0)
+			m_done_cv.notify_all();
+	}
+}
+
 ThreadedFileReader::ThreadedFileReader()
 {
 	m_readThread = std::thread([](ThreadedFileReader* r){ r->Loop(); }, this);
@@ -28,9 +228,11 @@ ThreadedFileReader::~ThreadedFileReader()
 	(void)std::lock_guard<std::mutex>{m_mtx};
 	m_condition.notify_one();
 	m_readThread.join();
-	for (auto& buffer : m_buffer)
-		if (buffer.ptr)
-			free(buffer.ptr);
+	for (u32 i = 0; i < m_bufferCount; i++)
+		if (m_buffers[i].ptr)
+			free(m_buffers[i].ptr);
+	if (m_cacheID)
+		s_chunk_cache.Purge(m_cacheID);
 }
 
 size_t ThreadedFileReader::CopyBlocks(void* dst, const void* src, size_t size) const
@@ -69,6 +271,7 @@ void ThreadedFileReader::Loop()
 
 		u64 requestOffset;
 		u32 requestSize;
+		bool readaheadOnly;
 
 		bool ok = true;
 		m_running = true;
@@ -78,6 +281,7 @@ void ThreadedFileReader::Loop()
 			void* ptr = m_requestPtr.load(std::memory_order_acquire);
 			requestOffset = m_requestOffset;
 			requestSize = m_requestSize;
+			readaheadOnly = !ptr;
 			lock.unlock();
 
 			if (ptr)
@@ -98,35 +302,9 @@ void ThreadedFileReader::Loop()
 
 		if (ok)
 		{
-			// Readahead
-			Chunk chunk = ChunkForOffset(requestOffset + requestSize);
-			if (chunk.chunkID >= 0)
-			{
-				int buffersFilled = 0;
-				Buffer* buf = GetBlockPtr(chunk);
-				// Cancel readahead if a new request comes in
-				while (buf && !m_requestPtr.load(std::memory_order_acquire))
-				{
-					u32 bufsize = buf->size.load(std::memory_order_relaxed);
-					chunk = ChunkForOffset(buf->offset + bufsize);
-					if (chunk.chunkID < 0)
-						break;
-					if (buf->offset + bufsize != chunk.offset || chunk.length + bufsize > buf->cap)
-					{
-						buffersFilled++;
-						if (buffersFilled >= 2)
-							break;
-						buf = GetBlockPtr(chunk);
-					}
-					else
-					{
-						int amt = ReadChunk(static_cast<char*>(buf->ptr) + bufsize, chunk.chunkID);
-						if (amt <= 0)
-							break;
-						buf->size.store(bufsize + amt, std::memory_order_release);
-					}
-				}
-			}
+			// Only read far ahead for streams, random accesses would just throw the buffers away.
+			const bool sequential = IsSequentialRequest(requestOffset, requestSize, readaheadOnly);
+			Readahead(requestOffset + requestSize, sequential ? m_bufferCount : std::min(m_bufferCount, RANDOM_READAHEAD_DEPTH));
 		}
 
 		lock.lock();
@@ -141,20 +319,150 @@ void ThreadedFileReader::Loop()
 	}
 }
 
+bool ThreadedFileReader::IsSequentialRequest(u64 offset, u32 size, bool readahead_only)
+{
+	// Readahead-only requests mean the last read was served from the buffers, so it followed on.
+	// Otherwise allow for small skips, as long as they land inside the readahead window.
+	const bool follows = readahead_only ||
+						 (offset >= m_lastRequestEnd && (offset - m_lastRequestEnd) < static_cast<u64>(m_bufferCount) * MINIMUM_SIZE);
+	m_sequentialRequests = follows ? std::min(m_sequentialRequests + 1, SEQUENTIAL_REQUEST_THRESHOLD) : 0;
+	m_lastRequestEnd = offset + size;
+	return (m_sequentialRequests >= SEQUENTIAL_REQUEST_THRESHOLD);
+}
+
+void ThreadedFileReader::Readahead(u64 offset, u32 depth)
+{
+	Chunk chunk = ChunkForOffset(offset);
+	if (chunk.chunkID < 0)
+		return;
+
+	u32 buffersFilled = 0;
+	Buffer* buf = GetBlockPtr(chunk);
+	// Cancel readahead if a new request comes in
+	while (buf && !m_requestPtr.load(std::memory_order_acquire))
+	{
+		u32 bufsize = buf->size.load(std::memory_order_relaxed);
+		chunk = ChunkForOffset(buf->offset + bufsize);
+		if (chunk.chunkID < 0)
+			break;
+		if (buf->offset + bufsize != chunk.offset || chunk.length + bufsize > buf->cap)
+		{
+			buffersFilled++;
+			if (buffersFilled >= depth)
+				break;
+			buf = GetBlockPtr(chunk);
+		}
+		else
+		{
+			u32 amt = ReadChunks(static_cast<char*>(buf->ptr) + bufsize, chunk, buf->cap - bufsize);
+			if (amt == 0)
+				break;
+			buf->size.store(bufsize + amt, std::memory_order_release);
+		}
+	}
+}
+
+u32 ThreadedFileReader::ReadChunks(void* dst, const Chunk& first, u32 space)
+{
+	char* write = static_cast<char*>(dst);
+	if (!m_parallelDecode)
+	{
+		int amt = ReadChunkCached(write, first.chunkID);
+		return std::max(amt, 0);
+	}
+
+	// Pull in the compressed data for every chunk which fits, then decode them all at once.
+	// A cached first chunk is copied straight in, the next call picks up from after it.
+	u32 count = 0;
+	u32 total = 0;
+	Chunk chunk = first;
+	while (chunk.chunkID >= 0 && chunk.offset == first.offset + total && total + chunk.length <= space)
+	{
+		int cached_size;
+		if (count == 0 && m_cacheChunks && s_chunk_cache.Lookup(CacheKey(chunk.chunkID), write, &cached_size))
+			return std::max(cached_size, 0);
+
+		if (m_rawChunks.size() <= count)
+			m_rawChunks.emplace_back();
+		if (!ReadRawChunk(&m_rawChunks[count], chunk.chunkID))
+			break;
+
+		count++;
+		total += chunk.length;
+		chunk = ChunkForOffset(chunk.offset + chunk.length);
+		if (m_requestPtr.load(std::memory_order_acquire))
+			break;
+	}
+
+	if (count == 0)
+		return 0;
+
+	// Every full chunk is the same length, so each one's position is known up front.
+	std::unique_ptr<int[]> sizes = std::make_unique<int[]>(count);
+	const u32 length = first.length;
+	s_decode_workers.Run(count, [this, write, length, &sizes](u32 i) {
+		sizes[i] = DecodeRawChunk(write + static_cast<size_t>(i) * length, m_rawChunks[i]);
+	});
+
+	u32 amt = 0;
+	for (u32 i = 0; i < count; i++)
+	{
+		if (sizes[i] <= 0)
+			break;
+		if (m_cacheChunks)
+			s_chunk_cache.Insert(CacheKey(m_rawChunks[i].chunkID), write + amt, sizes[i]);
+		amt += sizes[i];
+		if (static_cast<u32>(sizes[i]) < length)
+			break;
+	}
+	return amt;
+}
+
+int ThreadedFileReader::ReadChunkCached(void* dst, s64 chunkID)
+{
+	if (!m_cacheChunks)
+		return ReadChunk(dst, chunkID);
+
+	const u64 key = CacheKey(chunkID);
+	int size;
+	if (s_chunk_cache.Lookup(key, dst, &size))
+		return size;
+
+	size = ReadChunk(dst, chunkID);
+	if (size > 0)
+		s_chunk_cache.Insert(key, dst, size);
+	return size;
+}
+
+u64 ThreadedFileReader::CacheKey(s64 chunkID) const
+{
+	return (static_cast<u64>(m_cacheID) << CACHE_ID_SHIFT) | static_cast<u64>(chunkID);
+}
+
+bool ThreadedFileReader::ReadRawChunk(RawChunk* raw, s64 chunkID)
+{
+	return false;
+}
+
+int ThreadedFileReader::DecodeRawChunk(void* dst, const RawChunk& raw)
+{
+	return 0;
+}
+
 ThreadedFileReader::Buffer* ThreadedFileReader::GetBlockPtr(const Chunk& block)
 {
-	for (int i = 0; i < static_cast<int>(std::size(m_buffer)); i++)
+	for (u32 i = 0; i < m_bufferCount; i++)
 	{
-		u32 size = m_buffer[i].size.load(std::memory_order_relaxed);
-		u64 offset = m_buffer[i].offset;
+		u32 size = m_buffers[i].size.load(std::memory_order_relaxed);
+		u64 offset = m_buffers[i].offset;
 		if (size && offset <= block.offset && offset + size >= block.offset + block.length)
 		{
-			m_nextBuffer = (i + 1) % std::size(m_buffer);
-			return m_buffer + i;
+			m_nextBuffer = (i + 1) % m_bufferCount;
+			return &m_buffers[i];
 		}
 	}
 
-	Buffer& buf = m_buffer[m_nextBuffer];
+	Buffer& buf = m_buffers[m_nextBuffer];
 	{
 		// This can be called from both the read thread threads in ReadSync
 		// Calls from ReadSync are done with the lock already held to keep the read thread out
@@ -170,12 +478,12 @@ ThreadedFileReader::Buffer* ThreadedFileReader::GetBlockPtr(const Chunk& block)
 		}
 		buf.size.store(0, std::memory_order_relaxed);
 	}
-	int size = ReadChunk(buf.ptr, block.chunkID);
+	int size = ReadChunkCached(buf.ptr, block.chunkID);
 	if (size > 0)
 	{
 		buf.offset = block.offset;
 		buf.size.store(size, std::memory_order_release);
-		m_nextBuffer = (m_nextBuffer + 1) % std::size(m_buffer);
+		m_nextBuffer = (m_nextBuffer + 1) % m_bufferCount;
 		return &buf;
 	}
 	return nullptr;
@@ -208,7 +516,7 @@ bool ThreadedFileReader::Decompress(void* target, u64 begin, u32 size)
 		}
 		else
 		{
-			int amt = ReadChunk(write, chunk.chunkID);
+			int amt = ReadChunkCached(write, chunk.chunkID);
 			if (amt < static_cast<int>(chunk.length))
 				return false;
 			write += chunk.length;
@@ -222,13 +530,12 @@ bool ThreadedFileReader::Decompress(void* target, u64 begin, u32 size)
 
 bool ThreadedFileReader::TryCachedRead(void*& buffer, u64& offset, u32& size, const std::lock_guard<std::mutex>&)
 {
-	// Run through twice so that if m_buffer[1] contains the first half and m_buffer[0] contains the second half it still works
+	// Run through twice so that if m_buffers[1] contains the first half and m_buffers[0] contains the second half it still works
 	m_amtRead = 0;
 	u64 end = 0;
-	bool allDone = false;
-	for (int i = 0; i < static_cast<int>(std::size(m_buffer) * 2); i++)
+	for (u32 i = 0; i < m_bufferCount * 2; i++)
 	{
-		Buffer& buf = m_buffer[i % std::size(m_buffer)];
+		Buffer& buf = m_buffers[i % m_bufferCount];
 		u32 bufsize = buf.size.load(std::memory_order_acquire);
 		if (!bufsize)
 			continue;
@@ -244,11 +551,32 @@ bool ThreadedFileReader::TryCachedRead(void*& buffer, u64& offset, u32& size, co
 			if (size == 0)
 				end = buf.offset + bufsize;
 		}
-		// Do buffers contain the current and next block?
-		if (end > 0 && buf.offset == end)
-			allDone = true;
 	}
-	return allDone;
+	if (end == 0)
+		return false;
+
+	// Do buffers contain the current block and enough of the following ones?
+	// Readahead is kicked off once half the window has been used, so it stays ahead of a stream.
+	const u32 wanted = std::max(m_bufferCount / 2, 1u);
+	u32 ahead = 0;
+	bool found = true;
+	while (found && ahead < wanted)
+	{
+		found = false;
+		for (u32 i = 0; i < m_bufferCount; i++)
+		{
+			const Buffer& buf = m_buffers[i];
+			const u32 bufsize = buf.size.load(std::memory_order_acquire);
+			if (bufsize && buf.offset == end)
+			{
+				end += bufsize;
+				ahead++;
+				found = true;
+				break;
+			}
+		}
+	}
+	return (ahead >= wanted);
 }
 
 bool ThreadedFileReader::Precache(ProgressCallback* progress, Error* error)
@@ -286,6 +614,25 @@ bool ThreadedFileReader::CheckAvailableMemoryForPrecaching(u64 required_size, Er
 bool ThreadedFileReader::Open(std::string filename, Error* error)
 {
 	CancelAndWaitUntilStopped();
+
+	// The read thread is idle, so the buffers can be swapped out.
+	const u32 buffer_count = static_cast<u32>(std::clamp<int>(EmuConfig.CdvdReadaheadDepth, RANDOM_READAHEAD_DEPTH, MAX_READAHEAD_DEPTH));
+	if (buffer_count != m_bufferCount)
+	{
+		for (u32 i = 0; i < m_bufferCount; i++)
+			if (m_buffers[i].ptr)
+				free(m_buffers[i].ptr);
+		m_buffers = std::make_unique<Buffer[]>(buffer_count);
+		m_bufferCount = buffer_count;
+		m_nextBuffer = 0;
+	}
+	m_lastRequestEnd = 0;
+	m_sequentialRequests = 0;
+
+	if (m_cacheChunks)
+		SetCacheSize(EmuConfig.CdvdCacheSize);
+	m_cacheID = (s_next_cache_id.fetch_add(1, std::memory_order_relaxed) + 1) & ((1u << (64 - CACHE_ID_SHIFT)) - 1);
+
 	return Open2(std::move(filename), error);
 }
 
@@ -393,8 +740,14 @@ void ThreadedFileReader::CancelRead(void)
 void ThreadedFileReader::Close(void)
 {
 	CancelAndWaitUntilStopped();
-	for (auto& buf : m_buffer)
-		buf.size.store(0, std::memory_order_relaxed);
+	for (u32 i = 0; i < m_bufferCount; i++)
+		m_buffers[i].size.store(0, std::memory_order_relaxed);
+	m_rawChunks.clear();
+	if (m_cacheID)
+	{
+		s_chunk_cache.Purge(m_cacheID);
+		m_cacheID = 0;
+	}
 	Close2();
 }
 
@@ -407,3 +760,8 @@ void ThreadedFileReader::SetDataOffset(u32 bytes)
 {
 	m_dataoffset = bytes;
 }
+
+void ThreadedFileReader::SetCacheSize(u32 megabytes)
+{
+	s_chunk_cache.SetCapacity(static_cast<size_t>(megabytes) * _1mb);
+}
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
+#include <vector>
 
 class Error;
 class ProgressCallback;
@@ -37,10 +39,33 @@ protected:
 	/// Use to avoid overrunning stack because PCSX2 likes to allocate 2448-byte buffers
 	int m_internalBlockSize = 0;
 
+	/// Set to keep decompressed chunks in the block cache shared between all readers
+	/// Not worth it for formats which are just read from disk
+	bool m_cacheChunks = false;
+	/// Set if the reader implements ReadRawChunk() and DecodeRawChunk()
+	/// Readahead will then decode several chunks at once on the decompression workers
+	bool m_parallelDecode = false;
+
+	/// Compressed data for a chunk, read from the file but not decoded yet
+	struct RawChunk
+	{
+		s64 chunkID;
+		const u8* data;
+		u32 size;
+		/// Holds the data if it had to be read from the file
+		std::vector<u8> storage;
+	};
+
 	/// Get the block containing the given offset
 	virtual Chunk ChunkForOffset(u64 offset) = 0;
 	/// Synchronously read the given block into `dst`
 	virtual int ReadChunk(void* dst, s64 chunkID) = 0;
+	/// Read the compressed data of the given block, without decoding it
+	/// Only called from the read thread, and only if `m_parallelDecode` is set
+	virtual bool ReadRawChunk(RawChunk* raw, s64 chunkID);
+	/// Decode a block read by ReadRawChunk() into `dst`, returning the number of bytes written
+	/// Called from several threads at once, so must not touch any shared decompression state
+	virtual int DecodeRawChunk(void* dst, const RawChunk& raw);
 	/// AsyncFileReader open but ThreadedFileReader needs prep work first
 	virtual bool Open2(std::string filename, Error* error) = 0;
 	/// AsyncFileReader precache but ThreadedFileReader needs prep work first
@@ -72,10 +97,22 @@ private:
 		std::atomic<u32> size{0};
 		u32 cap = 0;
 	};
-	/// 2 buffers for readahead (current block, next block)
-	Buffer m_buffer[2];
+	/// Buffers for readahead (current block, next blocks), used round-robin
+	/// Only reallocated in Open(), when the read thread is idle
+	std::unique_ptr<Buffer[]> m_buffers;
+	u32 m_bufferCount = 0;
 	u32 m_nextBuffer = 0;
 
+	/// Identifies this reader's chunks in the shared block cache, changes every time a file is opened
+	u32 m_cacheID = 0;
+
+	/// End of the last request seen by the read thread, for detecting sequential access
+	u64 m_lastRequestEnd = 0;
+	/// Number of requests in a row which followed on from the previous one
+	u32 m_sequentialRequests = 0;
+	/// Compressed chunks waiting to be decoded during readahead
+	std::vector<RawChunk> m_rawChunks;
+
 	std::thread m_readThread;
 	std::mutex m_mtx;
 	std::condition_variable m_condition;
@@ -95,7 +132,20 @@ private:
 	/// Main loop of read thread
 	void Loop();
 
-	/// Load the given block into one of the `m_buffer` buffers if necessary and return a pointer to its contents if successful
+	/// Track whether requests follow on from each other
+	/// Returns true if the stream looks sequential, and the full readahead depth should be used
+	bool IsSequentialRequest(u64 offset, u32 size, bool readahead_only);
+	/// Fill up to `depth` buffers with the blocks following `offset`
+	void Readahead(u64 offset, u32 depth);
+	/// Read as many of the blocks starting at `first` as fit in `space` bytes into `dst`
+	/// Returns the number of bytes read, which stops early at the first failed or short block
+	u32 ReadChunks(void* dst, const Chunk& first, u32 space);
+	/// ReadChunk() through the shared block cache
+	int ReadChunkCached(void* dst, s64 chunkID);
+	/// Key for the given block in the shared block cache
+	u64 CacheKey(s64 chunkID) const;
+
+	/// Load the given block into one of the `m_buffers` buffers if necessary and return a pointer to its contents if successful
 	Buffer* GetBlockPtr(const Chunk& block);
 	/// Decompress from offset to size into
 	bool Decompress(void* ptr, u64 offset, u32 size);
@@ -124,4 +174,7 @@ public:
 	void Close();
 	void SetBlockSize(u32 bytes);
 	void SetDataOffset(u32 bytes);
+
+	/// Resize the block cache shared between all readers, evicting blocks if it shrinks
+	static void SetCacheSize(u32 megabytes);
 };
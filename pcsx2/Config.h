@@ -654,6 +654,10 @@ struct Pcsx2Config
 			EnableEECache : 1;
 		bool
 			EnableFastmem : 1;
+		bool
+			PrecompileEEBlocks : 1;
+		bool
+			PrecompileVUPrograms : 1;
 		bool
 			PauseOnTLBMiss : 1;
 		BITFIELD_END
@@ -790,6 +794,7 @@ struct Pcsx2Config
 					HWSpinCPUForReadbacks : 1,
 					GPUPaletteConversion : 1,
 					AutoFlushSW : 1,
+					SWExtraThreadsBinned : 1,
 					PreloadFrameWithGSData : 1,
 					Mipmap : 1,
 					HWMipmap : 1,
@@ -832,6 +837,7 @@ struct Pcsx2Config
 					LoadTextureReplacements : 1,
 					LoadTextureReplacementsAsync : 1,
 					PrecacheTextureReplacements : 1,
+					CompressTextureReplacements : 1,
 					EnableVideoCapture : 1,
 					EnableVideoCaptureParameters : 1,
 					VideoCaptureAutoResolution : 1,
@@ -905,6 +911,9 @@ struct Pcsx2Config
 
 		u16 SWExtraThreads = 2;
 		u16 SWExtraThreadsHeight = 4;
+		u16 SWPrimRenderThreads = 0;
+		u16 TextureReplacementCacheSize = 0; // MB, 0 for unlimited
+		u16 TextureHashCacheSize = 0; // MB, 0 for age based eviction
 
 		int SaveDrawStart = 0;
 		int SaveDrawCount = 5000;
@@ -1336,6 +1345,10 @@ struct Pcsx2Config
 		SavestateCompressionMethod CompressionType = SavestateCompressionMethod::Zstandard;
 		SavestateCompressionLevel CompressionRatio = SavestateCompressionLevel::Medium;
 
+		bool RewindEnable = false;
+		uint RewindFrequency = 10; // vsyncs between rewind captures
+		uint RewindBufferSize = 256; // megabytes
+
 		bool operator==(const SavestateOptions& right) const;
 		bool operator!=(const SavestateOptions& right) const;
 	};
@@ -1394,6 +1407,8 @@ struct Pcsx2Config
 	// slots (3 each)
 	McdOptions Mcd[8];
 	std::string GzipIsoIndexTemplate; // for quick-access index with gzipped ISO
+	int CdvdReadaheadDepth; // buffers read ahead when streaming from compressed images
+	int CdvdCacheSize; // megabytes of decompressed blocks kept for compressed images
 
 	int PINESlot;
 
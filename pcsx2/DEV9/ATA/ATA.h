@@ -13,6 +13,7 @@
 #include "common/Path.h"
 
 #include "DEV9/SimpleQueue.h"
+#include "HddBlockImage.h"
 
 class ATA
 {
@@ -27,6 +28,9 @@ private:
 	std::FILE* hddImage = nullptr;
 	u64 hddImageSize;
 
+	// Set instead of hddImage for block allocated images.
+	std::unique_ptr<HddBlockImage> hddBlockImage;
+
 	bool hddSparse = false;
 	u64 hddSparseBlockSize;
 	u64 HddSparseStart;
@@ -116,6 +120,10 @@ private:
 		u64 sector;
 	};
 	SimpleQueue<WriteQueueEntry> writeQueue;
+	// Dequeued, but not consecutive with the previous write, written next.
+	WriteQueueEntry ioWriteNext{nullptr, 0, 0};
+	//Max size of consecutive writes merged into one
+	static constexpr u32 ioWriteMergeMax = 4 * 1024 * 1024;
 
 	std::thread ioThread;
 	bool ioRunning = false;
@@ -212,6 +220,7 @@ private:
 	void IO_Thread();
 	void IO_Read();
 	bool IO_Write();
+	bool IO_DequeueWrite(WriteQueueEntry* entry);
 	bool IO_SparseZero(u64 byteOffset, u64 byteSize);
 	void IO_SparseCacheUpdateLocation(u64 Offset);
 	void IO_SparseCacheLoad();
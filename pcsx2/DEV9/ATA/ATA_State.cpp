@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "common/Assertions.h"
+#include "common/Error.h"
 #include "common/FileSystem.h"
 
 #include "ATA.h"
@@ -47,13 +48,28 @@ int ATA::Open(const std::string& hddPath)
 		return -1;
 
 	hddImage = FileSystem::OpenCFile(hddPath.c_str(), "r+b");
-	const s64 size = hddImage ? FileSystem::FSize64(hddImage) : -1;
+	s64 size = hddImage ? FileSystem::FSize64(hddImage) : -1;
 	if (!hddImage || size < 0)
 	{
 		Console.Error("DEV9: ATA: Failed to open HDD image '%s'", hddPath.c_str());
 		return -1;
 	}
 
+	if (HddBlockImage::IsBlockImage(hddImage))
+	{
+		std::fclose(hddImage);
+		hddImage = nullptr;
+
+		Error error;
+		hddBlockImage = HddBlockImage::Open(hddPath, false, &error);
+		if (!hddBlockImage)
+		{
+			Console.Error("DEV9: ATA: Failed to open HDD image '%s': %s", hddPath.c_str(), error.GetDescription().c_str());
+			return -1;
+		}
+		size = static_cast<s64>(hddBlockImage->GetSize());
+	}
+
 	// Open and read the content of the hddid file
 	std::string hddidPath = Path::ReplaceExtension(hddPath, "hddid");
 	std::optional<std::vector<u8>> fileContent = FileSystem::ReadBinaryFile(hddidPath.c_str());
@@ -99,7 +115,9 @@ int ATA::Open(const std::string& hddPath)
 
 	CreateHDDinfo(hddImageSize / 512);
 
-	InitSparseSupport(hddPath);
+	// Block images only allocate what is written already.
+	if (hddImage)
+		InitSparseSupport(hddPath);
 
 	{
 		std::lock_guard ioSignallock(ioMutex);
@@ -286,6 +304,7 @@ void ATA::Close()
 		std::fclose(hddImage);
 		hddImage = nullptr;
 	}
+	hddBlockImage.reset();
 
 	delete[] readBuffer;
 	readBuffer = nullptr;
@@ -513,7 +532,7 @@ void ATA::Write(u32 addr, u16 value, int width)
 
 void ATA::Async(uint cycles)
 {
-	if (!hddImage)
+	if (!hddImage && !hddBlockImage)
 		return;
 
 	if ((regStatus & (ATA_STAT_BUSY | ATA_STAT_DRQ)) == 0 ||
@@ -68,8 +68,11 @@ void ATA::IO_Read()
 	}
 
 	const u64 pos = lba * 512;
-	if (FileSystem::FSeek64(hddImage, pos, SEEK_SET) != 0 ||
-		std::fread(readBuffer,  512, nsector, hddImage) != static_cast<size_t>(nsector))
+	const bool readOk = hddBlockImage ?
+							hddBlockImage->Read(pos, readBuffer, nsector * 512) :
+							(FileSystem::FSeek64(hddImage, pos, SEEK_SET) == 0 &&
+								std::fread(readBuffer, 512, nsector, hddImage) == static_cast<size_t>(nsector));
+	if (!readOk)
 	{
 		Console.Error("DEV9: ATA: File read error");
 		pxAssert(false);
@@ -84,7 +87,7 @@ void ATA::IO_Read()
 bool ATA::IO_Write()
 {
 	WriteQueueEntry entry;
-	if (!writeQueue.Dequeue(&entry))
+	if (!IO_DequeueWrite(&entry))
 	{
 		std::lock_guard ioSignallock(ioMutex);
 		ioWrite = false;
@@ -92,6 +95,18 @@ bool ATA::IO_Write()
 	}
 
 	const u64 imagePos = entry.sector * 512;
+	if (hddBlockImage)
+	{
+		if (!hddBlockImage->Write(imagePos, entry.data, entry.length))
+		{
+			Console.Error("DEV9: ATA: File write error");
+			pxAssert(false);
+			abort();
+		}
+		delete[] entry.data;
+		return true;
+	}
+
 	if (FileSystem::FSeek64(hddImage, imagePos, SEEK_SET) != 0)
 	{
 		Console.Error("DEV9: ATA: File seek error");
@@ -181,6 +196,51 @@ bool ATA::IO_Write()
 	return true;
 }
 
+// Merges queued writes to consecutive sectors, so they reach the image as one write.
+bool ATA::IO_DequeueWrite(WriteQueueEntry* entry)
+{
+	if (ioWriteNext.data != nullptr)
+	{
+		*entry = ioWriteNext;
+		ioWriteNext = {nullptr, 0, 0};
+	}
+	else if (!writeQueue.Dequeue(entry))
+		return false;
+
+	std::vector<WriteQueueEntry> merged;
+	u32 mergedLength = entry->length;
+	WriteQueueEntry next;
+	while (mergedLength < ioWriteMergeMax && writeQueue.Dequeue(&next))
+	{
+		const u64 expectedSector = entry->sector + mergedLength / 512;
+		if (next.sector != expectedSector || mergedLength + next.length > ioWriteMergeMax)
+		{
+			ioWriteNext = next;
+			break;
+		}
+		merged.push_back(next);
+		mergedLength += next.length;
+	}
+
+	if (merged.empty())
+		return true;
+
+	u8* data = new u8[mergedLength];
+	memcpy(data, entry->data, entry->length);
+	u32 offset = entry->length;
+	for (const WriteQueueEntry& mergedEntry : merged)
+	{
+		memcpy(&data[offset], mergedEntry.data, mergedEntry.length);
+		offset += mergedEntry.length;
+		delete[] mergedEntry.data;
+	}
+	delete[] entry->data;
+
+	entry->data = data;
+	entry->length = mergedLength;
+	return true;
+}
+
 void ATA::IO_SparseCacheLoad()
 {
 	// Reads are bounds checked, but for the sectors read only.
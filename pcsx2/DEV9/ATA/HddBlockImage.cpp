@@ -0,0 +1,513 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "common/Assertions.h"
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+
+#include <fmt/format.h>
+#include "HddBlockImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+static bool IsAllZero(const u8* data, size_t len)
+{
+	return len == 0 || (data[0] == 0 && std::memcmp(data, data + 1, len - 1) == 0);
+}
+
+HddBlockImage::~HddBlockImage() = default;
+
+bool HddBlockImage::IsBlockImage(std::FILE* fp)
+{
+	const s64 orgPos = FileSystem::FTell64(fp);
+	u32 magic = 0;
+	const bool ret = (FileSystem::FSeek64(fp, 0, SEEK_SET) == 0 && std::fread(&magic, sizeof(magic), 1, fp) == 1 && magic == Magic);
+	FileSystem::FSeek64(fp, orgPos, SEEK_SET);
+	return ret;
+}
+
+std::optional<u64> HddBlockImage::GetDiskSize(std::FILE* fp)
+{
+	if (IsBlockImage(fp))
+	{
+		Header hdr;
+		if (FileSystem::FSeek64(fp, 0, SEEK_SET) != 0 || std::fread(&hdr, sizeof(hdr), 1, fp) != 1)
+			return std::nullopt;
+		return hdr.diskSize;
+	}
+
+	const s64 size = FileSystem::FSize64(fp);
+	if (size < 0)
+		return std::nullopt;
+	return static_cast<u64>(size);
+}
+
+std::optional<u64> HddBlockImage::GetImageSize(const std::string& path)
+{
+	FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(path.c_str(), "rb");
+	if (!fp)
+		return std::nullopt;
+
+	return GetDiskSize(fp.get());
+}
+
+std::unique_ptr<HddBlockImage> HddBlockImage::Open(const std::string& path, bool readOnly, Error* error)
+{
+	return Open(path, readOnly, 0, error);
+}
+
+std::unique_ptr<HddBlockImage> HddBlockImage::Open(const std::string& path, bool readOnly, u32 depth, Error* error)
+{
+	std::unique_ptr<HddBlockImage> image(new HddBlockImage());
+	image->file = FileSystem::OpenManagedCFile(path.c_str(), readOnly ? "rb" : "r+b", error);
+	if (!image->file)
+		return {};
+
+	image->readOnly = readOnly;
+
+	Header& hdr = image->header;
+	if (FileSystem::FSeek64(image->file.get(), 0, SEEK_SET) != 0 || std::fread(&hdr, sizeof(hdr), 1, image->file.get()) != 1)
+	{
+		Error::SetString(error, fmt::format("Failed to read header of '{}'", Path::GetFileName(path)));
+		return {};
+	}
+
+	if (hdr.magic != Magic || hdr.version != Version)
+	{
+		Error::SetString(error, fmt::format("'{}' is not a supported HDD image", Path::GetFileName(path)));
+		return {};
+	}
+
+	// 4KiB to 2MiB clusters.
+	if (hdr.clusterBits < 12 || hdr.clusterBits > 21 || hdr.diskSize == 0 || hdr.diskSize > MaxDiskSize ||
+		hdr.basePathLength > image->GetClusterSize() - sizeof(Header))
+	{
+		Error::SetString(error, fmt::format("Invalid header in '{}'", Path::GetFileName(path)));
+		return {};
+	}
+
+	const u64 clusters = (hdr.diskSize + image->GetClusterSize() - 1) >> hdr.clusterBits;
+	if (hdr.l1Entries != (clusters + image->GetL2Entries() - 1) / image->GetL2Entries())
+	{
+		Error::SetString(error, fmt::format("Invalid L1 table size in '{}'", Path::GetFileName(path)));
+		return {};
+	}
+
+	std::string storedBasePath(hdr.basePathLength, '\0');
+	if (hdr.basePathLength > 0 && std::fread(storedBasePath.data(), hdr.basePathLength, 1, image->file.get()) != 1)
+	{
+		Error::SetString(error, fmt::format("Failed to read base path of '{}'", Path::GetFileName(path)));
+		return {};
+	}
+
+	if (!image->LoadTables(error))
+		return {};
+
+	if (!storedBasePath.empty() && !image->OpenBase(path, storedBasePath, depth, error))
+		return {};
+
+	image->clusterBuffer = std::make_unique<u8[]>(image->GetClusterSize());
+	image->readAhead = std::make_unique<u8[]>(ReadAheadSize);
+
+	return image;
+}
+
+bool HddBlockImage::LoadTables(Error* error)
+{
+	// New clusters get appended, keep them aligned.
+	const s64 size = FileSystem::FSize64(file.get());
+	if (size < 0)
+	{
+		Error::SetString(error, "Failed to get HDD image size");
+		return false;
+	}
+	fileEnd = (static_cast<u64>(size) + GetClusterSize() - 1) & ~static_cast<u64>(GetClusterSize() - 1);
+
+	// Check before allocating, so a corrupt header can't have us allocate more than the file holds.
+	if (header.l1Offset > fileEnd || static_cast<u64>(header.l1Entries) * sizeof(u64) > fileEnd - header.l1Offset)
+	{
+		Error::SetString(error, "HDD image L1 table is outside of the file");
+		return false;
+	}
+
+	l1Table.resize(header.l1Entries);
+	if (!ReadFile(header.l1Offset, l1Table.data(), l1Table.size() * sizeof(u64)))
+	{
+		Error::SetString(error, "Failed to read HDD image L1 table");
+		return false;
+	}
+
+	// Every L2 table is loaded upfront, this is at most 8 bytes per cluster of disk.
+	l2Tables.resize(header.l1Entries);
+	for (u32 i = 0; i < header.l1Entries; i++)
+	{
+		if (l1Table[i] == 0)
+			continue;
+
+		if ((l1Table[i] & (GetClusterSize() - 1)) != 0 || l1Table[i] >= fileEnd)
+		{
+			Error::SetString(error, fmt::format("Invalid L1 table entry {}", i));
+			return false;
+		}
+
+		l2Tables[i] = std::make_unique<u64[]>(GetL2Entries());
+		if (!ReadFile(l1Table[i], l2Tables[i].get(), GetClusterSize()))
+		{
+			Error::SetString(error, fmt::format("Failed to read L2 table {}", i));
+			return false;
+		}
+
+		for (u32 j = 0; j < GetL2Entries(); j++)
+		{
+			const u64 entry = l2Tables[i][j];
+			if (entry != 0 && ((entry & (GetClusterSize() - 1)) != 0 || entry >= fileEnd))
+			{
+				Error::SetString(error, fmt::format("Invalid L2 table entry {} in table {}", j, i));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool HddBlockImage::OpenBase(const std::string& path, const std::string& storedBasePath, u32 depth, Error* error)
+{
+	if (depth >= MaxBaseDepth)
+	{
+		Error::SetString(error, fmt::format("Too many base images below '{}'", Path::GetFileName(path)));
+		return false;
+	}
+
+	const std::string basePath = Path::IsAbsolute(storedBasePath) ?
+									 storedBasePath :
+									 Path::Combine(Path::GetDirectory(path), storedBasePath);
+
+	FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(basePath.c_str(), "rb", error);
+	if (!fp)
+		return false;
+
+	if (IsBlockImage(fp.get()))
+	{
+		fp.reset();
+		baseImage = Open(basePath, true, depth + 1, error);
+		if (!baseImage)
+			return false;
+	}
+	else
+	{
+		baseFile = std::move(fp);
+	}
+
+	const std::optional<u64> baseSize = baseImage ? baseImage->GetSize() : GetDiskSize(baseFile.get());
+	if (baseSize != header.diskSize)
+	{
+		Error::SetString(error, fmt::format("Base image '{}' does not match the size of the overlay", Path::GetFileName(basePath)));
+		return false;
+	}
+
+	return true;
+}
+
+bool HddBlockImage::Create(const std::string& path, u64 size, Error* error)
+{
+	return WriteNewImage(path, size, std::string(), error);
+}
+
+bool HddBlockImage::CreateOverlay(const std::string& path, const std::string& basePath, Error* error)
+{
+	FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(basePath.c_str(), "rb", error);
+	if (!fp)
+		return false;
+
+	const std::optional<u64> size = GetDiskSize(fp.get());
+	if (!size.has_value())
+	{
+		Error::SetString(error, fmt::format("Failed to get size of base image '{}'", Path::GetFileName(basePath)));
+		return false;
+	}
+	fp.reset();
+
+	// Keep the base relative when possible, so a base and its overlays can be moved together.
+	const std::string storedBasePath = Path::MakeRelative(Path::RealPath(basePath), Path::RealPath(Path::GetDirectory(path)));
+	return WriteNewImage(path, size.value(), storedBasePath, error);
+}
+
+bool HddBlockImage::WriteNewImage(const std::string& path, u64 size, const std::string& storedBasePath, Error* error)
+{
+	if (FileSystem::FileExists(path.c_str()))
+	{
+		Error::SetString(error, fmt::format("'{}' already exists", Path::GetFileName(path)));
+		return false;
+	}
+
+	const u32 clusterSize = 1u << DefaultClusterBits;
+	const u32 l2Entries = clusterSize / sizeof(u64);
+	if (size == 0 || size > MaxDiskSize || storedBasePath.size() > clusterSize - sizeof(Header))
+	{
+		Error::SetString(error, "Invalid HDD image parameters");
+		return false;
+	}
+
+	Header hdr = {};
+	hdr.magic = Magic;
+	hdr.version = Version;
+	hdr.clusterBits = DefaultClusterBits;
+	hdr.diskSize = size;
+	hdr.l1Entries = static_cast<u32>((((size + clusterSize - 1) / clusterSize) + l2Entries - 1) / l2Entries);
+	hdr.l1Offset = clusterSize;
+	hdr.basePathLength = static_cast<u32>(storedBasePath.size());
+
+	// Header cluster, followed by the L1 table.
+	const size_t l1Size = (static_cast<size_t>(hdr.l1Entries) * sizeof(u64) + clusterSize - 1) & ~static_cast<size_t>(clusterSize - 1);
+	std::vector<u8> data(clusterSize + l1Size);
+	std::memcpy(data.data(), &hdr, sizeof(hdr));
+	std::memcpy(data.data() + sizeof(hdr), storedBasePath.data(), storedBasePath.size());
+
+	if (!FileSystem::WriteBinaryFile(path.c_str(), data.data(), data.size()))
+	{
+		Error::SetString(error, fmt::format("Failed to write '{}'", Path::GetFileName(path)));
+		return false;
+	}
+
+	return true;
+}
+
+bool HddBlockImage::ConvertRawImage(const std::string& rawPath, const std::string& path,
+	const std::function<bool(u64, u64)>& progress, Error* error)
+{
+	FileSystem::ManagedCFilePtr raw = FileSystem::OpenManagedCFile(rawPath.c_str(), "rb", error);
+	if (!raw)
+		return false;
+
+	const s64 size = FileSystem::FSize64(raw.get());
+	if (size <= 0)
+	{
+		Error::SetString(error, fmt::format("Failed to get size of '{}'", Path::GetFileName(rawPath)));
+		return false;
+	}
+
+	if (!Create(path, static_cast<u64>(size), error))
+		return false;
+
+	std::unique_ptr<HddBlockImage> image = Open(path, false, error);
+	bool ret = static_cast<bool>(image);
+
+	std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(ReadAheadSize);
+	for (u64 offset = 0; ret && offset < static_cast<u64>(size); offset += ReadAheadSize)
+	{
+		const u32 length = static_cast<u32>(std::min<u64>(ReadAheadSize, static_cast<u64>(size) - offset));
+		if (std::fread(buffer.get(), length, 1, raw.get()) != 1)
+		{
+			Error::SetString(error, fmt::format("Failed to read '{}'", Path::GetFileName(rawPath)));
+			ret = false;
+		}
+		else if (!image->Write(offset, buffer.get(), length))
+		{
+			Error::SetString(error, fmt::format("Failed to write '{}'", Path::GetFileName(path)));
+			ret = false;
+		}
+		else if (progress && !progress(offset + length, static_cast<u64>(size)))
+		{
+			Error::SetString(error, "Conversion canceled");
+			ret = false;
+		}
+	}
+
+	if (!ret)
+	{
+		image.reset();
+		FileSystem::DeleteFilePath(path.c_str());
+	}
+
+	return ret;
+}
+
+u64 HddBlockImage::GetClusterOffset(u64 cluster) const
+{
+	const u64 l1Index = cluster / GetL2Entries();
+	if (!l2Tables[l1Index])
+		return 0;
+
+	return l2Tables[l1Index][cluster % GetL2Entries()];
+}
+
+bool HddBlockImage::SetClusterOffset(u64 cluster, u64 fileOffset)
+{
+	const u64 l1Index = cluster / GetL2Entries();
+	const u64 l2Index = cluster % GetL2Entries();
+
+	if (!l2Tables[l1Index])
+	{
+		const u64 l2Offset = AllocateCluster();
+		l2Tables[l1Index] = std::make_unique<u64[]>(GetL2Entries());
+		std::memset(l2Tables[l1Index].get(), 0, GetClusterSize());
+		l2Tables[l1Index][l2Index] = fileOffset;
+
+		// Write the table before pointing the L1 entry at it.
+		if (!WriteFile(l2Offset, l2Tables[l1Index].get(), GetClusterSize()))
+			return false;
+
+		l1Table[l1Index] = l2Offset;
+		return WriteFile(header.l1Offset + l1Index * sizeof(u64), &l1Table[l1Index], sizeof(u64));
+	}
+
+	l2Tables[l1Index][l2Index] = fileOffset;
+	return WriteFile(l1Table[l1Index] + l2Index * sizeof(u64), &fileOffset, sizeof(u64));
+}
+
+u64 HddBlockImage::AllocateCluster()
+{
+	const u64 offset = fileEnd;
+	fileEnd += GetClusterSize();
+	return offset;
+}
+
+bool HddBlockImage::ReadFile(u64 fileOffset, void* data, size_t length)
+{
+	return FileSystem::FSeek64(file.get(), fileOffset, SEEK_SET) == 0 &&
+		   std::fread(data, length, 1, file.get()) == 1;
+}
+
+bool HddBlockImage::WriteFile(u64 fileOffset, const void* data, size_t length)
+{
+	return FileSystem::FSeek64(file.get(), fileOffset, SEEK_SET) == 0 &&
+		   std::fwrite(data, length, 1, file.get()) == 1;
+}
+
+bool HddBlockImage::ReadBase(u64 offset, u8* data, u32 length)
+{
+	if (baseImage)
+		return baseImage->ReadDirect(offset, data, length);
+
+	if (baseFile)
+	{
+		return FileSystem::FSeek64(baseFile.get(), offset, SEEK_SET) == 0 &&
+			   std::fread(data, length, 1, baseFile.get()) == 1;
+	}
+
+	std::memset(data, 0, length);
+	return true;
+}
+
+bool HddBlockImage::ReadDirect(u64 offset, u8* data, u32 length)
+{
+	const u32 clusterSize = GetClusterSize();
+	while (length > 0)
+	{
+		const u64 cluster = offset >> header.clusterBits;
+		const u32 inCluster = static_cast<u32>(offset & (clusterSize - 1));
+		const u64 fileOffset = GetClusterOffset(cluster);
+
+		// Extend over following clusters which are stored contiguously (or are also unallocated),
+		// so a sequential run is a single read.
+		u32 chunk = std::min(length, clusterSize - inCluster);
+		for (u64 next = cluster + 1; chunk < length; next++)
+		{
+			const u64 nextOffset = GetClusterOffset(next);
+			if (fileOffset != 0 ? (nextOffset != fileOffset + ((next - cluster) << header.clusterBits)) : (nextOffset != 0))
+				break;
+
+			chunk += std::min(length - chunk, clusterSize);
+		}
+
+		if (!(fileOffset != 0 ? ReadFile(fileOffset + inCluster, data, chunk) : ReadBase(offset, data, chunk)))
+			return false;
+
+		offset += chunk;
+		data += chunk;
+		length -= chunk;
+	}
+
+	return true;
+}
+
+bool HddBlockImage::Read(u64 offset, u8* data, u32 length)
+{
+	if (offset + length > header.diskSize)
+		return false;
+
+	if (offset >= readAheadOffset && offset + length <= readAheadOffset + readAheadLength)
+	{
+		std::memcpy(data, &readAhead[offset - readAheadOffset], length);
+		lastReadEnd = offset + length;
+		return true;
+	}
+
+	const bool sequential = (offset == lastReadEnd);
+	lastReadEnd = offset + length;
+	if (!sequential || length >= ReadAheadSize)
+		return ReadDirect(offset, data, length);
+
+	readAheadLength = static_cast<u32>(std::min<u64>(ReadAheadSize, header.diskSize - offset));
+	if (!ReadDirect(offset, readAhead.get(), readAheadLength))
+	{
+		readAheadLength = 0;
+		return false;
+	}
+
+	readAheadOffset = offset;
+	std::memcpy(data, readAhead.get(), length);
+	return true;
+}
+
+bool HddBlockImage::Write(u64 offset, const u8* data, u32 length)
+{
+	if (readOnly || offset + length > header.diskSize)
+		return false;
+
+	// Keep the read ahead in sync.
+	const u64 overlapStart = std::max(offset, readAheadOffset);
+	const u64 overlapEnd = std::min(offset + length, readAheadOffset + readAheadLength);
+	if (overlapStart < overlapEnd)
+		std::memcpy(&readAhead[overlapStart - readAheadOffset], &data[overlapStart - offset], overlapEnd - overlapStart);
+
+	const u32 clusterSize = GetClusterSize();
+	const bool hasBase = (baseImage || baseFile);
+	while (length > 0)
+	{
+		const u64 cluster = offset >> header.clusterBits;
+		const u32 inCluster = static_cast<u32>(offset & (clusterSize - 1));
+		const u32 chunk = std::min(length, clusterSize - inCluster);
+		const u64 fileOffset = GetClusterOffset(cluster);
+
+		if (fileOffset != 0)
+		{
+			if (!WriteFile(fileOffset + inCluster, data, chunk))
+				return false;
+		}
+		else if (hasBase || !IsAllZero(data, chunk))
+		{
+			// Copy on write, the rest of the cluster comes from the base (or is zero).
+			const u8* clusterData = data;
+			if (chunk != clusterSize)
+			{
+				// The last cluster may extend past the end of the disk.
+				const u64 clusterStart = offset - inCluster;
+				const u32 readable = static_cast<u32>(std::min<u64>(clusterSize, header.diskSize - clusterStart));
+				if (!ReadBase(clusterStart, clusterBuffer.get(), readable))
+					return false;
+
+				std::memset(&clusterBuffer[readable], 0, clusterSize - readable);
+
+				std::memcpy(&clusterBuffer[inCluster], data, chunk);
+				clusterData = clusterBuffer.get();
+			}
+
+			// Data first, so the tables never point at garbage.
+			const u64 newOffset = AllocateCluster();
+			if (!WriteFile(newOffset, clusterData, clusterSize) || !SetClusterOffset(cluster, newOffset))
+				return false;
+		}
+		// Otherwise an unallocated cluster without a base, which already reads as zeros.
+
+		offset += chunk;
+		data += chunk;
+		length -= chunk;
+	}
+
+	return std::fflush(file.get()) == 0;
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/FileSystem.h"
+
+class Error;
+
+// Block allocated HDD image.
+// The disk is split into clusters, which are only allocated in the file once written with
+// non-zero data, and located through a two level (L1/L2) table similar to qcow2.
+// An image can be an overlay on top of a read-only base image (raw or block allocated),
+// unallocated clusters are then read from the base, and copied into the overlay on first write.
+// Not thread safe, only used from the ATA IO thread.
+class HddBlockImage
+{
+public:
+	static constexpr u32 Magic = 0x44485850; // PXHD
+	static constexpr u32 Version = 1;
+	static constexpr u32 DefaultClusterBits = 16; // 64KiB
+	static constexpr u32 ReadAheadSize = 1024 * 1024;
+	// Longest chain of overlays opened, this also stops an image which is (indirectly) its own base.
+	static constexpr u32 MaxBaseDepth = 16;
+	// Largest disk LBA48 can address.
+	static constexpr u64 MaxDiskSize = (1ull << 48) * 512;
+
+	struct Header
+	{
+		u32 magic;
+		u32 version;
+		u32 clusterBits;
+		u32 l1Entries;
+		u64 diskSize;
+		u64 l1Offset;
+		u32 basePathLength; // Base image path follows the header, relative to the image directory.
+		u32 reserved[7];
+	};
+	static_assert(sizeof(Header) == 64);
+
+	~HddBlockImage();
+
+	static bool IsBlockImage(std::FILE* fp);
+	// Size of the disk in a raw or block allocated image, for raw images this is the file size.
+	static std::optional<u64> GetImageSize(const std::string& path);
+
+	static std::unique_ptr<HddBlockImage> Open(const std::string& path, bool readOnly, Error* error);
+
+	// Creates an empty image, this only writes the header and L1 table.
+	static bool Create(const std::string& path, u64 size, Error* error);
+	// Creates an empty overlay, with the same size as the base image.
+	static bool CreateOverlay(const std::string& path, const std::string& basePath, Error* error);
+	// Converts a raw image, zero filled clusters are left unallocated.
+	// progress gets the bytes processed and the total size, and returns false to cancel.
+	static bool ConvertRawImage(const std::string& rawPath, const std::string& path,
+		const std::function<bool(u64, u64)>& progress, Error* error);
+
+	u64 GetSize() const { return header.diskSize; }
+
+	bool Read(u64 offset, u8* data, u32 length);
+	bool Write(u64 offset, const u8* data, u32 length);
+
+private:
+	HddBlockImage() = default;
+
+	static std::unique_ptr<HddBlockImage> Open(const std::string& path, bool readOnly, u32 depth, Error* error);
+	static std::optional<u64> GetDiskSize(std::FILE* fp);
+	static bool WriteNewImage(const std::string& path, u64 size, const std::string& storedBasePath, Error* error);
+
+	u32 GetClusterSize() const { return 1u << header.clusterBits; }
+	u32 GetL2Entries() const { return GetClusterSize() / sizeof(u64); }
+
+	bool LoadTables(Error* error);
+	bool OpenBase(const std::string& path, const std::string& storedBasePath, u32 depth, Error* error);
+
+	u64 GetClusterOffset(u64 cluster) const;
+	bool SetClusterOffset(u64 cluster, u64 fileOffset);
+	u64 AllocateCluster();
+
+	bool ReadDirect(u64 offset, u8* data, u32 length);
+	bool ReadBase(u64 offset, u8* data, u32 length);
+	bool ReadFile(u64 fileOffset, void* data, size_t length);
+	bool WriteFile(u64 fileOffset, const void* data, size_t length);
+
+	FileSystem::ManagedCFilePtr file;
+	bool readOnly = true;
+
+	Header header = {};
+	std::vector<u64> l1Table;
+	std::vector<std::unique_ptr<u64[]>> l2Tables;
+	u64 fileEnd = 0;
+
+	// Base image, either block allocated or raw.
+	std::unique_ptr<HddBlockImage> baseImage;
+	FileSystem::ManagedCFilePtr baseFile;
+
+	std::unique_ptr<u8[]> clusterBuffer;
+
+	// Sequential reads are extended to ReadAheadSize, and served from here.
+	std::unique_ptr<u8[]> readAhead;
+	u64 readAheadOffset = 0;
+	u32 readAheadLength = 0;
+	u64 lastReadEnd = ~0ull;
+};
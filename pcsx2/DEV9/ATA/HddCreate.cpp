@@ -5,6 +5,7 @@
 
 #include <fmt/format.h>
 #include "HddCreate.h"
+#include "HddBlockImage.h"
 
 #if _WIN32
 #include "common/RedtapeWindows.h"
@@ -18,15 +19,58 @@
 #endif
 
 #include "common/Console.h"
+#include "common/Error.h"
 #include "common/StringUtil.h"
 
 void HddCreate::Start()
 {
+	// Converted images and overlays get the size of the image they're made from.
+	if (blockImage && (!sourcePath.empty() || !basePath.empty()))
+		neededSize = HddBlockImage::GetImageSize(!sourcePath.empty() ? sourcePath : basePath).value_or(0);
+
 	Init();
-	WriteImage(filePath, neededSize, 1024);
+	if (blockImage)
+		WriteBlockImage(filePath);
+	else
+		WriteImage(filePath, neededSize, 1024);
 	Cleanup();
 }
 
+void HddCreate::WriteBlockImage(const std::string& hddPath)
+{
+	Error error;
+	bool ret;
+	if (!sourcePath.empty())
+	{
+		lastUpdate = std::chrono::steady_clock::now();
+		ret = HddBlockImage::ConvertRawImage(sourcePath, hddPath, [this](u64 current, u64 total) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate).count() >= 100 || current == total)
+			{
+				lastUpdate = now;
+				SetFileProgress(current);
+			}
+			return !canceled.load();
+		}, &error);
+	}
+	else if (!basePath.empty())
+		ret = HddBlockImage::CreateOverlay(hddPath, basePath, &error);
+	else
+		ret = HddBlockImage::Create(hddPath, neededSize, &error);
+
+	if (!ret)
+	{
+		Console.Error("DEV9: HddCreate: %s", error.GetDescription().c_str());
+		errored.store(true);
+		SetError();
+		return;
+	}
+
+	// Creating an empty image or overlay only writes the tables.
+	if (sourcePath.empty())
+		SetFileProgress(neededSize);
+}
+
 void HddCreate::WriteImage(const std::string& hddPath, u64 fileBytes, u64 zeroSizeBytes)
 {
 	constexpr int buffsize = 4 * 1024;
@@ -15,6 +15,15 @@ public:
 	std::string filePath;
 	u64 neededSize;
 
+	// Create a block allocated image (see HddBlockImage) instead of a raw one.
+	bool blockImage = false;
+	// Block image only, convert this raw image instead of creating an empty one.
+	// neededSize is then taken from the source.
+	std::string sourcePath;
+	// Block image only, create an overlay of this read-only image instead of an empty one.
+	// neededSize is then taken from the base.
+	std::string basePath;
+
 	std::atomic_bool errored{false};
 
 private:
@@ -38,4 +47,5 @@ protected:
 
 private:
 	void WriteImage(const std::string& hddPath, u64 fileBytes, u64 zeroSizeBytes);
+	void WriteBlockImage(const std::string& hddPath);
 };
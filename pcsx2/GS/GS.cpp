@@ -524,7 +524,10 @@ void GSThrottlePresentation()
 void GSGameChanged()
 {
 	if (GSIsHardwareRenderer())
+	{
 		GSTextureReplacements::GameChanged();
+		g_texture_cache->ReloadHashCacheStats();
+	}
 
 	if (!VMManager::HasValidVM() && GSCapture::IsCapturing())
 		GSCapture::EndCapture();
@@ -823,7 +826,8 @@ void GSUpdateConfig(const Pcsx2Config::GSOptions& new_config)
 
 	// Options which aren't using the global struct yet, so we need to recreate all GS objects.
 	if (GSConfig.SWExtraThreads != old_config.SWExtraThreads ||
-		GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight)
+		GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight ||
+		GSConfig.SWExtraThreadsBinned != old_config.SWExtraThreadsBinned)
 	{
 		if (!GSreopen(false, true, GSConfig.Renderer, &old_config))
 			pxFailRel("Failed to do quick GS reopen");
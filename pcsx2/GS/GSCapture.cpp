@@ -136,7 +136,7 @@ extern "C" {
 namespace GSCapture
 {
 	static constexpr u32 NUM_FRAMES_IN_FLIGHT = 3;
-	static constexpr u32 MAX_PENDING_FRAMES = NUM_FRAMES_IN_FLIGHT * 2;
+	static constexpr u32 MAX_PENDING_FRAMES = NUM_FRAMES_IN_FLIGHT * 4;
 	static constexpr u32 AUDIO_BUFFER_SIZE = Common::AlignUpPow2((MAX_PENDING_FRAMES * 48000) / 60, AudioStream::CHUNK_SIZE);
 	static constexpr u32 AUDIO_CHANNELS = 2;
 
@@ -152,6 +152,7 @@ namespace GSCapture
 		std::unique_ptr<GSDownloadTexture> tex;
 		s64 pts;
 		State state;
+		bool packed_yuv; // Converted to NV12 on the GPU, see ShaderConvert::RGBA_TO_NV12.
 	};
 
 	static void LogAVError(int errnum, const char* format, ...);
@@ -165,6 +166,7 @@ namespace GSCapture
 	static void StartEncoderThread();
 	static void StopEncoderThread(std::unique_lock<std::mutex>& lock);
 	static bool SendFrame(const PendingFrame& pf);
+	static void CopyPackedYUVFrame(const PendingFrame& pf);
 	static bool ReceivePackets(AVCodecContext* codec_context, AVStream* stream, AVPacket* packet);
 	static bool ProcessAudioPackets(s64 video_pts);
 	static void InternalEndCapture(std::unique_lock<std::mutex>& lock);
@@ -184,6 +186,7 @@ namespace GSCapture
 	static AVFrame* s_hw_video_frame = nullptr;
 	static AVPacket* s_video_packet = nullptr;
 	static SwsContext* s_sws_context = nullptr;
+	static bool s_gpu_yuv_conversion = false;
 	static AVDictionary* s_video_codec_arguments = nullptr;
 	static AVBufferRef* s_video_hw_context = nullptr;
 	static AVBufferRef* s_video_hw_frames = nullptr;
@@ -592,6 +595,12 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 			return false;
 		}
 
+		// 4:2:0 formats can be produced by the GPU, which saves both the readback bandwidth and swscale on the encoder thread.
+		s_gpu_yuv_conversion = ((sw_pix_fmt == AV_PIX_FMT_NV12 || sw_pix_fmt == AV_PIX_FMT_YUV420P) &&
+								(s_size.x % 4) == 0 && (s_size.y % 2) == 0);
+		if (s_gpu_yuv_conversion)
+			Console.WriteLn("GSCapture: Converting frames to YUV on the GPU.");
+
 		if (IsUsingHardwareVideoEncoding())
 		{
 			s_hw_video_frame->format = s_video_codec_context->pix_fmt;
@@ -875,25 +884,45 @@ bool GSCapture::DeliverVideoFrame(GSTexture* stex)
 		s_frame_encoded_cv.wait(lock, [&pf]() { return pf.state == PendingFrame::State::Unused; });
 	}
 
-	if (!pf.tex || pf.tex->GetWidth() != static_cast<u32>(stex->GetWidth()) || pf.tex->GetHeight() != static_cast<u32>(stex->GetHeight()))
+	// Pack the frame into NV12 before reading it back, if the encoder wants 4:2:0.
+	// If that's not possible, fall back to downloading RGBA and letting swscale deal with it.
+	GSTexture* packed = nullptr;
+	if (s_gpu_yuv_conversion && stex->GetSize() == s_size)
+	{
+		packed = g_gs_device->CreateRenderTarget(s_size.x / 4, s_size.y + s_size.y / 2, GSTexture::Format::Color, false);
+		if (packed)
+		{
+			g_gs_device->StretchRect(stex, packed, GSVector4(0, 0, packed->GetWidth(), packed->GetHeight()),
+				ShaderConvert::RGBA_TO_NV12, Nearest);
+		}
+	}
+
+	GSTexture* const src = packed ? packed : stex;
+	if (!pf.tex || pf.tex->GetWidth() != static_cast<u32>(src->GetWidth()) || pf.tex->GetHeight() != static_cast<u32>(src->GetHeight()))
 	{
 		pf.tex.reset();
-		pf.tex = g_gs_device->CreateDownloadTexture(stex->GetWidth(), stex->GetHeight(), stex->GetFormat());
+		pf.tex = g_gs_device->CreateDownloadTexture(src->GetWidth(), src->GetHeight(), src->GetFormat());
 		if (!pf.tex)
 		{
-			Console.Error("GSCapture: Failed to create %x%d download texture", stex->GetWidth(), stex->GetHeight());
+			Console.Error("GSCapture: Failed to create %x%d download texture", src->GetWidth(), src->GetHeight());
+			if (packed)
+				g_gs_device->Recycle(packed);
 			return false;
 		}
 
 #ifdef PCSX2_DEVBUILD
-		pf.tex->SetDebugName(TinyString::from_format("GSCapture {}x{} Download Texture", stex->GetWidth(), stex->GetHeight()));
+		pf.tex->SetDebugName(TinyString::from_format("GSCapture {}x{} Download Texture", src->GetWidth(), src->GetHeight()));
 #endif
 	}
 
-	const GSVector4i rc(0, 0, stex->GetWidth(), stex->GetHeight());
-	pf.tex->CopyFromTexture(rc, stex, rc, 0);
+	const GSVector4i rc(0, 0, src->GetWidth(), src->GetHeight());
+	pf.tex->CopyFromTexture(rc, src, rc, 0);
 	pf.pts = s_next_video_pts++;
 	pf.state = PendingFrame::State::NeedsMap;
+	pf.packed_yuv = (packed != nullptr);
+
+	if (packed)
+		g_gs_device->Recycle(packed);
 
 	s_pending_frames_pos = (s_pending_frames_pos + 1) % MAX_PENDING_FRAMES;
 	s_frames_pending_map++;
@@ -916,7 +945,7 @@ void GSCapture::ProcessFramePendingMap(std::unique_lock<std::mutex>& lock)
 
 	// Even if the map failed, we need to kick it to the encode thread anyway, because
 	// otherwise our queue indices will get desynchronized.
-	if (!pf.tex->Map(GSVector4i(0, 0, s_size.x, s_size.y)))
+	if (!pf.tex->Map(GSVector4i(0, 0, pf.tex->GetWidth(), pf.tex->GetHeight())))
 		Console.Warning("GSCapture: Failed to map previously flushed frame.");
 
 	lock.lock();
@@ -996,25 +1025,32 @@ void GSCapture::StopEncoderThread(std::unique_lock<std::mutex>& lock)
 
 bool GSCapture::SendFrame(const PendingFrame& pf)
 {
-	const AVPixelFormat source_format = AV_PIX_FMT_RGBA;
-	const u8* source_ptr = pf.tex->GetMapPointer();
-	const int source_width = static_cast<int>(pf.tex->GetWidth());
-	const int source_height = static_cast<int>(pf.tex->GetHeight());
-	const int source_pitch = static_cast<int>(pf.tex->GetMapPitch());
-
 	// In case a previous frame is still using the frame.
 	wrap_av_frame_make_writable(s_converted_video_frame);
 
-	s_sws_context = wrap_sws_getCachedContext(s_sws_context, source_width, source_height, source_format, s_converted_video_frame->width,
-		s_converted_video_frame->height, static_cast<AVPixelFormat>(s_converted_video_frame->format), SWS_BICUBIC, nullptr, nullptr, nullptr);
-	if (!s_sws_context)
+	if (pf.packed_yuv)
 	{
-		Console.Error("sws_getCachedContext() failed");
-		return false;
+		CopyPackedYUVFrame(pf);
 	}
+	else
+	{
+		const AVPixelFormat source_format = AV_PIX_FMT_RGBA;
+		const u8* source_ptr = pf.tex->GetMapPointer();
+		const int source_width = static_cast<int>(pf.tex->GetWidth());
+		const int source_height = static_cast<int>(pf.tex->GetHeight());
+		const int source_pitch = static_cast<int>(pf.tex->GetMapPitch());
+
+		s_sws_context = wrap_sws_getCachedContext(s_sws_context, source_width, source_height, source_format, s_converted_video_frame->width,
+			s_converted_video_frame->height, static_cast<AVPixelFormat>(s_converted_video_frame->format), SWS_BICUBIC, nullptr, nullptr, nullptr);
+		if (!s_sws_context)
+		{
+			Console.Error("sws_getCachedContext() failed");
+			return false;
+		}
 
-	wrap_sws_scale(s_sws_context, reinterpret_cast<const u8**>(&source_ptr), &source_pitch, 0, source_height, s_converted_video_frame->data,
-		s_converted_video_frame->linesize);
+		wrap_sws_scale(s_sws_context, reinterpret_cast<const u8**>(&source_ptr), &source_pitch, 0, source_height, s_converted_video_frame->data,
+			s_converted_video_frame->linesize);
+	}
 
 	AVFrame* frame_to_send = s_converted_video_frame;
 	if (IsUsingHardwareVideoEncoding())
@@ -1043,6 +1079,41 @@ bool GSCapture::SendFrame(const PendingFrame& pf)
 	return ReceivePackets(s_video_codec_context, s_video_stream, s_video_packet);
 }
 
+void GSCapture::CopyPackedYUVFrame(const PendingFrame& pf)
+{
+	// Luma is laid out exactly as the encoder wants it, followed by the interleaved chroma at half height.
+	const u32 width = static_cast<u32>(s_converted_video_frame->width);
+	const u32 height = static_cast<u32>(s_converted_video_frame->height);
+	const u32 pitch = pf.tex->GetMapPitch();
+	const u8* src = pf.tex->GetMapPointer();
+	pxAssert((pf.tex->GetWidth() * 4) == width && pf.tex->GetHeight() == (height + height / 2));
+
+	AVFrame* const frame = s_converted_video_frame;
+	for (u32 y = 0; y < height; y++)
+		std::memcpy(frame->data[0] + y * frame->linesize[0], src + y * pitch, width);
+	src += height * pitch;
+
+	if (frame->format == AV_PIX_FMT_NV12)
+	{
+		for (u32 y = 0; y < height / 2; y++)
+			std::memcpy(frame->data[1] + y * frame->linesize[1], src + y * pitch, width);
+	}
+	else
+	{
+		for (u32 y = 0; y < height / 2; y++)
+		{
+			const u8* row = src + y * pitch;
+			u8* u_row = frame->data[1] + y * frame->linesize[1];
+			u8* v_row = frame->data[2] + y * frame->linesize[2];
+			for (u32 x = 0; x < width / 2; x++)
+			{
+				u_row[x] = row[x * 2 + 0];
+				v_row[x] = row[x * 2 + 1];
+			}
+		}
+	}
+}
+
 void GSCapture::ProcessAllInFlightFrames(std::unique_lock<std::mutex>& lock)
 {
 	while (s_frames_pending_map > 0)
@@ -1319,6 +1390,7 @@ void GSCapture::InternalEndCapture(std::unique_lock<std::mutex>& lock)
 		wrap_sws_freeContext(s_sws_context);
 		s_sws_context = nullptr;
 	}
+	s_gpu_yuv_conversion = false;
 	if (s_video_packet)
 		wrap_av_packet_free(&s_video_packet);
 	if (s_converted_video_frame)
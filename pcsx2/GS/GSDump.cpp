@@ -20,6 +20,7 @@ GSDumpBase::GSDumpBase(std::string fn)
 	: m_filename(std::move(fn))
 	, m_frames(0)
 	, m_extra_frames(2)
+	, m_packets(0)
 {
 	m_gs = FileSystem::OpenCFile(m_filename.c_str(), "wb");
 	if (!m_gs)
@@ -77,6 +78,7 @@ void GSDumpBase::Transfer(int index, const u8* mem, size_t size)
 	AppendRawData(static_cast<u8>(index));
 	AppendRawData(&size, 4);
 	AppendRawData(mem, size);
+	m_packets++;
 }
 
 void GSDumpBase::ReadFIFO(u32 size)
@@ -86,6 +88,7 @@ void GSDumpBase::ReadFIFO(u32 size)
 
 	AppendRawData(2);
 	AppendRawData(&size, 4);
+	m_packets++;
 }
 
 bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
@@ -99,6 +102,9 @@ bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
 
 	AppendRawData(1);
 	AppendRawData(static_cast<u8>(field));
+	m_packets += 2;
+
+	EndFrame();
 
 	if (last)
 		m_extra_frames--;
@@ -116,6 +122,19 @@ void GSDumpBase::Write(const void* data, size_t size)
 		Console.Error("GSDump: Error failed to write data");
 }
 
+void GSDumpBase::WriteAt(u64 offset, const void* data, size_t size)
+{
+	if (!m_gs || size == 0)
+		return;
+
+	if (FileSystem::FSeek64(m_gs, static_cast<s64>(offset), SEEK_SET) != 0 ||
+		std::fwrite(data, size, 1, m_gs) != 1 ||
+		FileSystem::FSeek64(m_gs, 0, SEEK_END) != 0)
+	{
+		Console.Error("GSDump: Error failed to write data");
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 // GSDump implementation
 //////////////////////////////////////////////////////////////////////
@@ -313,21 +332,40 @@ namespace
 {
 	class GSDumpZst final : public GSDumpBase
 	{
-		ZSTD_CStream* m_strm;
+		// Chunks are closed at the first vsync after they reach this size, and compressed independently.
+		static constexpr size_t CHUNK_SIZE = 4 * _1mb;
+
+		// Number of vsyncs between GS state keyframes.
+		static constexpr u32 KEYFRAME_INTERVAL = 600;
+
+		ZSTD_CCtx* m_cctx;
 
 		std::vector<u8> m_in_buff;
 		std::vector<u8> m_out_buff;
 
-		void MayFlush();
-		void Compress(ZSTD_EndDirective action);
-		void AppendRawData(const void* data, size_t size);
-		void AppendRawData(u8 c);
+		u64 m_file_offset = 0;
+		bool m_close_chunk = false;
+
+		std::vector<GSDumpIndexChunk> m_chunks;
+		std::vector<GSDumpIndexFrame> m_frames;
+		std::vector<GSDumpIndexKeyframe> m_keyframes;
+
+		void WriteData(const void* data, size_t size);
+		void WriteSkippableHeader(u32 size);
+		bool Compress(const void* data, size_t size, size_t* compressed_size);
+		void CloseChunk();
+		void AppendRawData(const void* data, size_t size) override;
+		void AppendRawData(u8 c) override;
+		void EndFrame() override;
 
 	public:
 		GSDumpZst(const std::string& fn, const std::string& serial, u32 crc,
 			u32 screenshot_width, u32 screenshot_height, const u32* screenshot_pixels,
 			const freezeData& fd, const GSPrivRegSet* regs);
-		virtual ~GSDumpZst();
+		~GSDumpZst() override;
+
+		bool IsKeyframeDue() const override;
+		void AddKeyframe(const freezeData& fd, const GSPrivRegSet* regs) override;
 	};
 
 	GSDumpZst::GSDumpZst(const std::string& fn, const std::string& serial, u32 crc,
@@ -335,84 +373,155 @@ namespace
 		const freezeData& fd, const GSPrivRegSet* regs)
 		: GSDumpBase(fn + ".gs.zst")
 	{
-		m_strm = ZSTD_createCStream();
+		m_cctx = ZSTD_createCCtx();
 
 		// Compression level 6 provides a good balance between speed and ratio.
-		ZSTD_CCtx_setParameter(m_strm, ZSTD_c_compressionLevel, 6);
+		ZSTD_CCtx_setParameter(m_cctx, ZSTD_c_compressionLevel, 6);
+
+		m_in_buff.reserve(CHUNK_SIZE);
 
-		m_in_buff.reserve(_1mb);
-		m_out_buff.resize(_1mb);
+		// Filled in with the index offset once the dump is complete.
+		const GSDumpIndexLocator locator = {GSDUMP_INDEX_MAGIC, GSDUMP_INDEX_VERSION, 0};
+		WriteSkippableHeader(sizeof(locator));
+		WriteData(&locator, sizeof(locator));
 
+		// Header gets a chunk to itself, so the first frame starts at the beginning of the next one.
 		AddHeader(serial, crc, screenshot_width, screenshot_height, screenshot_pixels, fd, regs);
+		m_close_chunk = true;
+		m_frames.push_back({1, 0, 0});
 	}
 
 	GSDumpZst::~GSDumpZst()
 	{
-		// Finish the stream
-		Compress(ZSTD_e_end);
+		// The index is written before the last chunk, so the file always ends with packet data.
+		// Otherwise decoders which don't know about the index can stall on a trailing skippable frame.
+		size_t last_chunk_size = 0;
+		const size_t last_chunk_uncompressed_size = m_in_buff.size();
+		const bool has_last_chunk = !m_in_buff.empty() && Compress(m_in_buff.data(), m_in_buff.size(), &last_chunk_size);
+
+		const u64 index_offset = m_file_offset;
+		const size_t num_chunks = m_chunks.size() + static_cast<size_t>(has_last_chunk);
+		const u32 index_size = static_cast<u32>(sizeof(GSDumpIndexHeader) +
+												num_chunks * sizeof(GSDumpIndexChunk) +
+												m_frames.size() * sizeof(GSDumpIndexFrame) +
+												m_keyframes.size() * sizeof(GSDumpIndexKeyframe));
+		if (has_last_chunk)
+		{
+			m_chunks.push_back({index_offset + sizeof(u32) * 2 + index_size, static_cast<u32>(last_chunk_size),
+				static_cast<u32>(last_chunk_uncompressed_size)});
+		}
+
+		const GSDumpIndexHeader header = {static_cast<u32>(m_chunks.size()), static_cast<u32>(m_frames.size()),
+			static_cast<u32>(m_keyframes.size()), GetPacketCount()};
+		WriteSkippableHeader(index_size);
+		WriteData(&header, sizeof(header));
+		WriteData(m_chunks.data(), m_chunks.size() * sizeof(GSDumpIndexChunk));
+		WriteData(m_frames.data(), m_frames.size() * sizeof(GSDumpIndexFrame));
+		WriteData(m_keyframes.data(), m_keyframes.size() * sizeof(GSDumpIndexKeyframe));
+
+		if (has_last_chunk)
+			WriteData(m_out_buff.data(), last_chunk_size);
+
+		const GSDumpIndexLocator locator = {GSDUMP_INDEX_MAGIC, GSDUMP_INDEX_VERSION, index_offset};
+		WriteAt(sizeof(u32) * 2, &locator, sizeof(locator));
+
+		ZSTD_freeCCtx(m_cctx);
+	}
+
+	void GSDumpZst::WriteData(const void* data, size_t size)
+	{
+		Write(data, size);
+		m_file_offset += size;
+	}
+
+	void GSDumpZst::WriteSkippableHeader(u32 size)
+	{
+		const u32 header[2] = {GSDUMP_INDEX_SKIPPABLE_MAGIC, size};
+		WriteData(header, sizeof(header));
+	}
+
+	bool GSDumpZst::Compress(const void* data, size_t size, size_t* compressed_size)
+	{
+		m_out_buff.resize(ZSTD_compressBound(size));
+
+		const size_t ret = ZSTD_compress2(m_cctx, m_out_buff.data(), m_out_buff.size(), data, size);
+		if (ZSTD_isError(ret))
+		{
+			Console.ErrorFmt("GSDumpZstd: Error {}", ZSTD_getErrorName(ret));
+			return false;
+		}
 
-		ZSTD_freeCStream(m_strm);
+		*compressed_size = ret;
+		return true;
+	}
+
+	void GSDumpZst::CloseChunk()
+	{
+		m_close_chunk = false;
+
+		size_t compressed_size;
+		if (m_in_buff.empty() || !Compress(m_in_buff.data(), m_in_buff.size(), &compressed_size))
+			return;
+
+		m_chunks.push_back({m_file_offset, static_cast<u32>(compressed_size), static_cast<u32>(m_in_buff.size())});
+		WriteData(m_out_buff.data(), compressed_size);
+		m_in_buff.clear();
 	}
 
 	void GSDumpZst::AppendRawData(const void* data, size_t size)
 	{
+		// Chunks are closed lazily, so there's always something left for the last one.
+		if (m_close_chunk)
+			CloseChunk();
+
 		size_t old_size = m_in_buff.size();
 		m_in_buff.resize(old_size + size);
 		memcpy(&m_in_buff[old_size], data, size);
-		MayFlush();
 	}
 
 	void GSDumpZst::AppendRawData(u8 c)
 	{
+		if (m_close_chunk)
+			CloseChunk();
+
 		m_in_buff.push_back(c);
-		MayFlush();
 	}
 
-	void GSDumpZst::MayFlush()
+	void GSDumpZst::EndFrame()
 	{
-		if (m_in_buff.size() >= _1mb)
-			Compress(ZSTD_e_continue);
+		if (m_in_buff.size() >= CHUNK_SIZE)
+			m_close_chunk = true;
+
+		if (m_close_chunk)
+			m_frames.push_back({static_cast<u32>(m_chunks.size() + 1), 0, GetPacketCount()});
+		else
+			m_frames.push_back({static_cast<u32>(m_chunks.size()), static_cast<u32>(m_in_buff.size()), GetPacketCount()});
 	}
 
-	void GSDumpZst::Compress(ZSTD_EndDirective action)
+	bool GSDumpZst::IsKeyframeDue() const
 	{
-		if (m_in_buff.empty())
-			return;
-
-		ZSTD_inBuffer inbuf = {m_in_buff.data(), m_in_buff.size(), 0};
+		const u32 frame = static_cast<u32>(m_frames.size() - 1);
+		const u32 last_keyframe = m_keyframes.empty() ? 0 : m_keyframes.back().frame;
+		return (frame - last_keyframe) >= KEYFRAME_INTERVAL;
+	}
 
-		for (;;)
-		{
-			ZSTD_outBuffer outbuf = {m_out_buff.data(), m_out_buff.size(), 0};
-
-			const size_t remaining = ZSTD_compressStream2(m_strm, &outbuf, &inbuf, action);
-			if (ZSTD_isError(remaining))
-			{
-				Console.ErrorFmt("GSDumpZstd: Error {}", ZSTD_getErrorName(remaining));
-				return;
-			}
-
-			if (outbuf.pos > 0)
-			{
-				Write(m_out_buff.data(), outbuf.pos);
-				outbuf.pos = 0;
-			}
-
-			if (action == ZSTD_e_end)
-			{
-				// break when compression output has finished
-				if (remaining == 0)
-					break;
-			}
-			else
-			{
-				// break when all input data is consumed
-				if (inbuf.pos == inbuf.size)
-					break;
-			}
-		}
+	void GSDumpZst::AddKeyframe(const freezeData& fd, const GSPrivRegSet* regs)
+	{
+		const u32 state_size = static_cast<u32>(fd.size);
+		std::vector<u8> data(sizeof(state_size) + state_size + sizeof(*regs));
+		std::memcpy(data.data(), &state_size, sizeof(state_size));
+		std::memcpy(data.data() + sizeof(state_size), fd.data, state_size);
+		std::memcpy(data.data() + sizeof(state_size) + state_size, regs, sizeof(*regs));
+
+		// Keyframes don't need to be in sequence with the chunks, the index has the location of both.
+		size_t compressed_size;
+		if (!Compress(data.data(), data.size(), &compressed_size))
+			return;
 
-		m_in_buff.clear();
+		WriteSkippableHeader(static_cast<u32>(compressed_size));
+		m_keyframes.push_back({m_file_offset, static_cast<u32>(compressed_size), static_cast<u32>(data.size()),
+			static_cast<u32>(m_frames.size() - 1)});
+		WriteData(m_out_buff.data(), compressed_size);
 	}
 } // namespace
 
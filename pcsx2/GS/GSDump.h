@@ -24,6 +24,21 @@ ReadFIFO2 data (id == 2)
 Regs data (id == 3)
 - [PMODE/0x2000]
 
+Zstandard dumps are written as a sequence of independent frames, so that they can be streamed and seeked:
+- [locator] [header chunk] [chunk] .. [keyframe] .. [chunk] [index] [last chunk]
+
+The locator, keyframes and index are zstd skippable frames, so the file still decompresses to the layout above
+with any zstd decoder. Chunks always end on a packet boundary, and are only split after a VSync packet.
+
+Locator
+- [skippable magic/4] [size/4] [GSDumpIndexLocator]
+
+Keyframe (GS state at the start of a frame, compressed as a single zstd frame)
+- [skippable magic/4] [size/4] [zstd: [state size/4] [state data/size] [PMODE/0x2000]]
+
+Index
+- [skippable magic/4] [size/4] [GSDumpIndexHeader] [GSDumpIndexChunk/n] [GSDumpIndexFrame/n] [GSDumpIndexKeyframe/n]
+
 */
 
 #pragma pack(push, 4)
@@ -39,6 +54,48 @@ struct GSDumpHeader
 	u32 screenshot_offset;
 	u32 screenshot_size;
 };
+
+static constexpr u32 GSDUMP_INDEX_SKIPPABLE_MAGIC = 0x184D2A5Au; ///< ZSTD_MAGIC_SKIPPABLE_START | 0xA
+static constexpr u32 GSDUMP_INDEX_MAGIC = 0x58495347u; ///< 'GSIX'
+static constexpr u32 GSDUMP_INDEX_VERSION = 1;
+
+struct GSDumpIndexLocator
+{
+	u32 magic;
+	u32 version;
+	u64 index_offset; ///< Zero if the dump was not closed cleanly.
+};
+
+struct GSDumpIndexHeader
+{
+	u32 num_chunks;
+	u32 num_frames;
+	u32 num_keyframes;
+	u32 num_packets;
+};
+
+struct GSDumpIndexChunk
+{
+	u64 file_offset;
+	u32 compressed_size;
+	u32 uncompressed_size;
+};
+
+/// Position of the first packet after N vsyncs.
+struct GSDumpIndexFrame
+{
+	u32 chunk;
+	u32 offset;
+	u32 packet;
+};
+
+struct GSDumpIndexKeyframe
+{
+	u64 file_offset;
+	u32 compressed_size;
+	u32 uncompressed_size;
+	u32 frame;
+};
 #pragma pack(pop)
 
 class GSDumpBase
@@ -47,16 +104,23 @@ class GSDumpBase
 	std::string m_filename;
 	int m_frames;
 	int m_extra_frames;
+	u32 m_packets;
 
 protected:
 	void AddHeader(const std::string& serial, u32 crc,
 		u32 screenshot_width, u32 screenshot_height, const u32* screenshot_pixels,
 		const freezeData& fd, const GSPrivRegSet* regs);
 	void Write(const void* data, size_t size);
+	void WriteAt(u64 offset, const void* data, size_t size);
+
+	__fi u32 GetPacketCount() const { return m_packets; }
 
 	virtual void AppendRawData(const void* data, size_t size) = 0;
 	virtual void AppendRawData(u8 c) = 0;
 
+	/// Called after the packets for a vsync have been appended.
+	virtual void EndFrame() {}
+
 public:
 	GSDumpBase(std::string fn);
 	virtual ~GSDumpBase();
@@ -67,6 +131,10 @@ public:
 	void Transfer(int index, const u8* mem, size_t size);
 	bool VSync(int field, bool last, const GSPrivRegSet* regs);
 
+	/// Keyframes let replay start part way through a dump, instead of from the initial state.
+	virtual bool IsKeyframeDue() const { return false; }
+	virtual void AddKeyframe(const freezeData& fd, const GSPrivRegSet* regs) {}
+
 	static std::unique_ptr<GSDumpBase> CreateUncompressedDump(
 		const std::string& fn, const std::string& serial, u32 crc,
 		u32 screenshot_width, u32 screenshot_height, const u32* screenshot_pixels,
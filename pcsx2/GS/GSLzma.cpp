@@ -21,6 +21,7 @@
 #include <XzCrc64.h>
 #include <zstd.h>
 
+#include <algorithm>
 #include <mutex>
 
 using namespace GSDumpTypes;
@@ -128,6 +129,11 @@ bool GSDumpFile::ReadFile(Error* error)
 		return false;
 	}
 
+	return ReadPackets(error);
+}
+
+bool GSDumpFile::ReadPackets(Error* error)
+{
 	// read all the packet data in
 	// TODO: make this suck less by getting the full/extracted size and preallocating
 	for (;;)
@@ -151,16 +157,34 @@ bool GSDumpFile::ReadFile(Error* error)
 		}
 	}
 
-	u8* data = m_packet_data.data();
+	const u8* data = m_packet_data.data();
 	size_t remaining = m_packet_data.size();
+	while (remaining > 0)
+	{
+		GSData packet;
+		const PacketParseResult res = ParsePacket(data, remaining, &packet, error);
+		if (res == PacketParseResult::Error)
+			return false;
+		else if (res == PacketParseResult::Truncated)
+			break;
+
+		m_dump_packets.push_back(std::move(packet));
+	}
+
+	m_packet_count = static_cast<u32>(m_dump_packets.size());
+	m_packet_index = 0;
+	return true;
+}
 
+GSDumpFile::PacketParseResult GSDumpFile::ParsePacket(const u8*& data, size_t& remaining, GSData* packet, Error* error)
+{
 #define GET_BYTE(dst) \
 	do \
 	{ \
 		if (remaining < sizeof(u8)) \
 		{ \
 			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Failed to read byte.")); \
-			return false; \
+			return PacketParseResult::Error; \
 		} \
 		std::memcpy(dst, data, sizeof(u8)); \
 		data++; \
@@ -172,63 +196,80 @@ bool GSDumpFile::ReadFile(Error* error)
 		if (remaining < sizeof(u32)) \
 		{ \
 			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Failed to read word.")); \
-			return false; \
+			return PacketParseResult::Error; \
 		} \
 		std::memcpy(dst, data, sizeof(u32)); \
 		data += sizeof(u32); \
 		remaining -= sizeof(u32); \
 	} while (0)
 
-	while (remaining > 0)
-	{
-		GSData packet = {};
-		packet.path = GSTransferPath::Dummy;
-		GET_BYTE(&packet.id);
+	*packet = {};
+	packet->path = GSTransferPath::Dummy;
+	GET_BYTE(&packet->id);
 
-		switch (packet.id)
-		{
-			case GSType::Transfer:
-				GET_BYTE(&packet.path);
-				GET_WORD(&packet.length);
-				break;
-			case GSType::VSync:
-				packet.length = 1;
-				break;
-			case GSType::ReadFIFO2:
-				packet.length = 4;
-				break;
-			case GSType::Registers:
-				packet.length = 8192;
-				break;
-			default:
-				Error::SetStringFmt(error,
-					TRANSLATE_FS("GSDumpFile", "Unknown packet type {}"), static_cast<u32>(packet.id));
-				return false;
-		}
+	switch (packet->id)
+	{
+		case GSType::Transfer:
+			GET_BYTE(&packet->path);
+			GET_WORD(&packet->length);
+			break;
+		case GSType::VSync:
+			packet->length = 1;
+			break;
+		case GSType::ReadFIFO2:
+			packet->length = 4;
+			break;
+		case GSType::Registers:
+			packet->length = 8192;
+			break;
+		default:
+			Error::SetStringFmt(error,
+				TRANSLATE_FS("GSDumpFile", "Unknown packet type {}"), static_cast<u32>(packet->id));
+			return PacketParseResult::Error;
+	}
 
-		if (packet.length > 0)
+	if (packet->length > 0)
+	{
+		if (remaining < packet->length)
 		{
-			if (remaining < packet.length)
-			{
-				// There's apparently some "bad" dumps out there that are missing bytes on the end..
-				// The "safest" option here is to discard the last packet, since that has less risk
-				// of leaving the GS in the middle of a command.
-				Console.Error("(GSDump) Dropping last packet of %u bytes (we only have %u bytes)",
-					static_cast<u32>(packet.length), static_cast<u32>(remaining));
-				break;
-			}
-
-			packet.data = data;
-			data += packet.length;
-			remaining -= packet.length;
+			// There's apparently some "bad" dumps out there that are missing bytes on the end..
+			// The "safest" option here is to discard the last packet, since that has less risk
+			// of leaving the GS in the middle of a command.
+			Console.Error("(GSDump) Dropping last packet of %u bytes (we only have %u bytes)",
+				static_cast<u32>(packet->length), static_cast<u32>(remaining));
+			return PacketParseResult::Truncated;
 		}
 
-		m_dump_packets.push_back(std::move(packet));
+		packet->data = data;
+		data += packet->length;
+		remaining -= packet->length;
 	}
 
 #undef GET_WORD
 #undef GET_BYTE
 
+	return PacketParseResult::OK;
+}
+
+const GSDumpFile::GSData* GSDumpFile::GetNextPacket()
+{
+	if (m_packet_index == m_dump_packets.size())
+		return nullptr;
+
+	return &m_dump_packets[m_packet_index++];
+}
+
+void GSDumpFile::Rewind()
+{
+	m_packet_index = 0;
+}
+
+bool GSDumpFile::SeekToKeyframe(u32 frame, u32* keyframe, ByteArray* state_data, ByteArray* regs_data, Error* error)
+{
+	Rewind();
+	*keyframe = 0;
+	*state_data = m_state_data;
+	*regs_data = m_regs_data;
 	return true;
 }
 
@@ -543,6 +584,10 @@ namespace
 				Console.Error("Decoder error: (error code %s)", ZSTD_getErrorName(ret));
 				return false;
 			}
+
+			// Skippable frames at the end of the stream don't produce any output.
+			if (outbuf.pos == 0 && m_inbuf.pos == m_inbuf.size && std::feof(m_fp.get()))
+				break;
 		}
 
 		m_start = 0;
@@ -580,6 +625,304 @@ namespace
 
 	/******************************************************************/
 
+	class GSDumpIndexedZst final : public GSDumpFile
+	{
+	public:
+		explicit GSDumpIndexedZst(u64 index_offset);
+		~GSDumpIndexedZst() override;
+
+		static bool FindIndex(std::FILE* fp, u64* index_offset);
+
+		const GSData* GetNextPacket() override;
+		void Rewind() override;
+		bool SeekToKeyframe(u32 frame, u32* keyframe, ByteArray* state_data, ByteArray* regs_data, Error* error) override;
+
+	protected:
+		bool Open(FileSystem::ManagedCFilePtr fp, Error* error) override;
+		bool IsEof() override;
+		size_t Read(void* ptr, size_t size) override;
+		bool ReadPackets(Error* error) override;
+
+	private:
+		// Anything larger is assumed to be corrupted, rather than allocating it.
+		static constexpr u32 MAX_CHUNK_SIZE = 256 * _1mb;
+
+		bool ReadCompressed(u64 offset, u32 compressed_size, u8* dst, u32 uncompressed_size);
+		bool LoadChunk(u32 index);
+		void SetPosition(const GSDumpIndexFrame& pos);
+
+		ZSTD_DCtx* m_dctx = nullptr;
+		u64 m_index_offset;
+
+		std::vector<GSDumpIndexChunk> m_chunks;
+		std::vector<GSDumpIndexFrame> m_frames;
+		std::vector<GSDumpIndexKeyframe> m_keyframes;
+
+		DynamicHeapArray<u8, 64> m_read_buffer;
+		DynamicHeapArray<u8, 64> m_chunk_buffer;
+		u32 m_chunk_index = 0;
+		size_t m_chunk_size = 0;
+		size_t m_chunk_pos = 0;
+
+		GSData m_packet = {};
+	};
+
+	GSDumpIndexedZst::GSDumpIndexedZst(u64 index_offset)
+		: m_index_offset(index_offset)
+	{
+	}
+
+	GSDumpIndexedZst::~GSDumpIndexedZst()
+	{
+		if (m_dctx)
+			ZSTD_freeDCtx(m_dctx);
+	}
+
+	bool GSDumpIndexedZst::FindIndex(std::FILE* fp, u64* index_offset)
+	{
+		u32 header[2];
+		GSDumpIndexLocator locator;
+		const bool found = (std::fread(header, sizeof(header), 1, fp) == 1 && header[0] == GSDUMP_INDEX_SKIPPABLE_MAGIC &&
+							header[1] == sizeof(locator) && std::fread(&locator, sizeof(locator), 1, fp) == 1 &&
+							locator.magic == GSDUMP_INDEX_MAGIC && locator.version == GSDUMP_INDEX_VERSION &&
+							locator.index_offset != 0);
+
+		// Unindexed dumps are still valid zstd streams, so go back to the start for the regular reader.
+		std::rewind(fp);
+		*index_offset = found ? locator.index_offset : 0;
+		return found;
+	}
+
+	bool GSDumpIndexedZst::Open(FileSystem::ManagedCFilePtr fp, Error* error)
+	{
+		m_fp = std::move(fp);
+
+		const s64 file_size = FileSystem::FSize64(m_fp.get());
+
+		u32 frame_header[2];
+		GSDumpIndexHeader header;
+		if (FileSystem::FSeek64(m_fp.get(), static_cast<s64>(m_index_offset), SEEK_SET) != 0 ||
+			std::fread(frame_header, sizeof(frame_header), 1, m_fp.get()) != 1 ||
+			std::fread(&header, sizeof(header), 1, m_fp.get()) != 1)
+		{
+			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Failed to read dump index."));
+			return false;
+		}
+
+		const u64 index_size = sizeof(header) +
+							   static_cast<u64>(header.num_chunks) * sizeof(GSDumpIndexChunk) +
+							   static_cast<u64>(header.num_frames) * sizeof(GSDumpIndexFrame) +
+							   static_cast<u64>(header.num_keyframes) * sizeof(GSDumpIndexKeyframe);
+		if (frame_header[0] != GSDUMP_INDEX_SKIPPABLE_MAGIC || frame_header[1] != index_size ||
+			(m_index_offset + sizeof(frame_header) + index_size) > static_cast<u64>(file_size) ||
+			header.num_chunks == 0 || header.num_frames == 0)
+		{
+			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Dump index is corrupted."));
+			return false;
+		}
+
+		m_chunks.resize(header.num_chunks);
+		m_frames.resize(header.num_frames);
+		m_keyframes.resize(header.num_keyframes);
+		if (std::fread(m_chunks.data(), sizeof(GSDumpIndexChunk), m_chunks.size(), m_fp.get()) != m_chunks.size() ||
+			std::fread(m_frames.data(), sizeof(GSDumpIndexFrame), m_frames.size(), m_fp.get()) != m_frames.size() ||
+			std::fread(m_keyframes.data(), sizeof(GSDumpIndexKeyframe), m_keyframes.size(), m_fp.get()) != m_keyframes.size())
+		{
+			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Failed to read dump index."));
+			return false;
+		}
+
+		const auto in_file = [file_size](u64 offset, u32 size) {
+			return (offset + size) <= static_cast<u64>(file_size);
+		};
+		const bool chunks_valid = std::all_of(m_chunks.begin(), m_chunks.end(), [&in_file](const GSDumpIndexChunk& chunk) {
+			return in_file(chunk.file_offset, chunk.compressed_size) && chunk.uncompressed_size <= MAX_CHUNK_SIZE;
+		});
+		const bool frames_valid = std::all_of(m_frames.begin(), m_frames.end(), [this](const GSDumpIndexFrame& frame) {
+			return (frame.chunk == m_chunks.size() && frame.offset == 0) ||
+				   (frame.chunk < m_chunks.size() && frame.offset <= m_chunks[frame.chunk].uncompressed_size);
+		});
+		const bool keyframes_valid = std::all_of(m_keyframes.begin(), m_keyframes.end(), [this, &in_file](const GSDumpIndexKeyframe& kf) {
+			return in_file(kf.file_offset, kf.compressed_size) && kf.uncompressed_size <= MAX_CHUNK_SIZE &&
+				   kf.frame < m_frames.size();
+		});
+		if (!chunks_valid || !frames_valid || !keyframes_valid)
+		{
+			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Dump index is corrupted."));
+			return false;
+		}
+
+		m_packet_count = header.num_packets;
+		m_frame_count = header.num_frames - 1;
+
+		DevCon.WriteLnFmt("Indexed Zstd dump has {} frames, {} packets and {} keyframes across {} chunks",
+			m_frame_count, m_packet_count, m_keyframes.size(), m_chunks.size());
+
+		m_dctx = ZSTD_createDCtx();
+		if (!m_dctx || !LoadChunk(0))
+		{
+			Error::SetString(error, TRANSLATE_STR("GSDumpFile", "Failed to decompress dump header."));
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GSDumpIndexedZst::ReadCompressed(u64 offset, u32 compressed_size, u8* dst, u32 uncompressed_size)
+	{
+		if (compressed_size > m_read_buffer.size())
+			m_read_buffer.resize(Common::AlignUpPow2(compressed_size, _128kb));
+
+		if (FileSystem::FSeek64(m_fp.get(), static_cast<s64>(offset), SEEK_SET) != 0 ||
+			std::fread(m_read_buffer.data(), compressed_size, 1, m_fp.get()) != 1)
+		{
+			Console.ErrorFmt("Failed to read {} bytes from offset {}", compressed_size, offset);
+			return false;
+		}
+
+		const size_t ret = ZSTD_decompressDCtx(m_dctx, dst, uncompressed_size, m_read_buffer.data(), compressed_size);
+		if (ZSTD_isError(ret) || ret != uncompressed_size)
+		{
+			Console.ErrorFmt("Decoder error: {}", ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "size mismatch");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GSDumpIndexedZst::LoadChunk(u32 index)
+	{
+		if (index == m_chunk_index && m_chunk_size > 0)
+			return true;
+
+		const GSDumpIndexChunk& chunk = m_chunks[index];
+		if (chunk.uncompressed_size > m_chunk_buffer.size())
+			m_chunk_buffer.resize(Common::AlignUpPow2(chunk.uncompressed_size, _128kb));
+
+		m_chunk_index = index;
+		m_chunk_pos = 0;
+		m_chunk_size = 0;
+		if (!ReadCompressed(chunk.file_offset, chunk.compressed_size, m_chunk_buffer.data(), chunk.uncompressed_size))
+			return false;
+
+		m_chunk_size = chunk.uncompressed_size;
+		return true;
+	}
+
+	void GSDumpIndexedZst::SetPosition(const GSDumpIndexFrame& pos)
+	{
+		m_packet_index = pos.packet;
+
+		// Frames past the last chunk have no packets.
+		if (pos.chunk == m_chunks.size() || !LoadChunk(pos.chunk))
+		{
+			m_chunk_index = static_cast<u32>(m_chunks.size() - 1);
+			m_chunk_pos = m_chunk_size = 0;
+			return;
+		}
+
+		m_chunk_pos = pos.offset;
+	}
+
+	bool GSDumpIndexedZst::IsEof()
+	{
+		return (m_chunk_pos == m_chunk_size && (m_chunk_index + 1) == m_chunks.size());
+	}
+
+	size_t GSDumpIndexedZst::Read(void* ptr, size_t size)
+	{
+		u8* dst = static_cast<u8*>(ptr);
+		size_t remain = size;
+		while (remain > 0)
+		{
+			if (m_chunk_pos == m_chunk_size && ((m_chunk_index + 1) == m_chunks.size() || !LoadChunk(m_chunk_index + 1))) [[unlikely]]
+				break;
+
+			const size_t read = std::min(m_chunk_size - m_chunk_pos, remain);
+			std::memcpy(dst, &m_chunk_buffer[m_chunk_pos], read);
+			dst += read;
+			remain -= read;
+			m_chunk_pos += read;
+		}
+
+		return size - remain;
+	}
+
+	bool GSDumpIndexedZst::ReadPackets(Error* error)
+	{
+		// Packets are decompressed a chunk at a time as they're needed.
+		Rewind();
+		return true;
+	}
+
+	const GSDumpFile::GSData* GSDumpIndexedZst::GetNextPacket()
+	{
+		while (m_chunk_pos == m_chunk_size)
+		{
+			if ((m_chunk_index + 1) == m_chunks.size() || !LoadChunk(m_chunk_index + 1))
+				return nullptr;
+		}
+
+		const u8* data = &m_chunk_buffer[m_chunk_pos];
+		size_t remaining = m_chunk_size - m_chunk_pos;
+		Error error;
+		const PacketParseResult res = ParsePacket(data, remaining, &m_packet, &error);
+		if (res != PacketParseResult::OK)
+		{
+			// Packets never cross chunks, so the rest of the stream can't be trusted.
+			if (res == PacketParseResult::Error)
+				Console.ErrorFmt("(GSDump) {}", error.GetDescription());
+
+			m_chunk_index = static_cast<u32>(m_chunks.size() - 1);
+			m_chunk_pos = m_chunk_size = 0;
+			return nullptr;
+		}
+
+		m_chunk_pos = m_chunk_size - remaining;
+		m_packet_index++;
+		return &m_packet;
+	}
+
+	void GSDumpIndexedZst::Rewind()
+	{
+		SetPosition(m_frames.front());
+	}
+
+	bool GSDumpIndexedZst::SeekToKeyframe(u32 frame, u32* keyframe, ByteArray* state_data, ByteArray* regs_data, Error* error)
+	{
+		const auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), frame,
+			[](u32 frame, const GSDumpIndexKeyframe& kf) { return frame < kf.frame; });
+		if (it == m_keyframes.begin())
+			return GSDumpFile::SeekToKeyframe(frame, keyframe, state_data, regs_data, error);
+
+		const GSDumpIndexKeyframe& kf = *(it - 1);
+		ByteArray data(kf.uncompressed_size);
+		u32 state_size;
+		if (!ReadCompressed(kf.file_offset, kf.compressed_size, data.data(), kf.uncompressed_size) ||
+			data.size() < sizeof(state_size))
+		{
+			Error::SetStringFmt(error, TRANSLATE_FS("GSDumpFile", "Failed to read keyframe at frame {}."), kf.frame);
+			return false;
+		}
+
+		std::memcpy(&state_size, data.data(), sizeof(state_size));
+		if ((static_cast<u64>(state_size) + sizeof(state_size)) > data.size())
+		{
+			Error::SetStringFmt(error, TRANSLATE_FS("GSDumpFile", "Keyframe at frame {} is corrupted."), kf.frame);
+			return false;
+		}
+
+		const auto state_start = data.begin() + sizeof(state_size);
+		state_data->assign(state_start, state_start + state_size);
+		regs_data->assign(state_start + state_size, data.end());
+
+		SetPosition(m_frames[kf.frame]);
+		*keyframe = kf.frame;
+		return true;
+	}
+
+	/******************************************************************/
+
 	class GSDumpRaw final : public GSDumpFile
 	{
 	public:
@@ -630,7 +973,13 @@ std::unique_ptr<GSDumpFile> GSDumpFile::OpenGSDump(const char* filename, Error*
 	if (StringUtil::EndsWithNoCase(filename, ".xz"))
 		file = std::make_unique<GSDumpLzma>();
 	else if (StringUtil::EndsWithNoCase(filename, ".zst"))
-		file = std::make_unique<GSDumpDecompressZst>();
+	{
+		u64 index_offset;
+		if (GSDumpIndexedZst::FindIndex(fp.get(), &index_offset))
+			file = std::make_unique<GSDumpIndexedZst>(index_offset);
+		else
+			file = std::make_unique<GSDumpDecompressZst>();
+	}
 	else
 		file = std::make_unique<GSDumpRaw>();
 
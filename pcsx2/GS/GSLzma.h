@@ -293,20 +293,52 @@ public:
 
 	__fi const ByteArray& GetRegsData() const { return m_regs_data; }
 	__fi const ByteArray& GetStateData() const { return m_state_data; }
-	__fi const GSDataArray& GetPackets() const { return m_dump_packets; }
+
+	__fi u32 GetPacketCount() const { return m_packet_count; }
+	__fi u32 GetPacketIndex() const { return m_packet_index; }
+
+	/// Returns the number of vsyncs in the dump, or zero if the dump does not have an index.
+	__fi u32 GetFrameCount() const { return m_frame_count; }
 
 	bool ReadFile(Error* error);
 
+	/// Returns the next packet in the dump, or nullptr at the end of the stream.
+	/// The packet data is only valid until the next call to GetNextPacket(), Rewind() or SeekToKeyframe().
+	virtual const GSData* GetNextPacket();
+
+	/// Moves back to the first packet in the dump.
+	virtual void Rewind();
+
+	/// Moves to the closest keyframe at or before the specified frame, returning the GS state at that point.
+	/// Dumps without keyframes always rewind to the start, and return the initial state.
+	virtual bool SeekToKeyframe(u32 frame, u32* keyframe, ByteArray* state_data, ByteArray* regs_data, Error* error);
+
 protected:
+	enum class PacketParseResult : u8
+	{
+		OK,
+		Truncated,
+		Error,
+	};
+
 	GSDumpFile();
 
 	virtual bool Open(FileSystem::ManagedCFilePtr fp, Error* error) = 0;
 	virtual bool IsEof() = 0;
 	virtual size_t Read(void* ptr, size_t size) = 0;
 
+	/// Called after the header has been read, to prepare the packet stream.
+	virtual bool ReadPackets(Error* error);
+
+	static PacketParseResult ParsePacket(const u8*& data, size_t& remaining, GSData* packet, Error* error);
+
 protected:
 	FileSystem::ManagedCFilePtr m_fp;
 
+	u32 m_packet_count = 0;
+	u32 m_packet_index = 0;
+	u32 m_frame_count = 0;
+
 private:
 	std::string m_serial;
 	u32 m_crc = 0;
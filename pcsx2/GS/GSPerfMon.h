@@ -26,6 +26,8 @@ public:
 		TextureCopiesROV, // Overlaps with regular texture copies.
 		DrawCallsROV, // Overlaps with regular draw calls.
 		BarriersROV, // Overlaps with regular barriers.
+		TargetLookups,
+		TargetCandidates, // Targets found through the page index by TargetLookups.
 		CounterLast,
 
 		// Reused counters for HW.
@@ -3340,6 +3340,10 @@ void GSState::ReadbackTextureCache()
 {
 }
 
+void GSState::PreloadTextureCache()
+{
+}
+
 template void GSState::Transfer<0>(const u8* mem, u32 size);
 template void GSState::Transfer<1>(const u8* mem, u32 size);
 template void GSState::Transfer<2>(const u8* mem, u32 size);
@@ -3785,6 +3789,9 @@ int GSState::Defrost(const freezeData* fd)
 
 	ResetPCRTC();
 
+	// Local memory is back, so anything the game was using regularly can be uploaded now, rather than on first use.
+	PreloadTextureCache();
+
 	return 0;
 }
 
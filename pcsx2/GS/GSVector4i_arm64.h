@@ -939,6 +939,11 @@ public:
 		return GSVector4i(vreinterpretq_s32_s16(vmulq_s16(vreinterpretq_s16_s32(v4s), vreinterpretq_s16_s32(v.v4s))));
 	}
 
+	__forceinline GSVector4i mul32l(const GSVector4i& v) const
+	{
+		return GSVector4i(vmulq_s32(v4s, v.v4s));
+	}
+
 	__forceinline GSVector4i mul16hrs(const GSVector4i& v) const
 	{
 		int32x4_t mul_lo = vmull_s16(vget_low_s16(vreinterpretq_s16_s32(v4s)), vget_low_s16(vreinterpretq_s16_s32(v.v4s)));
@@ -948,6 +953,13 @@ public:
 		return GSVector4i(vreinterpretq_s32_s16(vcombine_s16(narrow_lo, narrow_hi)));
 	}
 
+	__forceinline GSVector4i madd(const GSVector4i& v) const
+	{
+		int32x4_t mul_lo = vmull_s16(vget_low_s16(vreinterpretq_s16_s32(v4s)), vget_low_s16(vreinterpretq_s16_s32(v.v4s)));
+		int32x4_t mul_hi = vmull_s16(vget_high_s16(vreinterpretq_s16_s32(v4s)), vget_high_s16(vreinterpretq_s16_s32(v.v4s)));
+		return GSVector4i(vpaddq_s32(mul_lo, mul_hi));
+	}
+
 	template <int shift>
 	__forceinline GSVector4i lerp16(const GSVector4i& a, const GSVector4i& f) const
 	{
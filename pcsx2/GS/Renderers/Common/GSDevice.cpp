@@ -55,6 +55,7 @@ const char* ShaderEntryPoint(ShaderConvert value)
 		case ShaderConvert::CLUT_4:                 return "ps_convert_clut_4";
 		case ShaderConvert::CLUT_8:                 return "ps_convert_clut_8";
 		case ShaderConvert::YUV:                    return "ps_yuv";
+		case ShaderConvert::RGBA_TO_NV12:           return "ps_convert_rgba_nv12";
 		// clang-format on
 		default:
 			pxAssert(0);
@@ -115,6 +116,7 @@ const char* ShaderConvertName(ShaderConvert shader)
 		ENTRY(CLUT_4);
 		ENTRY(CLUT_8);
 		ENTRY(YUV);
+		ENTRY(RGBA_TO_NV12);
 		case ShaderConvert::Count: break;
 	}
 	#undef ENTRY
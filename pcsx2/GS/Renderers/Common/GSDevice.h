@@ -65,6 +65,7 @@ enum class ShaderConvert
 	CLUT_4,
 	CLUT_8,
 	YUV,
+	RGBA_TO_NV12,
 	Count
 };
 
@@ -128,6 +129,7 @@ static inline constexpr bool HasColorOutput(ShaderConvert shader)
 		case ShaderConvert::CLUT_4:
 		case ShaderConvert::CLUT_8:
 		case ShaderConvert::YUV:
+		case ShaderConvert::RGBA_TO_NV12:
 		case ShaderConvert::COLCLIP_RESOLVE:
 			return true;
 		default:
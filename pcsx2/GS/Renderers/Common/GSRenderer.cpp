@@ -801,9 +801,23 @@ void GSRenderer::VSync(u32 field, bool registers_written, bool idle_frame)
 				Host::OSD_INFO_DURATION);
 			m_dump.reset();
 		}
-		else if (!last)
+		else
 		{
-			m_dump_frames--;
+			if (!last)
+				m_dump_frames--;
+
+			if (m_dump->IsKeyframeDue())
+			{
+				if (GSConfig.UserHacks_ReadTCOnClose)
+					ReadbackTextureCache();
+
+				freezeData fd = {0, nullptr};
+				Freeze(&fd, true);
+				std::unique_ptr<u8[]> data = std::make_unique_for_overwrite<u8[]>(fd.size);
+				fd.data = data.get();
+				Freeze(&fd, false);
+				m_dump->AddKeyframe(fd, m_regs);
+			}
 		}
 	}
 
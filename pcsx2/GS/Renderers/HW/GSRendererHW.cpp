@@ -62,6 +62,11 @@ void GSRendererHW::ReadbackTextureCache()
 	g_texture_cache->ReadbackAll();
 }
 
+void GSRendererHW::PreloadTextureCache()
+{
+	g_texture_cache->PreloadHashCache();
+}
+
 GSTexture* GSRendererHW::LookupPaletteSource(u32 CBP, u32 CPSM, u32 CBW, GSVector2i& offset, float* scale, const GSVector2i& size)
 {
 	return g_texture_cache->LookupPaletteSource(CBP, CPSM, CBW, offset, scale, size);
@@ -93,6 +98,14 @@ void GSRendererHW::UpdateSettings(const Pcsx2Config::GSOptions& old_config)
 	GSRenderer::UpdateSettings(old_config);
 	m_mipmap = GSConfig.HWMipmap;
 	SetTCOffset();
+
+	// Thread pool is created on the next software draw.
+	if (GSConfig.SWPrimRenderThreads != old_config.SWPrimRenderThreads ||
+		GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight ||
+		GSConfig.SWExtraThreadsBinned != old_config.SWExtraThreadsBinned)
+	{
+		m_sw_rasterizer_list.reset();
+	}
 }
 
 void GSRendererHW::VSync(u32 field, bool registers_written, bool idle_frame)
@@ -7,6 +7,7 @@
 #include "GS/Renderers/Common/GSFunctionMap.h"
 #include "GS/Renderers/Common/GSRenderer.h"
 #include "GS/Renderers/SW/GSTextureCacheSW.h"
+#include "GS/GSRingHeap.h"
 #include "GS/GSState.h"
 #include "GS/MultiISA.h"
 
@@ -344,7 +345,9 @@ private:
 	// software sprite renderer state
 	std::vector<GSVertexSW> m_sw_vertex_buffer;
 	std::unique_ptr<GSTextureCacheSW::Texture> m_sw_texture[7 + 1];
+	GSRingHeap m_sw_heap;
 	std::unique_ptr<GSVirtualAlignedClass<32>> m_sw_rasterizer;
+	std::unique_ptr<GSVirtualAlignedClass<32>> m_sw_rasterizer_list; // IRasterizer, SWPrimRenderThreads workers
 
 public:
 	GSRendererHW();
@@ -382,6 +385,7 @@ public:
 	void Draw() override;
 
 	void PurgeTextureCache(bool sources, bool targets, bool hash_cache) override;
+	void PreloadTextureCache() override;
 	void ReadbackTextureCache() override;
 
 	GSTexture* LookupPaletteSource(u32 CBP, u32 CPSM, u32 CBW, GSVector2i& offset, float* scale, const GSVector2i& size) override;
@@ -36,7 +36,9 @@ bool GSRendererHWFunctions::SwPrimRender(GSRendererHW& hw, bool invalidate_tc, b
 	const GSDrawingEnvironment& env = *hw.m_draw_env;
 	const GS_PRIM_CLASS primclass = vt.m_primclass;
 
-	GSRasterizerData data;
+	// Drawn in place from the HW renderer's buffers, the rasterizer is always synced before returning.
+	GSRingHeap::SharedPtr<GSRasterizerData> shared_data = hw.m_sw_heap.make_shared<GSRasterizerData>();
+	GSRasterizerData& data = *shared_data.get();
 	GSScanlineGlobalData& gd = data.global;
 
 	hw.m_sw_vertex_buffer.resize(((hw.m_vertex->next + 1) & ~1));
@@ -539,10 +541,25 @@ bool GSRendererHWFunctions::SwPrimRender(GSRendererHW& hw, bool invalidate_tc, b
 		}
 	}
 
-	if (!hw.m_sw_rasterizer)
-		hw.m_sw_rasterizer = std::make_unique<GSSingleRasterizer>();
+	// Large sprites and CLUT draws can happen every frame, so split them into scanline bands across a thread pool.
+	// Small draws aren't worth waking the workers for, and are drawn inline.
+	constexpr int threaded_min_pixels = 128 * 128;
+	if (GSConfig.SWPrimRenderThreads > 0 && (bbox.z - bbox.x) * (bbox.w - bbox.y) >= threaded_min_pixels)
+	{
+		if (!hw.m_sw_rasterizer_list)
+			hw.m_sw_rasterizer_list = GSRasterizerList::Create(GSConfig.SWPrimRenderThreads, false);
 
-	static_cast<GSSingleRasterizer*>(hw.m_sw_rasterizer.get())->Draw(data);
+		IRasterizer* rl = static_cast<IRasterizer*>(hw.m_sw_rasterizer_list.get());
+		rl->Queue(shared_data);
+		rl->Sync();
+	}
+	else
+	{
+		if (!hw.m_sw_rasterizer)
+			hw.m_sw_rasterizer = std::make_unique<GSSingleRasterizer>();
+
+		static_cast<GSSingleRasterizer*>(hw.m_sw_rasterizer.get())->Draw(data);
+	}
 
 	if (invalidate_tc)
 		g_texture_cache->InvalidateVideoMem(context->offset.fb, bbox);
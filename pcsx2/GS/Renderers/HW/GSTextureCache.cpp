@@ -12,8 +12,15 @@
 
 #include "common/Console.h"
 #include "common/BitUtils.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
 #include "common/HashCombine.h"
+#include "common/Path.h"
 #include "common/SmallString.h"
+#include "common/Timer.h"
+
+#include "Config.h"
+#include "VMManager.h"
 
 #include "fmt/format.h"
 
@@ -30,6 +37,35 @@ std::unique_ptr<GSTextureCache> g_texture_cache;
 
 static u8* s_unswizzle_buffer;
 
+struct HashCacheStatsFileHeader
+{
+	u32 magic;
+	u32 version;
+	u32 num_entries;
+};
+
+struct HashCacheStatsFileEntry
+{
+	GSTextureCache::HashCacheKey key;
+	u64 TEX0;
+	u64 TEXA;
+	u64 region;
+	u32 uses;
+	u32 mem_usage;
+	u32 paltex;
+	u32 pad;
+};
+static_assert(sizeof(HashCacheStatsFileEntry) == 80);
+
+static constexpr u32 HASH_CACHE_STATS_FILE_MAGIC = 0x43485850; // PXHC
+static constexpr u32 HASH_CACHE_STATS_FILE_VERSION = 1;
+
+/// Only the most used textures are worth remembering, the rest are typically FMV frames or one-off uploads.
+static constexpr size_t MAX_HASH_CACHE_STATS = 2048;
+
+/// Upper bound on what gets uploaded after a state load, when there's no hash cache budget to go by.
+static constexpr u64 MAX_HASH_CACHE_PRELOAD_MEMORY = 256 * _1mb;
+
 /// List of candidates for purging when the hash cache gets too large.
 static std::vector<std::pair<GSTextureCache::HashCacheMap::iterator, s32>> s_hash_cache_purge_list;
 
@@ -56,11 +92,14 @@ GSTextureCache::GSTextureCache()
 	pxAssertRel(s_unswizzle_buffer, "Failed to allocate unswizzle buffer");
 
 	m_surface_offset_cache.reserve(S_SURFACE_OFFSET_CACHE_MAX_SIZE);
+
+	LoadHashCacheStats();
 }
 
 GSTextureCache::~GSTextureCache()
 {
 	RemoveAll(true, true, true);
+	SaveHashCacheStats();
 
 	s_hash_cache_purge_list = {};
 	_aligned_free(s_unswizzle_buffer);
@@ -4541,6 +4580,7 @@ bool GSTextureCache::PrepareDownloadTexture(u32 width, u32 height, GSTexture::Fo
 void GSTextureCache::InvalidateContainedTargets(u32 start_bp, u32 end_bp, u32 write_psm, u32 write_bw, u32 fb_mask, bool ignore_exact)
 {
 	const bool preserve_alpha = (GSLocalMemory::m_psm[write_psm].trbpp == 24) || (fb_mask & 0xFF000000);
+	BeginTargetLookup(start_bp, end_bp);
 	for (int type = 0; type < (ignore_exact ? 1 : 2); type++)
 	{
 		auto& list = m_dst[type];
@@ -4548,7 +4588,7 @@ void GSTextureCache::InvalidateContainedTargets(u32 start_bp, u32 end_bp, u32 wr
 		{
 			Target* const t = *i;
 
-			if ((ignore_exact && start_bp == t->m_TEX0.TBP0) || (start_bp != t->m_TEX0.TBP0 && (t->m_TEX0.TBP0 > end_bp || t->UnwrappedEndBlock() < start_bp)))
+			if (CanSkipTarget(t) || (ignore_exact && start_bp == t->m_TEX0.TBP0) || (start_bp != t->m_TEX0.TBP0 && (t->m_TEX0.TBP0 > end_bp || t->UnwrappedEndBlock() < start_bp)))
 			{
 				++i;
 				continue;
@@ -4853,6 +4893,7 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 	RGBAMask rgba;
 	rgba._u32 = GSUtil::GetChannelMask(psm);
 
+	BeginTargetLookup(bp, end_bp);
 	for (int type = 0; type < 2; type++)
 	{
 		auto& list = m_dst[type];
@@ -4862,7 +4903,7 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 			Target* t = *j;
 
 			// Don't bother checking any further if the target doesn't overlap with the write/invalidation.
-			if ((bp < t->m_TEX0.TBP0 && end_bp < t->m_TEX0.TBP0) || bp > t->UnwrappedEndBlock())
+			if (CanSkipTarget(t) || (bp < t->m_TEX0.TBP0 && end_bp < t->m_TEX0.TBP0) || bp > t->UnwrappedEndBlock())
 			{
 				++i;
 				continue;
@@ -5803,13 +5844,37 @@ GSTextureCache::Target* GSTextureCache::GetTargetWithSharedBits(u32 BP, u32 PSM)
 	return nullptr;
 }
 
+void GSTextureCache::BeginTargetLookup(u32 start_bp, u32 end_bp) const
+{
+	m_dst_lookup_stamp++;
+	const u32 candidates = m_dst_pages.Mark(start_bp, end_bp, m_dst_lookup_stamp);
+
+	g_perfmon.Put(GSPerfMon::TargetLookups, 1);
+	g_perfmon.Put(GSPerfMon::TargetCandidates, candidates);
+}
+
+bool GSTextureCache::CanSkipTarget(Target* t) const
+{
+	if (t->m_lookup_stamp == m_dst_lookup_stamp)
+		return false;
+
+	if (t->m_indexed && t->m_indexed_bp == t->m_TEX0.TBP0 && t->m_indexed_end_block == t->m_end_block)
+		return true;
+
+	// New, moved or resized since the lookup started, so it needs the full check. Refile it for next time.
+	m_dst_pages.Update(t);
+	return false;
+}
+
 GSTextureCache::Target* GSTextureCache::FindOverlappingTarget(GSTextureCache::Target* target) const
 {
+	BeginTargetLookup(target->m_TEX0.TBP0, target->m_end_block);
+
 	for (int i = 0; i < 2; i++)
 	{
 		for (Target* tgt : m_dst[i])
 		{
-			if (tgt == target)
+			if (tgt == target || CanSkipTarget(tgt))
 				continue;
 
 			if (CheckOverlap(tgt->m_TEX0.TBP0, tgt->m_end_block, target->m_TEX0.TBP0, target->m_end_block))
@@ -5822,11 +5887,13 @@ GSTextureCache::Target* GSTextureCache::FindOverlappingTarget(GSTextureCache::Ta
 
 GSTextureCache::Target* GSTextureCache::FindOverlappingTarget(u32 BP, u32 end_bp) const
 {
+	BeginTargetLookup(BP, end_bp);
+
 	for (int i = 0; i < 2; i++)
 	{
 		for (Target* tgt : m_dst[i])
 		{
-			if (CheckOverlap(tgt->m_TEX0.TBP0, tgt->m_end_block, BP, end_bp))
+			if (!CanSkipTarget(tgt) && CheckOverlap(tgt->m_TEX0.TBP0, tgt->m_end_block, BP, end_bp))
 				return tgt;
 		}
 	}
@@ -7053,6 +7120,14 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 		HashCacheEntry* entry = &it->second;
 		paltex &= (entry->texture->GetFormat() == GSTexture::Format::UNorm8);
 		entry->refcount++;
+
+		const auto sit = m_hash_cache_stats.find(it->first);
+		if (sit != m_hash_cache_stats.end())
+		{
+			sit->second.uses += (sit->second.uses != std::numeric_limits<u32>::max());
+			m_hash_cache_stats_dirty = true;
+		}
+
 		return entry;
 	}
 
@@ -7110,6 +7185,22 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 	if (!can_cache)
 		return nullptr;
 
+	// remove the palette hash when using paltex/indexed
+	if (paltex)
+		key.RemoveCLUTHash();
+
+	HashCacheEntry* entry = CreateHashCacheEntry(key, TEX0, TEXA, region, lod, paltex);
+
+	// without a palette or mipmaps, local memory is all we need to build it again after a state load
+	if (entry && !lod && key.CLUTHash == 0)
+		RecordHashCacheUse(key, TEX0, TEXA, region, paltex, entry->texture->GetMemUsage());
+
+	return entry;
+}
+
+GSTextureCache::HashCacheEntry* GSTextureCache::CreateHashCacheEntry(const HashCacheKey& key, const GIFRegTEX0& TEX0,
+	const GIFRegTEXA& TEXA, SourceRegion region, const GSVector2i* lod, bool paltex)
+{
 	// expand/upload texture
 	const int tw = region.HasX() ? region.GetWidth() : (1 << TEX0.TW);
 	const int th = region.HasY() ? region.GetHeight() : (1 << TEX0.TH);
@@ -7148,10 +7239,6 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 		tex->ClearMipmapGenerationFlag();
 	}
 
-	// remove the palette hash when using paltex/indexed
-	if (paltex)
-		key.RemoveCLUTHash();
-
 	// insert into the cache cache, and we're done
 	const HashCacheEntry entry{tex, 1u, 0u, alpha_minmax, compute_alpha_minmax, false};
 	m_hash_cache_memory_usage += tex->GetMemUsage();
@@ -7179,7 +7266,14 @@ void GSTextureCache::AgeHashCache()
 	constexpr u32 MAX_HASH_CACHE_SIZE = 800;
 	constexpr u32 MAX_HASH_CACHE_AGE = 30;
 
-	bool might_need_cache_purge = (m_hash_cache.size() > MAX_HASH_CACHE_SIZE);
+	// With a memory budget, unused textures are kept until the space is needed, and the least recently used go first.
+	// Otherwise they're dropped once they haven't been used for a while.
+	const u64 budget = static_cast<u64>(GSConfig.TextureHashCacheSize) * _1mb;
+	const auto over_limit = [this, budget]() {
+		return (m_hash_cache.size() > MAX_HASH_CACHE_SIZE || (budget != 0 && GetTotalHashCacheMemoryUsage() > budget));
+	};
+
+	bool might_need_cache_purge = over_limit();
 	if (might_need_cache_purge)
 		s_hash_cache_purge_list.clear();
 
@@ -7192,7 +7286,8 @@ void GSTextureCache::AgeHashCache()
 			continue;
 		}
 
-		if (++e.age > MAX_HASH_CACHE_AGE)
+		e.age += (e.age != std::numeric_limits<u16>::max());
+		if (budget == 0 && e.age > MAX_HASH_CACHE_AGE)
 		{
 			it = RemoveFromHashCache(it);
 			continue;
@@ -7201,7 +7296,7 @@ void GSTextureCache::AgeHashCache()
 		// We might free up enough just with "normal" removals above.
 		if (might_need_cache_purge)
 		{
-			might_need_cache_purge = (m_hash_cache.size() > MAX_HASH_CACHE_SIZE);
+			might_need_cache_purge = over_limit();
 			if (might_need_cache_purge)
 				s_hash_cache_purge_list.emplace_back(it, static_cast<s32>(e.age));
 		}
@@ -7215,13 +7310,177 @@ void GSTextureCache::AgeHashCache()
 		std::sort(s_hash_cache_purge_list.begin(), s_hash_cache_purge_list.end(),
 			[](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
 
-		const u32 entries_to_purge = std::min(static_cast<u32>(m_hash_cache.size() - MAX_HASH_CACHE_SIZE),
-			static_cast<u32>(s_hash_cache_purge_list.size()));
-		for (u32 i = 0; i < entries_to_purge; i++)
-			RemoveFromHashCache(s_hash_cache_purge_list[i].first);
+		for (const auto& [it, age] : s_hash_cache_purge_list)
+		{
+			if (!over_limit())
+				break;
+
+			RemoveFromHashCache(it);
+		}
 	}
 }
 
+void GSTextureCache::RecordHashCacheUse(const HashCacheKey& key, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA,
+	SourceRegion region, bool paltex, u32 mem_usage)
+{
+	const auto [it, inserted] = m_hash_cache_stats.try_emplace(key, HashCacheStats{TEX0, TEXA, region, 0u, mem_usage, paltex});
+	HashCacheStats& stats = it->second;
+	stats.TEX0 = TEX0;
+	stats.TEXA = TEXA;
+	stats.region = region;
+	stats.uses += (stats.uses != std::numeric_limits<u32>::max());
+	m_hash_cache_stats_dirty = true;
+
+	// don't let FMVs grow this forever
+	if (inserted && m_hash_cache_stats.size() > (MAX_HASH_CACHE_STATS * 2))
+		PruneHashCacheStats(MAX_HASH_CACHE_STATS);
+}
+
+void GSTextureCache::PruneHashCacheStats(size_t max_entries)
+{
+	if (m_hash_cache_stats.size() <= max_entries)
+		return;
+
+	std::vector<std::pair<u32, HashCacheKey>> order;
+	order.reserve(m_hash_cache_stats.size());
+	for (const auto& [key, stats] : m_hash_cache_stats)
+		order.emplace_back(stats.uses, key);
+
+	std::nth_element(order.begin(), order.begin() + max_entries, order.end(),
+		[](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+	for (auto it = order.begin() + max_entries; it != order.end(); ++it)
+		m_hash_cache_stats.erase(it->second);
+}
+
+void GSTextureCache::ReloadHashCacheStats()
+{
+	SaveHashCacheStats();
+	LoadHashCacheStats();
+}
+
+void GSTextureCache::LoadHashCacheStats()
+{
+	m_hash_cache_stats.clear();
+	m_hash_cache_stats_dirty = false;
+
+	// bios textures aren't worth tracking
+	const std::string serial = VMManager::GetDiscSerial();
+	if (serial.empty())
+	{
+		m_hash_cache_stats_filename = {};
+		return;
+	}
+
+	m_hash_cache_stats_filename = Path::Combine(Path::Combine(EmuFolders::Cache, "hash_cache"), fmt::format("{}.bin", serial));
+
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(m_hash_cache_stats_filename.c_str());
+	if (!data.has_value() || data->size() < sizeof(HashCacheStatsFileHeader))
+		return;
+
+	HashCacheStatsFileHeader header;
+	std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != HASH_CACHE_STATS_FILE_MAGIC || header.version != HASH_CACHE_STATS_FILE_VERSION ||
+		data->size() != (sizeof(header) + static_cast<size_t>(header.num_entries) * sizeof(HashCacheStatsFileEntry)))
+	{
+		Console.Warning(fmt::format("Ignoring invalid hash cache statistics '{}'.", Path::GetFileName(m_hash_cache_stats_filename)));
+		return;
+	}
+
+	m_hash_cache_stats.reserve(header.num_entries);
+	for (u32 i = 0; i < header.num_entries; i++)
+	{
+		HashCacheStatsFileEntry entry;
+		std::memcpy(&entry, data->data() + sizeof(header) + i * sizeof(HashCacheStatsFileEntry), sizeof(entry));
+
+		HashCacheStats stats;
+		stats.TEX0.U64 = entry.TEX0;
+		stats.TEXA.U64 = entry.TEXA;
+		stats.region.bits = entry.region;
+		stats.uses = entry.uses;
+		stats.mem_usage = entry.mem_usage;
+		stats.paltex = (entry.paltex != 0);
+		m_hash_cache_stats.emplace(entry.key, stats);
+	}
+
+	DevCon.WriteLn("Loaded hash cache statistics for %u textures.", header.num_entries);
+}
+
+void GSTextureCache::SaveHashCacheStats()
+{
+	if (!m_hash_cache_stats_dirty || m_hash_cache_stats_filename.empty())
+		return;
+
+	m_hash_cache_stats_dirty = false;
+	PruneHashCacheStats(MAX_HASH_CACHE_STATS);
+
+	const HashCacheStatsFileHeader header = {HASH_CACHE_STATS_FILE_MAGIC, HASH_CACHE_STATS_FILE_VERSION,
+		static_cast<u32>(m_hash_cache_stats.size())};
+	std::vector<u8> data(sizeof(header) + m_hash_cache_stats.size() * sizeof(HashCacheStatsFileEntry));
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	u8* ptr = data.data() + sizeof(header);
+	for (const auto& [key, stats] : m_hash_cache_stats)
+	{
+		const HashCacheStatsFileEntry entry = {key, stats.TEX0.U64, stats.TEXA.U64, stats.region.bits, stats.uses,
+			stats.mem_usage, stats.paltex ? 1u : 0u, 0u};
+		std::memcpy(ptr, &entry, sizeof(entry));
+		ptr += sizeof(entry);
+	}
+
+	Error error;
+	if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(m_hash_cache_stats_filename)).c_str(), false, &error) ||
+		!FileSystem::WriteBinaryFile(m_hash_cache_stats_filename.c_str(), data.data(), data.size()))
+	{
+		Console.Error(fmt::format("Failed to save hash cache statistics to '{}': {}", m_hash_cache_stats_filename,
+			error.GetDescription()));
+	}
+}
+
+void GSTextureCache::PreloadHashCache()
+{
+	if (m_hash_cache_stats.empty() || GSConfig.TexturePreloading != TexturePreloadingLevel::Full)
+		return;
+
+	Common::Timer timer;
+
+	// most used first, until we run out of budget
+	std::vector<HashCacheStatsMap::const_iterator> order;
+	order.reserve(m_hash_cache_stats.size());
+	for (auto it = m_hash_cache_stats.cbegin(); it != m_hash_cache_stats.cend(); ++it)
+		order.push_back(it);
+	std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) { return lhs->second.uses > rhs->second.uses; });
+
+	const u64 budget = (GSConfig.TextureHashCacheSize != 0) ? (static_cast<u64>(GSConfig.TextureHashCacheSize) * _1mb) :
+	                                                          MAX_HASH_CACHE_PRELOAD_MEMORY;
+
+	u32 preloaded = 0;
+	u32 checked = 0;
+	for (const auto& it : order)
+	{
+		const HashCacheStats& stats = it->second;
+		if ((GetTotalHashCacheMemoryUsage() + stats.mem_usage) > budget)
+			continue;
+
+		// the texture only comes back if the state has the same data at the same place
+		checked++;
+		const HashCacheKey key = HashCacheKey::Create(stats.TEX0, stats.TEXA, nullptr, nullptr, stats.region);
+		if (key != it->first || m_hash_cache.find(key) != m_hash_cache.end())
+			continue;
+
+		HashCacheEntry* entry = CreateHashCacheEntry(key, stats.TEX0, stats.TEXA, stats.region, nullptr, stats.paltex);
+		if (!entry)
+			break;
+
+		// nothing's referencing it yet, so it can be aged out if the game doesn't want it
+		entry->refcount = 0;
+		preloaded++;
+	}
+
+	DevCon.WriteLn("Preloaded %u of %u hash cache textures (%u checked) in %.2f ms, %llu KB.", preloaded,
+		static_cast<u32>(m_hash_cache_stats.size()), checked, timer.GetTimeMilliseconds(),
+		static_cast<unsigned long long>(GetTotalHashCacheMemoryUsage() / 1024));
+}
+
 GSTextureCache::Target* GSTextureCache::Target::Create(GIFRegTEX0 TEX0, int w, int h, float scale, int type, bool clear)
 {
 	pxAssert(type == RenderTarget || type == DepthStencil);
@@ -7874,6 +8133,9 @@ GSTextureCache::Target::~Target()
 	// Targets should never be shared.
 	pxAssert(!m_shared_texture);
 
+	if (m_indexed)
+		g_texture_cache->m_dst_pages.RemoveAt(this);
+
 	if (m_texture)
 	{
 		g_texture_cache->m_target_memory_usage -= m_texture->GetMemUsage();
@@ -8367,6 +8629,61 @@ void GSTextureCache::SourceMap::RemoveAt(Source* s)
 	delete s;
 }
 
+/// Calls the function for every page the block range touches, wrapping around the end of memory.
+template <typename F>
+static void LoopTargetPages(u32 start_bp, u32 end_bp, F&& f)
+{
+	if (end_bp < start_bp)
+		end_bp += GS_MAX_BLOCKS;
+
+	const u32 start_page = start_bp >> 5;
+	const u32 num_pages = std::min((end_bp >> 5) - start_page + 1, GS_MAX_PAGES);
+	for (u32 i = 0; i < num_pages; i++)
+		f((start_page + i) % GS_MAX_PAGES);
+}
+
+void GSTextureCache::TargetPageMap::Update(Target* t)
+{
+	if (t->m_indexed)
+	{
+		if (t->m_indexed_bp == t->m_TEX0.TBP0 && t->m_indexed_end_block == t->m_end_block)
+			return;
+
+		RemoveAt(t);
+	}
+
+	t->m_indexed_bp = t->m_TEX0.TBP0;
+	t->m_indexed_end_block = t->m_end_block;
+	t->m_indexed = true;
+
+	LoopTargetPages(t->m_indexed_bp, t->m_indexed_end_block, [this, t](u32 page) {
+		t->m_page_erase_it[page] = m_map[page].InsertFront(t);
+	});
+}
+
+void GSTextureCache::TargetPageMap::RemoveAt(Target* t)
+{
+	LoopTargetPages(t->m_indexed_bp, t->m_indexed_end_block, [this, t](u32 page) {
+		m_map[page].EraseIndex(t->m_page_erase_it[page]);
+	});
+
+	t->m_indexed = false;
+}
+
+u32 GSTextureCache::TargetPageMap::Mark(u32 start_bp, u32 end_bp, u32 stamp)
+{
+	u32 count = 0;
+	LoopTargetPages(start_bp, end_bp, [this, stamp, &count](u32 page) {
+		for (Target* t : m_map[page])
+		{
+			t->m_lookup_stamp = stamp;
+			count++;
+		}
+	});
+
+	return count;
+}
+
 void GSTextureCache::AttachPaletteToSource(Source* s, u16 pal, bool need_gs_texture, bool update_alpha_minmax)
 {
 	s->m_palette_obj = m_palette_map.LookupPalette(pal, need_gs_texture);
@@ -137,6 +137,20 @@ public:
 
 	using HashCacheMap = std::unordered_map<HashCacheKey, HashCacheEntry, HashCacheKeyHash>;
 
+	/// Usage of hash cache textures which can be rebuilt from local memory alone (no palette or mipmaps).
+	/// Persisted per game, so the most used ones can be uploaded again straight after loading a state.
+	struct HashCacheStats
+	{
+		GIFRegTEX0 TEX0;
+		GIFRegTEXA TEXA;
+		SourceRegion region;
+		u32 uses;
+		u32 mem_usage;
+		bool paltex;
+	};
+
+	using HashCacheStatsMap = std::unordered_map<HashCacheKey, HashCacheStats, HashCacheKeyHash>;
+
 	class Surface : public GSAlignedClass<32>
 	{
 	protected:
@@ -255,6 +269,14 @@ public:
 		GSVector4i m_drawn_since_read{};
 		int readbacks_since_draw = 0;
 
+		// Block range the target was filed under in GSTextureCache::TargetPageMap, and m_map iterators for fast erase.
+		// Ranges change all over the place, so lookups refile targets which no longer match.
+		std::array<u16, GS_MAX_PAGES> m_page_erase_it;
+		u32 m_indexed_bp = 0;
+		u32 m_indexed_end_block = 0;
+		bool m_indexed = false;
+		u32 m_lookup_stamp = 0;
+
 	public:
 		Target(GIFRegTEX0 TEX0, int type, const GSVector2i& unscaled_size, float scale, GSTexture* texture);
 		~Target();
@@ -383,6 +405,21 @@ public:
 		void RemoveAt(Source* s);
 	};
 
+	class TargetPageMap
+	{
+	public:
+		std::array<FastList<Target*>, GS_MAX_PAGES> m_map;
+
+		/// Files the target under the pages it covers, moving it if the range has changed.
+		void Update(Target* t);
+		/// Called when the target is destroyed.
+		void RemoveAt(Target* t);
+
+		/// Stamps every target filed under the pages the block range touches.
+		/// Returns the number of targets stamped, which counts targets spanning several pages more than once.
+		u32 Mark(u32 start_bp, u32 end_bp, u32 stamp);
+	};
+
 	struct TargetHeightElem
 	{
 		union
@@ -439,8 +476,13 @@ protected:
 	HashCacheMap m_hash_cache;
 	u64 m_hash_cache_memory_usage = 0;
 	u64 m_hash_cache_replacement_memory_usage = 0;
+	HashCacheStatsMap m_hash_cache_stats;
+	std::string m_hash_cache_stats_filename;
+	bool m_hash_cache_stats_dirty = false;
 
 	FastList<Target*> m_dst[2];
+	mutable TargetPageMap m_dst_pages;
+	mutable u32 m_dst_lookup_stamp = 0;
 	FastList<TargetHeightElem> m_target_heights;
 	u64 m_target_memory_usage = 0;
 
@@ -476,9 +518,15 @@ protected:
 	bool PrepareDownloadTexture(u32 width, u32 height, GSTexture::Format format, std::unique_ptr<GSDownloadTexture>* tex);
 
 	HashCacheEntry* LookupHashCache(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, bool& paltex, const u32* clut, const GSVector2i* lod, SourceRegion region);
+	HashCacheEntry* CreateHashCacheEntry(const HashCacheKey& key, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region, const GSVector2i* lod, bool paltex);
 	HashCacheMap::iterator RemoveFromHashCache(HashCacheMap::iterator it);
 	void AgeHashCache();
 
+	void RecordHashCacheUse(const HashCacheKey& key, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region, bool paltex, u32 mem_usage);
+	void PruneHashCacheStats(size_t max_entries);
+	void LoadHashCacheStats();
+	void SaveHashCacheStats();
+
 	static void PreloadTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region, GSLocalMemory& mem, bool paltex, GSTexture* tex, u32 level, std::pair<u8, u8>* alpha_minmax);
 	static HashType HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region);
 
@@ -553,6 +601,13 @@ public:
 	/// Looks up a target in the cache, and only returns it if the BP/BW match exactly.
 	Target* GetExactTarget(u32 BP, u32 BW, int type, u32 end_bp);
 	Target* GetTargetWithSharedBits(u32 BP, u32 PSM) const;
+	/// Marks the targets which could overlap the block range, for CanSkipTarget().
+	void BeginTargetLookup(u32 start_bp, u32 end_bp) const;
+
+	/// Returns true if the target can't overlap the range given to the last BeginTargetLookup().
+	/// Targets which have moved since they were filed are refiled, and never skipped.
+	bool CanSkipTarget(Target* t) const;
+
 	Target* FindOverlappingTarget(GSTextureCache::Target* target) const;
 	Target* FindOverlappingTarget(u32 BP, u32 end_bp) const;
 	Target* FindOverlappingTarget(u32 BP, u32 BW, u32 PSM, GSVector4i rc) const;
@@ -614,6 +669,12 @@ public:
 
 	/// Injects a texture into the hash cache, by using GSTexture::Swap(), transitively applying to all sources. Ownership of tex is transferred.
 	void InjectHashCacheTexture(const HashCacheKey& key, GSTexture* tex, const std::pair<u8, u8>& alpha_minmax);
+
+	/// Saves the hash cache statistics for the previous game, and loads the ones for the current game.
+	void ReloadHashCacheStats();
+
+	/// Uploads the most used hash cache textures which are still present in local memory. Called after loading a state.
+	void PreloadHashCache();
 };
 
 extern std::unique_ptr<GSTextureCache> g_texture_cache;
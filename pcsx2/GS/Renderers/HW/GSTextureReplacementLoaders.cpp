@@ -7,10 +7,12 @@
 #include "common/Path.h"
 #include "common/StringUtil.h"
 #include "common/ScopedGuard.h"
+#include "common/TextureDecompress.h"
 
 #include "GS/Renderers/HW/GSTextureReplacements.h"
 
 #include <csetjmp>
+#include <limits>
 #include <png.h>
 
 struct LoaderDefinition
@@ -631,3 +633,249 @@ bool DDSLoader(const std::string& filename, GSTextureReplacements::ReplacementTe
 
 	return true;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC3 Compression
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static constexpr u32 BC3_BLOCK_SIZE = 4;
+static constexpr u32 BC3_BLOCK_BYTES = 16;
+
+// Mean squared error per channel of the base level, above this the texture is kept uncompressed.
+// Roughly 36dB PSNR, which keeps gradients and text in UI replacements readable.
+static constexpr double BC3_MAX_MEAN_SQUARED_ERROR = 16.0;
+
+static u16 PackRGB565(s32 r, s32 g, s32 b)
+{
+	return static_cast<u16>((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void UnpackRGB565(u16 color, s32* rgb)
+{
+	// same expansion as the decoder, so index selection sees the colours the GPU will produce
+	u32 temp = (color >> 11) * 255 + 16;
+	rgb[0] = static_cast<s32>((temp / 32 + temp) / 32);
+	temp = ((color & 0x07E0) >> 5) * 255 + 32;
+	rgb[1] = static_cast<s32>((temp / 64 + temp) / 64);
+	temp = (color & 0x001F) * 255 + 16;
+	rgb[2] = static_cast<s32>((temp / 32 + temp) / 32);
+}
+
+/// Compresses 16 RGBA8 pixels to a BC3 block. Endpoints are fit to the bounding box of the block, which is
+/// nowhere near what an offline compressor would produce, but is fast enough to run on a whole pack in the background.
+static void CompressBlockBC3(const u8* pixels, u8* block)
+{
+	s32 amin = 255, amax = 0;
+	s32 cmin[3] = {255, 255, 255};
+	s32 cmax[3] = {0, 0, 0};
+	for (u32 i = 0; i < 16; i++)
+	{
+		const u8* px = &pixels[i * 4];
+		for (u32 c = 0; c < 3; c++)
+		{
+			cmin[c] = std::min<s32>(cmin[c], px[c]);
+			cmax[c] = std::max<s32>(cmax[c], px[c]);
+		}
+		amin = std::min<s32>(amin, px[3]);
+		amax = std::max<s32>(amax, px[3]);
+	}
+
+	// Alpha endpoints are the extents, with the 8 value interpolation mode.
+	s32 apalette[8];
+	apalette[0] = amax;
+	apalette[1] = amin;
+	for (s32 i = 2; i < 8; i++)
+		apalette[i] = ((8 - i) * amax + (i - 1) * amin) / 7;
+
+	u64 aindices = 0;
+	if (amax != amin)
+	{
+		for (u32 i = 0; i < 16; i++)
+		{
+			const s32 a = pixels[i * 4 + 3];
+			u32 best = 0;
+			for (u32 j = 1; j < 8; j++)
+			{
+				if (std::abs(apalette[j] - a) < std::abs(apalette[best] - a))
+					best = j;
+			}
+			aindices |= static_cast<u64>(best) << (i * 3);
+		}
+	}
+
+	// The bounding box diagonal only follows the colours when all channels increase together,
+	// so flip red/blue when they run against green.
+	s32 centre[3];
+	for (u32 c = 0; c < 3; c++)
+		centre[c] = (cmin[c] + cmax[c]) / 2;
+
+	s32 cov_rg = 0, cov_bg = 0;
+	for (u32 i = 0; i < 16; i++)
+	{
+		const u8* px = &pixels[i * 4];
+		const s32 g = px[1] - centre[1];
+		cov_rg += (px[0] - centre[0]) * g;
+		cov_bg += (px[2] - centre[2]) * g;
+	}
+	if (cov_rg < 0)
+		std::swap(cmin[0], cmax[0]);
+	if (cov_bg < 0)
+		std::swap(cmin[2], cmax[2]);
+
+	// Inset the endpoints a little, so they're not spent on the outliers.
+	for (u32 c = 0; c < 3; c++)
+	{
+		const s32 inset = (cmax[c] - cmin[c]) / 16;
+		cmax[c] -= inset;
+		cmin[c] += inset;
+	}
+
+	const u16 color0 = PackRGB565(cmax[0], cmax[1], cmax[2]);
+	const u16 color1 = PackRGB565(cmin[0], cmin[1], cmin[2]);
+
+	s32 cpalette[4][3];
+	UnpackRGB565(color0, cpalette[0]);
+	UnpackRGB565(color1, cpalette[1]);
+	for (u32 c = 0; c < 3; c++)
+	{
+		cpalette[2][c] = (2 * cpalette[0][c] + cpalette[1][c]) / 3;
+		cpalette[3][c] = (cpalette[0][c] + 2 * cpalette[1][c]) / 3;
+	}
+
+	u32 cindices = 0;
+	for (u32 i = 0; i < 16; i++)
+	{
+		const u8* px = &pixels[i * 4];
+		u32 best = 0;
+		s32 best_dist = std::numeric_limits<s32>::max();
+		for (u32 j = 0; j < 4; j++)
+		{
+			const s32 dr = cpalette[j][0] - px[0];
+			const s32 dg = cpalette[j][1] - px[1];
+			const s32 db = cpalette[j][2] - px[2];
+			const s32 dist = dr * dr + dg * dg + db * db;
+			if (dist < best_dist)
+			{
+				best = j;
+				best_dist = dist;
+			}
+		}
+		cindices |= best << (i * 2);
+	}
+
+	block[0] = static_cast<u8>(amax);
+	block[1] = static_cast<u8>(amin);
+	for (u32 i = 0; i < 6; i++)
+		block[2 + i] = static_cast<u8>(aindices >> (i * 8));
+	std::memcpy(&block[8], &color0, sizeof(color0));
+	std::memcpy(&block[10], &color1, sizeof(color1));
+	std::memcpy(&block[12], &cindices, sizeof(cindices));
+}
+
+/// Compresses one level, returning the sum of squared errors against the source after decoding it again.
+static u64 CompressLevelBC3(u32 width, u32 height, const u8* src, u32 src_pitch, std::vector<u8>& data, u32& pitch)
+{
+	const u32 blocks_wide = GetBlockCount(width, BC3_BLOCK_SIZE);
+	const u32 blocks_high = GetBlockCount(height, BC3_BLOCK_SIZE);
+	pitch = blocks_wide * BC3_BLOCK_BYTES;
+	data.resize(pitch * blocks_high);
+
+	u64 error = 0;
+	for (u32 by = 0; by < blocks_high; by++)
+	{
+		u8* block = data.data() + by * pitch;
+		for (u32 bx = 0; bx < blocks_wide; bx++, block += BC3_BLOCK_BYTES)
+		{
+			// small mips are padded by repeating the edge
+			alignas(16) u8 pixels[BC3_BLOCK_SIZE * BC3_BLOCK_SIZE * sizeof(u32)];
+			for (u32 y = 0; y < BC3_BLOCK_SIZE; y++)
+			{
+				const u32 sy = std::min(by * BC3_BLOCK_SIZE + y, height - 1);
+				for (u32 x = 0; x < BC3_BLOCK_SIZE; x++)
+				{
+					const u32 sx = std::min(bx * BC3_BLOCK_SIZE + x, width - 1);
+					std::memcpy(&pixels[(y * BC3_BLOCK_SIZE + x) * sizeof(u32)], src + sy * src_pitch + sx * sizeof(u32), sizeof(u32));
+				}
+			}
+
+			CompressBlockBC3(pixels, block);
+
+			alignas(16) u8 decoded[BC3_BLOCK_SIZE * BC3_BLOCK_SIZE * sizeof(u32)];
+			DecompressBlockBC3(0, 0, sizeof(u32) * BC3_BLOCK_SIZE, block, decoded);
+			for (u32 i = 0; i < sizeof(pixels); i++)
+			{
+				const s32 diff = static_cast<s32>(decoded[i]) - static_cast<s32>(pixels[i]);
+				error += static_cast<u64>(diff * diff);
+			}
+		}
+	}
+
+	return error;
+}
+
+/// 2x2 box filter, the last row/column is repeated for odd sizes.
+static void DownsampleRGBA8(u32 width, u32 height, const u8* src, u32 src_pitch, u32 new_width, u32 new_height, std::vector<u8>& data, u32& pitch)
+{
+	pitch = new_width * sizeof(u32);
+	data.resize(pitch * new_height);
+
+	for (u32 y = 0; y < new_height; y++)
+	{
+		const u8* row0 = src + std::min(y * 2, height - 1) * src_pitch;
+		const u8* row1 = src + std::min(y * 2 + 1, height - 1) * src_pitch;
+		u8* out = data.data() + y * pitch;
+		for (u32 x = 0; x < new_width; x++)
+		{
+			const u32 x0 = std::min(x * 2, width - 1) * sizeof(u32);
+			const u32 x1 = std::min(x * 2 + 1, width - 1) * sizeof(u32);
+			for (u32 c = 0; c < 4; c++)
+				*(out++) = static_cast<u8>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+		}
+	}
+}
+
+bool GSTextureReplacements::CompressReplacementTexture(const ReplacementTexture& rtex, ReplacementTexture* out)
+{
+	// D3D11 requires the base level to be block aligned, same as DDS.
+	if (rtex.format != GSTexture::Format::Color || (rtex.width % BC3_BLOCK_SIZE) != 0 || (rtex.height % BC3_BLOCK_SIZE) != 0)
+		return false;
+
+	out->width = rtex.width;
+	out->height = rtex.height;
+	out->format = GSTexture::Format::BC3;
+	out->alpha_minmax = rtex.alpha_minmax;
+	out->mips.clear();
+
+	const u64 error = CompressLevelBC3(rtex.width, rtex.height, rtex.data.data(), rtex.pitch, out->data, out->pitch);
+	const double mse = static_cast<double>(error) / (static_cast<double>(rtex.width) * rtex.height * 4);
+	if (mse > BC3_MAX_MEAN_SQUARED_ERROR)
+	{
+		DevCon.WriteLn("Not compressing %ux%u replacement, error %.2f is too high.", rtex.width, rtex.height, mse);
+		return false;
+	}
+
+	// Generate the rest of the chain from the uncompressed image, so the error doesn't compound.
+	std::vector<u8> prev_data;
+	std::vector<u8> level_data;
+	const u8* prev = rtex.data.data();
+	u32 prev_pitch = rtex.pitch;
+	const u32 levels = CalcMipmapLevelsForReplacement(rtex.width, rtex.height);
+	for (u32 level = 1; level < levels; level++)
+	{
+		ReplacementTexture::MipData md;
+		md.width = std::max<u32>(rtex.width >> level, 1u);
+		md.height = std::max<u32>(rtex.height >> level, 1u);
+
+		u32 level_pitch;
+		DownsampleRGBA8(std::max<u32>(rtex.width >> (level - 1), 1u), std::max<u32>(rtex.height >> (level - 1), 1u),
+			prev, prev_pitch, md.width, md.height, level_data, level_pitch);
+		CompressLevelBC3(md.width, md.height, level_data.data(), level_pitch, md.data, md.pitch);
+		out->mips.push_back(std::move(md));
+
+		prev_data.swap(level_data);
+		prev = prev_data.data();
+		prev_pitch = level_pitch;
+	}
+
+	return true;
+}
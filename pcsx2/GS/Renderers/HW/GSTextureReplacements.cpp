@@ -3,12 +3,15 @@
 
 #include "common/AlignedMalloc.h"
 #include "common/Console.h"
+#include "common/Error.h"
 #include "common/HashCombine.h"
 #include "common/FileSystem.h"
 #include "common/Path.h"
 #include "common/StringUtil.h"
 #include "common/ScopedGuard.h"
 #include "common/TextureDecompress.h"
+#include "common/Threading.h"
+#include "common/Timer.h"
 
 #include "Config.h"
 #include "Host.h"
@@ -18,6 +21,8 @@
 #include "GS/Renderers/HW/GSTextureReplacements.h"
 #include "VMManager.h"
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <condition_variable>
 #include <cstring>
@@ -38,6 +43,8 @@
 #define TEXTURE_FILENAME_OLD_REGION_CLUT_FORMAT_STRING "%" PRIx64 "-%" PRIx64 "-r%" PRIx64 "-%08x"
 #define TEXTURE_REPLACEMENT_SUBDIRECTORY_NAME "replacements"
 #define TEXTURE_DUMP_SUBDIRECTORY_NAME "dumps"
+#define TEXTURE_USAGE_SUBDIRECTORY_NAME "texture_usage"
+#define TEXTURE_COMPRESSED_SUBDIRECTORY_NAME "replacement_cache"
 
 namespace
 {
@@ -100,6 +107,68 @@ namespace std
 
 namespace GSTextureReplacements
 {
+	/// Work is picked up in this order, so draws waiting on a texture never queue behind dumps or precaching.
+	enum class WorkerPriority : u8
+	{
+		Load,
+		Dump,
+		Precache,
+		Compress,
+		Count
+	};
+
+	struct CachedReplacementTexture
+	{
+		ReplacementTexture rtex;
+		size_t size;
+		u64 last_used;
+	};
+
+	struct UsageFileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 num_entries;
+	};
+
+	struct UsageFileEntry
+	{
+		TextureName name;
+		u32 count;
+		u32 pad;
+	};
+	static_assert(sizeof(UsageFileEntry) == 40);
+
+	struct CompressedFileHeader
+	{
+		u32 magic;
+		u32 version;
+		s64 source_size;
+		s64 source_mtime;
+		u32 width;
+		u32 height;
+		u32 format;
+		u32 num_levels; // zero when the source can't be compressed
+		u8 alpha_min;
+		u8 alpha_max;
+		u8 pad[6];
+	};
+	static_assert(sizeof(CompressedFileHeader) == 48);
+
+	struct CompressedFileLevel
+	{
+		u32 width;
+		u32 height;
+		u32 pitch;
+		u32 size;
+	};
+
+	static constexpr u32 USAGE_FILE_MAGIC = 0x55525850; // PXRU
+	static constexpr u32 USAGE_FILE_VERSION = 1;
+	static constexpr u32 COMPRESSED_FILE_MAGIC = 0x43525850; // PXRC
+	static constexpr u32 COMPRESSED_FILE_VERSION = 1;
+	static constexpr u32 MAX_WORKER_THREADS = 4;
+
 	static TextureName CreateTextureName(const GSTextureCache::HashCacheKey& hash, u32 miplevel);
 	static GSTextureCache::HashCacheKey HashCacheKeyFromTextureName(const TextureName& tn);
 	static std::optional<TextureName> ParseReplacementName(const std::string& filename);
@@ -112,11 +181,25 @@ namespace GSTextureReplacements
 	static void QueueAsyncReplacementTextureLoad(const TextureName& name, const std::string& filename, bool mipmap, bool cache_only);
 	static void PrecacheReplacementTextures();
 	static void ClearReplacementTextures();
+	static const CachedReplacementTexture& InsertIntoCache(const TextureName& name, ReplacementTexture rtex);
+	static size_t GetCacheBudget();
+	static void EvictReplacementTextures(size_t budget);
+
+	static std::string GetUsageFilename();
+	static void LoadUsageCounts();
+	static void SaveUsageCounts();
+
+	static std::string GetCompressedFilename(const std::string& filename);
+	static bool LoadCompressedReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd, ReplacementTexture* rtex, bool* uncompressible);
+	static void QueueCompressReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd);
+	static void CompressAndSaveReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd, const ReplacementTexture& rtex);
+	static void CancelPendingCompressions();
 
 	static void StartWorkerThread();
 	static void StopWorkerThread();
-	static void QueueWorkerThreadItem(std::function<void()> fn, bool high_priority);
-	static void WorkerThreadEntryPoint();
+	static void QueueWorkerThreadItem(std::function<void()> fn, WorkerPriority priority);
+	static bool HasWorkerThreadItems();
+	static void WorkerThreadEntryPoint(u32 index);
 	static void SyncWorkerThread();
 	static void CancelPendingLoadsAndDumps();
 
@@ -133,8 +216,26 @@ namespace GSTextureReplacements
 	static std::unordered_set<TextureName> s_replacement_textures_without_clut_hash;
 
 	/// Lookup map of texture names to replacement data which has been cached.
-	static std::unordered_map<TextureName, ReplacementTexture> s_replacement_texture_cache;
+	static std::unordered_map<TextureName, CachedReplacementTexture> s_replacement_texture_cache;
 	static std::mutex s_replacement_texture_cache_mutex;
+	static size_t s_replacement_texture_cache_size = 0;
+	static u64 s_replacement_texture_cache_counter = 0;
+
+	/// Number of times each replacement has been requested, kept across sessions to order precaching.
+	static std::unordered_map<TextureName, u32> s_usage_counts;
+	static std::string s_usage_filename;
+	static bool s_usage_counts_dirty = false;
+
+	/// Where BC3 transcodes of PNG replacements are kept, empty when compression is off or unsupported.
+	/// Only changed while the workers are idle.
+	static std::string s_compressed_cache_directory;
+
+	/// Replacement directory the transcodes are named relative to, so subdirectories keep separate entries.
+	static std::string s_compressed_source_directory;
+
+	/// Source filenames with a transcode queued, so reloading an evicted texture doesn't compress it twice.
+	static std::unordered_set<std::string> s_pending_compressions;
+	static std::mutex s_pending_compressions_mutex;
 
 	/// List of textures that are pending asynchronous load. Second element is whether we're only precaching.
 	static std::unordered_map<TextureName, bool> s_pending_async_load_textures;
@@ -143,11 +244,13 @@ namespace GSTextureReplacements
 	/// Second element is whether the texture should be created with mipmaps.
 	static std::vector<std::pair<TextureName, bool>> s_async_loaded_textures;
 
-	/// Loader/dumper thread.
-	static std::thread s_worker_thread;
+	/// Loader/dumper threads.
+	static std::vector<std::thread> s_worker_threads;
 	static std::mutex s_worker_thread_mutex;
 	static std::condition_variable s_worker_thread_cv;
-	static std::deque<std::pair<std::function<void()>, bool>> s_worker_thread_queue;
+	static std::condition_variable s_worker_thread_idle_cv;
+	static std::array<std::deque<std::function<void()>>, static_cast<size_t>(WorkerPriority::Count)> s_worker_thread_queues;
+	static u32 s_worker_threads_busy = 0;
 	static bool s_worker_thread_running = false;
 }; // namespace GSTextureReplacements
 
@@ -375,15 +478,23 @@ static bool GetWrongCasePath(std::string* output, const char* dir, std::string_v
 
 void GSTextureReplacements::ReloadReplacementMap()
 {
+	// transcodes are picked up again the next time the texture is loaded, don't hold up the game change for them
+	CancelPendingCompressions();
 	SyncWorkerThread();
+	SaveUsageCounts();
 
 	// clear out the caches
 	{
 		s_replacement_texture_filenames.clear();
 		s_replacement_textures_without_clut_hash.clear();
+		s_usage_counts.clear();
+		s_usage_filename.clear();
+		s_compressed_cache_directory.clear();
+		s_compressed_source_directory.clear();
 
 		std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
 		s_replacement_texture_cache.clear();
+		s_replacement_texture_cache_size = 0;
 		s_pending_async_load_textures.clear();
 		s_async_loaded_textures.clear();
 	}
@@ -439,6 +550,17 @@ void GSTextureReplacements::ReloadReplacementMap()
 
 	if (!s_replacement_texture_filenames.empty())
 	{
+		s_usage_filename = GetUsageFilename();
+		LoadUsageCounts();
+
+		// only worth it when the GPU can sample BC3 directly
+		if (GSConfig.CompressTextureReplacements && g_gs_device && g_gs_device->Features().dxt_textures)
+		{
+			s_compressed_cache_directory = Path::Combine(Path::Combine(EmuFolders::Cache, TEXTURE_COMPRESSED_SUBDIRECTORY_NAME),
+				s_current_serial);
+			s_compressed_source_directory = replacement_dir;
+		}
+
 		if (GSConfig.PrecacheTextureReplacements)
 			PrecacheReplacementTextures();
 
@@ -465,8 +587,11 @@ void GSTextureReplacements::UpdateConfig(Pcsx2Config::GSOptions& old_config)
 		CancelPendingLoadsAndDumps();
 	}
 
-	if (GSConfig.LoadTextureReplacements && !old_config.LoadTextureReplacements)
+	if (GSConfig.LoadTextureReplacements && (!old_config.LoadTextureReplacements ||
+												GSConfig.CompressTextureReplacements != old_config.CompressTextureReplacements))
+	{
 		ReloadReplacementMap();
+	}
 	else if (!GSConfig.LoadTextureReplacements && old_config.LoadTextureReplacements)
 		ClearReplacementTextures();
 
@@ -475,11 +600,18 @@ void GSTextureReplacements::UpdateConfig(Pcsx2Config::GSOptions& old_config)
 
 	if (GSConfig.LoadTextureReplacements && GSConfig.PrecacheTextureReplacements && !old_config.PrecacheTextureReplacements)
 		PrecacheReplacementTextures();
+
+	if (GSConfig.TextureReplacementCacheSize != old_config.TextureReplacementCacheSize)
+	{
+		std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
+		EvictReplacementTextures(GetCacheBudget());
+	}
 }
 
 void GSTextureReplacements::Shutdown()
 {
 	StopWorkerThread();
+	SaveUsageCounts();
 
 	std::string().swap(s_current_serial);
 	ClearReplacementTextures();
@@ -513,6 +645,10 @@ GSTexture* GSTextureReplacements::LookupReplacementTexture(const GSTextureCache:
 	if (fnit == s_replacement_texture_filenames.end())
 		return nullptr;
 
+	u32& usage = s_usage_counts[name];
+	usage += (usage != std::numeric_limits<u32>::max());
+	s_usage_counts_dirty = true;
+
 	// try the full cache first, to avoid reloading from disk
 	{
 		std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
@@ -520,8 +656,9 @@ GSTexture* GSTextureReplacements::LookupReplacementTexture(const GSTextureCache:
 		if (it != s_replacement_texture_cache.end())
 		{
 			// replacement is cached, can immediately upload to host GPU
-			*alpha_minmax = it->second.alpha_minmax;
-			return CreateReplacementTexture(it->second, mipmap);
+			it->second.last_used = ++s_replacement_texture_cache_counter;
+			*alpha_minmax = it->second.rtex.alpha_minmax;
+			return CreateReplacementTexture(it->second.rtex, mipmap);
 		}
 	}
 
@@ -544,11 +681,11 @@ GSTexture* GSTextureReplacements::LookupReplacementTexture(const GSTextureCache:
 
 		// insert into cache
 		std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
-		const ReplacementTexture& rtex = s_replacement_texture_cache.emplace(name, std::move(replacement.value())).first->second;
+		const CachedReplacementTexture& ctex = InsertIntoCache(name, std::move(replacement.value()));
 
 		// and upload to gpu
-		*alpha_minmax = rtex.alpha_minmax;
-		return CreateReplacementTexture(rtex, mipmap);
+		*alpha_minmax = ctex.rtex.alpha_minmax;
+		return CreateReplacementTexture(ctex.rtex, mipmap);
 	}
 }
 
@@ -635,7 +772,17 @@ std::optional<GSTextureReplacements::ReplacementTexture> GSTextureReplacements::
 	if (!loader)
 		return std::nullopt;
 
+	// DDS files are already in the format the author wanted
+	FILESYSTEM_STAT_DATA sd;
+	const bool compress = (!s_compressed_cache_directory.empty() &&
+						   !StringUtil::compareNoCase(Path::GetExtension(filename), "dds") &&
+						   FileSystem::StatFile(filename.c_str(), &sd));
+
 	ReplacementTexture rtex;
+	bool uncompressible = false;
+	if (compress && LoadCompressedReplacementTexture(filename, sd, &rtex, &uncompressible))
+		return rtex;
+
 	if (!loader(filename.c_str(), &rtex, only_base_image))
 	{
 		Console.Warning("Failed to load replacement texture %s", filename.c_str());
@@ -644,6 +791,10 @@ std::optional<GSTextureReplacements::ReplacementTexture> GSTextureReplacements::
 
 	SetReplacementTextureAlphaMinMax(rtex);
 
+	// this load stays uncompressed, the next one will come from the cache
+	if (compress && !uncompressible && rtex.format == GSTexture::Format::Color)
+		QueueCompressReplacementTexture(filename, sd);
+
 	return rtex;
 }
 
@@ -666,7 +817,23 @@ void GSTextureReplacements::QueueAsyncReplacementTextureLoad(const TextureName&
 	}
 
 	s_pending_async_load_textures.emplace(name, cache_only);
-	QueueWorkerThreadItem([name, filename, mipmap]() {
+	QueueWorkerThreadItem([name, filename, mipmap, cache_only]() {
+		// once the budget is full, the rest of the precache list is used less than what's already loaded
+		if (cache_only)
+		{
+			std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
+			const size_t budget = GetCacheBudget();
+			if (budget != 0 && s_replacement_texture_cache_size >= budget)
+			{
+				auto it = s_pending_async_load_textures.find(name);
+				if (it != s_pending_async_load_textures.end() && it->second)
+				{
+					s_pending_async_load_textures.erase(it);
+					return;
+				}
+			}
+		}
+
 		// actually load the file, this is what will take the time
 		std::optional<ReplacementTexture> replacement(LoadReplacementTexture(name, filename, !mipmap));
 
@@ -686,7 +853,7 @@ void GSTextureReplacements::QueueAsyncReplacementTextureLoad(const TextureName&
 		// insert into the cache and queue for later injection
 		if (replacement.has_value())
 		{
-			s_replacement_texture_cache.emplace(name, std::move(replacement.value()));
+			InsertIntoCache(name, std::move(replacement.value()));
 			s_async_loaded_textures.emplace_back(name, mipmap);
 		}
 		else
@@ -694,7 +861,7 @@ void GSTextureReplacements::QueueAsyncReplacementTextureLoad(const TextureName&
 			// loading failed, so clear it from the pending list
 			s_pending_async_load_textures.erase(name);
 		}
-	}, !cache_only);
+	}, cache_only ? WorkerPriority::Precache : WorkerPriority::Load);
 }
 
 void GSTextureReplacements::PrecacheReplacementTextures()
@@ -705,15 +872,22 @@ void GSTextureReplacements::PrecacheReplacementTextures()
 	// TODO: This will be wrong for hw mipmap games like Jak.
 	const bool mipmap = GSConfig.HWMipmap || GSConfig.TriFilter == TriFiltering::Forced;
 
-	// pretty simple, just go through the filenames and if any aren't cached, cache them
-	for (const auto& it : s_replacement_texture_filenames)
+	// go through the filenames and if any aren't cached, cache them, most used in previous sessions first
+	std::vector<std::pair<u32, decltype(s_replacement_texture_filenames)::const_iterator>> order;
+	order.reserve(s_replacement_texture_filenames.size());
+	for (auto it = s_replacement_texture_filenames.begin(); it != s_replacement_texture_filenames.end(); ++it)
 	{
-		if (s_replacement_texture_cache.find(it.first) != s_replacement_texture_cache.end())
+		if (s_replacement_texture_cache.find(it->first) != s_replacement_texture_cache.end())
 			continue;
 
-		// precaching always goes async.. for now
-		QueueAsyncReplacementTextureLoad(it.first, it.second, mipmap, true);
+		const auto uit = s_usage_counts.find(it->first);
+		order.emplace_back((uit != s_usage_counts.end()) ? uit->second : 0u, it);
 	}
+	std::stable_sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+	// precaching always goes async.. for now
+	for (const auto& [usage, it] : order)
+		QueueAsyncReplacementTextureLoad(it->first, it->second, mipmap, true);
 }
 
 void GSTextureReplacements::ClearReplacementTextures()
@@ -723,10 +897,299 @@ void GSTextureReplacements::ClearReplacementTextures()
 
 	std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
 	s_replacement_texture_cache.clear();
+	s_replacement_texture_cache_size = 0;
 	s_pending_async_load_textures.clear();
 	s_async_loaded_textures.clear();
 }
 
+const GSTextureReplacements::CachedReplacementTexture& GSTextureReplacements::InsertIntoCache(const TextureName& name, ReplacementTexture rtex)
+{
+	size_t size = rtex.data.size();
+	for (const ReplacementTexture::MipData& mip : rtex.mips)
+		size += mip.data.size();
+
+	// make room first, so we don't throw out what we're about to return
+	const size_t budget = GetCacheBudget();
+	if (budget != 0)
+		EvictReplacementTextures((size < budget) ? (budget - size) : 0);
+
+	const auto [it, inserted] = s_replacement_texture_cache.emplace(name, CachedReplacementTexture{std::move(rtex), size, ++s_replacement_texture_cache_counter});
+	if (inserted)
+		s_replacement_texture_cache_size += size;
+
+	return it->second;
+}
+
+size_t GSTextureReplacements::GetCacheBudget()
+{
+	return static_cast<size_t>(GSConfig.TextureReplacementCacheSize) * _1mb;
+}
+
+void GSTextureReplacements::EvictReplacementTextures(size_t budget)
+{
+	if (GSConfig.TextureReplacementCacheSize == 0 || s_replacement_texture_cache_size <= budget)
+		return;
+
+	// least recently used first, but leave anything that's still waiting to be injected into the TC
+	std::vector<std::pair<u64, TextureName>> candidates;
+	candidates.reserve(s_replacement_texture_cache.size());
+	for (const auto& [name, ctex] : s_replacement_texture_cache)
+	{
+		if (s_pending_async_load_textures.find(name) == s_pending_async_load_textures.end())
+			candidates.emplace_back(ctex.last_used, name);
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+	u32 evicted = 0;
+	for (const auto& [last_used, name] : candidates)
+	{
+		if (s_replacement_texture_cache_size <= budget)
+			break;
+
+		auto it = s_replacement_texture_cache.find(name);
+		s_replacement_texture_cache_size -= it->second.size;
+		s_replacement_texture_cache.erase(it);
+		evicted++;
+	}
+
+	DbgCon.WriteLn("Evicted %u replacement textures, %zu KB cached.", evicted, s_replacement_texture_cache_size / 1024);
+}
+
+std::string GSTextureReplacements::GetUsageFilename()
+{
+	return Path::Combine(Path::Combine(EmuFolders::Cache, TEXTURE_USAGE_SUBDIRECTORY_NAME), fmt::format("{}.bin", s_current_serial));
+}
+
+void GSTextureReplacements::LoadUsageCounts()
+{
+	s_usage_counts_dirty = false;
+
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(s_usage_filename.c_str());
+	if (!data.has_value() || data->size() < sizeof(UsageFileHeader))
+		return;
+
+	UsageFileHeader header;
+	std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != USAGE_FILE_MAGIC || header.version != USAGE_FILE_VERSION ||
+		data->size() != (sizeof(header) + static_cast<size_t>(header.num_entries) * sizeof(UsageFileEntry)))
+	{
+		Console.Warning(fmt::format("Ignoring invalid texture usage file '{}'.", Path::GetFileName(s_usage_filename)));
+		return;
+	}
+
+	s_usage_counts.reserve(header.num_entries);
+	for (u32 i = 0; i < header.num_entries; i++)
+	{
+		UsageFileEntry entry;
+		std::memcpy(&entry, data->data() + sizeof(header) + i * sizeof(UsageFileEntry), sizeof(entry));
+		s_usage_counts.emplace(entry.name, entry.count);
+	}
+
+	DevCon.WriteLn("Loaded usage counts for %u replacement textures.", header.num_entries);
+}
+
+void GSTextureReplacements::SaveUsageCounts()
+{
+	if (!s_usage_counts_dirty || s_usage_filename.empty())
+		return;
+
+	s_usage_counts_dirty = false;
+
+	const UsageFileHeader header = {USAGE_FILE_MAGIC, USAGE_FILE_VERSION, static_cast<u32>(s_usage_counts.size())};
+	std::vector<u8> data(sizeof(header) + s_usage_counts.size() * sizeof(UsageFileEntry));
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	u8* ptr = data.data() + sizeof(header);
+	for (const auto& [name, count] : s_usage_counts)
+	{
+		const UsageFileEntry entry = {name, count, 0};
+		std::memcpy(ptr, &entry, sizeof(entry));
+		ptr += sizeof(entry);
+	}
+
+	Error error;
+	if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(s_usage_filename)).c_str(), false, &error) ||
+		!FileSystem::WriteBinaryFile(s_usage_filename.c_str(), data.data(), data.size()))
+	{
+		Console.Error(fmt::format("Failed to save texture usage to '{}': {}", s_usage_filename, error.GetDescription()));
+	}
+}
+
+std::string GSTextureReplacements::GetCompressedFilename(const std::string& filename)
+{
+	return Path::Combine(s_compressed_cache_directory,
+		fmt::format("{}.bin", Path::MakeRelative(filename, s_compressed_source_directory)));
+}
+
+bool GSTextureReplacements::LoadCompressedReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd,
+	ReplacementTexture* rtex, bool* uncompressible)
+{
+	const std::string cache_filename = GetCompressedFilename(filename);
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(cache_filename.c_str());
+	if (!data.has_value() || data->size() < sizeof(CompressedFileHeader))
+		return false;
+
+	// stale entries get overwritten when the new source has been compressed
+	CompressedFileHeader header;
+	std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != COMPRESSED_FILE_MAGIC || header.version != COMPRESSED_FILE_VERSION ||
+		header.source_size != sd.Size || header.source_mtime != static_cast<s64>(sd.ModificationTime))
+	{
+		return false;
+	}
+
+	if (header.num_levels == 0)
+	{
+		*uncompressible = true;
+		return false;
+	}
+
+	// Anything we didn't write ourselves gets thrown away and transcoded again, rather than
+	// trusting the level sizes enough to hand them to the device.
+	const auto discard = [&cache_filename, rtex](const char* reason) {
+		Console.Warning(fmt::format("Discarding {} compressed replacement '{}'.", reason, Path::GetFileName(cache_filename)));
+		FileSystem::DeleteFilePath(cache_filename.c_str());
+		rtex->mips.clear();
+		return false;
+	};
+
+	const GSTexture::Format format = static_cast<GSTexture::Format>(header.format);
+	if (format != GSTexture::Format::BC3 && format != GSTexture::Format::Color)
+		return discard("unsupported");
+	if (header.num_levels > CalcMipmapLevelsForReplacement(header.width, header.height))
+		return discard("invalid");
+
+	rtex->width = header.width;
+	rtex->height = header.height;
+	rtex->format = format;
+	rtex->alpha_minmax = std::make_pair(header.alpha_min, header.alpha_max);
+	rtex->mips.clear();
+
+	// Mips are always kept, since cache entries are shared between mipmapped and non-mipmapped lookups,
+	// and a compressed texture can't have them generated later.
+	size_t offset = sizeof(header);
+	for (u32 level = 0; level < header.num_levels; level++)
+	{
+		CompressedFileLevel lh;
+		if ((data->size() - offset) < sizeof(lh))
+			return discard("truncated");
+
+		std::memcpy(&lh, data->data() + offset, sizeof(lh));
+		offset += sizeof(lh);
+		if ((data->size() - offset) < lh.size)
+			return discard("truncated");
+
+		if (lh.width != std::max(header.width >> level, 1u) || lh.height != std::max(header.height >> level, 1u))
+			return discard("mismatched");
+
+		if (format == GSTexture::Format::BC3)
+		{
+			if (lh.pitch != ((lh.width + 3) / 4) * 16 ||
+				lh.size != static_cast<u64>(lh.pitch) * ((lh.height + 3) / 4))
+			{
+				return discard("invalid");
+			}
+		}
+		else if (lh.pitch < lh.width * sizeof(u32) || static_cast<u64>(lh.pitch) * lh.height > lh.size)
+		{
+			return discard("invalid");
+		}
+
+		std::vector<u8> level_data(data->begin() + offset, data->begin() + offset + lh.size);
+		offset += lh.size;
+
+		if (level == 0)
+		{
+			rtex->pitch = lh.pitch;
+			rtex->data = std::move(level_data);
+		}
+		else
+		{
+			rtex->mips.push_back(ReplacementTexture::MipData{lh.width, lh.height, lh.pitch, std::move(level_data)});
+		}
+	}
+
+	if (offset != data->size())
+		return discard("truncated");
+
+	return true;
+}
+
+void GSTextureReplacements::QueueCompressReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd)
+{
+	{
+		std::unique_lock<std::mutex> lock(s_pending_compressions_mutex);
+		if (!s_pending_compressions.insert(filename).second)
+			return;
+	}
+
+	// Decoded again when the job runs, holding on to the image would keep a second copy of every
+	// texture loaded during precaching until the compress queue gets to it.
+	QueueWorkerThreadItem([filename, sd]() {
+		const ReplacementTextureLoader loader = GetLoader(filename);
+		ReplacementTexture rtex;
+		if (loader && loader(filename.c_str(), &rtex, true) && rtex.format == GSTexture::Format::Color)
+		{
+			SetReplacementTextureAlphaMinMax(rtex);
+			CompressAndSaveReplacementTexture(filename, sd, rtex);
+		}
+
+		std::unique_lock<std::mutex> lock(s_pending_compressions_mutex);
+		s_pending_compressions.erase(filename);
+	}, WorkerPriority::Compress);
+}
+
+void GSTextureReplacements::CompressAndSaveReplacementTexture(const std::string& filename, const FILESYSTEM_STAT_DATA& sd,
+	const ReplacementTexture& rtex)
+{
+	Common::Timer timer;
+
+	// failures still get an entry, so we don't try again every boot
+	ReplacementTexture ctex;
+	const bool compressed = CompressReplacementTexture(rtex, &ctex);
+
+	CompressedFileHeader header = {};
+	header.magic = COMPRESSED_FILE_MAGIC;
+	header.version = COMPRESSED_FILE_VERSION;
+	header.source_size = sd.Size;
+	header.source_mtime = static_cast<s64>(sd.ModificationTime);
+	header.width = rtex.width;
+	header.height = rtex.height;
+	header.format = static_cast<u32>(compressed ? ctex.format : rtex.format);
+	header.num_levels = compressed ? static_cast<u32>(ctex.mips.size() + 1) : 0;
+	header.alpha_min = rtex.alpha_minmax.first;
+	header.alpha_max = rtex.alpha_minmax.second;
+
+	std::vector<u8> data(sizeof(header));
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	const auto append_level = [&data](u32 width, u32 height, u32 pitch, const std::vector<u8>& level_data) {
+		const CompressedFileLevel lh = {width, height, pitch, static_cast<u32>(level_data.size())};
+		const size_t offset = data.size();
+		data.resize(offset + sizeof(lh) + level_data.size());
+		std::memcpy(data.data() + offset, &lh, sizeof(lh));
+		std::memcpy(data.data() + offset + sizeof(lh), level_data.data(), level_data.size());
+	};
+	if (compressed)
+	{
+		append_level(ctex.width, ctex.height, ctex.pitch, ctex.data);
+		for (const ReplacementTexture::MipData& mip : ctex.mips)
+			append_level(mip.width, mip.height, mip.pitch, mip.data);
+	}
+
+	const std::string cache_filename = GetCompressedFilename(filename);
+	Error error;
+	if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(cache_filename)).c_str(), true, &error) ||
+		!FileSystem::WriteBinaryFile(cache_filename.c_str(), data.data(), data.size()))
+	{
+		Console.Error(fmt::format("Failed to save compressed replacement to '{}': {}", cache_filename, error.GetDescription()));
+		return;
+	}
+
+	DbgCon.WriteLn("Compressed %ux%u replacement '%s' in %.2f ms (%zu KB).", rtex.width, rtex.height,
+		Path::GetFileName(filename).data(), timer.GetTimeMilliseconds(), data.size() / 1024);
+}
+
 GSTexture* GSTextureReplacements::CreateReplacementTexture(const ReplacementTexture& rtex, bool mipmap)
 {
 	// can't use generated mipmaps with compressed formats, because they can't be rendered to
@@ -791,9 +1254,9 @@ void GSTextureReplacements::ProcessAsyncLoadedTextures()
 			continue;
 
 		// upload and inject into TC
-		GSTexture* tex = CreateReplacementTexture(it->second, mipmap);
+		GSTexture* tex = CreateReplacementTexture(it->second.rtex, mipmap);
 		if (tex)
-			g_texture_cache->InjectHashCacheTexture(HashCacheKeyFromTextureName(name), tex, it->second.alpha_minmax);
+			g_texture_cache->InjectHashCacheTexture(HashCacheKeyFromTextureName(name), tex, it->second.rtex.alpha_minmax);
 	}
 	s_async_loaded_textures.clear();
 }
@@ -841,7 +1304,7 @@ void GSTextureReplacements::DumpTexture(const GSTextureCache::HashCacheKey& hash
 		if (!SavePNGImage(filename.c_str(), tw, th, buffer + buffer_offset, pitch))
 			Console.Error(fmt::format("Failed to dump texture to '{}'.", filename));
 		_aligned_free(buffer);
-	}, false);
+	}, WorkerPriority::Dump);
 }
 
 void GSTextureReplacements::ClearDumpedTextureList()
@@ -870,110 +1333,103 @@ void GSTextureReplacements::StartWorkerThread()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
 
-	if (s_worker_thread.joinable())
+	if (!s_worker_threads.empty())
 		return;
 
+	// decoding big packs is mostly bound by png/dds decompression, so spread it out, but leave room for the emulator
+	const u32 num_threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_WORKER_THREADS);
 	s_worker_thread_running = true;
-	s_worker_thread = std::thread(WorkerThreadEntryPoint);
+	for (u32 i = 0; i < num_threads; i++)
+		s_worker_threads.emplace_back(WorkerThreadEntryPoint, i);
 }
 
 void GSTextureReplacements::StopWorkerThread()
 {
 	{
 		std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-		if (!s_worker_thread.joinable())
+		if (s_worker_threads.empty())
 			return;
 
 		s_worker_thread_running = false;
-		s_worker_thread_cv.notify_one();
+		s_worker_thread_cv.notify_all();
 	}
 
-	s_worker_thread.join();
+	for (std::thread& thread : s_worker_threads)
+		thread.join();
+	s_worker_threads.clear();
 
 	// clear out workery-things too
 	CancelPendingLoadsAndDumps();
 }
 
-void GSTextureReplacements::QueueWorkerThreadItem(std::function<void()> fn, bool high_priority)
+void GSTextureReplacements::QueueWorkerThreadItem(std::function<void()> fn, WorkerPriority priority)
 {
-	pxAssert(s_worker_thread.joinable());
+	pxAssert(!s_worker_threads.empty());
 
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	if (!high_priority)
-	{
-		// Low priority => throw on end.
-		s_worker_thread_queue.emplace_back(std::move(fn), false);
-	}
-	else
-	{
-		auto iter = s_worker_thread_queue.rbegin();
-		for (; iter != s_worker_thread_queue.rend(); ++iter)
-		{
-			// Found our first high priority item?
-			if (iter->second)
-			{
-				// Insert after here!
-				break;
-			}
-		}
-
-		if (iter != s_worker_thread_queue.rend())
-		{
-			// Insert after the last high priority item. Remember base() points to the next element.
-			s_worker_thread_queue.insert(iter.base(), std::make_pair(std::move(fn), true));
-		}
-		else
-		{
-			// All low-priority => insert at beginning.
-			s_worker_thread_queue.emplace_front(std::move(fn), true);
-		}
-	}
-
+	s_worker_thread_queues[static_cast<size_t>(priority)].push_back(std::move(fn));
 	s_worker_thread_cv.notify_one();
 }
 
-void GSTextureReplacements::WorkerThreadEntryPoint()
+bool GSTextureReplacements::HasWorkerThreadItems()
+{
+	return std::any_of(s_worker_thread_queues.begin(), s_worker_thread_queues.end(), [](const auto& queue) { return !queue.empty(); });
+}
+
+void GSTextureReplacements::WorkerThreadEntryPoint(u32 index)
 {
+	Threading::SetNameOfCurrentThread(fmt::format("Texture Replacement Worker {}", index).c_str());
+
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	while (s_worker_thread_running)
+	for (;;)
 	{
-		if (s_worker_thread_queue.empty())
-		{
-			s_worker_thread_cv.wait(lock);
-			continue;
-		}
+		s_worker_thread_cv.wait(lock, []() { return !s_worker_thread_running || HasWorkerThreadItems(); });
+		if (!s_worker_thread_running)
+			break;
+
+		auto queue = std::find_if(s_worker_thread_queues.begin(), s_worker_thread_queues.end(), [](const auto& queue) { return !queue.empty(); });
+		std::function<void()> fn = std::move(queue->front());
+		queue->pop_front();
+		s_worker_threads_busy++;
 
-		std::function<void()> fn = std::move(s_worker_thread_queue.front().first);
-		s_worker_thread_queue.pop_front();
 		lock.unlock();
 		fn();
 		lock.lock();
+
+		s_worker_threads_busy--;
+		if (s_worker_threads_busy == 0 && !HasWorkerThreadItems())
+			s_worker_thread_idle_cv.notify_all();
 	}
 }
 
 void GSTextureReplacements::SyncWorkerThread()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	if (!s_worker_thread.joinable())
+	if (s_worker_threads.empty())
 		return;
 
-	// not the most efficient by far, but it only gets called on config changes, so whatever
-	for (;;)
-	{
-		if (s_worker_thread_queue.empty())
-			break;
-
-		lock.unlock();
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		lock.lock();
-	}
+	s_worker_thread_idle_cv.wait(lock, []() { return (s_worker_threads_busy == 0 && !HasWorkerThreadItems()); });
 }
 
 void GSTextureReplacements::CancelPendingLoadsAndDumps()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	while (!s_worker_thread_queue.empty())
-		s_worker_thread_queue.pop_back();
+	for (auto& queue : s_worker_thread_queues)
+		queue.clear();
 	s_async_loaded_textures.clear();
 	s_pending_async_load_textures.clear();
+
+	std::unique_lock<std::mutex> compress_lock(s_pending_compressions_mutex);
+	s_pending_compressions.clear();
+}
+
+void GSTextureReplacements::CancelPendingCompressions()
+{
+	{
+		std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
+		s_worker_thread_queues[static_cast<size_t>(WorkerPriority::Compress)].clear();
+	}
+
+	std::unique_lock<std::mutex> lock(s_pending_compressions_mutex);
+	s_pending_compressions.clear();
 }
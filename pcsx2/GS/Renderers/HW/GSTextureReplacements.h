@@ -57,6 +57,10 @@ namespace GSTextureReplacements
 	using ReplacementTextureLoader = bool (*)(const std::string& filename, GSTextureReplacements::ReplacementTexture* tex, bool only_base_image);
 	ReplacementTextureLoader GetLoader(const std::string_view filename);
 
+	/// Transcodes an RGBA8 replacement to BC3 with a full mip chain. Fails if the base level isn't block aligned,
+	/// or the compressed image strays too far from the original.
+	bool CompressReplacementTexture(const ReplacementTexture& rtex, ReplacementTexture* out);
+
 	/// Saves an image buffer to a PNG file (for dumping).
 	bool SavePNGImage(const std::string& filename, u32 width, u32 height, const u8* buffer, u32 pitch);
 } // namespace GSTextureReplacements
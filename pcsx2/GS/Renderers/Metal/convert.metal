@@ -534,6 +534,39 @@ fragment float4 ps_yuv(ConvertShaderData data [[stage_in]], ConvertPSRes res,
 	return o;
 }
 
+static float3 rgb_to_yuv_bt601(float3 rgb)
+{
+	float Y = dot(rgb, float3(0.299, 0.587, 0.114));
+	float U = dot(rgb, float3(-0.168736, -0.331264, 0.5));
+	float V = dot(rgb, float3(0.5, -0.418688, -0.081312));
+	return float3(0xDB / 255.f * Y + 0x10 / 255.f, 0xE0 / 255.f * U + 0x80 / 255.f, 0xE0 / 255.f * V + 0x80 / 255.f);
+}
+
+fragment float4 ps_convert_rgba_nv12(ConvertShaderData data [[stage_in]], DirectReadTextureIn<float> res)
+{
+	// Packs the source into NV12 for video capture. The target is a quarter of the width, and 1.5x the height.
+	// The top part holds four luma samples per texel, the bottom two interleaved chroma pairs, each from a 2x2 block.
+	uint height = res.tex.get_height();
+	uint2 pos = uint2(data.p.xy);
+	uint x = pos.x * 4;
+
+	if (pos.y < height)
+	{
+		return float4(
+			rgb_to_yuv_bt601(res.tex.read(uint2(x + 0, pos.y)).rgb).x,
+			rgb_to_yuv_bt601(res.tex.read(uint2(x + 1, pos.y)).rgb).x,
+			rgb_to_yuv_bt601(res.tex.read(uint2(x + 2, pos.y)).rgb).x,
+			rgb_to_yuv_bt601(res.tex.read(uint2(x + 3, pos.y)).rgb).x);
+	}
+
+	uint y = (pos.y - height) * 2;
+	float3 c0 = res.tex.read(uint2(x + 0, y)).rgb + res.tex.read(uint2(x + 1, y)).rgb +
+		res.tex.read(uint2(x + 0, y + 1)).rgb + res.tex.read(uint2(x + 1, y + 1)).rgb;
+	float3 c1 = res.tex.read(uint2(x + 2, y)).rgb + res.tex.read(uint2(x + 3, y)).rgb +
+		res.tex.read(uint2(x + 2, y + 1)).rgb + res.tex.read(uint2(x + 3, y + 1)).rgb;
+	return float4(rgb_to_yuv_bt601(c0 * 0.25f).yz, rgb_to_yuv_bt601(c1 * 0.25f).yz);
+}
+
 fragment half4 ps_imgui(ImGuiShaderData data [[stage_in]], texture2d<half> texture [[texture(GSMTLTextureIndexNonHW)]])
 {
 	constexpr sampler s(coord::normalized, filter::linear, address::clamp_to_edge);
@@ -49,7 +49,8 @@ GSRasterizer::GSRasterizer(GSDrawScanline* ds, int id, int threads)
 	if (!m_edge.buff)
 		pxFailRel("failed to allocate storage for m_edge.buff");
 
-	int rows = (2048 >> m_thread_height) + 16;
+	// FindMyNextScanline() relies on the padding containing at least one of our rows.
+	int rows = (2048 >> m_thread_height) + std::max(threads, 16);
 	m_scanline = (u8*)_aligned_malloc(rows, 64);
 
 	for (int i = 0; i < rows; i++)
@@ -111,6 +112,20 @@ int GSRasterizer::FindMyNextScanline(int top) const
 	return top;
 }
 
+void GSRasterizer::SetId(int id)
+{
+	if (m_id == id)
+		return;
+
+	m_id = id;
+
+	const int rows = (2048 >> m_thread_height) + std::max(m_threads, 16);
+	for (int i = 0; i < rows; i++)
+	{
+		m_scanline[i] = (i % m_threads) == id ? 1 : 0;
+	}
+}
+
 int GSRasterizer::GetPixels(bool reset)
 {
 	int pixels = m_pixels.sum;
@@ -1500,30 +1515,54 @@ void GSSingleRasterizer::PrintStats()
 
 //
 
-GSRasterizerList::GSRasterizerList(int threads)
+GSRasterizerList::GSRasterizerList(int threads, bool binned, bool sw_renderer)
+	: m_threads(threads)
+	, m_sw_renderer(sw_renderer)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
+	// Scanline bands are owned by threads directly, or by bins which any thread can pick up.
+	const int owners = binned ? std::min(threads * BINS_PER_THREAD, 256) : threads;
 	const int rows = (2048 >> m_thread_height) + 16;
 	m_scanline = static_cast<u8*>(_aligned_malloc(rows, 64));
 
 	for (int i = 0; i < rows; i++)
 	{
-		m_scanline[i] = static_cast<u8>(i % threads);
+		m_scanline[i] = static_cast<u8>(i % owners);
 	}
 
-	PerformanceMetrics::SetGSSWThreadCount(threads);
+	if (binned)
+	{
+		m_bins.reserve(owners);
+		for (int i = 0; i < owners; i++)
+			m_bins.push_back(std::make_unique<Bin>());
+	}
+
+	if (m_sw_renderer)
+		PerformanceMetrics::SetGSSWThreadCount(threads);
 }
 
 GSRasterizerList::~GSRasterizerList()
 {
-	PerformanceMetrics::SetGSSWThreadCount(0);
+	if (IsBinned())
+	{
+		m_bin_exit = true;
+		for (std::unique_ptr<BinWorker>& w : m_bin_workers)
+			w->sema.NotifyOfWork();
+		for (std::unique_ptr<BinWorker>& w : m_bin_workers)
+			w->thread.join();
+	}
+
+	if (m_sw_renderer)
+		PerformanceMetrics::SetGSSWThreadCount(0);
 	_aligned_free(m_scanline);
 }
 
-void GSRasterizerList::OnWorkerStartup(int i, u64 affinity)
+void GSRasterizerList::OnWorkerStartup(int i, u64 affinity, bool sw_renderer)
 {
-	Threading::SetNameOfCurrentThread(StringUtil::StdStringFromFormat("GS-SW-%d", i).c_str());
+	Threading::SetNameOfCurrentThread(StringUtil::StdStringFromFormat(sw_renderer ? "GS-SW-%d" : "GS-SWPrim-%d", i).c_str());
+	if (!sw_renderer)
+		return;
 
 	Threading::ThreadHandle handle(Threading::ThreadHandle::GetForCallingThread());
 	if (affinity != 0)
@@ -1553,6 +1592,14 @@ void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data
 	pxAssert(r.top >= 0 && r.top <= 2048 && r.bottom >= 0 && r.bottom <= 2048);
 
 	int top = r.top >> m_thread_height;
+
+	if (IsBinned())
+	{
+		const int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + static_cast<int>(m_bins.size()));
+		QueueBinned(data, top, bottom);
+		return;
+	}
+
 	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + (int)m_workers.size());
 
 	while (top < bottom)
@@ -1561,13 +1608,112 @@ void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data
 	}
 }
 
+void GSRasterizerList::QueueBinned(const GSRingHeap::SharedPtr<GSRasterizerData>& data, int top, int bottom)
+{
+	if (top >= bottom)
+		return;
+
+	// Count everything up front, so IsSynced() can't see zero while the later bins are still being filled.
+	m_bin_pending.fetch_add(static_cast<u32>(bottom - top), std::memory_order_relaxed);
+
+	while (top < bottom)
+	{
+		const int bin = m_scanline[top++];
+		Bin& b = *m_bins[bin];
+
+		while (!b.queue.push(data))
+			std::this_thread::yield();
+
+		// Must come after the push, and be sequentially consistent with the owner flag. Either the worker
+		// releasing the bin sees the new item and keeps going, or the worker we wake below can claim it.
+		b.pending.fetch_add(1);
+		m_bin_workers[bin % m_threads]->sema.NotifyOfWork();
+	}
+}
+
+bool GSRasterizerList::DrainBin(int i, int bin)
+{
+	Bin& b = *m_bins[bin];
+	GSRasterizer& r = *m_r[i];
+	bool drawn = false;
+
+	while (b.pending.load() != 0)
+	{
+		// Somebody else is already working through this bin, they'll pick up anything new on release.
+		if (b.owned.exchange(true))
+			break;
+
+		r.SetId(bin);
+
+		const auto draw = [&r](GSRingHeap::SharedPtr<GSRasterizerData>& item) { r.Draw(*item.get()); };
+		while (b.queue.consume_one(draw))
+		{
+			b.pending.fetch_sub(1, std::memory_order_relaxed);
+			m_bin_pending.fetch_sub(1, std::memory_order_release);
+			drawn = true;
+		}
+
+		b.owned.store(false);
+	}
+
+	return drawn;
+}
+
+void GSRasterizerList::BinWorkerThread(int i, u64 affinity)
+{
+	OnWorkerStartup(i, affinity, m_sw_renderer);
+
+	BinWorker& w = *m_bin_workers[i];
+	const int bins = static_cast<int>(m_bins.size());
+
+	while (true)
+	{
+		w.sema.WaitForWorkWithSpin();
+		if (m_bin_exit)
+			break;
+
+		bool progress;
+		do
+		{
+			progress = false;
+
+			// Home bins first, so the same bands stay on the same thread while the load is even.
+			for (int bin = i; bin < bins; bin += m_threads)
+				progress |= DrainBin(i, bin);
+
+			// Then help with whatever is still queued in everybody else's bins.
+			for (int n = 1; n < bins; n++)
+			{
+				const int bin = (i + n) % bins;
+				if ((bin % m_threads) != i && DrainBin(i, bin))
+				{
+					w.stolen.fetch_add(1, std::memory_order_relaxed);
+					progress = true;
+				}
+			}
+		} while (progress);
+	}
+
+	OnWorkerShutdown(i);
+}
+
 void GSRasterizerList::Sync()
 {
 	if (!IsSynced())
 	{
-		for (size_t i = 0; i < m_workers.size(); i++)
+		if (IsBinned())
+		{
+			for (std::unique_ptr<BinWorker>& w : m_bin_workers)
+				w->sema.WaitForEmptyWithSpin();
+
+			pxAssert(m_bin_pending.load(std::memory_order_acquire) == 0);
+		}
+		else
 		{
-			m_workers[i]->Wait();
+			for (size_t i = 0; i < m_workers.size(); i++)
+			{
+				m_workers[i]->Wait();
+			}
 		}
 
 		g_perfmon.Put(GSPerfMon::SyncPoint, 1);
@@ -1576,6 +1722,9 @@ void GSRasterizerList::Sync()
 
 bool GSRasterizerList::IsSynced() const
 {
+	if (IsBinned())
+		return (m_bin_pending.load(std::memory_order_acquire) == 0);
+
 	for (size_t i = 0; i < m_workers.size(); i++)
 	{
 		if (!m_workers[i]->IsEmpty())
@@ -1591,7 +1740,7 @@ int GSRasterizerList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for (size_t i = 0; i < m_workers.size(); i++)
+	for (size_t i = 0; i < m_r.size(); i++)
 	{
 		pixels += m_r[i]->GetPixels(reset);
 	}
@@ -1599,7 +1748,7 @@ int GSRasterizerList::GetPixels(bool reset)
 	return pixels;
 }
 
-std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
+std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads, bool sw_renderer)
 {
 	threads = std::max<int>(threads, 0);
 
@@ -1608,20 +1757,41 @@ std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
 		return std::make_unique<GSSingleRasterizer>();
 	}
 
-	std::unique_ptr<GSRasterizerList> rl(new GSRasterizerList(threads));
+	const bool binned = GSConfig.SWExtraThreadsBinned;
+	std::unique_ptr<GSRasterizerList> rl(new GSRasterizerList(threads, binned, sw_renderer));
 
 	const std::vector<u32>& procs = VMManager::Internal::GetSoftwareRendererProcessorList();
-	const bool pin = (EmuConfig.EnableThreadPinning && static_cast<size_t>(threads) <= procs.size());
-	if (EmuConfig.EnableThreadPinning && !pin)
+	const bool pin = (sw_renderer && EmuConfig.EnableThreadPinning && static_cast<size_t>(threads) <= procs.size());
+	if (sw_renderer && EmuConfig.EnableThreadPinning && !pin)
 		WARNING_LOG("Not pinning SW threads, we need {} processors, but only have {}", threads, procs.size());
 
+	if (binned)
+	{
+		// Rasterizers start out on their first home bin, and switch between bins as they're claimed.
+		const int bins = static_cast<int>(rl->m_bins.size());
+		for (int i = 0; i < threads; i++)
+		{
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(&rl->m_ds, i, bins)));
+			rl->m_bin_workers.push_back(std::make_unique<BinWorker>());
+		}
+
+		// Workers steal from each other, so everything has to exist before the first one starts.
+		for (int i = 0; i < threads; i++)
+		{
+			const u64 affinity = pin ? (static_cast<u64>(1u) << procs[i]) : 0;
+			rl->m_bin_workers[i]->thread = std::thread(&GSRasterizerList::BinWorkerThread, rl.get(), i, affinity);
+		}
+
+		return rl;
+	}
+
 	for (int i = 0; i < threads; i++)
 	{
 		const u64 affinity = pin ? (static_cast<u64>(1u) << procs[i]) : 0;
 		rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(&rl->m_ds, i, threads)));
 		auto& r = *rl->m_r[i];
 		rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-			[i, affinity]() { GSRasterizerList::OnWorkerStartup(i, affinity); },
+			[i, affinity, sw_renderer]() { GSRasterizerList::OnWorkerStartup(i, affinity, sw_renderer); },
 			[&r](GSRingHeap::SharedPtr<GSRasterizerData>& item) { r.Draw(*item.get()); },
 			[i]() { GSRasterizerList::OnWorkerShutdown(i); })));
 	}
@@ -1631,6 +1801,10 @@ std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
 
 void GSRasterizerList::PrintStats()
 {
+	for (size_t i = 0; i < m_bin_workers.size(); i++)
+	{
+		DEV_LOG("GS-SW-{}: stole {} bins", i, m_bin_workers[i]->stolen.load(std::memory_order_relaxed));
+	}
 }
 
 #define INIT4(x0, x1, x2, x3, x4) static_cast<DrawEdgeTrianglePtr>(&GSRasterizer::DrawEdgeTriangle<x0, x1, x2, x3, x4>)
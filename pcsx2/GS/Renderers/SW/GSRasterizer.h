@@ -132,6 +132,9 @@ public:
 	__forceinline bool IsOneOfMyScanlines(int top, int bottom) const;
 	__forceinline int FindMyNextScanline(int top) const;
 
+	/// Switches the set of scanline bands this rasterizer draws to the ones owned by id.
+	void SetId(int id);
+
 	void Draw(GSRasterizerData& data);
 	int GetPixels(bool reset);
 };
@@ -172,23 +175,57 @@ class GSRasterizerList final : public IRasterizer
 protected:
 	using GSWorker = GSJobQueue<GSRingHeap::SharedPtr<GSRasterizerData>, 65536>;
 
+	// Binned mode: scanline bands are interleaved across more bins than there are threads. Each bin
+	// keeps its own ordered queue, and can only be drained by one worker at a time, so draws within
+	// a bin stay in submission order. Workers drain their home bins first, then steal from others.
+	static constexpr int BINS_PER_THREAD = 4;
+	static constexpr int BIN_QUEUE_CAPACITY = 8192;
+
+	struct alignas(__cachelinesize) Bin
+	{
+		ringbuffer_base<GSRingHeap::SharedPtr<GSRasterizerData>, BIN_QUEUE_CAPACITY> queue;
+		std::atomic<u32> pending{0};
+		std::atomic<bool> owned{false};
+	};
+
+	struct alignas(__cachelinesize) BinWorker
+	{
+		std::thread thread;
+		Threading::WorkSema sema;
+		std::atomic<u32> stolen{0};
+	};
+
 	GSDrawScanline m_ds;
 
 	// Worker threads depend on the rasterizers, so don't change the order.
 	std::vector<std::unique_ptr<GSRasterizer>> m_r;
 	std::vector<std::unique_ptr<GSWorker>> m_workers;
+	std::vector<std::unique_ptr<Bin>> m_bins;
+	std::vector<std::unique_ptr<BinWorker>> m_bin_workers;
+	std::atomic<u32> m_bin_pending{0};
+	bool m_bin_exit = false;
 	u8* m_scanline;
 	int m_thread_height;
+	int m_threads;
+	bool m_sw_renderer;
 
-	GSRasterizerList(int threads);
+	GSRasterizerList(int threads, bool binned, bool sw_renderer);
 
-	static void OnWorkerStartup(int i, u64 affinity);
+	static void OnWorkerStartup(int i, u64 affinity, bool sw_renderer);
 	static void OnWorkerShutdown(int i);
 
+	__fi bool IsBinned() const { return !m_bins.empty(); }
+
+	void QueueBinned(const GSRingHeap::SharedPtr<GSRasterizerData>& data, int top, int bottom);
+	void BinWorkerThread(int i, u64 affinity);
+	bool DrainBin(int i, int bin);
+
 public:
 	~GSRasterizerList() override;
 
-	static std::unique_ptr<IRasterizer> Create(int threads);
+	/// sw_renderer is false for the HW renderer's software fallback pool, which isn't pinned, and
+	/// isn't reported as the software renderer's threads in the performance metrics.
+	static std::unique_ptr<IRasterizer> Create(int threads, bool sw_renderer = true);
 
 	// IRasterizer
 
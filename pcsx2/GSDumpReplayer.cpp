@@ -3,6 +3,7 @@
 
 #include "GS.h"
 #include "GS/GSLzma.h"
+#include "GS/GSPerfMon.h"
 #include "GSDumpReplayer.h"
 #include "GameList.h"
 #include "Gif.h"
@@ -38,8 +39,8 @@ static void GSDumpReplayerCancelInstruction();
 static void GSDumpReplayerCpuClear(u32 addr, u32 size);
 
 static std::unique_ptr<GSDumpFile> s_dump_file;
-static u32 s_current_packet = 0;
 static u32 s_dump_frame_number = 0;
+static u32 s_dump_start_frame = 0;
 static s32 s_dump_loop_count = 0;
 static bool s_dump_running = false;
 static bool s_needs_state_loaded = false;
@@ -85,6 +86,11 @@ int GSDumpReplayer::GetLoopCount()
 	return s_dump_loop_count;
 }
 
+void GSDumpReplayer::SetStartFrame(u32 frame)
+{
+	s_dump_start_frame = frame;
+}
+
 bool GSDumpReplayer::Initialize(const char* filename, Error* error)
 {
 	Common::Timer timer;
@@ -134,7 +140,6 @@ bool GSDumpReplayer::ChangeDump(const char* filename)
 	}
 
 	s_dump_file = std::move(new_dump);
-	s_current_packet = 0;
 
 	// Don't forget to reset the GS!
 	GSDumpReplayerCpuReset();
@@ -194,25 +199,51 @@ void GSDumpReplayerCpuShutdown()
 void GSDumpReplayerCpuReset()
 {
 	s_needs_state_loaded = true;
-	s_current_packet = 0;
 	s_dump_frame_number = 0;
 }
 
-static void GSDumpReplayerLoadInitialState()
+static void GSDumpReplayerLoadState(const GSDumpFile::ByteArray& state_data, const GSDumpFile::ByteArray& regs_data)
 {
-	// reset GS registers to initial dump values
-	std::memcpy(PS2MEM_GS, s_dump_file->GetRegsData().data(),
-		std::min(Ps2MemSize::GSregs, static_cast<u32>(s_dump_file->GetRegsData().size())));
+	// reset GS registers to dump values
+	std::memcpy(PS2MEM_GS, regs_data.data(), std::min(Ps2MemSize::GSregs, static_cast<u32>(regs_data.size())));
 
 	// load GS state
-	freezeData fd = {static_cast<int>(s_dump_file->GetStateData().size()),
-		const_cast<u8*>(s_dump_file->GetStateData().data())};
+	freezeData fd = {static_cast<int>(state_data.size()), const_cast<u8*>(state_data.data())};
 	MTGS::FreezeData mfd = {&fd, 0};
 	MTGS::Freeze(FreezeAction::Load, mfd);
 	if (mfd.retval != 0)
 		Host::ReportFormattedErrorAsync("GSDumpReplayer", "Failed to load GS state.");
 }
 
+static void GSDumpReplayerLoadInitialState()
+{
+	if (s_dump_start_frame == 0)
+	{
+		s_dump_file->Rewind();
+		GSDumpReplayerLoadState(s_dump_file->GetStateData(), s_dump_file->GetRegsData());
+		return;
+	}
+
+	// Start from the closest keyframe, frames between it and the start frame are played back unthrottled.
+	GSDumpFile::ByteArray state_data, regs_data;
+	u32 keyframe;
+	Error error;
+	if (!s_dump_file->SeekToKeyframe(s_dump_start_frame, &keyframe, &state_data, &regs_data, &error))
+	{
+		Console.ErrorFmt("(GSDumpReplayer) Failed to seek to frame {}: {}", s_dump_start_frame, error.GetDescription());
+		s_dump_file->Rewind();
+		GSDumpReplayerLoadState(s_dump_file->GetStateData(), s_dump_file->GetRegsData());
+		return;
+	}
+
+	Console.WriteLn("(GSDumpReplayer) Starting from frame %u for frame %u.", keyframe, s_dump_start_frame);
+	GSDumpReplayerLoadState(state_data, regs_data);
+
+	// Loading state resets the frame counter, keep it in sync with the dump so frame ranges still line up.
+	s_dump_frame_number = keyframe;
+	MTGS::RunOnGSThread([keyframe]() { g_perfmon.SetFrame(static_cast<int>(keyframe)); });
+}
+
 static void GSDumpReplayerSendPacketToMTGS(GIF_PATH path, const u8* data, size_t length)
 {
 	pxAssert((length % 16) == 0 && length < UINT32_MAX);
@@ -264,9 +295,8 @@ void GSDumpReplayerCpuStep()
 		s_needs_state_loaded = false;
 	}
 
-	const GSDumpFile::GSData& packet = s_dump_file->GetPackets()[s_current_packet];
-	s_current_packet = (s_current_packet + 1) % static_cast<u32>(s_dump_file->GetPackets().size());
-	if (s_current_packet == 0)
+	const GSDumpFile::GSData* next_packet = s_dump_file->GetNextPacket();
+	if (!next_packet)
 	{
 		s_dump_frame_number = 0;
 		if (s_dump_loop_count > 0)
@@ -275,9 +305,21 @@ void GSDumpReplayerCpuStep()
 		{
 			Host::RequestVMShutdown(false, false, false);
 			s_dump_running = false;
+			return;
+		}
+
+		s_dump_file->Rewind();
+		next_packet = s_dump_file->GetNextPacket();
+		if (!next_packet)
+		{
+			Console.Error("(GSDumpReplayer) Dump has no packets.");
+			Host::RequestVMShutdown(false, false, false);
+			s_dump_running = false;
+			return;
 		}
 	}
 
+	const GSDumpFile::GSData& packet = *next_packet;
 	switch (packet.id)
 	{
 		case GSDumpTypes::GSType::Transfer:
@@ -316,8 +358,11 @@ void GSDumpReplayerCpuStep()
 		case GSDumpTypes::GSType::VSync:
 		{
 			s_dump_frame_number++;
-			GSDumpReplayerUpdateFrameLimit();
-			GSDumpReplayerFrameLimit();
+			if (s_dump_frame_number >= s_dump_start_frame)
+			{
+				GSDumpReplayerUpdateFrameLimit();
+				GSDumpReplayerFrameLimit();
+			}
 			MTGS::PostVsyncStart(false);
 			VMManager::Internal::VSyncOnCPUThread();
 			if (VMManager::Internal::IsExecutionInterrupted())
@@ -395,11 +440,14 @@ void GSDumpReplayer::RenderUI()
 		position_y += text_size.y + spacing; \
 	} while (0)
 
-	fmt::format_to(std::back_inserter(text), "Dump Frame: {}", s_dump_frame_number);
+	if (s_dump_file->GetFrameCount() > 0)
+		fmt::format_to(std::back_inserter(text), "Dump Frame: {}/{}", s_dump_frame_number, s_dump_file->GetFrameCount());
+	else
+		fmt::format_to(std::back_inserter(text), "Dump Frame: {}", s_dump_frame_number);
 	DRAW_LINE(font, font_size, text.c_str(), IM_COL32(255, 255, 255, 255));
 
 	text.clear();
-	fmt::format_to(std::back_inserter(text), "Packet Number: {}/{}", s_current_packet, static_cast<u32>(s_dump_file->GetPackets().size()));
+	fmt::format_to(std::back_inserter(text), "Packet Number: {}/{}", s_dump_file->GetPacketIndex(), s_dump_file->GetPacketCount());
 	DRAW_LINE(font, font_size, text.c_str(), IM_COL32(255, 255, 255, 255));
 
 #undef DRAW_LINE
@@ -15,6 +15,9 @@ namespace GSDumpReplayer
 	/// If set, playback will repeat once it reaches the last frame.
 	void SetLoopCount(s32 loop_count = 0);
 	int GetLoopCount();
+
+	/// Starts playback from the specified frame, using the closest keyframe in the dump.
+	void SetStartFrame(u32 frame);
 	bool IsRunner();
 	void SetIsDumpRunner(bool is_runner);
 
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "CDVD/CDVD.h"
+#include "CDVD/IsoFileFormats.h"
+#include "CDVD/IsoReader.h"
 #include "Elfheader.h"
 #include "GameList.h"
 #include "Host.h"
@@ -18,14 +20,18 @@
 #include "common/ProgressCallback.h"
 #include "common/ScopedGuard.h"
 #include "common/StringUtil.h"
+#include "common/Threading.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #include <cstdio>
 #include <ctime>
 #include <fstream>
 #include <string_view>
+#include <thread>
 #include <utility>
 
 #ifdef _WIN32
@@ -37,7 +43,9 @@ namespace GameList
 	enum : u32
 	{
 		GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-		GAME_LIST_CACHE_VERSION = 34,
+		GAME_LIST_CACHE_VERSION = 35,
+
+		MAX_SCAN_THREADS = 8,
 
 
 		PLAYED_TIME_SERIAL_LENGTH = 32,
@@ -52,6 +60,14 @@ namespace GameList
 		std::time_t total_played_time;
 	};
 
+	/// Identifies an unchanged file without opening it.
+	struct FileFingerprint
+	{
+		std::time_t modification_time;
+		std::time_t change_time;
+		s64 size;
+	};
+
 	using CacheMap = UnorderedStringMap<Entry>;
 	using PlayedTimeMap = UnorderedStringMap<PlayedTimeEntry>;
 
@@ -65,9 +81,11 @@ namespace GameList
 	static bool GetGameListEntryFromCache(const std::string& path, GameList::Entry* entry);
 	static void ScanDirectory(const char* path, bool recursive, bool only_cache, const std::vector<std::string>& excluded_paths,
 		const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini, ProgressCallback* progress);
-	static bool AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map);
-	static bool ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
+	static bool AddFileFromCache(const std::string& path, const FileFingerprint& fingerprint, const PlayedTimeMap& played_time_map);
+	static bool ScanFile(std::string path, const FileFingerprint& fingerprint, std::unique_lock<std::recursive_mutex>& lock,
 		const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini);
+	static void ScanFiles(std::vector<FILESYSTEM_FIND_DATA*>& files, const PlayedTimeMap& played_time_map,
+		const INISettingsInterface& custom_attributes_ini, ProgressCallback* progress, u32 progress_base);
 
 	static void LoadCache();
 	static bool LoadEntriesFromCache(std::FILE* stream);
@@ -257,18 +275,19 @@ bool GameList::GetIsoSerialAndCRC(const std::string& path, s32* disc_type, std::
 {
 	Error error;
 
-	// This isn't great, we really want to make it all thread-local...
-	CDVD = &CDVDapi_Iso;
-	if (!CDVD->open(path, &error))
+	// Read through our own image rather than the global CDVD interface, so several files can be scanned at once.
+	InputIsoFile iso;
+	if (!iso.Open(path, &error))
 	{
 		Console.Error(fmt::format("(GameList::GetIsoSerialAndCRC) CDVD open of '{}' failed: {}", path, error.GetDescription()));
 		return false;
 	}
 
 	// TODO: we could include the version in the game list?
-	*disc_type = DoCDVDdetectDiskType();
-	cdvdGetDiscInfo(serial, nullptr, nullptr, crc, nullptr);
-	DoCDVDclose();
+	*disc_type = DoCDVDdetectDiskType(iso);
+
+	IsoReader isor(&iso);
+	cdvdGetDiscInfo(isor, serial, nullptr, nullptr, crc, nullptr);
 	return true;
 }
 
@@ -527,10 +546,13 @@ bool GameList::LoadEntriesFromCache(std::FILE* stream)
 		u8 region;
 		u8 compatibility_rating;
 		u64 last_modified_time;
+		u64 last_change_time;
+		u64 file_size;
 
 		if (!ReadString(stream, &path) || !ReadString(stream, &ge.serial) || !ReadString(stream, &ge.title) || !ReadString(stream, &ge.title_sort) ||
 			!ReadString(stream, &ge.title_en) || !ReadU8(stream, &type) || !ReadU8(stream, &region) || !ReadU64(stream, &ge.total_size) ||
-			!ReadU64(stream, &last_modified_time) || !ReadU32(stream, &ge.crc) || !ReadU8(stream, &compatibility_rating) ||
+			!ReadU64(stream, &last_modified_time) || !ReadU64(stream, &last_change_time) || !ReadU64(stream, &file_size) ||
+			!ReadU32(stream, &ge.crc) || !ReadU8(stream, &compatibility_rating) ||
 			region >= static_cast<u8>(Region::Count) || type >= static_cast<u8>(EntryType::Count) ||
 			compatibility_rating > static_cast<u8>(CompatibilityRating::Perfect))
 		{
@@ -543,6 +565,8 @@ bool GameList::LoadEntriesFromCache(std::FILE* stream)
 		ge.type = static_cast<EntryType>(type);
 		ge.compatibility_rating = static_cast<CompatibilityRating>(compatibility_rating);
 		ge.last_modified_time = static_cast<std::time_t>(last_modified_time);
+		ge.last_change_time = static_cast<std::time_t>(last_change_time);
+		ge.file_size = static_cast<s64>(file_size);
 
 		auto iter = s_cache_map.find(ge.path);
 		if (iter != s_cache_map.end())
@@ -630,6 +654,8 @@ bool GameList::WriteEntryToCache(const Entry* entry)
 	result &= WriteU8(s_cache_write_stream, static_cast<u8>(entry->region));
 	result &= WriteU64(s_cache_write_stream, entry->total_size);
 	result &= WriteU64(s_cache_write_stream, static_cast<u64>(entry->last_modified_time));
+	result &= WriteU64(s_cache_write_stream, static_cast<u64>(entry->last_change_time));
+	result &= WriteU64(s_cache_write_stream, static_cast<u64>(entry->file_size));
 	result &= WriteU32(s_cache_write_stream, entry->crc);
 	result &= WriteU8(s_cache_write_stream, static_cast<u8>(entry->compatibility_rating));
 
@@ -702,40 +728,124 @@ void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
 					(FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES),
 		&files, progress);
 
-	u32 files_scanned = 0;
 	progress->SetProgressRange(static_cast<u32>(files.size()));
 	progress->SetProgressValue(0);
 
+	// Anything we already know about gets added straight away, only files which changed need to be opened.
+	std::vector<FILESYSTEM_FIND_DATA*> files_to_scan;
 	for (FILESYSTEM_FIND_DATA& ffd : files)
 	{
-		files_scanned++;
-
 		if (progress->IsCancelled() || !GameList::IsScannableFilename(ffd.FileName) || IsPathExcluded(excluded_paths, ffd.FileName))
 		{
 			continue;
 		}
 
+		const FileFingerprint fingerprint = {ffd.ModificationTime, ffd.CreationTime, ffd.Size};
+
 		std::unique_lock lock(s_mutex);
-		if (GetEntryForPath(ffd.FileName.c_str()) || AddFileFromCache(ffd.FileName, ffd.ModificationTime, played_time_map) || only_cache)
+		if (GetEntryForPath(ffd.FileName.c_str()) || AddFileFromCache(ffd.FileName, fingerprint, played_time_map) || only_cache)
 		{
 			continue;
 		}
 
-		const std::string_view filename = Path::GetFileName(ffd.FileName);
-		progress->SetStatusText(fmt::format(TRANSLATE_FS("GameList", "Scanning {}..."), filename.data()).c_str());
-		ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map, custom_attributes_ini);
-		progress->SetProgressValue(files_scanned);
+		files_to_scan.push_back(&ffd);
 	}
 
-	progress->SetProgressValue(files_scanned);
+	const u32 files_from_cache = static_cast<u32>(files.size() - files_to_scan.size());
+	progress->SetProgressValue(files_from_cache);
+
+	if (!files_to_scan.empty() && !progress->IsCancelled())
+		ScanFiles(files_to_scan, played_time_map, custom_attributes_ini, progress, files_from_cache);
+
+	progress->SetProgressValue(static_cast<u32>(files.size()));
 	progress->PopState();
 }
 
-bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map)
+void GameList::ScanFiles(std::vector<FILESYSTEM_FIND_DATA*>& files, const PlayedTimeMap& played_time_map,
+	const INISettingsInterface& custom_attributes_ini, ProgressCallback* progress, u32 progress_base)
+{
+	// Scanning is mostly waiting on I/O (especially for network shares), so use a few more threads than
+	// we'd normally want for CPU work, but not so many that we thrash spinning disks.
+	const u32 num_threads = std::min<u32>(static_cast<u32>(files.size()),
+		std::clamp<u32>(std::thread::hardware_concurrency(), 1, MAX_SCAN_THREADS));
+
+	std::mutex progress_mutex;
+	std::condition_variable progress_cv;
+	std::string last_filename;
+	std::atomic<size_t> next_file{0};
+	std::atomic<u32> files_done{0};
+	std::atomic<u32> threads_done{0};
+	std::atomic_bool cancelled{false};
+
+	const auto scan_worker = [&]() {
+		Threading::SetNameOfCurrentThread("Game List Scan");
+
+		for (;;)
+		{
+			const size_t index = next_file.fetch_add(1, std::memory_order_relaxed);
+			if (index >= files.size() || cancelled.load(std::memory_order_relaxed))
+				break;
+
+			FILESYSTEM_FIND_DATA& ffd = *files[index];
+			const FileFingerprint fingerprint = {ffd.ModificationTime, ffd.CreationTime, ffd.Size};
+			const std::string_view filename = Path::GetFileName(ffd.FileName);
+
+			{
+				std::unique_lock plock(progress_mutex);
+				last_filename = filename;
+			}
+
+			// Only takes the list lock to publish the entry.
+			std::unique_lock lock(s_mutex);
+			ScanFile(std::move(ffd.FileName), fingerprint, lock, played_time_map, custom_attributes_ini);
+			if (lock.owns_lock())
+				lock.unlock();
+
+			files_done.fetch_add(1, std::memory_order_relaxed);
+			progress_cv.notify_one();
+		}
+
+		threads_done.fetch_add(1, std::memory_order_release);
+		progress_cv.notify_one();
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads);
+	for (u32 i = 0; i < num_threads; i++)
+		threads.emplace_back(scan_worker);
+
+	// The progress callback isn't thread safe, so report from here while the workers do the scanning.
+	{
+		std::unique_lock plock(progress_mutex);
+		while (threads_done.load(std::memory_order_acquire) != num_threads)
+		{
+			progress_cv.wait_for(plock, std::chrono::milliseconds(100));
+
+			if (progress->IsCancelled())
+				cancelled.store(true, std::memory_order_relaxed);
+
+			if (!last_filename.empty())
+			{
+				progress->SetStatusText(fmt::format(TRANSLATE_FS("GameList", "Scanning {}..."), last_filename).c_str());
+				last_filename.clear();
+			}
+
+			progress->SetProgressValue(progress_base + files_done.load(std::memory_order_relaxed));
+		}
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+bool GameList::AddFileFromCache(const std::string& path, const FileFingerprint& fingerprint, const PlayedTimeMap& played_time_map)
 {
 	Entry entry;
-	if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != timestamp)
+	if (!GetGameListEntryFromCache(path, &entry) || entry.last_modified_time != fingerprint.modification_time ||
+		entry.last_change_time != fingerprint.change_time || entry.file_size != fingerprint.size)
+	{
 		return false;
+	}
 
 	// Skip over invalid entries.
 	if (entry.type == EntryType::Invalid)
@@ -752,7 +862,7 @@ bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp,
 	return true;
 }
 
-bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
+bool GameList::ScanFile(std::string path, const FileFingerprint& fingerprint, std::unique_lock<std::recursive_mutex>& lock,
 	const PlayedTimeMap& played_time_map, const INISettingsInterface& custom_attributes_ini)
 {
 	// don't block UI while scanning
@@ -764,44 +874,47 @@ bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
 	if (!PopulateEntryFromPath(path, &entry))
 		return false;
 
-	entry.last_modified_time = timestamp;
+	entry.last_modified_time = fingerprint.modification_time;
+	entry.last_change_time = fingerprint.change_time;
+	entry.file_size = fingerprint.size;
 
-	if (s_cache_write_stream || OpenCacheForWriting())
+	if (entry.type != EntryType::Invalid)
 	{
-		if (!WriteEntryToCache(&entry))
-			Console.Warning("Failed to write entry '%s' to cache", entry.path.c_str());
-	}
+		const auto iter = played_time_map.find(entry.serial);
+		if (iter != played_time_map.end())
+		{
+			entry.last_played_time = iter->second.last_played_time;
+			entry.total_played_time = iter->second.total_played_time;
+		}
 
-	if (entry.type == EntryType::Invalid)
-	{
-		// don't add invalid entries to list
-		lock.lock();
-		return true;
+		auto custom_title = custom_attributes_ini.GetOptionalStringValue(EncodeIniKey(entry.path).c_str(), "Title");
+		if (custom_title)
+		{
+			entry.title = std::move(custom_title.value());
+		}
+		const auto custom_region = custom_attributes_ini.GetOptionalIntValue(EncodeIniKey(entry.path).c_str(), "Region");
+		if (custom_region)
+		{
+			const int custom_region_value = custom_region.value();
+			if (custom_region_value >= 0 && custom_region_value < static_cast<int>(Region::Count))
+			{
+				entry.region = static_cast<Region>(custom_region_value);
+			}
+		}
 	}
 
-	const auto iter = played_time_map.find(entry.serial);
-	if (iter != played_time_map.end())
-	{
-		entry.last_played_time = iter->second.last_played_time;
-		entry.total_played_time = iter->second.total_played_time;
-	}
+	lock.lock();
 
-	auto custom_title = custom_attributes_ini.GetOptionalStringValue(EncodeIniKey(entry.path).c_str(), "Title");
-	if (custom_title)
-	{
-		entry.title = std::move(custom_title.value());
-	}
-	const auto custom_region = custom_attributes_ini.GetOptionalIntValue(EncodeIniKey(entry.path).c_str(), "Region");
-	if (custom_region)
+	// The cache stream is shared between scanning threads, so it's written under the list lock.
+	if (s_cache_write_stream || OpenCacheForWriting())
 	{
-		const int custom_region_value = custom_region.value();
-		if (custom_region_value >= 0 && custom_region_value < static_cast<int>(Region::Count))
-		{
-			entry.region = static_cast<Region>(custom_region_value);
-		}
+		if (!WriteEntryToCache(&entry))
+			Console.Warning("Failed to write entry '%s' to cache", entry.path.c_str());
 	}
 
-	lock.lock();
+	// don't add invalid entries to list
+	if (entry.type == EntryType::Invalid)
+		return true;
 
 	// remove if present
 	auto it = std::find_if(
@@ -945,7 +1058,7 @@ bool GameList::RescanPath(const std::string& path)
 	}
 
 	// re-scan!
-	if (!ScanFile(path, sd.ModificationTime, lock, played_time, custom_attributes_ini))
+	if (!ScanFile(path, {sd.ModificationTime, sd.CreationTime, sd.Size}, lock, played_time, custom_attributes_ini))
 		return true;
 
 	// update cache.. this is far from ideal, but since everything's variable length, all we can do.
@@ -82,6 +82,8 @@ namespace GameList
 		std::string title_en;
 		u64 total_size = 0;
 		std::time_t last_modified_time = 0;
+		std::time_t last_change_time = 0; // Inode change time on Linux, creation time on Windows.
+		s64 file_size = 0;
 		std::time_t last_played_time = 0;
 		std::time_t total_played_time = 0;
 
@@ -113,7 +115,7 @@ namespace GameList
 	void FillBootParametersForEntry(VMBootParameters* params, const Entry* entry);
 
 	/// Populates a game list entry struct with information from the iso/elf.
-	/// Do *not* call while the system is running, it will mess with CDVD state.
+	/// Images are read independently of the CDVD interface, so this can be called from multiple threads.
 	bool PopulateEntryFromPath(const std::string& path, GameList::Entry* entry);
 
 	// Game list access. It's the caller's responsibility to hold the lock while manipulating the entry in any way.
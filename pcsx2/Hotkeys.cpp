@@ -287,6 +287,20 @@ DEFINE_HOTKEY("LoadBackupStateFromSlot", TRANSLATE_NOOP("Hotkeys", "Save States"
 		if (!pressed && VMManager::HasValidVM())
 			SaveStateSelectorUI::LoadCurrentBackupSlot();
 	})
+DEFINE_HOTKEY("RewindState", TRANSLATE_NOOP("Hotkeys", "Save States"),
+	TRANSLATE_NOOP("Hotkeys", "Rewind"), [](s32 pressed) {
+		if (!pressed && VMManager::HasValidVM())
+		{
+			Host::RunOnCPUThread([]() {
+				Error error;
+				if (!VMManager::RewindState(&error))
+				{
+					Host::AddIconOSDMessage("RewindState", ICON_FA_TRIANGLE_EXCLAMATION, error.GetDescription(),
+						Host::OSD_QUICK_DURATION);
+				}
+			});
+		}
+	})
 DEFINE_HOTKEY("SaveStateAndSelectNextSlot", TRANSLATE_NOOP("Hotkeys", "Save States"),
 	TRANSLATE_NOOP("Hotkeys", "Save State and Select Next Slot"), [](s32 pressed) {
 		if (!pressed && VMManager::HasValidVM())
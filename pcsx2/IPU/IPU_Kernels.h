@@ -0,0 +1,441 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "IPU/IPU_MultiISA.h"
+#include "GS/GSVector.h"
+
+// IDCT, colour conversion threshold and VQ kernels of the IPU.
+// The _reference versions are the original scalar code, and the vector versions must match them exactly.
+
+#define W1 2841 /* 2048*sqrt (2)*cos (1*pi/16) */
+#define W2 2676 /* 2048*sqrt (2)*cos (2*pi/16) */
+#define W3 2408 /* 2048*sqrt (2)*cos (3*pi/16) */
+#define W5 1609 /* 2048*sqrt (2)*cos (5*pi/16) */
+#define W6 1108 /* 2048*sqrt (2)*cos (6*pi/16) */
+#define W7 565  /* 2048*sqrt (2)*cos (7*pi/16) */
+
+MULTI_ISA_UNSHARED_START
+
+/*
+ * In legal streams, the IDCT output should be between -384 and +384.
+ * In corrupted streams, it is possible to force the IDCT output to go
+ * to +-3826 - this is the worst case for a column IDCT where the
+ * column inputs are 16-bit values.
+ */
+
+static __fi void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
+{
+	int tmp = w0 * (d0 + d1);
+	t0 = tmp + (w1 - w0) * d1;
+	t1 = tmp - (w1 + w0) * d0;
+}
+
+static __fi void IDCT_Block_reference(s16* block)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		s16* const rblock = block + 8 * i;
+		if (!(rblock[1] | ((s32*)rblock)[1] | ((s32*)rblock)[2] |
+				((s32*)rblock)[3]))
+		{
+			u32 tmp = (u16)(rblock[0] << 3);
+			tmp |= tmp << 16;
+			((s32*)rblock)[0] = tmp;
+			((s32*)rblock)[1] = tmp;
+			((s32*)rblock)[2] = tmp;
+			((s32*)rblock)[3] = tmp;
+			continue;
+		}
+
+		int a0, a1, a2, a3;
+		{
+			const int d0 = (rblock[0] << 11) + 128;
+			const int d1 = rblock[1];
+			const int d2 = rblock[2] << 11;
+			const int d3 = rblock[3];
+			int t0 = d0 + d2;
+			int t1 = d0 - d2;
+			int t2, t3;
+			BUTTERFLY(t2, t3, W6, W2, d3, d1);
+			a0 = t0 + t2;
+			a1 = t1 + t3;
+			a2 = t1 - t3;
+			a3 = t0 - t2;
+		}
+
+		int b0, b1, b2, b3;
+		{
+			const int d0 = rblock[4];
+			const int d1 = rblock[5];
+			const int d2 = rblock[6];
+			const int d3 = rblock[7];
+			int t0, t1, t2, t3;
+			BUTTERFLY(t0, t1, W7, W1, d3, d0);
+			BUTTERFLY(t2, t3, W3, W5, d1, d2);
+			b0 = t0 + t2;
+			b3 = t1 + t3;
+			t0 -= t2;
+			t1 -= t3;
+			b1 = ((t0 + t1) * 181) >> 8;
+			b2 = ((t0 - t1) * 181) >> 8;
+		}
+
+		rblock[0] = (a0 + b0) >> 8;
+		rblock[1] = (a1 + b1) >> 8;
+		rblock[2] = (a2 + b2) >> 8;
+		rblock[3] = (a3 + b3) >> 8;
+		rblock[4] = (a3 - b3) >> 8;
+		rblock[5] = (a2 - b2) >> 8;
+		rblock[6] = (a1 - b1) >> 8;
+		rblock[7] = (a0 - b0) >> 8;
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		s16* const cblock = block + i;
+
+		int a0, a1, a2, a3;
+		{
+			const int d0 = (cblock[8 * 0] << 11) + 65536;
+			const int d1 = cblock[8 * 1];
+			const int d2 = cblock[8 * 2] << 11;
+			const int d3 = cblock[8 * 3];
+			const int t0 = d0 + d2;
+			const int t1 = d0 - d2;
+			int t2;
+			int t3;
+			BUTTERFLY(t2, t3, W6, W2, d3, d1);
+			a0 = t0 + t2;
+			a1 = t1 + t3;
+			a2 = t1 - t3;
+			a3 = t0 - t2;
+		}
+
+		int b0, b1, b2, b3;
+		{
+			const int d0 = cblock[8 * 4];
+			const int d1 = cblock[8 * 5];
+			const int d2 = cblock[8 * 6];
+			const int d3 = cblock[8 * 7];
+			int t0, t1, t2, t3;
+			BUTTERFLY(t0, t1, W7, W1, d3, d0);
+			BUTTERFLY(t2, t3, W3, W5, d1, d2);
+			b0 = t0 + t2;
+			b3 = t1 + t3;
+			t0 = (t0 - t2) >> 8;
+			t1 = (t1 - t3) >> 8;
+			b1 = (t0 + t1) * 181;
+			b2 = (t0 - t1) * 181;
+		}
+
+		cblock[8 * 0] = (a0 + b0) >> 17;
+		cblock[8 * 1] = (a1 + b1) >> 17;
+		cblock[8 * 2] = (a2 + b2) >> 17;
+		cblock[8 * 3] = (a3 + b3) >> 17;
+		cblock[8 * 4] = (a3 - b3) >> 17;
+		cblock[8 * 5] = (a2 - b2) >> 17;
+		cblock[8 * 6] = (a1 - b1) >> 17;
+		cblock[8 * 7] = (a0 - b0) >> 17;
+	}
+}
+
+/// Coefficients for madd, a multiplies the first input of each pair and b the second.
+static constexpr int IDCT_Coefficients(int a, int b)
+{
+	return static_cast<int>((static_cast<u32>(a) & 0xffff) | (static_cast<u32>(b) << 16));
+}
+
+/// One pass of the IDCT, on as many rows or columns as there are 32-bit lanes.
+/// The inputs are interleaved in pairs, so the butterflies can be done with 16-bit multiply-adds:
+/// BUTTERFLY(t0, t1, w0, w1, d0, d1) is t0 = w0 * d0 + w1 * d1, t1 = w0 * d1 - w1 * d0.
+template <bool row, typename V>
+static __fi void IDCT_Butterflies(const V& d02, const V& d13, const V& d47, const V& d56, V (&d)[8])
+{
+	const V bias(row ? 128 : 65536);
+	const V t0 = d02.madd(V(IDCT_Coefficients(2048, 2048))).add32(bias);
+	const V t1 = d02.madd(V(IDCT_Coefficients(2048, -2048))).add32(bias);
+	const V t2 = d13.madd(V(IDCT_Coefficients(W2, W6)));
+	const V t3 = d13.madd(V(IDCT_Coefficients(W6, -W2)));
+	const V a0 = t0.add32(t2);
+	const V a1 = t1.add32(t3);
+	const V a2 = t1.sub32(t3);
+	const V a3 = t0.sub32(t2);
+
+	const V u0 = d47.madd(V(IDCT_Coefficients(W1, W7)));
+	const V u1 = d47.madd(V(IDCT_Coefficients(W7, -W1)));
+	const V u2 = d56.madd(V(IDCT_Coefficients(W3, W5)));
+	const V u3 = d56.madd(V(IDCT_Coefficients(-W5, W3)));
+	const V b0 = u0.add32(u2);
+	const V b3 = u1.add32(u3);
+	V b1, b2;
+	if constexpr (row)
+	{
+		const V v0 = u0.sub32(u2);
+		const V v1 = u1.sub32(u3);
+		b1 = v0.add32(v1).mul32l(V(181)).template sra32<8>();
+		b2 = v0.sub32(v1).mul32l(V(181)).template sra32<8>();
+	}
+	else
+	{
+		const V v0 = u0.sub32(u2).template sra32<8>();
+		const V v1 = u1.sub32(u3).template sra32<8>();
+		b1 = v0.add32(v1).mul32l(V(181));
+		b2 = v0.sub32(v1).mul32l(V(181));
+	}
+
+	constexpr int shift = row ? 8 : 17;
+	d[0] = a0.add32(b0).template sra32<shift>();
+	d[1] = a1.add32(b1).template sra32<shift>();
+	d[2] = a2.add32(b2).template sra32<shift>();
+	d[3] = a3.add32(b3).template sra32<shift>();
+	d[4] = a3.sub32(b3).template sra32<shift>();
+	d[5] = a2.sub32(b2).template sra32<shift>();
+	d[6] = a1.sub32(b1).template sra32<shift>();
+	d[7] = a0.sub32(b0).template sra32<shift>();
+}
+
+/// Truncates 32-bit lanes to 16 bits like a store to s16 does, and sign extends them again so they pack without saturating.
+template <typename V>
+static __fi V IDCT_Truncate(const V& v)
+{
+	return v.template sll32<16>().template sra32<16>();
+}
+
+static __fi void IDCT_Transpose(GSVector4i (&v)[8])
+{
+	const GSVector4i a0 = v[0].upl16(v[1]);
+	const GSVector4i a1 = v[0].uph16(v[1]);
+	const GSVector4i a2 = v[2].upl16(v[3]);
+	const GSVector4i a3 = v[2].uph16(v[3]);
+	const GSVector4i a4 = v[4].upl16(v[5]);
+	const GSVector4i a5 = v[4].uph16(v[5]);
+	const GSVector4i a6 = v[6].upl16(v[7]);
+	const GSVector4i a7 = v[6].uph16(v[7]);
+
+	const GSVector4i b0 = a0.upl32(a2);
+	const GSVector4i b1 = a0.uph32(a2);
+	const GSVector4i b2 = a1.upl32(a3);
+	const GSVector4i b3 = a1.uph32(a3);
+	const GSVector4i b4 = a4.upl32(a6);
+	const GSVector4i b5 = a4.uph32(a6);
+	const GSVector4i b6 = a5.upl32(a7);
+	const GSVector4i b7 = a5.uph32(a7);
+
+	v[0] = b0.upl64(b4);
+	v[1] = b0.uph64(b4);
+	v[2] = b1.upl64(b5);
+	v[3] = b1.uph64(b5);
+	v[4] = b2.upl64(b6);
+	v[5] = b2.uph64(b6);
+	v[6] = b3.upl64(b7);
+	v[7] = b3.uph64(b7);
+}
+
+template <bool row>
+static __fi void IDCT_Pass(GSVector4i (&v)[8])
+{
+#if _M_SSE >= 0x501
+	const auto pair = [&v](int a, int b) { return GSVector8i(v[a].upl16(v[b]), v[a].uph16(v[b])); };
+
+	GSVector8i d[8];
+	IDCT_Butterflies<row>(pair(0, 2), pair(1, 3), pair(4, 7), pair(5, 6), d);
+
+	for (int k = 0; k < 8; k++)
+	{
+		const GSVector8i t = IDCT_Truncate(d[k]);
+		v[k] = t.extract<0>().ps32(t.extract<1>());
+	}
+#else
+	GSVector4i lo[8], hi[8];
+	IDCT_Butterflies<row>(v[0].upl16(v[2]), v[1].upl16(v[3]), v[4].upl16(v[7]), v[5].upl16(v[6]), lo);
+	IDCT_Butterflies<row>(v[0].uph16(v[2]), v[1].uph16(v[3]), v[4].uph16(v[7]), v[5].uph16(v[6]), hi);
+
+	for (int k = 0; k < 8; k++)
+		v[k] = IDCT_Truncate(lo[k]).ps32(IDCT_Truncate(hi[k]));
+#endif
+}
+
+/// Transforms the block, leaving the rows in v. block must be 16 byte aligned.
+static __fi void IDCT_Block(const s16* block, GSVector4i (&v)[8])
+{
+	// The row pass wants each row in a lane, so transpose in, and back for the column pass.
+	for (int i = 0; i < 8; i++)
+		v[i] = GSVector4i::load<true>(block + 8 * i);
+
+	IDCT_Transpose(v);
+	IDCT_Pass<true>(v);
+	IDCT_Transpose(v);
+	IDCT_Pass<false>(v);
+}
+
+static __fi void IDCT_Block(s16* block)
+{
+	GSVector4i v[8];
+	IDCT_Block(block, v);
+
+	for (int i = 0; i < 8; i++)
+		GSVector4i::store<true>(block + 8 * i, v[i]);
+}
+
+static __fi void ipu_threshold_reference(macroblock_rgb32& rgb32, int sgn, const u16* thresh)
+{
+	int i;
+	u8* p = (u8*)&rgb32;
+
+	if (thresh[0] > 0)
+	{
+		for (i = 0; i < 16*16; i++, p += 4)
+		{
+			if ((p[0] < thresh[0]) && (p[1] < thresh[0]) && (p[2] < thresh[0]))
+				*(u32*)p = 0;
+			else if ((p[0] < thresh[1]) && (p[1] < thresh[1]) && (p[2] < thresh[1]))
+				p[3] = 0x40;
+		}
+	}
+	else if (thresh[1] > 0)
+	{
+		for (i = 0; i < 16*16; i++, p += 4)
+		{
+			if ((p[0] < thresh[1]) && (p[1] < thresh[1]) && (p[2] < thresh[1]))
+				p[3] = 0x40;
+		}
+	}
+	if (sgn)
+	{
+		for (i = 0; i < 16*16; i++, p += 4)
+		{
+			*(u32*)p ^= 0x808080;
+		}
+	}
+}
+
+#if _M_SSE >= 0x501
+using IPUVector = GSVector8i;
+#else
+using IPUVector = GSVector4i;
+#endif
+
+/// All ones for the pixels whose red, green and blue are all below the threshold.
+static __fi IPUVector ipu_threshold_mask(const IPUVector& p, u32 thresh)
+{
+	if (thresh == 0)
+		return IPUVector::zero();
+	if (thresh > 0xff)
+		return IPUVector::xffffffff();
+
+	const IPUVector below = p.min_u8(IPUVector(static_cast<int>(0x01010101u * (thresh - 1)))).eq8(p);
+	return (below | IPUVector(static_cast<int>(0xff000000u))).eq32(IPUVector::xffffffff());
+}
+
+/// In the reference, the sign offset is applied after the threshold loops have moved p past the macroblock,
+/// so it only changes the macroblock when no threshold is set. The write past the end isn't kept.
+static __fi void ipu_threshold(macroblock_rgb32& rgb32, int sgn, const u16* thresh)
+{
+	constexpr u32 pixels = sizeof(IPUVector) / sizeof(u32);
+	u32* const p = reinterpret_cast<u32*>(&rgb32);
+
+	if (thresh[0] > 0 || thresh[1] > 0)
+	{
+		const IPUVector alpha(0x40000000);
+		const IPUVector rgb(0x00ffffff);
+
+		for (u32 i = 0; i < 16 * 16; i += pixels)
+		{
+			IPUVector v = IPUVector::load<false>(p + i);
+			const IPUVector zero_mask = ipu_threshold_mask(v, thresh[0]);
+			const IPUVector alpha_mask = ipu_threshold_mask(v, thresh[1]);
+			v = v.blend8((v & rgb) | alpha, alpha_mask).andnot(zero_mask);
+			IPUVector::store<false>(p + i, v);
+		}
+	}
+	else if (sgn)
+	{
+		const IPUVector offset(0x808080);
+
+		for (u32 i = 0; i < 16 * 16; i += pixels)
+			IPUVector::store<false>(p + i, IPUVector::load<false>(p + i) ^ offset);
+	}
+}
+
+static __fi void ipu_vq_reference(const macroblock_rgb16& rgb16, u8* indx4, const rgb16_t* vqclut)
+{
+	const auto closest_index = [&](int i, int j) {
+		u8 index = 0;
+		int min_distance = std::numeric_limits<int>::max();
+		for (u8 k = 0; k < 16; ++k)
+		{
+			const int dr = rgb16.c[i][j].r - vqclut[k].r;
+			const int dg = rgb16.c[i][j].g - vqclut[k].g;
+			const int db = rgb16.c[i][j].b - vqclut[k].b;
+			const int distance = dr * dr + dg * dg + db * db;
+
+			// XXX: If two distances are the same which index is used?
+			if (min_distance > distance)
+			{
+				index = k;
+				min_distance = distance;
+			}
+		}
+
+		return index;
+	};
+
+	for (int i = 0; i < 16; ++i)
+		for (int j = 0; j < 8; ++j)
+			indx4[i * 8 + j] = closest_index(i, 2 * j + 1) << 4 | closest_index(i, 2 * j);
+}
+
+/// Index of the closest CLUT entry for each 16-bit pixel, the first one wins on ties.
+static __fi IPUVector ipu_vq_closest(const IPUVector& p, const rgb16_t* vqclut)
+{
+	// Components are 5 bits, so the squared distance fits in 16 bits.
+	const IPUVector mask(0x001f001f);
+	const IPUVector r = p & mask;
+	const IPUVector g = p.srl16<5>() & mask;
+	const IPUVector b = p.srl16<10>() & mask;
+
+	const auto distance = [&](const rgb16_t& c) {
+		const IPUVector dr = r.sub16(IPUVector(static_cast<int>(c.r * 0x10001u)));
+		const IPUVector dg = g.sub16(IPUVector(static_cast<int>(c.g * 0x10001u)));
+		const IPUVector db = b.sub16(IPUVector(static_cast<int>(c.b * 0x10001u)));
+		return dr.mul16l(dr).add16(dg.mul16l(dg)).add16(db.mul16l(db));
+	};
+
+	IPUVector min_distance = distance(vqclut[0]);
+	IPUVector index = IPUVector::zero();
+	for (u32 k = 1; k < 16; k++)
+	{
+		const IPUVector d = distance(vqclut[k]);
+		const IPUVector closer = d.lt16(min_distance);
+		min_distance = min_distance.blend8(d, closer);
+		index = index.blend8(IPUVector(static_cast<int>(k * 0x10001u)), closer);
+	}
+
+	return index;
+}
+
+/// Packs the indices of 8 pixels in 16-bit lanes to 4 bytes, odd pixels in the high nibble.
+static __fi GSVector4i ipu_vq_pack(const GSVector4i& index)
+{
+	return (index | index.srl32<12>()) & GSVector4i(0xff);
+}
+
+static __fi void ipu_vq(const macroblock_rgb16& rgb16, u8* indx4, const rgb16_t* vqclut)
+{
+	for (int i = 0; i < 16; i++)
+	{
+#if _M_SSE >= 0x501
+		const GSVector8i index = ipu_vq_closest(GSVector8i::load<false>(&rgb16.c[i][0]), vqclut);
+		const GSVector4i lo = ipu_vq_pack(index.extract<0>());
+		const GSVector4i hi = ipu_vq_pack(index.extract<1>());
+#else
+		const GSVector4i lo = ipu_vq_pack(ipu_vq_closest(GSVector4i::load<false>(&rgb16.c[i][0]), vqclut));
+		const GSVector4i hi = ipu_vq_pack(ipu_vq_closest(GSVector4i::load<false>(&rgb16.c[i][8]), vqclut));
+#endif
+		GSVector4i::storel(indx4 + i * 8, lo.ps32(hi).pu16());
+	}
+}
+
+MULTI_ISA_UNSHARED_END
@@ -13,20 +13,13 @@
 #include "IPU/IPUdma.h"
 #include "IPU/yuv2rgb.h"
 #include "IPU/IPU_MultiISA.h"
+#include "IPU/IPU_Kernels.h"
 
 // the IPU is fixed to 16 byte strides (128-bit / QWC resolution):
 static const uint decoder_stride = 16;
 
 #if MULTI_ISA_COMPILE_ONCE
 
-static constexpr std::array<u8, 1024> make_clip_lut()
-{
-	std::array<u8, 1024> lut = {};
-	for (int i = -384; i < 640; i++)
-		lut[i+384] = (i < 0) ? 0 : ((i > 255) ? 255 : i);
-	return lut;
-}
-
 static constexpr mpeg2_scan_pack make_scan_pack()
 {
 	constexpr u8 mpeg2_scan_norm[64] = {
@@ -57,15 +50,13 @@ static constexpr mpeg2_scan_pack make_scan_pack()
 	return pack;
 }
 
-alignas(16) const std::array<u8, 1024> g_idct_clip_lut = make_clip_lut();
 alignas(16) const mpeg2_scan_pack mpeg2_scan = make_scan_pack();
 
 #endif
 
 MULTI_ISA_UNSHARED_START
 
-static void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn);
-static void ipu_vq(macroblock_rgb16& rgb16, u8* indx4);
+static void ipu_csc(const macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn, const u16* thresh);
 
 // --------------------------------------------------------------------------------------
 //  Buffer reader
@@ -192,152 +183,16 @@ __ri static u8 getBits8(u8 *address, bool advance)
 }
 
 
-#define W1 2841 /* 2048*sqrt (2)*cos (1*pi/16) */
-#define W2 2676 /* 2048*sqrt (2)*cos (2*pi/16) */
-#define W3 2408 /* 2048*sqrt (2)*cos (3*pi/16) */
-#define W5 1609 /* 2048*sqrt (2)*cos (5*pi/16) */
-#define W6 1108 /* 2048*sqrt (2)*cos (6*pi/16) */
-#define W7 565  /* 2048*sqrt (2)*cos (7*pi/16) */
-
-/*
- * In legal streams, the IDCT output should be between -384 and +384.
- * In corrupted streams, it is possible to force the IDCT output to go
- * to +-3826 - this is the worst case for a column IDCT where the
- * column inputs are 16-bit values.
- */
-
-__fi static void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
-{
-	int tmp = w0 * (d0 + d1);
-	t0 = tmp + (w1 - w0) * d1;
-	t1 = tmp - (w1 + w0) * d0;
-}
-
-__ri static void IDCT_Block(s16* block)
-{
-	for (int i = 0; i < 8; i++)
-	{
-		s16* const rblock = block + 8 * i;
-		if (!(rblock[1] | ((s32*)rblock)[1] | ((s32*)rblock)[2] |
-				((s32*)rblock)[3]))
-		{
-			u32 tmp = (u16)(rblock[0] << 3);
-			tmp |= tmp << 16;
-			((s32*)rblock)[0] = tmp;
-			((s32*)rblock)[1] = tmp;
-			((s32*)rblock)[2] = tmp;
-			((s32*)rblock)[3] = tmp;
-			continue;
-		}
-
-		int a0, a1, a2, a3;
-		{
-			const int d0 = (rblock[0] << 11) + 128;
-			const int d1 = rblock[1];
-			const int d2 = rblock[2] << 11;
-			const int d3 = rblock[3];
-			int t0 = d0 + d2;
-			int t1 = d0 - d2;
-			int t2, t3;
-			BUTTERFLY(t2, t3, W6, W2, d3, d1);
-			a0 = t0 + t2;
-			a1 = t1 + t3;
-			a2 = t1 - t3;
-			a3 = t0 - t2;
-		}
-
-		int b0, b1, b2, b3;
-		{
-			const int d0 = rblock[4];
-			const int d1 = rblock[5];
-			const int d2 = rblock[6];
-			const int d3 = rblock[7];
-			int t0, t1, t2, t3;
-			BUTTERFLY(t0, t1, W7, W1, d3, d0);
-			BUTTERFLY(t2, t3, W3, W5, d1, d2);
-			b0 = t0 + t2;
-			b3 = t1 + t3;
-			t0 -= t2;
-			t1 -= t3;
-			b1 = ((t0 + t1) * 181) >> 8;
-			b2 = ((t0 - t1) * 181) >> 8;
-		}
-
-		rblock[0] = (a0 + b0) >> 8;
-		rblock[1] = (a1 + b1) >> 8;
-		rblock[2] = (a2 + b2) >> 8;
-		rblock[3] = (a3 + b3) >> 8;
-		rblock[4] = (a3 - b3) >> 8;
-		rblock[5] = (a2 - b2) >> 8;
-		rblock[6] = (a1 - b1) >> 8;
-		rblock[7] = (a0 - b0) >> 8;
-	}
-
-	for (int i = 0; i < 8; i++)
-	{
-		s16* const cblock = block + i;
-
-		int a0, a1, a2, a3;
-		{
-			const int d0 = (cblock[8 * 0] << 11) + 65536;
-			const int d1 = cblock[8 * 1];
-			const int d2 = cblock[8 * 2] << 11;
-			const int d3 = cblock[8 * 3];
-			const int t0 = d0 + d2;
-			const int t1 = d0 - d2;
-			int t2;
-			int t3;
-			BUTTERFLY(t2, t3, W6, W2, d3, d1);
-			a0 = t0 + t2;
-			a1 = t1 + t3;
-			a2 = t1 - t3;
-			a3 = t0 - t2;
-		}
-
-		int b0, b1, b2, b3;
-		{
-			const int d0 = cblock[8 * 4];
-			const int d1 = cblock[8 * 5];
-			const int d2 = cblock[8 * 6];
-			const int d3 = cblock[8 * 7];
-			int t0, t1, t2, t3;
-			BUTTERFLY(t0, t1, W7, W1, d3, d0);
-			BUTTERFLY(t2, t3, W3, W5, d1, d2);
-			b0 = t0 + t2;
-			b3 = t1 + t3;
-			t0 = (t0 - t2) >> 8;
-			t1 = (t1 - t3) >> 8;
-			b1 = (t0 + t1) * 181;
-			b2 = (t0 - t1) * 181;
-		}
-
-		cblock[8 * 0] = (a0 + b0) >> 17;
-		cblock[8 * 1] = (a1 + b1) >> 17;
-		cblock[8 * 2] = (a2 + b2) >> 17;
-		cblock[8 * 3] = (a3 + b3) >> 17;
-		cblock[8 * 4] = (a3 - b3) >> 17;
-		cblock[8 * 5] = (a2 - b2) >> 17;
-		cblock[8 * 6] = (a1 - b1) >> 17;
-		cblock[8 * 7] = (a0 - b0) >> 17;
-	}
-}
-
 __ri static void IDCT_Copy(s16* block, u8* dest, const int stride)
 {
-	IDCT_Block(block);
+	GSVector4i rows[8];
+	IDCT_Block(block, rows);
 
+	// Legal streams only produce -384 to +384, which saturating to u8 clips the same as a lookup table would.
 	for (int i = 0; i < 8; i++)
 	{
-		dest[0] = (g_idct_clip_lut.data() + 384)[block[0]];
-		dest[1] = (g_idct_clip_lut.data() + 384)[block[1]];
-		dest[2] = (g_idct_clip_lut.data() + 384)[block[2]];
-		dest[3] = (g_idct_clip_lut.data() + 384)[block[3]];
-		dest[4] = (g_idct_clip_lut.data() + 384)[block[4]];
-		dest[5] = (g_idct_clip_lut.data() + 384)[block[5]];
-		dest[6] = (g_idct_clip_lut.data() + 384)[block[6]];
-		dest[7] = (g_idct_clip_lut.data() + 384)[block[7]];
-
-		std::memset(block, 0, 16);
+		GSVector4i::storel(dest, rows[i].pu16());
+		GSVector4i::store<true>(block, GSVector4i::zero());
 
 		dest += stride;
 		block += 8;
@@ -352,13 +207,13 @@ __ri static void IDCT_Add(const int last, s16* block, s16* dest, const int strid
 
 	if (last != 129 || (block[0] & 7) == 4)
 	{
-		IDCT_Block(block);
+		GSVector4i rows[8];
+		IDCT_Block(block, rows);
 
-		const r128 zero = r128_zero();
 		for (int i = 0; i < 8; i++)
 		{
-			r128_store(dest, r128_load(block));
-			r128_store(block, zero);
+			GSVector4i::store<true>(dest, rows[i]);
+			GSVector4i::store<true>(block, GSVector4i::zero());
 
 			dest += stride;
 			block += 8;
@@ -1085,7 +940,7 @@ __ri static bool mpeg2sliceIDEC()
 				}
 
 				// Send The MacroBlock via DmaIpuFrom
-				ipu_csc(mb8, rgb32, decoder.sgn);
+				ipu_csc(mb8, rgb32, decoder.sgn, g_ipu_thresh);
 
 				if (decoder.ofm == 0)
 					decoder.SetOutputTo(rgb32);
@@ -1801,7 +1656,7 @@ __ri static bool ipuCSC(tIPU_CMD_CSC csc)
 			if (!getBits64((u8*)&decoder.mb8 + 8 * ipu_cmd.pos[0], 1)) return false;
 		}
 
-		ipu_csc(decoder.mb8, decoder.rgb32, 0);
+		ipu_csc(decoder.mb8, decoder.rgb32, 0, g_ipu_thresh);
 		if (csc.OFM) ipu_dither(decoder.rgb32, decoder.rgb16, csc.DTE);
 
 		if (csc.OFM)
@@ -1843,7 +1698,7 @@ __ri static bool ipuPACK(tIPU_CMD_CSC csc)
 
 		ipu_dither(decoder.rgb32, decoder.rgb16, csc.DTE);
 
-		if (!csc.OFM) ipu_vq(decoder.rgb16, g_ipu_indx4);
+		if (!csc.OFM) ipu_vq(decoder.rgb16, g_ipu_indx4, g_ipu_vqclut);
 
 		if (csc.OFM)
 		{
@@ -1875,66 +1730,10 @@ __ri static bool ipuPACK(tIPU_CMD_CSC csc)
 //  CORE Functions (referenced from MPEG library)
 // --------------------------------------------------------------------------------------
 
-__fi static void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
-{
-	int i;
-	u8* p = (u8*)&rgb32;
-
-	yuv2rgb();
-
-	if (g_ipu_thresh[0] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < g_ipu_thresh[0]) && (p[1] < g_ipu_thresh[0]) && (p[2] < g_ipu_thresh[0]))
-				*(u32*)p = 0;
-			else if ((p[0] < g_ipu_thresh[1]) && (p[1] < g_ipu_thresh[1]) && (p[2] < g_ipu_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	else if (g_ipu_thresh[1] > 0)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			if ((p[0] < g_ipu_thresh[1]) && (p[1] < g_ipu_thresh[1]) && (p[2] < g_ipu_thresh[1]))
-				p[3] = 0x40;
-		}
-	}
-	if (sgn)
-	{
-		for (i = 0; i < 16*16; i++, p += 4)
-		{
-			*(u32*)p ^= 0x808080;
-		}
-	}
-}
-
-__fi static void ipu_vq(macroblock_rgb16& rgb16, u8* indx4)
+__fi static void ipu_csc(const macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn, const u16* thresh)
 {
-	const auto closest_index = [&](int i, int j) {
-		u8 index = 0;
-		int min_distance = std::numeric_limits<int>::max();
-		for (u8 k = 0; k < 16; ++k)
-		{
-			const int dr = rgb16.c[i][j].r - g_ipu_vqclut[k].r;
-			const int dg = rgb16.c[i][j].g - g_ipu_vqclut[k].g;
-			const int db = rgb16.c[i][j].b - g_ipu_vqclut[k].b;
-			const int distance = dr * dr + dg * dg + db * db;
-
-			// XXX: If two distances are the same which index is used?
-			if (min_distance > distance)
-			{
-				index = k;
-				min_distance = distance;
-			}
-		}
-
-		return index;
-	};
-
-	for (int i = 0; i < 16; ++i)
-		for (int j = 0; j < 8; ++j)
-			indx4[i * 8 + j] = closest_index(i, 2 * j + 1) << 4 | closest_index(i, 2 * j);
+	yuv2rgb(mb8, rgb32);
+	ipu_threshold(rgb32, sgn, thresh);
 }
 
 __noinline void IPUWorker()
@@ -21,11 +21,8 @@
 MULTI_ISA_UNSHARED_START
 
 // conforming implementation for reference, do not optimise
-void yuv2rgb_reference(void)
+void yuv2rgb_reference(const macroblock_8& mb8, macroblock_rgb32& rgb32)
 {
-	const macroblock_8& mb8 = decoder.mb8;
-	macroblock_rgb32& rgb32 = decoder.rgb32;
-
 	for (int y = 0; y < 16; y++)
 		for (int x = 0; x < 16; x++)
 		{
@@ -45,10 +42,7 @@ void yuv2rgb_reference(void)
 #if defined(ARCH_X86)
 
 // Suikoden Tactics FMV speed results: Reference - ~72fps, SSE2 - ~120fps
-// An AVX2 version is only slightly faster than an SSE2 version (+2-3fps)
-// (or I'm a poor optimiser), though it might be worth attempting again
-// once we've ported to 64 bits (the extra registers should help).
-__ri void yuv2rgb_sse2()
+__ri void yuv2rgb_sse2(const macroblock_8& mb8, macroblock_rgb32& rgb32)
 {
 	const __m128i c_bias = _mm_set1_epi8(s8(IPU_C_BIAS));
 	const __m128i y_bias = _mm_set1_epi8(IPU_Y_BIAS);
@@ -69,8 +63,8 @@ __ri void yuv2rgb_sse2()
 	for (int n = 0; n < 8; ++n) {
 		// could skip the loadl_epi64 but most SSE instructions require 128-bit
 		// alignment so two versions would be needed.
-		__m128i cb = _mm_loadl_epi64(reinterpret_cast<__m128i*>(&decoder.mb8.Cb[n][0]));
-		__m128i cr = _mm_loadl_epi64(reinterpret_cast<__m128i*>(&decoder.mb8.Cr[n][0]));
+		__m128i cb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&mb8.Cb[n][0]));
+		__m128i cr = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&mb8.Cr[n][0]));
 
 		// (Cb - 128) << 8, (Cr - 128) << 8
 		cb = _mm_xor_si128(cb, c_bias);
@@ -83,7 +77,7 @@ __ri void yuv2rgb_sse2()
 		__m128i bc = _mm_mulhi_epi16(cb, bcb_coefficient);
 
 		for (int m = 0; m < 2; ++m) {
-			__m128i y = _mm_load_si128(reinterpret_cast<__m128i*>(&decoder.mb8.Y[n * 2 + m][0]));
+			__m128i y = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb8.Y[n * 2 + m][0]));
 			y = _mm_subs_epu8(y, y_bias);
 			// Y << 8 for pixels 0, 2, 4, 6, 8, 10, 12, 14
 			__m128i y_even = _mm_slli_epi16(y, 8);
@@ -128,14 +122,98 @@ __ri void yuv2rgb_sse2()
 			__m128i rgba_hl = _mm_unpacklo_epi16(rg_h, ba_h);
 			__m128i rgba_hh = _mm_unpackhi_epi16(rg_h, ba_h);
 
-			_mm_store_si128(reinterpret_cast<__m128i*>(&decoder.rgb32.c[n * 2 + m][0]), rgba_ll);
-			_mm_store_si128(reinterpret_cast<__m128i*>(&decoder.rgb32.c[n * 2 + m][4]), rgba_lh);
-			_mm_store_si128(reinterpret_cast<__m128i*>(&decoder.rgb32.c[n * 2 + m][8]), rgba_hl);
-			_mm_store_si128(reinterpret_cast<__m128i*>(&decoder.rgb32.c[n * 2 + m][12]), rgba_hh);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&rgb32.c[n * 2 + m][0]), rgba_ll);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&rgb32.c[n * 2 + m][4]), rgba_lh);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&rgb32.c[n * 2 + m][8]), rgba_hl);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&rgb32.c[n * 2 + m][12]), rgba_hh);
 		}
 	}
 }
 
+#if _M_SSE >= 0x501
+
+// Same as the SSE2 version, with both luma rows sharing a line of chroma in the two halves.
+__ri void yuv2rgb_avx2(const macroblock_8& mb8, macroblock_rgb32& rgb32)
+{
+	const __m256i c_bias = _mm256_set1_epi8(s8(IPU_C_BIAS));
+	const __m256i y_bias = _mm256_set1_epi8(IPU_Y_BIAS);
+	const __m256i y_mask = _mm256_set1_epi16(s16(0xFF00));
+	const __m256i round_1bit = _mm256_set1_epi16(0x0001);
+
+	const __m256i y_coefficient = _mm256_set1_epi16(s16(IPU_Y_COEFF << 2));
+	const __m256i gcr_coefficient = _mm256_set1_epi16(s16(u16(IPU_GCR_COEFF) << 2));
+	const __m256i gcb_coefficient = _mm256_set1_epi16(s16(u16(IPU_GCB_COEFF) << 2));
+	const __m256i rcr_coefficient = _mm256_set1_epi16(s16(IPU_RCR_COEFF << 2));
+	const __m256i bcb_coefficient = _mm256_set1_epi16(s16(IPU_BCB_COEFF << 2));
+
+	const __m256i& alpha = c_bias;
+
+	for (int n = 0; n < 8; ++n) {
+		__m256i cb = _mm256_broadcastsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&mb8.Cb[n][0])));
+		__m256i cr = _mm256_broadcastsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&mb8.Cr[n][0])));
+
+		// (Cb - 128) << 8, (Cr - 128) << 8
+		cb = _mm256_xor_si256(cb, c_bias);
+		cr = _mm256_xor_si256(cr, c_bias);
+		cb = _mm256_unpacklo_epi8(_mm256_setzero_si256(), cb);
+		cr = _mm256_unpacklo_epi8(_mm256_setzero_si256(), cr);
+
+		const __m256i rc = _mm256_mulhi_epi16(cr, rcr_coefficient);
+		const __m256i gc = _mm256_adds_epi16(_mm256_mulhi_epi16(cr, gcr_coefficient), _mm256_mulhi_epi16(cb, gcb_coefficient));
+		const __m256i bc = _mm256_mulhi_epi16(cb, bcb_coefficient);
+
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&mb8.Y[n * 2][0]));
+		y = _mm256_subs_epu8(y, y_bias);
+		__m256i y_even = _mm256_slli_epi16(y, 8);
+		__m256i y_odd = _mm256_and_si256(y, y_mask);
+
+		y_even = _mm256_mulhi_epu16(y_even, y_coefficient);
+		y_odd  = _mm256_mulhi_epu16(y_odd,  y_coefficient);
+
+		__m256i r_even = _mm256_adds_epi16(rc, y_even);
+		__m256i r_odd  = _mm256_adds_epi16(rc, y_odd);
+		__m256i g_even = _mm256_adds_epi16(gc, y_even);
+		__m256i g_odd  = _mm256_adds_epi16(gc, y_odd);
+		__m256i b_even = _mm256_adds_epi16(bc, y_even);
+		__m256i b_odd  = _mm256_adds_epi16(bc, y_odd);
+
+		// round
+		r_even = _mm256_srai_epi16(_mm256_add_epi16(r_even, round_1bit), 1);
+		r_odd  = _mm256_srai_epi16(_mm256_add_epi16(r_odd,  round_1bit), 1);
+		g_even = _mm256_srai_epi16(_mm256_add_epi16(g_even, round_1bit), 1);
+		g_odd  = _mm256_srai_epi16(_mm256_add_epi16(g_odd,  round_1bit), 1);
+		b_even = _mm256_srai_epi16(_mm256_add_epi16(b_even, round_1bit), 1);
+		b_odd  = _mm256_srai_epi16(_mm256_add_epi16(b_odd,  round_1bit), 1);
+
+		// combine even and odd bytes in original order
+		__m256i r = _mm256_packus_epi16(r_even, r_odd);
+		__m256i g = _mm256_packus_epi16(g_even, g_odd);
+		__m256i b = _mm256_packus_epi16(b_even, b_odd);
+
+		r = _mm256_unpacklo_epi8(r, _mm256_shuffle_epi32(r, _MM_SHUFFLE(3, 2, 3, 2)));
+		g = _mm256_unpacklo_epi8(g, _mm256_shuffle_epi32(g, _MM_SHUFFLE(3, 2, 3, 2)));
+		b = _mm256_unpacklo_epi8(b, _mm256_shuffle_epi32(b, _MM_SHUFFLE(3, 2, 3, 2)));
+
+		const __m256i rg_l = _mm256_unpacklo_epi8(r, g);
+		const __m256i ba_l = _mm256_unpacklo_epi8(b, alpha);
+		const __m256i rgba_ll = _mm256_unpacklo_epi16(rg_l, ba_l);
+		const __m256i rgba_lh = _mm256_unpackhi_epi16(rg_l, ba_l);
+
+		const __m256i rg_h = _mm256_unpackhi_epi8(r, g);
+		const __m256i ba_h = _mm256_unpackhi_epi8(b, alpha);
+		const __m256i rgba_hl = _mm256_unpacklo_epi16(rg_h, ba_h);
+		const __m256i rgba_hh = _mm256_unpackhi_epi16(rg_h, ba_h);
+
+		// Each half holds one row, so swap the halves around to store whole rows.
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&rgb32.c[n * 2][0]), _mm256_permute2x128_si256(rgba_ll, rgba_lh, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&rgb32.c[n * 2][8]), _mm256_permute2x128_si256(rgba_hl, rgba_hh, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&rgb32.c[n * 2 + 1][0]), _mm256_permute2x128_si256(rgba_ll, rgba_lh, 0x31));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&rgb32.c[n * 2 + 1][8]), _mm256_permute2x128_si256(rgba_hl, rgba_hh, 0x31));
+	}
+}
+
+#endif
+
 #elif defined(ARCH_ARM64)
 
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -146,7 +224,7 @@ __ri void yuv2rgb_sse2()
 
 #define MULHI16(a, b) vshrq_n_s16(vqdmulhq_s16((a), (b)), 1)
 
-__ri void yuv2rgb_neon()
+__ri void yuv2rgb_neon(const macroblock_8& mb8, macroblock_rgb32& rgb32)
 {
 	const int8x16_t c_bias = vdupq_n_s8(s8(IPU_C_BIAS));
 	const uint8x16_t y_bias = vdupq_n_u8(IPU_Y_BIAS);
@@ -169,8 +247,8 @@ __ri void yuv2rgb_neon()
 	{
 		// could skip the loadl_epi64 but most SSE instructions require 128-bit
 		// alignment so two versions would be needed.
-		int8x16_t cb = vcombine_s8(vld1_s8(reinterpret_cast<s8*>(&decoder.mb8.Cb[n][0])), vdup_n_s8(0));
-		int8x16_t cr = vcombine_s8(vld1_s8(reinterpret_cast<s8*>(&decoder.mb8.Cr[n][0])), vdup_n_s8(0));
+		int8x16_t cb = vcombine_s8(vld1_s8(reinterpret_cast<const s8*>(&mb8.Cb[n][0])), vdup_n_s8(0));
+		int8x16_t cr = vcombine_s8(vld1_s8(reinterpret_cast<const s8*>(&mb8.Cr[n][0])), vdup_n_s8(0));
 
 		// (Cb - 128) << 8, (Cr - 128) << 8
 		cb = veorq_s8(cb, c_bias);
@@ -184,7 +262,7 @@ __ri void yuv2rgb_neon()
 
 		for (int m = 0; m < 2; ++m)
 		{
-			uint8x16_t y = vld1q_u8(&decoder.mb8.Y[n * 2 + m][0]);
+			uint8x16_t y = vld1q_u8(&mb8.Y[n * 2 + m][0]);
 			y = vqsubq_u8(y, y_bias);
 			// Y << 8 for pixels 0, 2, 4, 6, 8, 10, 12, 14
 			int16x8_t y_even = vshlq_n_s16(vreinterpretq_s16_u8(y), 8);
@@ -241,10 +319,10 @@ __ri void yuv2rgb_neon()
 			uint16x8_t rgba_hl = vzip1q_u16(vreinterpretq_u16_u8(rg_h), vreinterpretq_u16_u8(ba_h));
 			uint16x8_t rgba_hh = vzip2q_u16(vreinterpretq_u16_u8(rg_h), vreinterpretq_u16_u8(ba_h));
 
-			vst1q_u8(reinterpret_cast<u8*>(&decoder.rgb32.c[n * 2 + m][0]), vreinterpretq_u8_u16(rgba_ll));
-			vst1q_u8(reinterpret_cast<u8*>(&decoder.rgb32.c[n * 2 + m][4]), vreinterpretq_u8_u16(rgba_lh));
-			vst1q_u8(reinterpret_cast<u8*>(&decoder.rgb32.c[n * 2 + m][8]), vreinterpretq_u8_u16(rgba_hl));
-			vst1q_u8(reinterpret_cast<u8*>(&decoder.rgb32.c[n * 2 + m][12]), vreinterpretq_u8_u16(rgba_hh));
+			vst1q_u8(reinterpret_cast<u8*>(&rgb32.c[n * 2 + m][0]), vreinterpretq_u8_u16(rgba_ll));
+			vst1q_u8(reinterpret_cast<u8*>(&rgb32.c[n * 2 + m][4]), vreinterpretq_u8_u16(rgba_lh));
+			vst1q_u8(reinterpret_cast<u8*>(&rgb32.c[n * 2 + m][8]), vreinterpretq_u8_u16(rgba_hl));
+			vst1q_u8(reinterpret_cast<u8*>(&rgb32.c[n * 2 + m][12]), vreinterpretq_u8_u16(rgba_hh));
 		}
 	}
 }
@@ -5,16 +5,24 @@
 
 #include "GS/MultiISA.h"
 
-MULTI_ISA_DEF(extern void yuv2rgb_reference();)
+struct macroblock_8;
+struct macroblock_rgb32;
+
+MULTI_ISA_DEF(extern void yuv2rgb_reference(const macroblock_8& mb8, macroblock_rgb32& rgb32);)
 
 #if defined(ARCH_X86)
 
+#if _M_SSE >= 0x501
+#define yuv2rgb yuv2rgb_avx2
+#else
 #define yuv2rgb yuv2rgb_sse2
-MULTI_ISA_DEF(extern void yuv2rgb_sse2();)
+#endif
+MULTI_ISA_DEF(extern void yuv2rgb_sse2(const macroblock_8& mb8, macroblock_rgb32& rgb32);)
+MULTI_ISA_DEF(extern void yuv2rgb_avx2(const macroblock_8& mb8, macroblock_rgb32& rgb32);)
 
 #elif defined(ARCH_ARM64)
 
 #define yuv2rgb yuv2rgb_neon
-MULTI_ISA_DEF(extern void yuv2rgb_neon();)
+MULTI_ISA_DEF(extern void yuv2rgb_neon(const macroblock_8& mb8, macroblock_rgb32& rgb32);)
 
 #endif
@@ -47,6 +47,7 @@ namespace FullscreenUI
 	TinyString TimeToPrintableString(time_t t);
 	
 	bool CreateHardDriveWithProgress(const std::string& filePath, int sizeInGB, bool use48BitLBA = true);
+	bool CreateHardDriveFromImageWithProgress(const std::string& filePath, const std::string& sourcePath, bool overlay);
 	void CancelAllHddOperations();
 } // namespace FullscreenUI
 
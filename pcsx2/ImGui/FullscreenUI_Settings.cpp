@@ -18,6 +18,7 @@
 #include "USB/USB.h"
 #include "VMManager.h"
 #include "ps2/BiosTools.h"
+#include "DEV9/ATA/HddBlockImage.h"
 #include "DEV9/ATA/HddCreate.h"
 #include "DEV9/pcap_io.h"
 #include "DEV9/sockets.h"
@@ -70,13 +71,57 @@ namespace FullscreenUI
 			if (filePath.empty() || sizeInGB <= 0)
 				return false;
 
-			std::string dialogId = fmt::format("hdd_create_{}", s_nextOperationId.fetch_add(1, std::memory_order_relaxed));
-
-			std::shared_ptr<HddCreateInProgress> instance = std::make_shared<HddCreateInProgress>(dialogId);
+			std::shared_ptr<HddCreateInProgress> instance = CreateInstance();
 
 			// Convert GB to bytes
 			const u64 sizeBytes = static_cast<u64>(sizeInGB) * static_cast<u64>(_1gb);
 
+			// Setup the creation parameters
+			instance->filePath = filePath;
+			instance->neededSize = sizeBytes;
+
+			return Run(std::move(instance));
+		}
+
+		// Creates a block allocated image, converted from the raw image at sourcePath, or as an overlay on it.
+		static bool StartCreationFromImage(const std::string& filePath, const std::string& sourcePath, bool overlay)
+		{
+			if (filePath.empty() || sourcePath.empty())
+				return false;
+
+			std::shared_ptr<HddCreateInProgress> instance = CreateInstance();
+
+			// The size is taken from the source image
+			instance->filePath = filePath;
+			instance->neededSize = 0;
+			instance->blockImage = true;
+			if (overlay)
+				instance->basePath = sourcePath;
+			else
+				instance->sourcePath = sourcePath;
+
+			return Run(std::move(instance));
+		}
+
+		static void CancelAllOperations()
+		{
+			std::lock_guard<std::mutex> lock(s_operationsMutex);
+			for (auto& operation : s_activeOperations)
+				operation->SetCanceled();
+			s_activeOperations.clear();
+		}
+
+	private:
+		static std::shared_ptr<HddCreateInProgress> CreateInstance()
+		{
+			std::string dialogId = fmt::format("hdd_create_{}", s_nextOperationId.fetch_add(1, std::memory_order_relaxed));
+			return std::make_shared<HddCreateInProgress>(dialogId);
+		}
+
+		static bool Run(std::shared_ptr<HddCreateInProgress> instance)
+		{
+			const std::string& filePath = instance->filePath;
+
 			// Make sure the file doesn't already exist (or delete it if it does)
 			if (FileSystem::FileExists(filePath.c_str()))
 			{
@@ -90,10 +135,6 @@ namespace FullscreenUI
 				}
 			}
 
-			// Setup the creation parameters
-			instance->filePath = filePath;
-			instance->neededSize = sizeBytes;
-
 			// Register the operation
 			{
 				std::lock_guard<std::mutex> lock(s_operationsMutex);
@@ -133,14 +174,6 @@ namespace FullscreenUI
 			return true;
 		}
 
-		static void CancelAllOperations()
-		{
-			std::lock_guard<std::mutex> lock(s_operationsMutex);
-			for (auto& operation : s_activeOperations)
-				operation->SetCanceled();
-			s_activeOperations.clear();
-		}
-
 	protected:
 		virtual void Init() override
 		{
@@ -181,6 +214,18 @@ namespace FullscreenUI
 		return HddCreateInProgress::StartCreation(filePath, sizeInGB, use48BitLBA);
 	}
 
+	bool CreateHardDriveFromImageWithProgress(const std::string& filePath, const std::string& sourcePath, bool overlay)
+	{
+		// Replacing the source would delete it before it's read
+		if (FileSystem::FileExists(filePath.c_str()) && Path::RealPath(filePath) == Path::RealPath(sourcePath))
+		{
+			ShowToast(ICON_FA_TRIANGLE_EXCLAMATION, "The new HDD image can't replace the image it's made from.");
+			return false;
+		}
+
+		return HddCreateInProgress::StartCreationFromImage(filePath, sourcePath, overlay);
+	}
+
 	void CancelAllHddOperations()
 	{
 		HddCreateInProgress::CancelAllOperations();
@@ -2618,6 +2663,11 @@ void FullscreenUI::DrawEmulationSettingsPage()
 
 	DrawToggleSetting(bsi, FSUI_ICONSTR(ICON_FA_COMPACT_DISC, "Enable CDVD Precaching"), FSUI_CSTR("Loads the disc image into RAM before starting the virtual machine."),
 		"EmuCore", "CdvdPrecache", false);
+	DrawIntRangeSetting(bsi, FSUI_ICONSTR(ICON_FA_COMPACT_DISC, "Compressed Image Readahead"),
+		FSUI_CSTR("Number of buffers read ahead of the game when streaming from compressed disc images."), "EmuCore", "CdvdReadaheadDepth", 8, 2, 16,
+		FSUI_CSTR("%d buffers"));
+	DrawIntRangeSetting(bsi, FSUI_ICONSTR(ICON_FA_COMPACT_DISC, "Compressed Image Cache Size"),
+		FSUI_CSTR("Amount of decompressed data kept in memory for compressed disc images."), "EmuCore", "CdvdCacheSize", 32, 0, 512, FSUI_CSTR("%d MB"));
 
 	if (IsEditingGameSettings(bsi))
 	{
@@ -4099,12 +4149,12 @@ void FullscreenUI::DrawNetworkHDDSettingsPage()
 			const std::string full_path = fd.FileName;
 			const std::string filename = std::string(Path::GetFileName(full_path));
 
-			// Get file size and determine LBA mode
-			const s64 file_size = FileSystem::GetPathFileSize(full_path.c_str());
-			if (file_size > 0)
+			// Get disk size and determine LBA mode, block allocated images store it in their header
+			const u64 disk_size = HddBlockImage::GetImageSize(full_path).value_or(0);
+			if (disk_size > 0)
 			{
-				const int size_gb = static_cast<int>(file_size / _1gb);
-				const bool uses_lba48 = (file_size > static_cast<s64>(120) * _1gb);
+				const int size_gb = static_cast<int>(disk_size / _1gb);
+				const bool uses_lba48 = (disk_size > static_cast<u64>(120) * _1gb);
 				const std::string lba_mode = uses_lba48 ? "LBA48" : "LBA28";
 
 				choices.emplace_back(fmt::format("{} ({} GB, {})", filename, size_gb, lba_mode),
@@ -4119,6 +4169,12 @@ void FullscreenUI::DrawNetworkHDDSettingsPage()
 		choices.emplace_back(FSUI_STR("Create New..."), false);
 		values.emplace_back("__create__");
 
+		choices.emplace_back(FSUI_STR("Convert to Block Allocated..."), false);
+		values.emplace_back("__convert__");
+
+		choices.emplace_back(FSUI_STR("Create Overlay..."), false);
+		values.emplace_back("__overlay__");
+
 		OpenChoiceDialog(FSUI_CSTR("HDD Image Selection"), false, std::move(choices),
 			[game_settings = IsEditingGameSettings(bsi), values = std::move(values)](s32 index, const std::string& title, bool checked) {
 				if (index < 0)
@@ -4138,6 +4194,44 @@ void FullscreenUI::DrawNetworkHDDSettingsPage()
 							SetSettingsChanged(bsi);
 							ShowToast(ICON_FA_HARD_DRIVE, fmt::format(FSUI_FSTR("Selected HDD image: {}"), Path::GetFileName(path))); }, {"*.raw", "*"}, EmuFolders::DataRoot);
 				}
+				else if (values[index] == "__convert__" || values[index] == "__overlay__")
+				{
+					CloseChoiceDialog();
+
+					const bool overlay = (values[index] == "__overlay__");
+					OpenFileSelector(overlay ? FSUI_ICONSTR(ICON_FA_HARD_DRIVE, "Select Base HDD Image") : FSUI_ICONSTR(ICON_FA_HARD_DRIVE, "Select HDD Image to Convert"), false,
+						[game_settings, overlay](const std::string& path) {
+							if (path.empty())
+								return;
+
+							const std::string filename = fmt::format("{}_{}.raw", Path::GetFileTitle(path), overlay ? "overlay" : "block");
+							const std::string filepath = Path::Combine(EmuFolders::DataRoot, filename);
+
+							auto create = [filepath, path, overlay, game_settings]() {
+								auto lock = Host::GetSettingsLock();
+								SettingsInterface* bsi = GetEditingSettingsInterface(game_settings);
+								bsi->SetStringValue("DEV9/Hdd", "HddFile", filepath.c_str());
+								SetSettingsChanged(bsi);
+								FullscreenUI::CreateHardDriveFromImageWithProgress(filepath, path, overlay);
+							};
+
+							if (FileSystem::FileExists(filepath.c_str()))
+							{
+								OpenConfirmMessageDialog(
+									FSUI_ICONSTR(ICON_FA_TRIANGLE_EXCLAMATION, "File Already Exists"),
+									fmt::format(FSUI_FSTR("HDD image '{}' already exists. Do you want to overwrite it?"), filename),
+									[create = std::move(create)](bool confirmed) {
+										if (confirmed)
+											create();
+									});
+							}
+							else
+							{
+								create();
+							}
+						},
+						{"*.raw", "*"}, EmuFolders::DataRoot);
+				}
 				else if (values[index] == "__create__")
 				{
 					CloseChoiceDialog();
@@ -5953,6 +6047,10 @@ TRANSLATE_NOOP("FullscreenUI", "Enables loading cheats from pnach files.");
 TRANSLATE_NOOP("FullscreenUI", "Enables access to files from the host: namespace in the virtual machine.");
 TRANSLATE_NOOP("FullscreenUI", "Fast disc access, less loading times. Not recommended.");
 TRANSLATE_NOOP("FullscreenUI", "Loads the disc image into RAM before starting the virtual machine.");
+TRANSLATE_NOOP("FullscreenUI", "Number of buffers read ahead of the game when streaming from compressed disc images.");
+TRANSLATE_NOOP("FullscreenUI", "%d buffers");
+TRANSLATE_NOOP("FullscreenUI", "%d MB");
+TRANSLATE_NOOP("FullscreenUI", "Amount of decompressed data kept in memory for compressed disc images.");
 TRANSLATE_NOOP("FullscreenUI", "Real-Time Clock");
 TRANSLATE_NOOP("FullscreenUI", "Uses a fixed date/time for the virtual PS2 instead of the host clock. Applied on boot only.");
 TRANSLATE_NOOP("FullscreenUI", "Calendar year for the virtual PS2 RTC.");
@@ -6575,6 +6673,8 @@ TRANSLATE_NOOP("FullscreenUI", "Enable Cheats");
 TRANSLATE_NOOP("FullscreenUI", "Enable Host Filesystem");
 TRANSLATE_NOOP("FullscreenUI", "Enable Fast CDVD");
 TRANSLATE_NOOP("FullscreenUI", "Enable CDVD Precaching");
+TRANSLATE_NOOP("FullscreenUI", "Compressed Image Readahead");
+TRANSLATE_NOOP("FullscreenUI", "Compressed Image Cache Size");
 TRANSLATE_NOOP("FullscreenUI", "Manually Set Real-Time Clock");
 TRANSLATE_NOOP("FullscreenUI", "Year");
 TRANSLATE_NOOP("FullscreenUI", "Month");
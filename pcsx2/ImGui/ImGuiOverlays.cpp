@@ -67,6 +67,7 @@ SmallString s_hardware_info_gpu_line;
 SmallString s_cpu_usage_ee_line;
 SmallString s_cpu_usage_gs_line;
 SmallString s_cpu_usage_vu_line;
+SmallString s_vif_cache_line;
 std::vector<SmallString> s_software_thread_lines;
 SmallString s_capture_line;
 SmallString s_gpu_usage_line;
@@ -480,6 +481,11 @@ __ri void ImGuiManager::DrawPerformanceOverlay(float& position_y, float scale, f
 					DRAW_LINE(osd_font, font_size, s_cpu_usage_vu_line.c_str(), white_color);
 				}
 
+				s_vif_cache_line.format("VIF: {:.1f}% hit | {} blocks | {} compiled | {} evicted | chain {}",
+					PerformanceMetrics::GetVIFHitRate(), PerformanceMetrics::GetVIFBlockCount(), PerformanceMetrics::GetVIFCompiles(),
+					PerformanceMetrics::GetVIFEvictions(), PerformanceMetrics::GetVIFMaxChainLength());
+				DRAW_LINE(osd_font, font_size, s_vif_cache_line.c_str(), white_color);
+
 				const u32 gs_sw_threads = PerformanceMetrics::GetGSSWThreadCount();
 				for (u32 thread = 0; thread < gs_sw_threads; thread++)
 				{
@@ -570,6 +576,7 @@ __ri void ImGuiManager::DrawPerformanceOverlay(float& position_y, float scale, f
 				DRAW_LINE(osd_font, font_size, s_cpu_usage_gs_line.c_str(), white_color);
 				if (THREAD_VU1)
 					DRAW_LINE(osd_font, font_size, s_cpu_usage_vu_line.c_str(), white_color);
+				DRAW_LINE(osd_font, font_size, s_vif_cache_line.c_str(), white_color);
 
 				const u32 thread_count = std::min(
 					PerformanceMetrics::GetGSSWThreadCount(),
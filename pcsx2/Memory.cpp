@@ -87,7 +87,7 @@ namespace HostMemoryMap
 
 bool SysMemory::AllocateMemoryMap()
 {
-	s_data_memory_file_handle = HostSys::CreateSharedMemory(HostSys::GetFileMappingName("pcsx2").c_str(), HostMemoryMap::MainSize);
+	s_data_memory_file_handle = HostSys::CreateSharedMemory(GetDataFileMappingName().c_str(), HostMemoryMap::MainSize);
 	if (!s_data_memory_file_handle)
 	{
 		Host::ReportErrorAsync("Error", "Failed to create shared memory file.");
@@ -231,6 +231,11 @@ void* SysMemory::GetDataFileHandle()
 	return s_data_memory_file_handle;
 }
 
+std::string SysMemory::GetDataFileMappingName()
+{
+	return HostSys::GetFileMappingName("pcsx2");
+}
+
 bool memGetExtraMemMode()
 {
 	return s_extra_memory;
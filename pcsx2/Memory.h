@@ -111,6 +111,10 @@ namespace SysMemory
 	/// Returns the file mapping which backs the data memory.
 	void* GetDataFileHandle();
 
+	/// Returns the name the data memory file mapping was created with.
+	/// Only Windows keeps the name around for other processes to open it by.
+	std::string GetDataFileMappingName();
+
 	// clang-format off
 
 	//////////////////////////////////////////////////////////////////////////
@@ -3,8 +3,10 @@
 
 #include "BuildVersion.h"
 #include "Common.h"
+#include "Counters.h"
 #include "Host.h"
 #include "Elfheader.h"
+#include "Memory.h"
 #include "SaveState.h"
 #include "PINE.h"
 #include "VMManager.h"
@@ -15,6 +17,8 @@
 #include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <cstddef>
+#include <mutex>
 #include <span>
 #include <sys/types.h>
 #include <thread>
@@ -47,6 +51,8 @@
 			(a) = -1; \
 		} \
 	} while (0)
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -62,6 +68,7 @@
 			(a) = -1; \
 		} \
 	} while (0)
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -110,6 +117,36 @@ namespace PINEServer
 	// Whether the socket processing thread should stop executing/is stopped.
 	static std::atomic_bool s_end{true};
 
+	// Serializes replies and subscription pushes on the message socket.
+	static std::mutex s_write_mutex;
+
+	/**
+	 * Memory ranges the client subscribed to.
+	 * Read on the CPU thread at every vsync into s_push_buffer, which the
+	 * push thread then sends, so the client gets a consistent snapshot of
+	 * all of them for each frame without a round trip.
+	 */
+	struct SubscriptionRange
+	{
+		u32 address;
+		u32 size;
+	};
+	static std::mutex s_subscription_mutex;
+	static std::vector<SubscriptionRange> s_subscription;
+	static std::atomic_bool s_subscribed{false};
+	// Set while a snapshot is waiting to be sent, frames are dropped until it is.
+	static std::atomic_bool s_push_pending{false};
+	static std::vector<u8> s_push_buffer;
+	static std::thread s_push_thread;
+	static Threading::KernelSemaphore s_push_sema;
+
+	/**
+	 * How long a client gets to take the rest of a push once part of it
+	 * has been sent. A frame can't be dropped halfway without breaking the
+	 * stream, so the client is disconnected after that.
+	 */
+	static constexpr int PUSH_SEND_TIMEOUT_MS = 1000;
+
 	/**
 	 * Maximum memory used by an IPC message request.
 	 * Equivalent to 50,000 Write64 requests.
@@ -159,6 +196,10 @@ namespace PINEServer
 		MsgUUID = 0xD, /**< Returns the game UUID. */
 		MsgGameVersion = 0xE, /**< Returns the game verion. */
 		MsgStatus = 0xF, /**< Returns the emulator status. */
+		MsgReadRange = 0x10, /**< Reads a range of memory. */
+		MsgWriteRange = 0x11, /**< Writes a range of memory. */
+		MsgSubscribe = 0x12, /**< Sets the memory ranges pushed every vsync. */
+		MsgSharedMemory = 0x13, /**< Maps EE memory read-only in the client. */
 		MsgUnimplemented = 0xFF /**< Unimplemented IPC message. */
 	};
 
@@ -180,7 +221,8 @@ namespace PINEServer
 	struct IPCBuffer
 	{
 		int size; /**< Size of the buffer. */
-		std::vector<u8> buffer; /**< Buffer. */
+		std::span<const u8> buffer; /**< Buffer. */
+		int fd = -1; /**< Descriptor passed along with the reply, Linux only. */
 	};
 
 	/**
@@ -192,6 +234,7 @@ namespace PINEServer
 	enum IPCResult : unsigned char
 	{
 		IPC_OK = 0, /**< IPC command successfully completed. */
+		IPC_PUSH = 1, /**< Subscribed memory ranges, sent unprompted. */
 		IPC_FAIL = 0xFF /**< IPC command failed to complete. */
 	};
 
@@ -199,6 +242,32 @@ namespace PINEServer
 	void MainLoop();
 	void ClientLoop();
 
+	// Thread used to send subscribed memory ranges.
+	void PushLoop();
+
+	enum class PushResult
+	{
+		Sent,
+		Dropped, /**< Nothing was sent, the client isn't reading. */
+		Failed /**< The socket failed or the client stalled mid-frame. */
+	};
+
+	/**
+	 * Sends s_push_buffer without blocking on a client which isn't reading.
+	 */
+	static PushResult SendPush();
+
+	/**
+	 * Sends an IPC reply, and the descriptor attached to it if any.
+	 * return value: false if the socket failed.
+	 */
+	static bool SendReply(const IPCBuffer& res);
+
+	/**
+	 * Drops the client's subscription, after which no more pushes are sent.
+	 */
+	static void ClearSubscription();
+
 	/**
 	 * Internal function, Parses an IPC command.
 	 * buf: buffer containing the IPC command.
@@ -350,8 +419,10 @@ bool PINEServer::Initialize(int slot)
 	// request, as malloc is expansive when we optimize for µs.
 	s_ret_buffer.resize(MAX_IPC_RETURN_SIZE);
 	s_ipc_buffer.resize(MAX_IPC_SIZE);
+	s_push_buffer.reserve(MAX_IPC_RETURN_SIZE);
 
-	// we start the thread
+	// we start the threads
+	s_push_thread = std::thread(&PINEServer::PushLoop);
 	s_thread = std::thread(&PINEServer::MainLoop);
 
 	return true;
@@ -407,6 +478,12 @@ bool PINEServer::AcceptClient()
 	setsockopt(s_msgsock, SOL_SOCKET, SO_NOSIGPIPE, &nosigpipe, sizeof(nosigpipe));
 #endif
 
+#ifdef _WIN32
+	// there's no per-call non-blocking send, so bound how long the push thread can wait instead
+	const DWORD send_timeout = PUSH_SEND_TIMEOUT_MS;
+	setsockopt(s_msgsock, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&send_timeout), sizeof(send_timeout));
+#endif
+
 	// Gross C-style cast, but SOCKET is a handle on Windows.
 	Console.WriteLn("PINE: New client with FD %d connected.", (int)s_msgsock);
 	return true;
@@ -424,10 +501,163 @@ void PINEServer::MainLoop()
 		ClientLoop();
 
 		Console.WriteLn("PINE: Client disconnected.");
+		ClearSubscription();
 		safe_close_portable(s_msgsock);
 	}
 }
 
+void PINEServer::PushLoop()
+{
+	Threading::SetNameOfCurrentThread("PINE Push");
+
+	for (;;)
+	{
+		s_push_sema.Wait();
+		if (s_end.load(std::memory_order_acquire))
+			break;
+
+		if (!s_push_pending.load(std::memory_order_acquire))
+			continue;
+
+		{
+			// the subscription can't change or be dropped while we're sending
+			std::unique_lock lock(s_subscription_mutex);
+			if (s_subscribed.load(std::memory_order_relaxed) && s_push_pending.load(std::memory_order_relaxed))
+			{
+				std::unique_lock write_lock(s_write_mutex);
+				if (SendPush() == PushResult::Failed)
+				{
+					// the stream is out of sync or gone, make the client loop's read fail
+					s_subscribed.store(false, std::memory_order_release);
+#ifdef _WIN32
+					shutdown(s_msgsock, SD_BOTH);
+#else
+					shutdown(s_msgsock, SHUT_RDWR);
+#endif
+				}
+			}
+		}
+
+		s_push_pending.store(false, std::memory_order_release);
+	}
+}
+
+PINEServer::PushResult PINEServer::SendPush()
+{
+	const u8* data = s_push_buffer.data();
+	size_t remaining = s_push_buffer.size();
+
+#ifdef _WIN32
+	// only start when there's room in the send buffer, SO_SNDTIMEO bounds the rest
+	fd_set write_fds;
+	FD_ZERO(&write_fds);
+	FD_SET(s_msgsock, &write_fds);
+	timeval no_wait = {};
+	if (select(0, nullptr, &write_fds, nullptr, &no_wait) <= 0)
+		return PushResult::Dropped;
+
+	// the socket can't be used anymore after a timeout, so partial sends are failures too
+	const int sent = send(s_msgsock, reinterpret_cast<const char*>(data), static_cast<int>(remaining), 0);
+	return (sent == static_cast<int>(remaining)) ? PushResult::Sent : PushResult::Failed;
+#else
+#ifdef MSG_NOSIGNAL
+	constexpr int flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+	constexpr int flags = MSG_DONTWAIT;
+#endif
+	while (remaining > 0)
+	{
+		const ssize_t sent = send(s_msgsock, data, remaining, flags);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				return PushResult::Failed;
+
+			// nothing of this frame went out yet, the client just gets a gap in the frame numbers
+			if (remaining == s_push_buffer.size())
+				return PushResult::Dropped;
+
+			pollfd pfd = {s_msgsock, POLLOUT, 0};
+			if (poll(&pfd, 1, PUSH_SEND_TIMEOUT_MS) <= 0)
+				return PushResult::Failed;
+
+			continue;
+		}
+
+		data += sent;
+		remaining -= static_cast<size_t>(sent);
+	}
+
+	return PushResult::Sent;
+#endif
+}
+
+void PINEServer::VSync()
+{
+	// the push thread is still sending the last frame, so skip this one
+	if (!s_subscribed.load(std::memory_order_acquire) || s_push_pending.load(std::memory_order_acquire))
+		return;
+
+	std::unique_lock lock(s_subscription_mutex);
+	if (!s_subscribed.load(std::memory_order_relaxed))
+		return;
+
+	// reply header, then the frame number and the ranges in the order they were given
+	u32 pos = 9;
+	for (const SubscriptionRange& range : s_subscription)
+	{
+		// ranges which aren't backed by memory (anymore) read as zero
+		if (!vtlb_memSafeReadBytes(range.address, &s_push_buffer[pos], range.size))
+			std::memset(&s_push_buffer[pos], 0, range.size);
+		pos += range.size;
+	}
+	std::memcpy(&s_push_buffer[5], &g_FrameCount, sizeof(u32));
+
+	s_push_pending.store(true, std::memory_order_release);
+	s_push_sema.Post();
+}
+
+void PINEServer::ClearSubscription()
+{
+	std::unique_lock lock(s_subscription_mutex);
+	s_subscribed.store(false, std::memory_order_release);
+	s_subscription.clear();
+}
+
+bool PINEServer::SendReply(const IPCBuffer& res)
+{
+	std::unique_lock lock(s_write_mutex);
+
+#ifdef __linux__
+	if (res.fd >= 0)
+	{
+		iovec iov = {const_cast<u8*>(res.buffer.data()), static_cast<size_t>(res.size)};
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+		msghdr msg = {};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		std::memcpy(CMSG_DATA(cmsg), &res.fd, sizeof(int));
+
+		// the client has its own copy now, or never will
+		const bool result = (sendmsg(s_msgsock, &msg, MSG_NOSIGNAL) >= 0);
+		close(res.fd);
+		return result;
+	}
+#endif
+
+	return (write_portable(s_msgsock, res.buffer.data(), res.size) >= 0);
+}
+
 void PINEServer::ClientLoop()
 {
 	while (!s_end.load(std::memory_order_acquire))
@@ -474,7 +704,7 @@ void PINEServer::ClientLoop()
 			res = ParseCommand(ipc_buffer_span.subspan(4), s_ret_buffer, (u32)end_length - 4);
 
 			// if we cannot send back our answer restart the socket
-			if (write_portable(s_msgsock, res.buffer.data(), res.size) < 0)
+			if (!SendReply(res))
 				return;
 		}
 	}
@@ -492,26 +722,43 @@ void PINEServer::Deinitialize()
 	}
 #endif
 
-	// shutdown() is needed, otherwise accept() will still block.
+	// shutdown() is needed, otherwise accept() will still block, and so
+	// would a push or reply to a client which stopped reading.
 #ifdef _WIN32
 	if (s_sock != INVALID_SOCKET)
 		shutdown(s_sock, SD_BOTH);
+	if (s_msgsock != INVALID_SOCKET)
+		shutdown(s_msgsock, SD_BOTH);
 #else
 	if (s_sock >= 0)
 		shutdown(s_sock, SHUT_RDWR);
+	if (s_msgsock >= 0)
+		shutdown(s_msgsock, SHUT_RDWR);
 #endif
 
 	safe_close_portable(s_sock);
-	safe_close_portable(s_msgsock);
 
 	if (s_thread.joinable())
 		s_thread.join();
+
+	if (s_push_thread.joinable())
+	{
+		s_push_sema.Post();
+		s_push_thread.join();
+	}
+
+	// not before, the push thread could still be using it
+	safe_close_portable(s_msgsock);
+
+	ClearSubscription();
+	s_push_pending.store(false, std::memory_order_release);
 }
 
 PINEServer::IPCBuffer PINEServer::ParseCommand(std::span<u8> buf, std::vector<u8>& ret_buffer, u32 buf_size)
 {
 	u32 ret_cnt = 5;
 	u32 buf_cnt = 0;
+	int reply_fd = -1;
 
 	while (buf_cnt < buf_size)
 	{
@@ -746,12 +993,125 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(std::span<u8> buf, std::vector<u8
 				ret_cnt += 4;
 				break;
 			}
+			case MsgReadRange:
+			{
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size)) [[unlikely]]
+					goto error;
+				const u32 a = FromSpan<u32>(buf, buf_cnt);
+				const u32 size = FromSpan<u32>(buf, buf_cnt + 4);
+				if (size > MAX_IPC_RETURN_SIZE || !SafetyChecks(buf_cnt, 8, ret_cnt, size, buf_size)) [[unlikely]]
+					goto error;
+				// straight into the reply, memory-mapped registers aren't supported
+				if (!vtlb_memSafeReadBytes(a, &ret_buffer[ret_cnt], size))
+					goto error;
+				ret_cnt += size;
+				buf_cnt += 8;
+				break;
+			}
+			case MsgWriteRange:
+			{
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size)) [[unlikely]]
+					goto error;
+				const u32 a = FromSpan<u32>(buf, buf_cnt);
+				const u32 size = FromSpan<u32>(buf, buf_cnt + 4);
+				if (size > MAX_IPC_SIZE || !SafetyChecks(buf_cnt, 8 + size, ret_cnt, 0, buf_size)) [[unlikely]]
+					goto error;
+				if (!vtlb_memSafeWriteBytes(a, &buf[buf_cnt + 8], size))
+					goto error;
+				buf_cnt += 8 + size;
+				break;
+			}
+			case MsgSubscribe:
+			{
+				// format: XX CC CC CC CC [AA AA AA AA SS SS SS SS] * count
+				// the ranges are then pushed every vsync until the next
+				// MsgSubscribe, a count of 0 unsubscribes.
+				//        IPC_PUSH
+				//        |  frame number
+				//        |  |           range data, in order
+				//        |  |           |
+				// push:  01 FF FF FF FF ZZ ZZ ...
+				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 0, buf_size)) [[unlikely]]
+					goto error;
+				const u32 count = FromSpan<u32>(buf, buf_cnt);
+				if (count > (MAX_IPC_SIZE / 8) || !SafetyChecks(buf_cnt, 4 + count * 8, ret_cnt, 0, buf_size)) [[unlikely]]
+					goto error;
+
+				std::vector<SubscriptionRange> ranges(count);
+				u32 push_size = 9;
+				for (u32 i = 0; i < count; i++)
+				{
+					ranges[i].address = FromSpan<u32>(buf, buf_cnt + 4 + i * 8);
+					ranges[i].size = FromSpan<u32>(buf, buf_cnt + 8 + i * 8);
+					if (ranges[i].size > (MAX_IPC_RETURN_SIZE - push_size)) [[unlikely]]
+						goto error;
+					push_size += ranges[i].size;
+				}
+
+				{
+					std::unique_lock lock(s_subscription_mutex);
+					s_subscription = std::move(ranges);
+					s_push_buffer.resize(push_size);
+					ToResultVector<u32>(s_push_buffer, push_size, 0);
+					s_push_buffer[4] = IPC_PUSH;
+					s_subscribed.store(count > 0, std::memory_order_release);
+					// a snapshot of the old ranges could be waiting, don't send it
+					s_push_pending.store(false, std::memory_order_release);
+				}
+
+				buf_cnt += 4 + count * 8;
+				break;
+			}
+			case MsgSharedMemory:
+			{
+				// reply: size of EE memory, offset of it in the mapping, and the
+				// mapping name on Windows. On Linux a read-only descriptor is
+				// passed with the reply instead, and the name is empty.
+				// On Windows the mapping's DACL only lets other processes open it
+				// with FILE_MAP_READ, but that doesn't stop a client running as the
+				// same user from writing to our process memory some other way.
+				if (!VMManager::HasValidVM())
+					goto error;
+				std::string name;
+#if defined(_WIN32)
+				name = SysMemory::GetDataFileMappingName();
+#elif defined(__linux__)
+				if (reply_fd < 0)
+				{
+					// reopen rather than dup, so the client can't map it writable
+					const int data_fd = static_cast<int>(reinterpret_cast<intptr_t>(SysMemory::GetDataFileHandle()));
+					reply_fd = open(fmt::format("/proc/self/fd/{}", data_fd).c_str(), O_RDONLY | O_CLOEXEC);
+					if (reply_fd < 0)
+						goto error;
+				}
+#else
+				// no way to hand out a read-only mapping here
+				goto error;
+#endif
+				const u32 size = name.size() + 1;
+				if (!SafetyChecks(buf_cnt, 0, ret_cnt, 4 + 8 + 4 + size, buf_size)) [[unlikely]]
+					goto error;
+				ToResultVector<u32>(ret_buffer, Ps2MemSize::ExposedRam, ret_cnt);
+				ToResultVector<u64>(ret_buffer, HostMemoryMap::EEmemOffset + offsetof(EEVM_MemoryAllocMess, Main), ret_cnt + 4);
+				ToResultVector(ret_buffer, size, ret_cnt + 12);
+				memcpy(&ret_buffer[ret_cnt + 16], name.c_str(), size);
+				ret_cnt += 16 + size;
+				break;
+			}
 			default:
 			{
 			error:
+#ifdef __linux__
+				if (reply_fd >= 0)
+					close(reply_fd);
+#endif
 				return IPCBuffer{5, MakeFailIPC(ret_buffer)};
 			}
 		}
 	}
-	return IPCBuffer{(int)ret_cnt, MakeOkIPC(ret_buffer, ret_cnt)};
+	return IPCBuffer{(int)ret_cnt, MakeOkIPC(ret_buffer, ret_cnt), reply_fd};
 }
@@ -19,4 +19,7 @@ namespace PINEServer
 
 	bool Initialize(int slot = PINE_DEFAULT_SLOT);
 	void Deinitialize();
+
+	/// Sends the memory ranges the client subscribed to, called on the CPU thread every vsync.
+	void VSync();
 } // namespace PINEServer
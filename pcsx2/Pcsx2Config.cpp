@@ -453,6 +453,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 	EnableVU0 = true;
 	EnableVU1 = true;
 	EnableFastmem = true;
+	PrecompileEEBlocks = false;
+	PrecompileVUPrograms = false;
 	PauseOnTLBMiss = false;
 
 	// vu and fpu clamping default to standard overflow.
@@ -531,6 +533,8 @@ void Pcsx2Config::RecompilerOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(EnableVU0);
 	SettingsWrapBitBool(EnableVU1);
 	SettingsWrapBitBool(EnableFastmem);
+	SettingsWrapBitBool(PrecompileEEBlocks);
+	SettingsWrapBitBool(PrecompileVUPrograms);
 	SettingsWrapBitBool(PauseOnTLBMiss);
 
 	SettingsWrapBitBool(vu0Overflow);
@@ -750,6 +754,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	HWSpinCPUForReadbacks = false;
 	GPUPaletteConversion = false;
 	AutoFlushSW = true;
+	SWExtraThreadsBinned = false;
 	PreloadFrameWithGSData = false;
 	Mipmap = true;
 	HWMipmap = true;
@@ -783,6 +788,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	LoadTextureReplacements = false;
 	LoadTextureReplacementsAsync = true;
 	PrecacheTextureReplacements = false;
+	CompressTextureReplacements = false;
 
 	EnableVideoCapture = true;
 	EnableVideoCaptureParameters = false;
@@ -839,6 +845,7 @@ bool Pcsx2Config::GSOptions::OptionsAreEqual(const GSOptions& right) const
 		OpEqu(MaxAnisotropy) &&
 		OpEqu(SWExtraThreads) &&
 		OpEqu(SWExtraThreadsHeight) &&
+		OpEqu(SWPrimRenderThreads) &&
 		OpEqu(TriFilter) &&
 		OpEqu(TVShader) &&
 		OpEqu(GetSkipCountFunctionId) &&
@@ -869,6 +876,8 @@ bool Pcsx2Config::GSOptions::OptionsAreEqual(const GSOptions& right) const
 		OpEqu(ShadeBoost_Saturation) &&
 		OpEqu(ShadeBoost_Gamma) &&
 		OpEqu(PNGCompressionLevel) &&
+		OpEqu(TextureReplacementCacheSize) &&
+		OpEqu(TextureHashCacheSize) &&
 		OpEqu(SaveDrawStart) &&
 		OpEqu(SaveDrawCount) &&
 		OpEqu(SaveDrawBy) &&
@@ -1026,6 +1035,9 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(LoadTextureReplacements);
 	SettingsWrapBitBool(LoadTextureReplacementsAsync);
 	SettingsWrapBitBool(PrecacheTextureReplacements);
+	SettingsWrapBitBool(CompressTextureReplacements);
+	SettingsWrapBitfieldEx(TextureReplacementCacheSize, "TextureReplacementCacheSize");
+	SettingsWrapBitfieldEx(TextureHashCacheSize, "TextureHashCacheSize");
 	SettingsWrapBitBool(EnableVideoCapture);
 	SettingsWrapBitBool(EnableVideoCaptureParameters);
 	SettingsWrapBitBool(VideoCaptureAutoResolution);
@@ -1062,6 +1074,8 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitfieldEx(MaxAnisotropy, "MaxAnisotropy");
 	SettingsWrapBitfieldEx(SWExtraThreads, "extrathreads");
 	SettingsWrapBitfieldEx(SWExtraThreadsHeight, "extrathreads_height");
+	SettingsWrapBitBoolEx(SWExtraThreadsBinned, "extrathreads_binned");
+	SettingsWrapBitfieldEx(SWPrimRenderThreads, "sw_prim_render_threads");
 	SettingsWrapBitfieldEx(TVShader, "TVShader");
 	SettingsWrapBitfieldEx(SkipDrawStart, "UserHacks_SkipDraw_Start");
 	SettingsWrapBitfieldEx(SkipDrawEnd, "UserHacks_SkipDraw_End");
@@ -1681,6 +1695,11 @@ void Pcsx2Config::SavestateOptions::LoadSave(SettingsWrapper& wrap)
 
 	SettingsWrapIntEnumEx(CompressionType, "SavestateCompressionType");
 	SettingsWrapIntEnumEx(CompressionRatio, "SavestateCompressionRatio");
+
+	SettingsWrapEntryEx(RewindEnable, "RewindEnable");
+	SettingsWrapEntryEx(RewindFrequency, "RewindFrequency");
+	SettingsWrapEntryEx(RewindBufferSize, "RewindBufferSize");
+	RewindFrequency = std::max(RewindFrequency, 1u);
 }
 
 bool Pcsx2Config::SavestateOptions::operator!=(const SavestateOptions& right) const
@@ -1690,7 +1709,8 @@ bool Pcsx2Config::SavestateOptions::operator!=(const SavestateOptions& right) co
 
 bool Pcsx2Config::SavestateOptions::operator==(const SavestateOptions& right) const
 {
-	return OpEqu(CompressionType) && OpEqu(CompressionRatio);
+	return OpEqu(CompressionType) && OpEqu(CompressionRatio) && OpEqu(RewindEnable) && OpEqu(RewindFrequency) &&
+		   OpEqu(RewindBufferSize);
 };
 
 Pcsx2Config::FilenameOptions::FilenameOptions()
@@ -1965,6 +1985,8 @@ Pcsx2Config::Pcsx2Config()
 	}
 
 	GzipIsoIndexTemplate = "$(f).pindex.tmp";
+	CdvdReadaheadDepth = 8;
+	CdvdCacheSize = 32;
 	PINESlot = 28011;
 	RtcYear = 0;
 	RtcMonth = 1;
@@ -2021,6 +2043,8 @@ void Pcsx2Config::LoadSaveCore(SettingsWrapper& wrap)
 	Achievements.LoadSave(wrap);
 
 	SettingsWrapEntry(GzipIsoIndexTemplate);
+	SettingsWrapEntry(CdvdReadaheadDepth);
+	SettingsWrapEntry(CdvdCacheSize);
 	SettingsWrapEntry(PINESlot);
 	SettingsWrapEntry(RtcYear);
 	SettingsWrapEntry(RtcMonth);
@@ -14,6 +14,7 @@
 #include "MTGS.h"
 #include "MTVU.h"
 #include "VMManager.h"
+#include "Vif_Dynarec.h"
 
 static const float UPDATE_INTERVAL = 0.5f;
 
@@ -54,6 +55,16 @@ static float s_vu_thread_time = 0.0f;
 static float s_capture_thread_usage = 0.0f;
 static float s_capture_thread_time = 0.0f;
 
+// VIF block cache, the counters are owned by the EE and VU threads and only sampled here
+static u32 s_last_vif_lookups = 0;
+static u32 s_last_vif_compiles = 0;
+static u32 s_last_vif_evictions = 0;
+static float s_vif_hit_rate = 0.0f;
+static u32 s_vif_block_count = 0;
+static u32 s_vif_max_chain_length = 0;
+static u32 s_vif_compiles = 0;
+static u32 s_vif_evictions = 0;
+
 static PerformanceMetrics::FrameTimeHistory s_frame_time_history;
 static u32 s_frame_time_history_pos = 0;
 
@@ -95,6 +106,12 @@ void PerformanceMetrics::Clear()
 	s_capture_thread_usage = 0.0f;
 	s_capture_thread_time = 0.0f;
 
+	s_vif_hit_rate = 0.0f;
+	s_vif_block_count = 0;
+	s_vif_max_chain_length = 0;
+	s_vif_compiles = 0;
+	s_vif_evictions = 0;
+
 	s_average_gpu_time = 0.0f;
 	s_gpu_usage = 0.0f;
 
@@ -126,6 +143,10 @@ void PerformanceMetrics::Reset()
 	s_last_ticks = GetCPUTicks();
 	s_last_capture_time = GSCapture::IsCapturing() ? GSCapture::GetEncoderThreadHandle().GetCPUTime() : 0;
 
+	s_last_vif_lookups = nVif[0].lookups + nVif[1].lookups;
+	s_last_vif_compiles = nVif[0].compiles + nVif[1].compiles;
+	s_last_vif_evictions = nVif[0].evictions + nVif[1].evictions;
+
 	for (GSSWThreadStats& stat : s_gs_sw_threads)
 		stat.last_cpu_time = stat.handle.GetCPUTime();
 }
@@ -220,6 +241,21 @@ void PerformanceMetrics::Update(bool gs_register_write, bool fb_blit, bool is_sk
 	s_vu_thread_time = static_cast<double>(vu_delta) * time_divider;
 	s_capture_thread_time = static_cast<double>(capture_delta) * time_divider;
 
+	const u32 vif_lookups = nVif[0].lookups + nVif[1].lookups;
+	const u32 vif_compiles = nVif[0].compiles + nVif[1].compiles;
+	const u32 vif_evictions = nVif[0].evictions + nVif[1].evictions;
+	const u32 vif_lookups_delta = vif_lookups - s_last_vif_lookups;
+	s_vif_compiles = vif_compiles - s_last_vif_compiles;
+	s_vif_evictions = vif_evictions - s_last_vif_evictions;
+	s_vif_hit_rate = (vif_lookups_delta > 0) ?
+		(100.0f * static_cast<float>(vif_lookups_delta - std::min(s_vif_compiles, vif_lookups_delta)) / static_cast<float>(vif_lookups_delta)) :
+		100.0f;
+	s_vif_block_count = nVif[0].vifBlocks.count() + nVif[1].vifBlocks.count();
+	s_vif_max_chain_length = std::max(nVif[0].vifBlocks.max_chain(), nVif[1].vifBlocks.max_chain());
+	s_last_vif_lookups = vif_lookups;
+	s_last_vif_compiles = vif_compiles;
+	s_last_vif_evictions = vif_evictions;
+
 	for (GSSWThreadStats& thread : s_gs_sw_threads)
 	{
 		const u64 time = thread.handle.GetCPUTime();
@@ -362,6 +398,31 @@ double PerformanceMetrics::GetGSSWThreadAverageTime(u32 index)
 	return s_gs_sw_threads[index].time;
 }
 
+float PerformanceMetrics::GetVIFHitRate()
+{
+	return s_vif_hit_rate;
+}
+
+u32 PerformanceMetrics::GetVIFBlockCount()
+{
+	return s_vif_block_count;
+}
+
+u32 PerformanceMetrics::GetVIFMaxChainLength()
+{
+	return s_vif_max_chain_length;
+}
+
+u32 PerformanceMetrics::GetVIFCompiles()
+{
+	return s_vif_compiles;
+}
+
+u32 PerformanceMetrics::GetVIFEvictions()
+{
+	return s_vif_evictions;
+}
+
 float PerformanceMetrics::GetGPUUsage()
 {
 	return s_gpu_usage;
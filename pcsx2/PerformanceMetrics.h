@@ -55,6 +55,13 @@ namespace PerformanceMetrics
 	double GetGSSWThreadUsage(u32 index);
 	double GetGSSWThreadAverageTime(u32 index);
 
+	/// VIF unpack block cache statistics, summed over both VIFs.
+	float GetVIFHitRate();
+	u32 GetVIFBlockCount();
+	u32 GetVIFMaxChainLength();
+	u32 GetVIFCompiles();
+	u32 GetVIFEvictions();
+
 	float GetGPUUsage();
 	float GetGPUAverageTime();
 	double GetGPUAverageVSInvocations();
@@ -15,6 +15,8 @@
 #include "CDVD/Ps1CD.h"
 #include "CDVD/CDVD.h"
 
+#include <bit>
+
 using namespace R3000A;
 
 R3000Acpu *psxCpu;
@@ -32,6 +34,9 @@ static constexpr uint iopWaitCycles = 384; // Keep inline with EE wait cycle max
 
 bool iopEventTestIsActive = false;
 
+// Cycle the earliest pending IOP event is due at, see eeNextEventDue.
+static u64 psxNextEventDue = 0;
+
 alignas(16) psxRegisters psxRegs;
 
 void psxReset()
@@ -46,6 +51,7 @@ void psxReset()
 	psxRegs.iopCycleEE = -1;
 	psxRegs.iopCycleEECarry = 0;
 	psxRegs.iopNextEventCycle = psxRegs.cycle + 4;
+	psxNextEventDue = psxRegs.cycle;
 
 	psxHwReset();
 	PSXCLK = 36864000;
@@ -135,6 +141,9 @@ __fi void PSX_INT( IopEventId n, s32 ecycle )
 	psxRegs.sCycle[n] = psxRegs.cycle;
 	psxRegs.eCycle[n] = ecycle;
 
+	if (static_cast<s32>(psxRegs.cycle + ecycle - psxNextEventDue) < 0)
+		psxNextEventDue = psxRegs.cycle + ecycle;
+
 	psxSetNextBranchDelta(ecycle);
 	const float mutiplier = static_cast<float>(PS2CLK) / static_cast<float>(PSXCLK);
 	const s32 iopDelta = (psxRegs.iopNextEventCycle - psxRegs.cycle) * mutiplier;
@@ -160,48 +169,59 @@ static __fi void IopTestEvent( IopEventId n, void (*callback)() )
 		psxSetNextBranch( psxRegs.sCycle[n], psxRegs.eCycle[n] );
 }
 
-static __fi void Sio0TestEvent(IopEventId n)
+static void sio0Interrupt()
 {
-	if (!(psxRegs.interrupt & (1 << n)))
-	{
-		return;
-	}
+	g_Sio0.Interrupt(Sio0Interrupt::TEST_EVENT);
+}
 
-	if (psxTestCycle(psxRegs.sCycle[n], psxRegs.eCycle[n]))
-	{
-		psxRegs.interrupt &= ~(1 << n);
-		g_Sio0.Interrupt(Sio0Interrupt::TEST_EVENT);
-	}
-	else
+struct IopEventHandler
+{
+	IopEventId event;
+	void (*callback)();
+};
+
+// Run in this order when due.
+static constexpr IopEventHandler s_iopEventHandlers[] = {
+	{IopEvt_SIF0, sif0Interrupt},
+	{IopEvt_SIF1, sif1Interrupt},
+	{IopEvt_SIF2, sif2Interrupt},
+	{IopEvt_SIO, sio0Interrupt},
+	{IopEvt_CdvdSectorReady, cdvdSectorReady},
+	{IopEvt_CdvdRead, cdvdReadInterrupt},
+	{IopEvt_Cdvd, cdvdActionInterrupt},
+	{IopEvt_Dma11, psxDMA11Interrupt}, // SIO2
+	{IopEvt_Dma12, psxDMA12Interrupt}, // SIO2
+	{IopEvt_Cdrom, cdrInterrupt},
+	{IopEvt_CdromRead, cdrReadInterrupt},
+	{IopEvt_DEV9, dev9Interrupt},
+	{IopEvt_USB, usbInterrupt},
+};
+
+void psxUpdateNextEventDue()
+{
+	s32 nearest = std::numeric_limits<s32>::max();
+	for (u32 pending = psxRegs.interrupt; pending != 0; pending &= pending - 1)
 	{
-		psxSetNextBranch(psxRegs.sCycle[n], psxRegs.eCycle[n]);
+		const u32 n = std::countr_zero(pending);
+		nearest = std::min(nearest, static_cast<s32>(psxRegs.sCycle[n] + psxRegs.eCycle[n] - psxRegs.cycle));
 	}
+
+	psxNextEventDue = psxRegs.cycle + nearest;
 }
 
 static __fi void _psxTestInterrupts()
 {
-	IopTestEvent(IopEvt_SIF0,		sif0Interrupt);	// SIF0
-	IopTestEvent(IopEvt_SIF1,		sif1Interrupt);	// SIF1
-	IopTestEvent(IopEvt_SIF2,		sif2Interrupt);	// SIF2
-	Sio0TestEvent(IopEvt_SIO);
-	IopTestEvent(IopEvt_CdvdSectorReady, cdvdSectorReady);
-	IopTestEvent(IopEvt_CdvdRead,	cdvdReadInterrupt);
-
-	// Profile-guided Optimization (sorta)
-	// The following ints are rarely called.  Encasing them in a conditional
-	// as follows helps speed up most games.
-
-	if( psxRegs.interrupt & ((1 << IopEvt_Cdvd) | (1 << IopEvt_Dma11) | (1 << IopEvt_Dma12)
-		| (1 << IopEvt_Cdrom) | (1 << IopEvt_CdromRead) | (1 << IopEvt_DEV9) | (1 << IopEvt_USB)))
+	// Nothing is due yet, only the next event test needs scheduling.
+	if (static_cast<s32>(psxRegs.cycle - psxNextEventDue) < 0)
 	{
-		IopTestEvent(IopEvt_Cdvd,		cdvdActionInterrupt);
-		IopTestEvent(IopEvt_Dma11,		psxDMA11Interrupt);	// SIO2
-		IopTestEvent(IopEvt_Dma12,		psxDMA12Interrupt);	// SIO2
-		IopTestEvent(IopEvt_Cdrom,		cdrInterrupt);
-		IopTestEvent(IopEvt_CdromRead,	cdrReadInterrupt);
-		IopTestEvent(IopEvt_DEV9,		dev9Interrupt);
-		IopTestEvent(IopEvt_USB,		usbInterrupt);
+		psxSetNextBranch(psxNextEventDue, 0);
+		return;
 	}
+
+	for (const IopEventHandler& handler : s_iopEventHandlers)
+		IopTestEvent(handler.event, handler.callback);
+
+	psxUpdateNextEventDue();
 }
 
 __ri void iopEventTest()
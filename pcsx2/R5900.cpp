@@ -30,6 +30,8 @@
 
 #include "fmt/format.h"
 
+#include <bit>
+
 using namespace R5900;	// for R5900 disasm tools
 
 s32 EEsCycle;		// used to sync the IOP to the EE
@@ -46,6 +48,11 @@ static constexpr uint eeWaitCycles = 3072;
 bool eeEventTestIsActive = false;
 EE_intProcessStatus eeRunInterruptScan = INT_NOT_RUNNING;
 
+// Cycle the earliest pending EE event is due at, so event tests can skip dispatching until then.
+// CPU_INT only ever moves it earlier. Events which get cleared or pushed back leave it early,
+// which costs one dispatch that finds nothing due, after which it's recomputed.
+static u64 eeNextEventDue = 0;
+
 u32 g_eeloadMain = 0, g_eeloadExec = 0, g_osdsys_str = 0;
 
 /* I don't know how much space for args there is in the memory block used for args in full boot mode,
@@ -72,6 +79,7 @@ void cpuReset()
 	fpuRegs.fprc[31]		= 0x01000001; // fpu Status/Control
 
 	cpuRegs.nextEventCycle = cpuRegs.cycle + 4;
+	eeNextEventDue = cpuRegs.cycle;
 	EEsCycle = 0;
 	EEoCycle = cpuRegs.cycle;
 
@@ -256,6 +264,58 @@ static __fi void TESTINT( u8 n, void (*callback)() )
 		cpuSetNextEvent( cpuRegs.sCycle[n], cpuRegs.eCycle[n] );
 }
 
+struct EEEventHandler
+{
+	EE_EventType event;
+	void (*callback)();
+};
+
+/* These are 'pcsx2 interrupts', they handle asynchronous stuff
+   that depends on the cycle timings. Run in this order when due. */
+static constexpr EEEventHandler s_eeEventHandlers[] = {
+	{VU_MTVU_BUSY, MTVUInterrupt},
+	{DMAC_VIF1, vif1Interrupt},
+	{DMAC_GIF, gifInterrupt},
+	{DMAC_SIF0, EEsif0Interrupt},
+	{DMAC_SIF1, EEsif1Interrupt},
+	{DMAC_VIF0, vif0Interrupt},
+	{DMAC_FROM_IPU, ipu0Interrupt},
+	{DMAC_TO_IPU, ipu1Interrupt},
+	{IPU_PROCESS, ipuCMDProcess},
+	{DMAC_FROM_SPR, SPRFROMinterrupt},
+	{DMAC_TO_SPR, SPRTOinterrupt},
+	{DMAC_MFIFO_VIF, vifMFIFOInterrupt},
+	{DMAC_MFIFO_GIF, gifMFIFOInterrupt},
+	{VIF_VU0_FINISH, vif0VUFinish},
+	{VIF_VU1_FINISH, vif1VUFinish},
+};
+
+static constexpr u32 s_eeEventHandlerMask = [] {
+	u32 mask = 0;
+	for (const EEEventHandler& handler : s_eeEventHandlers)
+		mask |= 1u << handler.event;
+	return mask;
+}();
+
+static __fi void cpuScheduleEvent(u64 dueCycle)
+{
+	if (static_cast<s32>(dueCycle - eeNextEventDue) < 0)
+		eeNextEventDue = dueCycle;
+}
+
+void cpuUpdateNextEventDue()
+{
+	// Only the pending events need looking at, not every handler.
+	s32 nearest = std::numeric_limits<s32>::max();
+	for (u32 pending = cpuRegs.interrupt & s_eeEventHandlerMask; pending != 0; pending &= pending - 1)
+	{
+		const u32 n = std::countr_zero(pending);
+		nearest = std::min(nearest, static_cast<s32>(cpuRegs.sCycle[n] + cpuRegs.eCycle[n] - cpuRegs.cycle));
+	}
+
+	eeNextEventDue = cpuRegs.cycle + nearest;
+}
+
 // [TODO] move this function to Dmac.cpp, and remove most of the DMAC-related headers from
 // being included into R5900.cpp.
 static __fi bool _cpuTestInterrupts()
@@ -267,40 +327,19 @@ static __fi bool _cpuTestInterrupts()
 		return false;
 	}
 
+	// Nothing is due yet, so there's nothing to run, only the next event test to schedule.
+	if (!CHECK_INSTANTDMAHACK && static_cast<s32>(cpuRegs.cycle - eeNextEventDue) < 0)
+	{
+		cpuSetNextEvent(eeNextEventDue, 0);
+		return ((cpuRegs.interrupt & 0x1FFFF) & ~cpuRegs.dmastall) != 0;
+	}
+
 	eeRunInterruptScan = INT_RUNNING;
 
 	while (eeRunInterruptScan == INT_RUNNING)
 	{
-		/* These are 'pcsx2 interrupts', they handle asynchronous stuff
-		   that depends on the cycle timings */
-		TESTINT(VU_MTVU_BUSY, MTVUInterrupt);
-		TESTINT(DMAC_VIF1, vif1Interrupt);
-		TESTINT(DMAC_GIF, gifInterrupt);
-		TESTINT(DMAC_SIF0, EEsif0Interrupt);
-		TESTINT(DMAC_SIF1, EEsif1Interrupt);
-		// Profile-guided Optimization (sorta)
-		// The following ints are rarely called.  Encasing them in a conditional
-		// as follows helps speed up most games.
-
-		if (cpuRegs.interrupt & ((1 << DMAC_VIF0) | (1 << DMAC_FROM_IPU) | (1 << DMAC_TO_IPU)
-			| (1 << DMAC_FROM_SPR) | (1 << DMAC_TO_SPR) | (1 << DMAC_MFIFO_VIF) | (1 << DMAC_MFIFO_GIF)
-			| (1 << VIF_VU0_FINISH) | (1 << VIF_VU1_FINISH) | (1 << IPU_PROCESS)))
-		{
-			TESTINT(DMAC_VIF0, vif0Interrupt);
-
-			TESTINT(DMAC_FROM_IPU, ipu0Interrupt);
-			TESTINT(DMAC_TO_IPU, ipu1Interrupt);
-			TESTINT(IPU_PROCESS, ipuCMDProcess);
-
-			TESTINT(DMAC_FROM_SPR, SPRFROMinterrupt);
-			TESTINT(DMAC_TO_SPR, SPRTOinterrupt);
-
-			TESTINT(DMAC_MFIFO_VIF, vifMFIFOInterrupt);
-			TESTINT(DMAC_MFIFO_GIF, gifMFIFOInterrupt);
-
-			TESTINT(VIF_VU0_FINISH, vif0VUFinish);
-			TESTINT(VIF_VU1_FINISH, vif1VUFinish);
-		}
+		for (const EEEventHandler& handler : s_eeEventHandlers)
+			TESTINT(handler.event, handler.callback);
 
 		if (eeRunInterruptScan == INT_REQ_LOOP)
 			eeRunInterruptScan = INT_RUNNING;
@@ -310,6 +349,8 @@ static __fi bool _cpuTestInterrupts()
 
 	eeRunInterruptScan = INT_NOT_RUNNING;
 
+	cpuUpdateNextEventDue();
+
 	if ((cpuRegs.interrupt & 0x1FFFF) & ~cpuRegs.dmastall)
 		return true;
 	else
@@ -529,6 +570,7 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 		cpuRegs.interrupt |= 1 << n;
 		cpuRegs.sCycle[n] = cpuRegs.cycle;
 		cpuRegs.eCycle[n] = 0;
+		cpuScheduleEvent(cpuRegs.cycle);
 		return;
 	}
 
@@ -541,6 +583,7 @@ __fi void CPU_INT( EE_EventType n, s32 ecycle)
 	cpuRegs.interrupt |= 1 << n;
 	cpuRegs.sCycle[n] = cpuRegs.cycle;
 	cpuRegs.eCycle[n] = ecycle;
+	cpuScheduleEvent(cpuRegs.cycle + ecycle);
 
 	// Interrupt is happening soon: make sure both EE and IOP are aware.
 
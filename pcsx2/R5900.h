@@ -356,6 +356,10 @@ extern R5900cpu *Cpu;
 extern R5900cpu intCpu;
 extern R5900cpu recCpu;
 
+// Selects the game whose compiled blocks are remembered and precompiled by the EE recompiler.
+// The previous game's list is saved. Passing a zero CRC saves the list without selecting a new one.
+extern void recSetBlockListGame(const std::string& serial, u32 crc);
+
 enum EE_intProcessStatus
 {
 	INT_NOT_RUNNING = 0,
@@ -410,6 +414,7 @@ extern void cpuSetNextEventDelta( s32 delta );
 extern int  cpuTestCycle( u64 startCycle, s32 delta );
 extern void cpuSetEvent();
 extern int cpuGetCycles(int interrupt);
+extern void cpuUpdateNextEventDue();
 
 extern void _cpuEventTest_Shared();		// for internal use by the Dynarecs and Ints inside R5900:
 
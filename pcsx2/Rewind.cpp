@@ -0,0 +1,380 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "Achievements.h"
+#include "Config.h"
+#include "GSDumpReplayer.h"
+#include "Host.h"
+#include "R5900.h"
+#include "Rewind.h"
+#include "SaveState.h"
+
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/Threading.h"
+#include "common/Timer.h"
+
+#include "fmt/format.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <zstd.h>
+
+// States are split into pages, and only the pages which differ from the last keyframe are kept.
+// The page size doesn't need to match the host, since changes are found by comparing the data.
+static constexpr u32 REWIND_PAGE_SIZE = 4096;
+
+// Deltas grow as the game runs further from the keyframe, so start a new one regularly.
+static constexpr u32 REWIND_KEYFRAME_INTERVAL = 30;
+
+// Favour speed over ratio, compression has to keep up with captures.
+static constexpr int REWIND_COMPRESSION_LEVEL = 1;
+
+namespace Rewind
+{
+	struct State
+	{
+		std::vector<ArchiveEntry> entries;
+		std::vector<u32> pages; // empty for keyframes
+		std::vector<u8> compressed_data;
+		size_t size;
+		u64 vsync;
+		bool keyframe;
+	};
+
+	static void ThreadEntryPoint();
+	static void CompressCapture();
+	static bool Decompress(const State& state, u8* dst, size_t size);
+	static void EvictOldStates();
+	static void ClearStates();
+
+	static std::thread s_thread;
+	static std::mutex s_mutex;
+	static std::condition_variable s_cv;
+	static bool s_thread_shutdown = false;
+
+	// Captured on the CPU thread, then diffed and compressed on the rewind thread.
+	static std::unique_ptr<ArchiveEntryList> s_capture;
+	static u64 s_capture_vsync = 0;
+	static bool s_capture_pending = false;
+
+	// Protected by s_mutex.
+	static std::deque<State> s_states;
+	static size_t s_states_size = 0;
+
+	// Uncompressed copy of the newest keyframe, owned by the rewind thread (or the CPU thread when idle).
+	static std::vector<u8> s_keyframe_data;
+	static bool s_keyframe_valid = false;
+	static u32 s_deltas_since_keyframe = 0;
+
+	// Only touched on the CPU thread.
+	static u64 s_vsync_count = 0;
+	static u64 s_last_capture_vsync = 0;
+	static bool s_capture_due = false;
+} // namespace Rewind
+
+void Rewind::OnVSync()
+{
+	s_vsync_count++;
+
+	if (!EmuConfig.Savestate.RewindEnable || GSDumpReplayer::IsReplayingDump() ||
+		Achievements::IsHardcoreModeActive() || (s_vsync_count - s_last_capture_vsync) < EmuConfig.Savestate.RewindFrequency)
+	{
+		return;
+	}
+
+	if (!s_thread.joinable())
+	{
+		s_thread_shutdown = false;
+		s_capture = std::make_unique<ArchiveEntryList>();
+		s_thread = std::thread(ThreadEntryPoint);
+	}
+
+	{
+		// If the last capture is still being compressed, try again next frame rather than stalling.
+		std::unique_lock lock(s_mutex);
+		if (s_capture_pending)
+			return;
+	}
+
+	s_last_capture_vsync = s_vsync_count;
+
+	// Saving here would catch the vsync counter mid-transition, so wait for the event test to finish,
+	// and capture once execution has stopped, like a save state requested from the UI.
+	s_capture_due = true;
+	Cpu->ExitExecution();
+}
+
+void Rewind::CaptureIfDue()
+{
+	if (!std::exchange(s_capture_due, false))
+		return;
+
+	Error error;
+	if (!SaveState_DownloadState(s_capture.get(), &error))
+	{
+		Console.ErrorFmt("(Rewind) Failed to capture state: {}", error.GetDescription());
+		return;
+	}
+
+	std::unique_lock lock(s_mutex);
+	s_capture_vsync = s_last_capture_vsync;
+	s_capture_pending = true;
+	s_cv.notify_one();
+}
+
+void Rewind::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("Rewind Compression");
+
+	std::unique_lock lock(s_mutex);
+	for (;;)
+	{
+		s_cv.wait(lock, []() { return s_capture_pending || s_thread_shutdown; });
+		if (s_thread_shutdown)
+			break;
+
+		lock.unlock();
+		CompressCapture();
+		lock.lock();
+
+		s_capture_pending = false;
+		s_cv.notify_all();
+	}
+}
+
+void Rewind::CompressCapture()
+{
+	Common::Timer timer;
+
+	const ArchiveEntry& last_entry = (*s_capture)[s_capture->GetLength() - 1];
+	const size_t size = last_entry.GetDataIndex() + last_entry.GetDataSize();
+	const u8* data = s_capture->GetPtr(0);
+
+	State state;
+	state.entries.reserve(s_capture->GetLength());
+	for (size_t i = 0; i < s_capture->GetLength(); i++)
+		state.entries.push_back((*s_capture)[i]);
+	state.size = size;
+	state.vsync = s_capture_vsync;
+	state.keyframe = (!s_keyframe_valid || s_deltas_since_keyframe >= REWIND_KEYFRAME_INTERVAL);
+
+	std::vector<u8> delta_data;
+	if (!state.keyframe)
+	{
+		for (size_t offset = 0; offset < size; offset += REWIND_PAGE_SIZE)
+		{
+			const size_t page_size = std::min<size_t>(REWIND_PAGE_SIZE, size - offset);
+			if ((offset + page_size) <= s_keyframe_data.size() &&
+				std::memcmp(data + offset, s_keyframe_data.data() + offset, page_size) == 0)
+			{
+				continue;
+			}
+
+			state.pages.push_back(static_cast<u32>(offset / REWIND_PAGE_SIZE));
+			delta_data.insert(delta_data.end(), data + offset, data + offset + page_size);
+		}
+
+		// Not worth keeping a delta when most of the state has changed.
+		state.keyframe = (delta_data.size() > (size / 2));
+	}
+
+	const u8* src = state.keyframe ? data : delta_data.data();
+	const size_t src_size = state.keyframe ? size : delta_data.size();
+	state.compressed_data.resize(ZSTD_compressBound(src_size));
+	const size_t compressed_size = ZSTD_compress(state.compressed_data.data(), state.compressed_data.size(), src, src_size,
+		REWIND_COMPRESSION_LEVEL);
+	if (ZSTD_isError(compressed_size))
+	{
+		Console.ErrorFmt("(Rewind) Failed to compress state: {}", ZSTD_getErrorName(compressed_size));
+		return;
+	}
+	state.compressed_data.resize(compressed_size);
+	state.compressed_data.shrink_to_fit();
+
+	if (state.keyframe)
+	{
+		state.pages.clear();
+		s_keyframe_data.assign(data, data + size);
+		s_keyframe_valid = true;
+		s_deltas_since_keyframe = 0;
+	}
+	else
+	{
+		s_deltas_since_keyframe++;
+	}
+
+	DevCon.WriteLnFmt("(Rewind) Captured {} of {} KB ({} pages, {} KB compressed) in {:.2f} ms",
+		state.keyframe ? "keyframe" : "delta", size / 1024, state.keyframe ? 0 : state.pages.size(),
+		compressed_size / 1024, timer.GetTimeMilliseconds());
+
+	std::unique_lock lock(s_mutex);
+	s_states_size += state.compressed_data.size();
+	s_states.push_back(std::move(state));
+	EvictOldStates();
+}
+
+void Rewind::EvictOldStates()
+{
+	const size_t budget = static_cast<size_t>(EmuConfig.Savestate.RewindBufferSize) * _1mb;
+
+	// Deltas are useless without their keyframe, so states are dropped a keyframe group at a time.
+	// The newest group is always kept, even if it doesn't fit.
+	while (!s_states.empty() && (s_states_size + s_keyframe_data.capacity()) > budget)
+	{
+		const auto next_keyframe = std::find_if(s_states.begin() + 1, s_states.end(), [](const State& st) { return st.keyframe; });
+		if (next_keyframe == s_states.end())
+			break;
+
+		for (auto it = s_states.begin(); it != next_keyframe; ++it)
+			s_states_size -= it->compressed_data.size();
+		s_states.erase(s_states.begin(), next_keyframe);
+	}
+}
+
+bool Rewind::Decompress(const State& state, u8* dst, size_t size)
+{
+	const size_t ret = ZSTD_decompress(dst, size, state.compressed_data.data(), state.compressed_data.size());
+	if (ZSTD_isError(ret) || ret != size)
+	{
+		Console.ErrorFmt("(Rewind) Failed to decompress state: {}", ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "size mismatch");
+		return false;
+	}
+
+	return true;
+}
+
+bool Rewind::LoadPreviousState(u32* frames_rewound, Error* error)
+{
+	// Make sure the last capture has been added to the buffer, and the thread isn't touching anything.
+	std::unique_lock lock(s_mutex);
+	s_cv.wait(lock, []() { return !s_capture_pending; });
+
+	if (s_states.empty())
+	{
+		Error::SetString(error, TRANSLATE_STR("Rewind", "No rewind states are available."));
+		return false;
+	}
+
+	Common::Timer timer;
+
+	const auto keyframe_it = std::find_if(s_states.rbegin(), s_states.rend(), [](const State& st) { return st.keyframe; });
+	if (keyframe_it == s_states.rend())
+	{
+		Error::SetString(error, TRANSLATE_STR("Rewind", "No rewind states are available."));
+		ClearStates();
+		return false;
+	}
+
+	const State& state = s_states.back();
+	const State& keyframe = *keyframe_it;
+
+	// Reuse the capture list for the reconstructed state, the thread is idle.
+	ArchiveEntryList& list = *s_capture;
+	list.Clear();
+	std::vector<u8>& buffer = list.GetBuffer();
+	buffer.resize(std::max(keyframe.size, state.size));
+	if (!Decompress(keyframe, buffer.data(), keyframe.size))
+	{
+		Error::SetString(error, TRANSLATE_STR("Rewind", "Failed to decompress rewind state."));
+		ClearStates();
+		return false;
+	}
+
+	if (!state.keyframe)
+	{
+		size_t delta_size = 0;
+		for (const u32 page : state.pages)
+			delta_size += std::min<size_t>(REWIND_PAGE_SIZE, state.size - static_cast<size_t>(page) * REWIND_PAGE_SIZE);
+
+		std::vector<u8> delta_data(delta_size);
+
+		if (!Decompress(state, delta_data.data(), delta_size))
+		{
+			Error::SetString(error, TRANSLATE_STR("Rewind", "Failed to decompress rewind state."));
+			ClearStates();
+			return false;
+		}
+
+		const u8* src = delta_data.data();
+		for (const u32 page : state.pages)
+		{
+			const size_t offset = static_cast<size_t>(page) * REWIND_PAGE_SIZE;
+			const size_t page_size = std::min<size_t>(REWIND_PAGE_SIZE, state.size - offset);
+			std::memcpy(buffer.data() + offset, src, page_size);
+			src += page_size;
+		}
+	}
+
+	for (const ArchiveEntry& entry : state.entries)
+		list.Add(entry);
+
+	const u64 state_vsync = state.vsync;
+	*frames_rewound = static_cast<u32>(s_vsync_count - state_vsync);
+
+	// Holding the rewind key steps further back each time.
+	if (state.keyframe)
+	{
+		s_keyframe_valid = false;
+		s_keyframe_data = {};
+	}
+	s_states_size -= state.compressed_data.size();
+	s_states.pop_back();
+
+	lock.unlock();
+
+	if (!SaveState_LoadFromMemory(list, error))
+	{
+		ClearStates();
+		return false;
+	}
+
+	s_vsync_count = state_vsync;
+	s_last_capture_vsync = state_vsync;
+	s_capture_due = false;
+
+	DevCon.WriteLnFmt("(Rewind) Loaded state from {} frames ago in {:.2f} ms", *frames_rewound, timer.GetTimeMilliseconds());
+	return true;
+}
+
+void Rewind::ClearStates()
+{
+	s_states.clear();
+	s_states_size = 0;
+	s_keyframe_data = {};
+	s_keyframe_valid = false;
+	s_deltas_since_keyframe = 0;
+}
+
+void Rewind::Reset()
+{
+	std::unique_lock lock(s_mutex);
+	s_cv.wait(lock, []() { return !s_capture_pending; });
+	ClearStates();
+	s_capture_due = false;
+}
+
+void Rewind::Shutdown()
+{
+	if (s_thread.joinable())
+	{
+		{
+			std::unique_lock lock(s_mutex);
+			s_thread_shutdown = true;
+			s_cv.notify_one();
+		}
+
+		s_thread.join();
+	}
+
+	// Pending captures are simply dropped.
+	s_capture_pending = false;
+	s_capture.reset();
+	ClearStates();
+	s_vsync_count = 0;
+	s_last_capture_vsync = 0;
+	s_capture_due = false;
+}
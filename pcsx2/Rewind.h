@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+class Error;
+
+namespace Rewind
+{
+	/// Decides whether a state should be captured, every few vsyncs when rewind is enabled.
+	/// The counters are part way through the vsync here, so this only asks the CPU to stop executing.
+	void OnVSync();
+
+	/// Takes the capture requested by OnVSync(), on the CPU thread once execution has stopped.
+	void CaptureIfDue();
+
+	/// Loads the most recently captured state, and removes it from the buffer.
+	/// The number of frames between the current and loaded state is returned in frames_rewound.
+	bool LoadPreviousState(u32* frames_rewound, Error* error);
+
+	/// Discards all captured states, e.g. after a reset or a state load.
+	void Reset();
+
+	/// Discards all captured states and stops the compression thread.
+	void Shutdown();
+} // namespace Rewind
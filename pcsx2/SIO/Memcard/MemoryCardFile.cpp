@@ -13,9 +13,20 @@
 #include "common/FileSystem.h"
 #include "common/Path.h"
 #include "common/StringUtil.h"
+#include "common/Threading.h"
 
 #include <array>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "Config.h"
 #include "Host.h"
@@ -153,19 +164,38 @@ static bool ConvertRAWtoNoECC(const char* file_in, const char* file_out)
 // --------------------------------------------------------------------------------------
 //  FileMemoryCard
 // --------------------------------------------------------------------------------------
-// Provides thread-safe direct file IO mapping.
-//
+// Cards are kept in memory while open, so the EE thread never waits on the disk. Writes mark
+// erase blocks dirty, and once the game has stopped writing for a couple of frames the dirty
+// blocks are handed to a flush thread, which writes them back and syncs the file.
 class FileMemoryCard
 {
 protected:
+	static constexpr int FramesAfterWriteUntilFlush = 2;
+
+	struct FlushRequest
+	{
+		uint slot;
+		u32 offset;
+		std::vector<u8> data;
+	};
+
 	std::FILE* m_file[8] = {};
 	s64 m_fileSize[8] = {};
 	std::string m_filenames[8] = {};
-	std::vector<u8> m_currentdata;
+	std::vector<u8> m_data[8];
+	std::vector<bool> m_dirtyBlocks[8];
+	int m_framesUntilFlush[8] = {};
 	u64 m_chksum[8] = {};
 	bool m_ispsx[8] = {};
 	u32 m_chkaddr = 0;
 
+	// Only the flush thread touches the files while it's running.
+	std::thread m_flushThread;
+	std::mutex m_flushMutex;
+	std::condition_variable m_flushCV;
+	std::deque<FlushRequest> m_flushQueue;
+	bool m_flushThreadShutdown = false;
+
 public:
 	FileMemoryCard();
 	~FileMemoryCard();
@@ -184,9 +214,16 @@ public:
 	s32 EraseBlock(uint slot, u32 adr);
 	u64 GetCRC(uint slot);
 
+	// called once per frame, used for flushing data after FramesAfterWriteUntilFlush frames of no writes
+	void NextFrame(uint slot);
+
 protected:
 	bool Seek(std::FILE* f, u32 adr);
 	bool Create(const char* mcdFile, uint sizeInMB);
+
+	void MarkDirty(uint slot, u32 adr, u32 size);
+	void QueueFlush(uint slot);
+	void FlushThreadEntryPoint();
 };
 
 uint FileMcd_GetMtapPort(uint slot)
@@ -294,7 +331,8 @@ void FileMemoryCard::Open()
 			}
 		}
 
-		if (fname.ends_with(".bin") || fname.ends_with(".mc2"))
+		const bool converted = fname.ends_with(".bin") || fname.ends_with(".mc2");
+		if (converted)
 		{
 			std::string newname(fname + "x");
 			if (!ConvertNoECCtoRAW(fname.c_str(), newname.c_str()))
@@ -324,27 +362,70 @@ void FileMemoryCard::Open()
 		else // Load checksum
 		{
 			m_fileSize[slot] = FileSystem::FSize64(m_file[slot]);
+			if (m_fileSize[slot] >= 0)
+			{
+				m_data[slot].resize(static_cast<size_t>(m_fileSize[slot]));
+				if (!Seek(m_file[slot], 0) || std::fread(m_data[slot].data(), m_data[slot].size(), 1, m_file[slot]) != 1)
+					m_fileSize[slot] = -1;
+			}
+
+			if (m_fileSize[slot] < 0)
+			{
+				Host::ReportErrorAsync("Memory Card Read Failed", "Error reading memory card.");
+				std::fclose(m_file[slot]);
+				m_file[slot] = nullptr;
+				m_data[slot] = {};
+
+				// don't leave the converted copy of a .bin/.mc2 card behind
+				if (converted)
+					FileSystem::DeleteFilePath((fname + "x").c_str());
+
+				continue;
+			}
 
 			Console.WriteLnFmt(Color_Green, "McdSlot {} [File]: {} [{} MB, {}]", slot, Path::GetFileName(fname),
 				(m_fileSize[slot] + (MCD_SIZE + 1)) / MC2_MBSIZE,
 				FileMcd_IsMemoryCardFormatted(m_file[slot]) ? "Formatted" : "UNFORMATTED");
 
+			m_dirtyBlocks[slot].assign((m_data[slot].size() + MC2_ERASE_SIZE - 1) / MC2_ERASE_SIZE, false);
+			m_framesUntilFlush[slot] = 0;
+
 			m_filenames[slot] = std::move(fname);
 			m_ispsx[slot] = m_fileSize[slot] == 0x20000;
 			m_chkaddr = 0x210;
 
-			if (!m_ispsx[slot] && FileSystem::FSeek64(m_file[slot], m_chkaddr, SEEK_SET) == 0)
-			{
-				const size_t read_result = std::fread(&m_chksum[slot], sizeof(m_chksum[slot]), 1, m_file[slot]);
-				if (read_result == 0)
-					Host::ReportErrorAsync("Memory Card Read Failed", "Error reading memory card.");
-			}
+			if (!m_ispsx[slot] && (m_chkaddr + sizeof(m_chksum[slot])) <= m_data[slot].size())
+				std::memcpy(&m_chksum[slot], &m_data[slot][m_chkaddr], sizeof(m_chksum[slot]));
 		}
 	}
+
+	if (std::any_of(std::begin(m_file), std::end(m_file), [](std::FILE* fp) { return fp != nullptr; }))
+	{
+		m_flushThreadShutdown = false;
+		m_flushThread = std::thread(&FileMemoryCard::FlushThreadEntryPoint, this);
+	}
 }
 
 void FileMemoryCard::Close()
 {
+	if (m_flushThread.joinable())
+	{
+		// Write back anything the game hasn't finished with yet, then let the thread go.
+		for (uint slot = 0; slot < 8; ++slot)
+		{
+			if (m_file[slot])
+				QueueFlush(slot);
+		}
+
+		{
+			std::unique_lock lock(m_flushMutex);
+			m_flushThreadShutdown = true;
+			m_flushCV.notify_one();
+		}
+
+		m_flushThread.join();
+	}
+
 	for (int slot = 0; slot < 8; ++slot)
 	{
 		if (!m_file[slot])
@@ -356,6 +437,9 @@ void FileMemoryCard::Close()
 
 		std::fclose(m_file[slot]);
 		m_file[slot] = nullptr;
+		m_data[slot] = {};
+		m_dirtyBlocks[slot] = {};
+		m_framesUntilFlush[slot] = 0;
 
 		if (m_filenames[slot].ends_with(".bin") || m_filenames[slot].ends_with(".mc2"))
 		{
@@ -425,51 +509,41 @@ bool FileMemoryCard::IsPSX(uint slot)
 
 s32 FileMemoryCard::Read(uint slot, u8* dest, u32 adr, int size)
 {
-	std::FILE* mcfp = m_file[slot];
-	if (!mcfp)
+	if (!m_file[slot])
 	{
 		DevCon.Error("(FileMcd) Ignoring attempted read from disabled slot.");
 		memset(dest, 0, size);
 		return 1;
 	}
-	if (!Seek(mcfp, adr))
+	if ((static_cast<u64>(adr) + size) > m_data[slot].size())
 		return 0;
-	return std::fread(dest, size, 1, mcfp) == 1;
+
+	std::memcpy(dest, &m_data[slot][adr], size);
+	return 1;
 }
 
 s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 {
-	std::FILE* mcfp = m_file[slot];
-
-	if (!mcfp)
+	if (!m_file[slot])
 	{
 		DevCon.Error("(FileMcd) Ignoring attempted save/write to disabled slot.");
 		return 1;
 	}
+	if ((static_cast<u64>(adr) + size) > m_data[slot].size())
+		return 0;
 
+	u8* data = &m_data[slot][adr];
 	if (m_ispsx[slot])
 	{
-		if (static_cast<int>(m_currentdata.size()) < size)
-			m_currentdata.resize(size);
-		for (int i = 0; i < size; i++)
-			m_currentdata[i] = src[i];
+		std::memcpy(data, src, size);
 	}
 	else
 	{
-		if (!Seek(mcfp, adr))
-			return 0;
-		if (static_cast<int>(m_currentdata.size()) < size)
-			m_currentdata.resize(size);
-
-		const size_t read_result = std::fread(m_currentdata.data(), size, 1, mcfp);
-		if (read_result == 0)
-			Host::ReportErrorAsync("Memory Card Read Failed", "Error reading memory card.");
-
 		for (int i = 0; i < size; i++)
 		{
-			if ((m_currentdata[i] & src[i]) != src[i])
+			if ((data[i] & src[i]) != src[i])
 				Console.Warning("(FileMcd) Warning: writing to uncleared data. (%d) [%08X]", slot, adr);
-			m_currentdata[i] &= src[i];
+			data[i] &= src[i];
 		}
 
 		// Checksumness
@@ -477,82 +551,66 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 			if (adr == m_chkaddr)
 				Console.Warning("(FileMcd) Warning: checksum sector overwritten. (%d)", slot);
 
-			u64* pdata = (u64*)&m_currentdata[0];
 			u32 loops = size / 8;
 
 			for (u32 i = 0; i < loops; i++)
-				m_chksum[slot] ^= pdata[i];
+			{
+				u64 value;
+				std::memcpy(&value, data + i * 8, sizeof(value));
+				m_chksum[slot] ^= value;
+			}
 		}
 	}
 
-	if (!Seek(mcfp, adr))
-		return 0;
+	MarkDirty(slot, adr, size);
 
-	if (std::fwrite(m_currentdata.data(), size, 1, mcfp) == 1)
-	{
-		static auto last = std::chrono::time_point<std::chrono::system_clock>();
+	static auto last = std::chrono::time_point<std::chrono::system_clock>();
 
-		std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
-		if (elapsed > std::chrono::seconds(5))
-		{
-			Host::AddIconOSDMessage(fmt::format("MemoryCardSave{}", slot), ICON_PF_MEMORY_CARD,
-				fmt::format(TRANSLATE_FS("MemoryCard", "Memory Card '{}' was saved to storage."),
-					Path::GetFileName(m_filenames[slot])),
-				Host::OSD_INFO_DURATION);
-			last = std::chrono::system_clock::now();
-		}
-		return 1;
+	std::chrono::duration<float> elapsed = std::chrono::system_clock::now() - last;
+	if (elapsed > std::chrono::seconds(5))
+	{
+		Host::AddIconOSDMessage(fmt::format("MemoryCardSave{}", slot), ICON_PF_MEMORY_CARD,
+			fmt::format(TRANSLATE_FS("MemoryCard", "Memory Card '{}' was saved to storage."),
+				Path::GetFileName(m_filenames[slot])),
+			Host::OSD_INFO_DURATION);
+		last = std::chrono::system_clock::now();
 	}
 
-	return 0;
+	return 1;
 }
 
 s32 FileMemoryCard::EraseBlock(uint slot, u32 adr)
 {
-	std::FILE* mcfp = m_file[slot];
-	if (!mcfp)
+	if (!m_file[slot])
 	{
 		DevCon.Error("MemoryCard: Ignoring erase for disabled slot.");
 		return 1;
 	}
-
-	if (!Seek(mcfp, adr))
+	if ((static_cast<u64>(adr) + MC2_ERASE_SIZE) > m_data[slot].size())
 		return 0;
 
-	u8 buf[MC2_ERASE_SIZE];
-	std::memset(buf, 0xff, sizeof(buf));
-	return std::fwrite(buf, sizeof(buf), 1, mcfp) == 1;
+	std::memset(&m_data[slot][adr], 0xff, MC2_ERASE_SIZE);
+	MarkDirty(slot, adr, MC2_ERASE_SIZE);
+	return 1;
 }
 
 u64 FileMemoryCard::GetCRC(uint slot)
 {
-	std::FILE* mcfp = m_file[slot];
-	if (!mcfp)
+	if (!m_file[slot])
 		return 0;
 
 	u64 retval = 0;
 
 	if (m_ispsx[slot])
 	{
-		if (!Seek(mcfp, 0))
-			return 0;
-
-		const s64 mcfpsize = m_fileSize[slot];
-		if (mcfpsize < 0)
-			return 0;
-
-		// Process the file in 4k chunks.  Speeds things up significantly.
-
-		u64 buffer[528 * 8]; // use 528 (sector size), ensures even divisibility
-
-		const uint filesize = static_cast<uint>(mcfpsize) / sizeof(buffer);
-		for (uint i = filesize; i; --i)
+		// Only whole 4k chunks were ever included, keep it that way so the CRC doesn't change.
+		static constexpr size_t chunk_size = 528 * 8 * sizeof(u64);
+		const size_t size = (m_data[slot].size() / chunk_size) * chunk_size;
+		for (size_t offset = 0; offset < size; offset += sizeof(u64))
 		{
-			if (std::fread(buffer, sizeof(buffer), 1, mcfp) != 1)
-				return 0;
-
-			for (uint t = 0; t < std::size(buffer); ++t)
-				retval ^= buffer[t];
+			u64 value;
+			std::memcpy(&value, &m_data[slot][offset], sizeof(value));
+			retval ^= value;
 		}
 	}
 	else
@@ -563,6 +621,101 @@ u64 FileMemoryCard::GetCRC(uint slot)
 	return retval;
 }
 
+void FileMemoryCard::NextFrame(uint slot)
+{
+	if (m_framesUntilFlush[slot] > 0 && --m_framesUntilFlush[slot] == 0)
+		QueueFlush(slot);
+}
+
+void FileMemoryCard::MarkDirty(uint slot, u32 adr, u32 size)
+{
+	const u32 first = adr / MC2_ERASE_SIZE;
+	const u32 last = (adr + size - 1) / MC2_ERASE_SIZE;
+	for (u32 block = first; block <= last; block++)
+		m_dirtyBlocks[slot][block] = true;
+
+	m_framesUntilFlush[slot] = FramesAfterWriteUntilFlush;
+}
+
+void FileMemoryCard::QueueFlush(uint slot)
+{
+	// Neighbouring dirty blocks go out as one write. The data is copied, so the game can carry on writing.
+	std::vector<bool>& dirty = m_dirtyBlocks[slot];
+	std::unique_lock lock(m_flushMutex);
+	for (u32 block = 0; block < dirty.size();)
+	{
+		if (!dirty[block])
+		{
+			block++;
+			continue;
+		}
+
+		u32 end = block;
+		while (end < dirty.size() && dirty[end])
+			dirty[end++] = false;
+
+		const u32 offset = block * MC2_ERASE_SIZE;
+		const u32 size = std::min<u32>(end * MC2_ERASE_SIZE, static_cast<u32>(m_data[slot].size())) - offset;
+		FlushRequest& req = m_flushQueue.emplace_back();
+		req.slot = slot;
+		req.offset = offset;
+		req.data.assign(m_data[slot].begin() + offset, m_data[slot].begin() + offset + size);
+		block = end;
+	}
+
+	m_framesUntilFlush[slot] = 0;
+	m_flushCV.notify_one();
+}
+
+void FileMemoryCard::FlushThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("Memory Card Flush");
+
+	bool written[8] = {};
+
+	std::unique_lock lock(m_flushMutex);
+	for (;;)
+	{
+		m_flushCV.wait(lock, [this]() { return !m_flushQueue.empty() || m_flushThreadShutdown; });
+		if (m_flushQueue.empty())
+			break;
+
+		FlushRequest req = std::move(m_flushQueue.front());
+		m_flushQueue.pop_front();
+		lock.unlock();
+
+		std::FILE* fp = m_file[req.slot];
+		if (!Seek(fp, req.offset) || std::fwrite(req.data.data(), req.data.size(), 1, fp) != 1)
+		{
+			Host::ReportErrorAsync(TRANSLATE_SV("MemoryCard", "Memory Card Write Failed"),
+				fmt::format(TRANSLATE_FS("MemoryCard", "Failed to write to memory card:\n\n{}"), m_filenames[req.slot]));
+		}
+		written[req.slot] = true;
+
+		lock.lock();
+
+		// Make sure it actually hits the disk once the game has stopped saving.
+		if (m_flushQueue.empty())
+		{
+			lock.unlock();
+			for (uint slot = 0; slot < std::size(written); slot++)
+			{
+				if (!written[slot])
+					continue;
+
+				std::fflush(m_file[slot]);
+#ifdef _WIN32
+				_commit(_fileno(m_file[slot]));
+#else
+				fsync(fileno(m_file[slot]));
+#endif
+				written[slot] = false;
+			}
+			lock.lock();
+		}
+	}
+}
+
 // --------------------------------------------------------------------------------------
 //  MemoryCard Component API Bindings
 // --------------------------------------------------------------------------------------
@@ -802,9 +955,9 @@ void FileMcd_NextFrame(uint port, uint slot)
 	const uint combinedSlot = FileMcd_ConvertToSlot(port, slot);
 	switch (EmuConfig.Mcd[combinedSlot].Type)
 	{
-		//case MemoryCardType::MemoryCard_File:
-		//	Mcd::impl.NextFrame( combinedSlot );
-		//	break;
+		case MemoryCardType::File:
+			Mcd::impl.NextFrame(combinedSlot);
+			break;
 		case MemoryCardType::Folder:
 			Mcd::implFolder.NextFrame(combinedSlot);
 			break;
@@ -16,6 +16,7 @@
 #include "common/FileSystem.h"
 #include "common/Path.h"
 #include "common/StringUtil.h"
+#include "common/Threading.h"
 #include "common/Timer.h"
 #include "common/YAML.h"
 
@@ -111,6 +112,11 @@ FolderMemoryCard::FolderMemoryCard()
 {
 }
 
+FolderMemoryCard::~FolderMemoryCard()
+{
+	StopWriteThread();
+}
+
 void FolderMemoryCard::InitializeInternalData()
 {
 	memset(&m_superBlock, 0xFF, sizeof(m_superBlock));
@@ -120,6 +126,8 @@ void FolderMemoryCard::InitializeInternalData()
 	memset(&m_backupBlock2, 0xFF, sizeof(m_backupBlock2));
 	m_cache.clear();
 	m_oldDataCache.clear();
+	WaitForPendingWrites();
+	m_stagedWrites.clear();
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 	m_timeLastWritten = 0;
@@ -205,6 +213,9 @@ void FolderMemoryCard::Close(bool flush)
 		Flush();
 	}
 
+	// make sure everything has hit the host files before the handles go away
+	StopWriteThread();
+
 	m_cache.clear();
 	m_oldDataCache.clear();
 	m_lastAccessedFile.CloseAll();
@@ -253,6 +264,8 @@ void FolderMemoryCard::LoadMemoryCardData(const u32 sizeInClusters, const bool e
 	// if superblock was valid, load folders and files
 	if (formatted)
 	{
+		Common::Timer timeIndexStart;
+
 		if (enableFiltering)
 		{
 			Console.WriteLn(Color_Green, "FolderMcd: Indexing slot %u with filter \"%s\".", m_slot, filter.c_str());
@@ -267,6 +280,7 @@ void FolderMemoryCard::LoadMemoryCardData(const u32 sizeInClusters, const bool e
 		MemoryCardFileEntry* const rootDirEntry = &m_fileEntryDict[m_superBlock.data.rootdir_cluster].entries[0];
 		AddFolder(rootDirEntry, m_folderName, nullptr, enableFiltering, filter);
 
+		Console.WriteLn(Color_Green, "FolderMcd: Indexed slot %u in %.2f ms.", m_slot, timeIndexStart.GetTimeMilliseconds());
 
 #ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 		WriteToFile(m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format(L"%Y-%m-%d-%H-%M-%S") + L"_load.ps2");
@@ -910,6 +924,7 @@ bool FolderMemoryCard::ReadFromFile(u8* dest, u32 adr, u32 dataLength)
 	if (it != m_fileMetadataQuickAccess.end())
 	{
 		const u32 clusterNumber = it->second.consecutiveCluster;
+		WaitForPendingWrites();
 		std::FILE* file = m_lastAccessedFile.ReOpen(m_folderName, &it->second);
 		if (file)
 		{
@@ -1080,6 +1095,9 @@ void FolderMemoryCard::Flush()
 	Console.WriteLn("FolderMcd: Writing data for slot %u to file system...", m_slot);
 	Common::Timer timeFlushStart;
 
+	// the previous flush may still be writing file data, and the file handles are about to be used
+	WaitForPendingWrites();
+
 	// Keep a copy of the old file entries so we can figure out which files and directories, if any, have been deleted from the memory card.
 	std::vector<MemoryCardFileEntryTreeNode> oldFileEntryTree;
 	if (IsFormatted())
@@ -1141,7 +1159,7 @@ void FolderMemoryCard::Flush()
 		FlushPage(i);
 	}
 
-	m_lastAccessedFile.FlushAll();
+	SubmitStagedWrites();
 	m_lastAccessedFile.ClearMetadataWriteState();
 	m_oldDataCache.clear();
 
@@ -1529,25 +1547,8 @@ bool FolderMemoryCard::WriteToFile(const u8* src, u32 adr, u32 dataLength)
 				const u32 fileOffsetEnd = std::min(fileOffsetStart + dataLength, fileSize);
 				const u32 bytesToWrite = fileOffsetEnd - fileOffsetStart;
 
-				u32 actualFileSize = static_cast<u32>(std::clamp<s64>(FileSystem::FSize64(file), 0, std::numeric_limits<u32>::max()));
-				if (actualFileSize < fileOffsetStart)
-				{
-					FileSystem::FSeek64(file, actualFileSize, SEEK_SET);
-					const u32 diff = fileOffsetStart - actualFileSize;
-					u8 temp = 0xFF;
-					for (u32 i = 0; i < diff; ++i)
-					{
-						std::fwrite(&temp, 1, 1, file);
-					}
-				}
-
-				if (FileSystem::FTell64(file) == fileOffsetStart || FileSystem::FSeek64(file, fileOffsetStart, SEEK_SET) == 0)
-				{
-					if (bytesToWrite > 0)
-					{
-						std::fwrite(src, bytesToWrite, 1, file);
-					}
-				}
+				// even without data, this makes sure the file is extended up to fileOffsetStart
+				StageWrite(file, fileOffsetStart, src, bytesToWrite);
 			}
 			else
 			{
@@ -1561,6 +1562,141 @@ bool FolderMemoryCard::WriteToFile(const u8* src, u32 adr, u32 dataLength)
 	return false;
 }
 
+void FolderMemoryCard::StageWrite(std::FILE* file, u32 offset, const u8* src, u32 size)
+{
+	std::map<u32, std::vector<u8>>& ranges = m_stagedWrites[file];
+
+	// extend the range this one touches, if any, otherwise start a new one
+	auto it = ranges.upper_bound(offset);
+	if (it != ranges.begin() && std::prev(it)->first + std::prev(it)->second.size() >= offset)
+	{
+		--it;
+	}
+	else
+	{
+		it = ranges.emplace_hint(it, offset, std::vector<u8>());
+	}
+
+	std::vector<u8>& data = it->second;
+	const u32 start = offset - it->first;
+	if (data.size() < start + size)
+	{
+		data.resize(start + size);
+	}
+	if (size > 0)
+	{
+		memcpy(&data[start], src, size);
+	}
+
+	// and merge any following ranges that now touch it, the new data takes priority
+	const u32 end = it->first + static_cast<u32>(data.size());
+	for (auto next = std::next(it); next != ranges.end() && next->first <= end;)
+	{
+		const u32 nextEnd = next->first + static_cast<u32>(next->second.size());
+		if (nextEnd > end)
+		{
+			data.insert(data.end(), next->second.end() - (nextEnd - end), next->second.end());
+		}
+		next = ranges.erase(next);
+	}
+}
+
+void FolderMemoryCard::SubmitStagedWrites()
+{
+	if (m_stagedWrites.empty())
+	{
+		return;
+	}
+
+	if (!m_writeThread.joinable())
+	{
+		m_writeThreadShutdown = false;
+		m_writeThread = std::thread(&FolderMemoryCard::WriteThreadEntryPoint, this);
+	}
+
+	// Flush() waited for the last batch before staging this one, so the thread is idle
+	std::unique_lock lock(m_writeMutex);
+	m_pendingWrites = std::move(m_stagedWrites);
+	m_stagedWrites.clear();
+	m_writesPending = true;
+	m_writeCV.notify_all();
+}
+
+void FolderMemoryCard::WaitForPendingWrites()
+{
+	std::unique_lock lock(m_writeMutex);
+	m_writeCV.wait(lock, [this]() { return !m_writesPending; });
+}
+
+void FolderMemoryCard::StopWriteThread()
+{
+	if (!m_writeThread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::unique_lock lock(m_writeMutex);
+		m_writeThreadShutdown = true;
+		m_writeCV.notify_all();
+	}
+
+	// pending writes are finished before the thread exits
+	m_writeThread.join();
+}
+
+void FolderMemoryCard::WriteThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("Folder Memory Card Writer");
+
+	std::unique_lock lock(m_writeMutex);
+	for (;;)
+	{
+		m_writeCV.wait(lock, [this]() { return m_writesPending || m_writeThreadShutdown; });
+		if (!m_writesPending)
+		{
+			break;
+		}
+
+		lock.unlock();
+
+		Common::Timer timeWriteStart;
+		size_t bytesWritten = 0;
+		for (const auto& [file, ranges] : m_pendingWrites)
+		{
+			s64 fileSize = FileSystem::FSize64(file);
+			for (const auto& [offset, data] : ranges)
+			{
+				// pad files that grew with 0xFF, like an erased memory card
+				if (fileSize >= 0 && fileSize < offset && FileSystem::FSeek64(file, fileSize, SEEK_SET) == 0)
+				{
+					const std::vector<u8> padding(offset - static_cast<u32>(fileSize), 0xFF);
+					if (std::fwrite(padding.data(), padding.size(), 1, file) == 1)
+					{
+						fileSize = offset;
+					}
+				}
+
+				if (!data.empty() && FileSystem::FSeek64(file, offset, SEEK_SET) == 0 &&
+					std::fwrite(data.data(), data.size(), 1, file) == 1)
+				{
+					fileSize = std::max<s64>(fileSize, offset + data.size());
+					bytesWritten += data.size();
+				}
+			}
+
+			std::fflush(file);
+		}
+
+		Console.WriteLn("FolderMcd: Wrote %zu bytes for slot %u in %.2f ms.", bytesWritten, m_slot, timeWriteStart.GetTimeMilliseconds());
+		m_pendingWrites.clear();
+
+		lock.lock();
+		m_writesPending = false;
+		m_writeCV.notify_all();
+	}
+}
+
 const std::string& FolderMemoryCard::GetFolderName()
 {
 	return m_folderName;
@@ -1780,6 +1916,9 @@ std::vector<FolderMemoryCard::EnumeratedFileEntry> FolderMemoryCard::GetOrderedF
 		int64_t orderForDirectories = 1;
 		int64_t orderForLegacyFiles = -1;
 
+		// Only parse this directory's index once, rather than for every file in it.
+		std::optional<ryml::Tree> dirIndex = loadYamlFile(Path::Combine(dirPath, "_pcsx2_index").c_str());
+
 		for (FILESYSTEM_FIND_DATA& fd : results)
 		{
 			if (fd.FileName.starts_with("_pcsx2_"))
@@ -1788,17 +1927,11 @@ std::vector<FolderMemoryCard::EnumeratedFileEntry> FolderMemoryCard::GetOrderedF
 			std::string filePath(Path::Combine(dirPath, fd.FileName));
 			if (!(fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY))
 			{
-				std::optional<ryml::Tree> yaml = loadYamlFile(Path::Combine(dirPath, "_pcsx2_index").c_str());
-
 				EnumeratedFileEntry entry{fd.FileName, fd.CreationTime, fd.ModificationTime, true};
 				int64_t newOrder = orderForLegacyFiles--;
-				if (yaml.has_value() && !yaml.value().empty())
+				if (dirIndex.has_value() && !dirIndex.value().empty())
 				{
-					ryml::NodeRef index = yaml.value().rootref();
-					for (const auto& n : index.children())
-					{
-						auto key = std::string(n.key().str, n.key().len);
-					}
+					ryml::NodeRef index = dirIndex.value().rootref();
 					if (index.has_child(ryml::to_csubstr(fd.FileName)))
 					{
 						const auto& node = index[ryml::to_csubstr(fd.FileName)];
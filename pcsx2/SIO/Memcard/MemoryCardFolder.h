@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <cstdio>
 #include <map>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "Config.h"
@@ -290,6 +294,19 @@ protected:
 	// remembers and keeps the last accessed file open for further access
 	FileAccessHelper m_lastAccessedFile;
 
+	// file data written while flushing, per host file handle and offset, with touching ranges merged
+	// the handles belong to m_lastAccessedFile, which must not be used while the write thread has data
+	using HostFileWrites = std::map<std::FILE*, std::map<u32, std::vector<u8>>>;
+	HostFileWrites m_stagedWrites;
+
+	// writes file data to the host file system after a flush, so the EE thread doesn't have to wait for it
+	std::thread m_writeThread;
+	std::mutex m_writeMutex;
+	std::condition_variable m_writeCV;
+	HostFileWrites m_pendingWrites;
+	bool m_writesPending = false;
+	bool m_writeThreadShutdown = false;
+
 	// path to the folder that contains the files of this memory card
 	std::string m_folderName;
 
@@ -307,7 +324,7 @@ protected:
 
 public:
 	FolderMemoryCard();
-	virtual ~FolderMemoryCard() = default;
+	virtual ~FolderMemoryCard();
 
 	void Lock();
 	void Unlock();
@@ -504,6 +521,18 @@ protected:
 	// write data as Save() normally would, but ignore the cache; used for flushing
 	s32 WriteWithoutCache(const u8* src, u32 adr, int size);
 
+	// queues data for a host file, to be written by the write thread once the flush is done
+	void StageWrite(std::FILE* file, u32 offset, const u8* src, u32 size);
+
+	// hands the staged writes to the write thread
+	void SubmitStagedWrites();
+
+	// blocks until the write thread is done with the host files
+	void WaitForPendingWrites();
+
+	void StopWriteThread();
+	void WriteThreadEntryPoint();
+
 	// copies the contents of m_fileEntryDict into the tree structure fileEntryTree
 	void CopyEntryDictIntoTree(std::vector<MemoryCardFileEntryTreeNode>* fileEntryTree, const u32 cluster, const u32 fileCount);
 
@@ -6,6 +6,7 @@
 #include "SPU2/defs.h"
 #include "SPU2/spu2.h"
 #include "SPU2/interpolate_table.h"
+#include "SPU2/VoiceBatch.h"
 
 #include "common/Assertions.h"
 
@@ -284,18 +285,17 @@ static __forceinline void ConsumeSamples(V_Core& thiscore, uint voiceidx)
 	vc.DecPosRead += consumed;
 }
 
-static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+static __forceinline void GetVoiceValues(V_Core& thiscore, uint voiceidx, VoiceBatch& batch)
 {
 	V_Voice& vc(thiscore.Voices[voiceidx]);
 
+	// The interpolation itself is done for all voices at once, in MixVoiceBatch.
 	int phase = (vc.SP & 0x0ff0) >> 4;
-	s32 out = 0;
-	out += (interpTable[phase][0] * vc.DecodeFifo[(vc.DecPosRead + 0) % 32]) >> 15;
-	out += (interpTable[phase][1] * vc.DecodeFifo[(vc.DecPosRead + 1) % 32]) >> 15;
-	out += (interpTable[phase][2] * vc.DecodeFifo[(vc.DecPosRead + 2) % 32]) >> 15;
-	out += (interpTable[phase][3] * vc.DecodeFifo[(vc.DecPosRead + 3) % 32]) >> 15;
-
-	return out;
+	for (int i = 0; i < 4; i++)
+	{
+		batch.Coefs[i][voiceidx] = interpTable[phase][i];
+		batch.Samples[i][voiceidx] = vc.DecodeFifo[(vc.DecPosRead + i) % 32];
+	}
 }
 
 // This is Dr. Hell's noise algorithm as implemented in pcsxr
@@ -368,7 +368,9 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+// Everything in a voice that has to happen in order: decoding, IRQs, and the envelope.
+// Fills in the voice's slot in the batch, and returns whether the voice is playing.
+static __forceinline bool PrepareVoice(uint coreidx, uint voiceidx, VoiceBatch& batch)
 {
 	V_Core& thiscore(Cores[coreidx]);
 	V_Voice& vc(thiscore.Voices[voiceidx]);
@@ -381,60 +383,90 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
 	DecodeSamples(coreidx, voiceidx);
 
-	StereoOut32 voiceOut(0, 0);
-	s32 Value = 0;
-
-	if (vc.ADSR.Phase > V_ADSR::PHASE_STOPPED)
+	const bool active = (vc.ADSR.Phase > V_ADSR::PHASE_STOPPED);
+	if (active)
 	{
-		if (vc.Noise)
-			Value = GetNoiseValues(thiscore);
-		else
-			Value = GetVoiceValues(thiscore, voiceidx);
+		GetVoiceValues(thiscore, voiceidx, batch);
+		batch.NoiseMask[voiceidx] = vc.Noise ? -1 : 0;
 
 		// Update and Apply ADSR  (applies to normal and noise sources)
 
 		CalculateADSR(thiscore, voiceidx);
-		Value = ApplyVolume(Value, vc.ADSR.Value);
-		vc.OutX = Value;
+		batch.Envelope[voiceidx] = vc.ADSR.Value;
+	}
+	else
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			batch.Coefs[i][voiceidx] = 0;
+			batch.Samples[i][voiceidx] = 0;
+		}
+		batch.NoiseMask[voiceidx] = 0;
+		batch.Envelope[voiceidx] = 0;
+	}
+
+	batch.VolL[voiceidx] = vc.Volume.Left.Value;
+	batch.VolR[voiceidx] = vc.Volume.Right.Value;
+	batch.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+	batch.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+	batch.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+	batch.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
+	// Write-back of raw voice data (post ADSR applied)
+	// Done here rather than after the batch, so that later voices decoding from the output area see it.
+	if (voiceidx == 1)
+		spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, GetVoiceBatchValue(batch, voiceidx));
+	else if (voiceidx == 3)
+		spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, GetVoiceBatchValue(batch, voiceidx));
+
+	return active;
+}
+
+static __forceinline void FinishVoice(uint coreidx, uint voiceidx, const VoiceBatch& batch, bool active)
+{
+	V_Voice& vc(Cores[coreidx].Voices[voiceidx]);
+
+	if (active)
+	{
+		vc.OutX = batch.Out[voiceidx];
 
 		if (IsDevBuild)
 			DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, (s32)vc.OutX);
-
-		voiceOut = ApplyVolume(StereoOut32(Value, Value), vc.Volume);
 	}
 
 	// SPU2 Note: The spu2 continues to process voices for eternity, always, so we
 	// have to run through all the motions of updating the voice regardless of it's
 	// audible status.  Otherwise IRQs might not trigger and emulation might fail.
 
+	// Pitch modulation reads OutX of the previous voice, which was set in the previous iteration.
 	UpdatePitch(coreidx, voiceidx);
 
-	ConsumeSamples(thiscore, voiceidx);
-
-	// Write-back of raw voice data (post ADSR applied)
-	if (voiceidx == 1)
-		spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, Value);
-	else if (voiceidx == 3)
-		spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, Value);
-
-	return voiceOut;
+	ConsumeSamples(Cores[coreidx], voiceidx);
 }
 
 static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
 {
+	static_assert(VoiceBatch::NumVoices == V_Core::NumVoices);
+
 	V_Core& thiscore(Cores[coreidx]);
 
+	VoiceBatch batch;
+	batch.Noise = GetNoiseValues(thiscore);
+
+	u32 active = 0;
 	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
-	{
-		StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+		active |= static_cast<u32>(PrepareVoice(coreidx, voiceidx, batch)) << voiceidx;
 
-		// Note: Results from MixVoice are ranged at 16 bits.
+	// Note: Results from the batch are ranged at 16 bits.
+	const VoiceBatchMix mix = MixVoiceBatch(batch);
 
-		dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-		dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-		dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-		dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
-	}
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+		FinishVoice(coreidx, voiceidx, batch, (active >> voiceidx) & 1);
+
+	dest.Dry.Left += mix.DryL;
+	dest.Dry.Right += mix.DryR;
+	dest.Wet.Left += mix.WetL;
+	dest.Wet.Right += mix.WetR;
 }
 
 static __forceinline StereoOut32 MixCore(const uint coreidx, const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext)
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "GS/GSVector.h"
+#include "GS/MultiISA.h"
+
+#include "common/Pcsx2Defs.h"
+
+// The per-sample arithmetic of the voice mixer, for all the voices of one core at once.
+// Anything which touches SPU2 memory, raises IRQs, or depends on the previous voice (decoding,
+// ADSR, pitch modulation) stays in PrepareVoice, and fills this in for the batch to work on.
+struct alignas(32) VoiceBatch
+{
+	static constexpr u32 NumVoices = 24;
+
+	s32 Samples[4][NumVoices]; // Decode FIFO at the read position
+	s32 Coefs[4][NumVoices]; // Gaussian interpolation weights for the current phase
+	s32 NoiseMask[NumVoices]; // All ones when the voice outputs noise instead of samples
+	s32 Envelope[NumVoices]; // ADSR level, zero when the voice is stopped
+	s32 VolL[NumVoices];
+	s32 VolR[NumVoices];
+	s32 DryL[NumVoices]; // Voice gates, see V_VoiceGates
+	s32 DryR[NumVoices];
+	s32 WetL[NumVoices];
+	s32 WetR[NumVoices];
+
+	s32 Out[NumVoices]; // Post-ADSR voice output, for OutX and the voice output areas
+
+	s32 Noise;
+};
+
+struct VoiceBatchMix
+{
+	s32 DryL;
+	s32 DryR;
+	s32 WetL;
+	s32 WetR;
+};
+
+MULTI_ISA_UNSHARED_START
+
+/// Output of a single voice, post-ADSR. Matches the order and rounding of the original per-voice mixer.
+static __forceinline s32 GetVoiceBatchValue(const VoiceBatch& batch, u32 i)
+{
+	s32 value = 0;
+	for (u32 j = 0; j < 4; j++)
+		value += (batch.Coefs[j][i] * batch.Samples[j][i]) >> 15;
+
+	value = batch.NoiseMask[i] ? batch.Noise : value;
+	return (batch.Envelope[i] * value) >> 15;
+}
+
+/// Scalar version of the batch, for reference.
+static __forceinline VoiceBatchMix MixVoiceBatch_reference(VoiceBatch& batch)
+{
+	VoiceBatchMix mix = {};
+	for (u32 i = 0; i < VoiceBatch::NumVoices; i++)
+	{
+		const s32 value = GetVoiceBatchValue(batch, i);
+		batch.Out[i] = value;
+
+		const s32 left = (batch.VolL[i] * value) >> 15;
+		const s32 right = (batch.VolR[i] * value) >> 15;
+		mix.DryL += left & batch.DryL[i];
+		mix.DryR += right & batch.DryR[i];
+		mix.WetL += left & batch.WetL[i];
+		mix.WetR += right & batch.WetR[i];
+	}
+
+	return mix;
+}
+
+#if _M_SSE >= 0x501
+using VoiceBatchVector = GSVector8i;
+#else
+using VoiceBatchVector = GSVector4i;
+#endif
+
+static __forceinline VoiceBatchMix MixVoiceBatch(VoiceBatch& batch)
+{
+	constexpr u32 lanes = sizeof(VoiceBatchVector) / sizeof(s32);
+	static_assert((VoiceBatch::NumVoices % lanes) == 0);
+
+	const VoiceBatchVector noise(batch.Noise);
+	VoiceBatchVector dry_l = VoiceBatchVector::zero();
+	VoiceBatchVector dry_r = VoiceBatchVector::zero();
+	VoiceBatchVector wet_l = VoiceBatchVector::zero();
+	VoiceBatchVector wet_r = VoiceBatchVector::zero();
+
+	for (u32 i = 0; i < VoiceBatch::NumVoices; i += lanes)
+	{
+		// Each tap is shifted before summing, same as the scalar mixer.
+		VoiceBatchVector value = VoiceBatchVector::zero();
+		for (u32 j = 0; j < 4; j++)
+		{
+			const VoiceBatchVector c = VoiceBatchVector::load<true>(&batch.Coefs[j][i]);
+			const VoiceBatchVector s = VoiceBatchVector::load<true>(&batch.Samples[j][i]);
+			value = value.add32(c.mul32l(s).sra32<15>());
+		}
+
+		value = value.blend(noise, VoiceBatchVector::load<true>(&batch.NoiseMask[i]));
+		value = VoiceBatchVector::load<true>(&batch.Envelope[i]).mul32l(value).sra32<15>();
+		VoiceBatchVector::store<true>(&batch.Out[i], value);
+
+		const VoiceBatchVector left = VoiceBatchVector::load<true>(&batch.VolL[i]).mul32l(value).sra32<15>();
+		const VoiceBatchVector right = VoiceBatchVector::load<true>(&batch.VolR[i]).mul32l(value).sra32<15>();
+		dry_l = dry_l.add32(left & VoiceBatchVector::load<true>(&batch.DryL[i]));
+		dry_r = dry_r.add32(right & VoiceBatchVector::load<true>(&batch.DryR[i]));
+		wet_l = wet_l.add32(left & VoiceBatchVector::load<true>(&batch.WetL[i]));
+		wet_r = wet_r.add32(right & VoiceBatchVector::load<true>(&batch.WetR[i]));
+	}
+
+	// The sums are exact, so adding the lanes together last gives the same result as the scalar order.
+	alignas(32) s32 sums[4][lanes];
+	VoiceBatchVector::store<true>(sums[0], dry_l);
+	VoiceBatchVector::store<true>(sums[1], dry_r);
+	VoiceBatchVector::store<true>(sums[2], wet_l);
+	VoiceBatchVector::store<true>(sums[3], wet_r);
+
+	VoiceBatchMix mix = {};
+	for (u32 i = 0; i < lanes; i++)
+	{
+		mix.DryL += sums[0][i];
+		mix.DryR += sums[1][i];
+		mix.WetL += sums[2][i];
+		mix.WetR += sums[3][i];
+	}
+
+	return mix;
+}
+
+MULTI_ISA_UNSHARED_END
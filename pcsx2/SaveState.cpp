@@ -41,8 +41,14 @@
 #include "IconsFontAwesome.h"
 #include "fmt/format.h"
 
+#include <algorithm>
+#include <atomic>
 #include <csetjmp>
+#include <numeric>
 #include <png.h>
+#include <thread>
+#include <zlib.h>
+#include <zstd.h>
 
 using namespace R5900;
 
@@ -83,6 +89,9 @@ static void PostLoadPrep()
 
 	UpdateVSyncRate(true);
 
+	cpuUpdateNextEventDue();
+	psxUpdateNextEventDue();
+
 	if (VMManager::Internal::HasBootedELF())
 		R5900SymbolImporter.OnElfLoadedInMemory();
 }
@@ -341,6 +350,65 @@ static const char* EntryFilename_Screenshot = "Screenshot.png";
 static const char* EntryFilename_InternalStructures = "PCSX2 Internal Structures.dat";
 static constexpr u32 STATE_PCSX2_VERSION_SIZE = 32;
 
+// --------------------------------------------------------------------------------------
+//  SavestateEntryReader
+// --------------------------------------------------------------------------------------
+// Source of the data for a savestate entry, either a file in a zip archive, or a block of
+// an in-memory state.
+class SavestateEntryReader
+{
+public:
+	virtual ~SavestateEntryReader() = default;
+
+	virtual s64 Read(void* data, size_t size) = 0;
+	virtual std::optional<std::vector<u8>> ReadAll() = 0;
+};
+
+class ZipSavestateEntryReader final : public SavestateEntryReader
+{
+public:
+	ZipSavestateEntryReader(zip_file_t* zf)
+		: m_zf(zf)
+	{
+	}
+
+	s64 Read(void* data, size_t size) override { return zip_fread(m_zf, data, size); }
+	std::optional<std::vector<u8>> ReadAll() override { return ReadBinaryFileInZip(m_zf); }
+
+private:
+	zip_file_t* m_zf;
+};
+
+class MemorySavestateEntryReader final : public SavestateEntryReader
+{
+public:
+	MemorySavestateEntryReader(const u8* data, size_t size)
+		: m_data(data)
+		, m_size(size)
+	{
+	}
+
+	s64 Read(void* data, size_t size) override
+	{
+		const size_t count = std::min(size, m_size - m_pos);
+		std::memcpy(data, m_data + m_pos, count);
+		m_pos += count;
+		return static_cast<s64>(count);
+	}
+
+	std::optional<std::vector<u8>> ReadAll() override
+	{
+		std::vector<u8> ret(m_data + m_pos, m_data + m_size);
+		m_pos = m_size;
+		return ret;
+	}
+
+private:
+	const u8* m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+};
+
 struct SysState_Component
 {
 	const char* name;
@@ -357,9 +425,9 @@ static int SysState_MTGSFreeze(FreezeAction mode, freezeData* fP)
 static constexpr SysState_Component SPU2_{ "SPU2", SPU2freeze };
 static constexpr SysState_Component GS{ "GS", SysState_MTGSFreeze };
 
-static bool SysState_ComponentFreezeIn(zip_file_t* zf, SysState_Component comp)
+static bool SysState_ComponentFreezeIn(SavestateEntryReader* reader, SysState_Component comp)
 {
-	if (!zf)
+	if (!reader)
 		return true;
 
 	freezeData fP = { 0, nullptr };
@@ -374,7 +442,7 @@ static bool SysState_ComponentFreezeIn(zip_file_t* zf, SysState_Component comp)
 		data = std::make_unique<u8[]>(fP.size);
 		fP.data = data.get();
 
-		if (zip_fread(zf, data.get(), fP.size) != static_cast<zip_int64_t>(fP.size))
+		if (reader->Read(data.get(), fP.size) != static_cast<s64>(fP.size))
 		{
 			Console.Error(fmt::format("* {}: Failed to decompress save data", comp.name));
 			return false;
@@ -418,13 +486,13 @@ static bool SysState_ComponentFreezeOut(SaveStateBase& writer, SysState_Componen
 	return true;
 }
 
-static bool SysState_ComponentFreezeInNew(zip_file_t* zf, const char* name, bool(*do_state_func)(StateWrapper&))
+static bool SysState_ComponentFreezeInNew(SavestateEntryReader* reader, const char* name, bool(*do_state_func)(StateWrapper&))
 {
 	// TODO: We could decompress on the fly here for a little bit more speed.
 	std::vector<u8> data;
-	if (zf)
+	if (reader)
 	{
-		std::optional<std::vector<u8>> optdata(ReadBinaryFileInZip(zf));
+		std::optional<std::vector<u8>> optdata(reader->ReadAll());
 		if (optdata.has_value())
 			data = std::move(optdata.value());
 	}
@@ -466,7 +534,7 @@ public:
 	virtual ~BaseSavestateEntry() = default;
 
 	virtual const char* GetFilename() const = 0;
-	virtual bool FreezeIn(zip_file_t* zf) const = 0;
+	virtual bool FreezeIn(SavestateEntryReader* reader) const = 0;
 	virtual bool FreezeOut(SaveStateBase& writer) const = 0;
 	virtual bool IsRequired() const = 0;
 };
@@ -478,7 +546,7 @@ protected:
 	virtual ~MemorySavestateEntry() = default;
 
 public:
-	virtual bool FreezeIn(zip_file_t* zf) const;
+	virtual bool FreezeIn(SavestateEntryReader* reader) const;
 	virtual bool FreezeOut(SaveStateBase& writer) const;
 	virtual bool IsRequired() const { return true; }
 
@@ -487,10 +555,10 @@ protected:
 	virtual u32 GetDataSize() const = 0;
 };
 
-bool MemorySavestateEntry::FreezeIn(zip_file_t* zf) const
+bool MemorySavestateEntry::FreezeIn(SavestateEntryReader* reader) const
 {
 	const u32 expectedSize = GetDataSize();
-	const s64 bytesRead = zip_fread(zf, GetDataPtr(), expectedSize);
+	const s64 bytesRead = reader->Read(GetDataPtr(), expectedSize);
 	if (bytesRead != static_cast<s64>(expectedSize))
 	{
 		Console.WriteLn(Color_Yellow, " '%s' is incomplete (expected 0x%x bytes, loading only 0x%x bytes)",
@@ -524,9 +592,9 @@ public:
 	u8* GetDataPtr() const override { return eeMem->Main; }
 	uint GetDataSize() const override { return Ps2MemSize::ExposedRam; }
 
-	virtual bool FreezeIn(zip_file_t* zf) const override
+	virtual bool FreezeIn(SavestateEntryReader* reader) const override
 	{
-		return MemorySavestateEntry::FreezeIn(zf);
+		return MemorySavestateEntry::FreezeIn(reader);
 	}
 };
 
@@ -616,7 +684,7 @@ public:
 	~SavestateEntry_SPU2() override = default;
 
 	const char* GetFilename() const override { return "SPU2.bin"; }
-	bool FreezeIn(zip_file_t* zf) const override { return SysState_ComponentFreezeIn(zf, SPU2_); }
+	bool FreezeIn(SavestateEntryReader* reader) const override { return SysState_ComponentFreezeIn(reader, SPU2_); }
 	bool FreezeOut(SaveStateBase& writer) const override { return SysState_ComponentFreezeOut(writer, SPU2_); }
 	bool IsRequired() const override { return true; }
 };
@@ -627,7 +695,7 @@ public:
 	~SavestateEntry_USB() override = default;
 
 	const char* GetFilename() const override { return "USB.bin"; }
-	bool FreezeIn(zip_file_t* zf) const override { return SysState_ComponentFreezeInNew(zf, "USB", &USB::DoState); }
+	bool FreezeIn(SavestateEntryReader* reader) const override { return SysState_ComponentFreezeInNew(reader, "USB", &USB::DoState); }
 	bool FreezeOut(SaveStateBase& writer) const override { return SysState_ComponentFreezeOutNew(writer, "USB", 16 * 1024, &USB::DoState); }
 	bool IsRequired() const override { return false; }
 };
@@ -638,7 +706,7 @@ public:
 	~SavestateEntry_PAD() override = default;
 
 	const char* GetFilename() const override { return "PAD.bin"; }
-	bool FreezeIn(zip_file_t* zf) const override { return SysState_ComponentFreezeInNew(zf, "PAD", &Pad::Freeze); }
+	bool FreezeIn(SavestateEntryReader* reader) const override { return SysState_ComponentFreezeInNew(reader, "PAD", &Pad::Freeze); }
 	bool FreezeOut(SaveStateBase& writer) const override { return SysState_ComponentFreezeOutNew(writer, "PAD", 16 * 1024, &Pad::Freeze); }
 	bool IsRequired() const override { return true; }
 };
@@ -649,7 +717,7 @@ public:
 	~SavestateEntry_GS() = default;
 
 	const char* GetFilename() const { return "GS.bin"; }
-	bool FreezeIn(zip_file_t* zf) const { return SysState_ComponentFreezeIn(zf, GS); }
+	bool FreezeIn(SavestateEntryReader* reader) const { return SysState_ComponentFreezeIn(reader, GS); }
 	bool FreezeOut(SaveStateBase& writer) const { return SysState_ComponentFreezeOut(writer, GS); }
 	bool IsRequired() const { return true; }
 };
@@ -659,14 +727,14 @@ class SaveStateEntry_Achievements final : public BaseSavestateEntry
 	~SaveStateEntry_Achievements() override = default;
 
 	const char* GetFilename() const override { return "Achievements.bin"; }
-	bool FreezeIn(zip_file_t* zf) const override
+	bool FreezeIn(SavestateEntryReader* reader) const override
 	{
 		if (!Achievements::IsActive())
 			return true;
 
 		std::optional<std::vector<u8>> data;
-		if (zf)
-			data = ReadBinaryFileInZip(zf);
+		if (reader)
+			data = reader->ReadAll();
 
 		if (data.has_value())
 			Achievements::LoadState(data.value());
@@ -713,7 +781,17 @@ static const std::unique_ptr<BaseSavestateEntry> SavestateEntries[] = {
 std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error)
 {
 	std::unique_ptr<ArchiveEntryList> destlist = std::make_unique<ArchiveEntryList>();
-	destlist->GetBuffer().resize(1024 * 1024 * 64);
+	if (!SaveState_DownloadState(destlist.get(), error))
+		destlist.reset();
+
+	return destlist;
+}
+
+bool SaveState_DownloadState(ArchiveEntryList* destlist, Error* error)
+{
+	destlist->Clear();
+	if (destlist->GetBuffer().size() < 1024 * 1024 * 64)
+		destlist->GetBuffer().resize(1024 * 1024 * 64);
 
 	memSavingState saveme(destlist->GetBuffer());
 	ArchiveEntry internals(EntryFilename_InternalStructures);
@@ -722,7 +800,7 @@ std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error)
 	if (!saveme.FreezeBios())
 	{
 		Error::SetString(error, "FreezeBios() failed");
-		return nullptr;
+		return false;
 	}
 
 	if (!saveme.FreezeInternals(error))
@@ -730,7 +808,7 @@ std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error)
 		if (!error->IsValid())
 			Error::SetString(error, "FreezeInternals() failed");
 
-		return nullptr;
+		return false;
 	}
 
 	internals.SetDataSize(saveme.GetCurrentPos() - internals.GetDataIndex());
@@ -742,8 +820,7 @@ std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error)
 		if (!entry->FreezeOut(saveme))
 		{
 			Error::SetString(error, fmt::format("FreezeOut() failed for {}.", entry->GetFilename()));
-			destlist.reset();
-			break;
+			return false;
 		}
 
 		destlist->Add(
@@ -752,7 +829,7 @@ std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error)
 				.SetDataSize(saveme.GetCurrentPos() - startpos));
 	}
 
-	return destlist;
+	return true;
 }
 
 std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot()
@@ -775,21 +852,8 @@ std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot()
 	return data;
 }
 
-static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, zip_t* zf)
+static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, std::vector<u8>* out_data)
 {
-	zip_error_t ze = {};
-	zip_source_t* const zs = zip_source_buffer_create(nullptr, 0, 0, &ze);
-	if (!zs)
-		return false;
-
-	if (zip_source_begin_write(zs) != 0)
-	{
-		zip_source_free(zs);
-		return false;
-	}
-
-	ScopedGuard zs_free([zs]() { zip_source_free(zs); });
-
 	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
 	png_infop info_ptr = nullptr;
 	if (!png_ptr)
@@ -807,8 +871,9 @@ static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, zip_t* z
 	if (setjmp(png_jmpbuf(png_ptr)))
 		return false;
 
-	png_set_write_fn(png_ptr, zs, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
-		zip_source_write(static_cast<zip_source_t*>(png_get_io_ptr(png_ptr)), data_ptr, size);
+	png_set_write_fn(png_ptr, out_data, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
+		std::vector<u8>* buffer = static_cast<std::vector<u8>*>(png_get_io_ptr(png_ptr));
+		buffer->insert(buffer->end(), data_ptr, data_ptr + size);
 	}, [](png_structp png_ptr) {});
 	png_set_compression_level(png_ptr, 5);
 	png_set_IHDR(png_ptr, info_ptr, data->width, data->height, 8, PNG_COLOR_TYPE_RGBA,
@@ -826,19 +891,6 @@ static bool SaveState_CompressScreenshot(SaveStateScreenshotData* data, zip_t* z
 	}
 
 	png_write_end(png_ptr, nullptr);
-
-	if (zip_source_commit_write(zs) != 0)
-		return false;
-
-	const s64 file_index = zip_file_add(zf, EntryFilename_Screenshot, zs, 0);
-	if (file_index < 0)
-		return false;
-
-	// png is already compressed, no point doing it twice
-	zip_set_file_compression(zf, file_index, ZIP_CM_STORE, 0);
-
-	// source is now owned by the zip file for later compression
-	zs_free.Cancel();
 	return true;
 }
 
@@ -924,14 +976,139 @@ static bool SaveState_ReadScreenshot(zip_t* zf, u32* out_width, u32* out_height,
 // --------------------------------------------------------------------------------------
 //  CompressThread_VmState
 // --------------------------------------------------------------------------------------
-static bool SaveState_AddToZip(zip_t* zf, ArchiveEntryList* srclist, SaveStateScreenshotData* screenshot)
+namespace
+{
+	// Entries are compressed up front, so they can be done in parallel. libzip copies the data
+	// as-is when the source reports the same compression method as the entry.
+	struct SaveStateCompressedEntry
+	{
+		const char* filename;
+		const u8* data;
+		size_t size;
+		std::vector<u8> compressed_data;
+		size_t read_pos;
+		u32 crc;
+		u16 compression_method;
+		bool result;
+	};
+} // namespace
+
+// Entries larger than this are split across zstd's worker threads, since they'd hold up the whole save otherwise.
+static constexpr size_t SAVESTATE_MT_ENTRY_SIZE = 8 * _1mb;
+
+// Emulation is still running while we compress, so don't take every core.
+static constexpr u32 SAVESTATE_MAX_COMPRESS_THREADS = 4;
+
+static bool SaveState_CompressEntryZstd(SaveStateCompressedEntry* entry, int level, u32 num_threads)
 {
-	u32 compression = ZIP_CM_DEFAULT;
-	u32 compression_level = 0;
+	ZSTD_CCtx* cctx = ZSTD_createCCtx();
+	if (!cctx)
+		return false;
+
+	ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+	if (entry->size >= SAVESTATE_MT_ENTRY_SIZE && num_threads > 1)
+	{
+		// Fails when zstd is built without threading, in which case we just compress on this thread.
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, static_cast<int>(num_threads));
+	}
+
+	entry->compressed_data.resize(ZSTD_compressBound(entry->size));
+	const size_t ret = ZSTD_compress2(cctx, entry->compressed_data.data(), entry->compressed_data.size(),
+		entry->data, entry->size);
+	ZSTD_freeCCtx(cctx);
+	if (ZSTD_isError(ret))
+	{
+		Console.ErrorFmt("Failed to compress save state entry '{}': {}", entry->filename, ZSTD_getErrorName(ret));
+		return false;
+	}
+
+	entry->compressed_data.resize(ret);
+	return true;
+}
+
+static bool SaveState_CompressEntryDeflate(SaveStateCompressedEntry* entry, int level)
+{
+	// zip uses raw deflate streams, without the zlib header.
+	z_stream zs = {};
+	if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	entry->compressed_data.resize(deflateBound(&zs, static_cast<uLong>(entry->size)));
+	zs.next_in = const_cast<Bytef*>(entry->data);
+	zs.avail_in = static_cast<uInt>(entry->size);
+	zs.next_out = entry->compressed_data.data();
+	zs.avail_out = static_cast<uInt>(entry->compressed_data.size());
+
+	const int ret = deflate(&zs, Z_FINISH);
+	entry->compressed_data.resize(zs.total_out);
+	deflateEnd(&zs);
+	if (ret != Z_STREAM_END)
+	{
+		Console.ErrorFmt("Failed to compress save state entry '{}': {}", entry->filename, ret);
+		return false;
+	}
+
+	return true;
+}
+
+static zip_int64_t SaveState_CompressedEntrySourceCallback(void* userdata, void* data, zip_uint64_t len, zip_source_cmd_t cmd)
+{
+	SaveStateCompressedEntry* entry = static_cast<SaveStateCompressedEntry*>(userdata);
+	switch (cmd)
+	{
+		case ZIP_SOURCE_OPEN:
+			entry->read_pos = 0;
+			return 0;
+
+		case ZIP_SOURCE_READ:
+		{
+			const size_t count = std::min(static_cast<size_t>(len), entry->compressed_data.size() - entry->read_pos);
+			std::memcpy(data, entry->compressed_data.data() + entry->read_pos, count);
+			entry->read_pos += count;
+			return static_cast<zip_int64_t>(count);
+		}
+
+		case ZIP_SOURCE_CLOSE:
+		case ZIP_SOURCE_FREE:
+			return 0;
+
+		case ZIP_SOURCE_STAT:
+		{
+			zip_stat_t* st = ZIP_SOURCE_GET_ARGS(zip_stat_t, data, len, nullptr);
+			if (!st)
+				return -1;
+
+			zip_stat_init(st);
+			st->valid = ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_CRC;
+			st->size = entry->size;
+			st->comp_size = entry->compressed_data.size();
+			st->comp_method = entry->compression_method;
+			st->crc = entry->crc;
+			return sizeof(*st);
+		}
+
+		case ZIP_SOURCE_ERROR:
+			return zip_error_to_data(nullptr, data, len);
+
+		case ZIP_SOURCE_SUPPORTS:
+			return zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT,
+				ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, -1);
+
+		default:
+			return -1;
+	}
+}
+
+// Entries reference the data in srclist, and both entries and screenshot_data must be kept alive until the zip is closed.
+static bool SaveState_AddToZip(zip_t* zf, ArchiveEntryList* srclist, SaveStateScreenshotData* screenshot,
+	std::vector<SaveStateCompressedEntry>* entries, std::vector<u8>* screenshot_data)
+{
+	u16 compression_method = ZIP_CM_STORE;
+	int compression_level = 0;
 
 	if (EmuConfig.Savestate.CompressionType == SavestateCompressionMethod::Zstandard)
 	{
-		compression = ZIP_CM_ZSTD;
+		compression_method = ZIP_CM_ZSTD;
 
 		if (EmuConfig.Savestate.CompressionRatio == SavestateCompressionLevel::Low)
 			compression_level = 1;
@@ -944,7 +1121,8 @@ static bool SaveState_AddToZip(zip_t* zf, ArchiveEntryList* srclist, SaveStateSc
 	}
 	else if (EmuConfig.Savestate.CompressionType == SavestateCompressionMethod::Deflate)
 	{
-		compression = ZIP_CM_DEFLATE;
+		compression_method = ZIP_CM_DEFLATE;
+
 		if (EmuConfig.Savestate.CompressionRatio == SavestateCompressionLevel::Low)
 			compression_level = 1;
 		else if (EmuConfig.Savestate.CompressionRatio == SavestateCompressionLevel::Medium)
@@ -954,11 +1132,6 @@ static bool SaveState_AddToZip(zip_t* zf, ArchiveEntryList* srclist, SaveStateSc
 		else if (EmuConfig.Savestate.CompressionRatio == SavestateCompressionLevel::VeryHigh)
 			compression_level = 9;
 	}
-	else if (EmuConfig.Savestate.CompressionType == SavestateCompressionMethod::Uncompressed)
-	{
-		compression = ZIP_CM_STORE;
-		compression_level = 0;
-	}
 
 	// version indicator
 	{
@@ -999,31 +1172,106 @@ static bool SaveState_AddToZip(zip_t* zf, ArchiveEntryList* srclist, SaveStateSc
 		zip_set_file_compression(zf, fi, ZIP_CM_STORE, 0);
 	}
 
-	const uint listlen = srclist->GetLength();
-	for (uint i = 0; i < listlen; ++i)
+	entries->clear();
+	entries->reserve(srclist->GetLength());
+	for (uint i = 0; i < srclist->GetLength(); ++i)
 	{
 		const ArchiveEntry& entry = (*srclist)[i];
 		if (!entry.GetDataSize())
 			continue;
 
-		zip_source_t* const zs = zip_source_buffer(zf, srclist->GetPtr(entry.GetDataIndex()), entry.GetDataSize(), 0);
+		entries->push_back({entry.GetFilename().c_str(), srclist->GetPtr(entry.GetDataIndex()), entry.GetDataSize(),
+			{}, 0, 0, compression_method, true});
+	}
+
+	// Largest jobs go first, so the last thread to finish isn't stuck with main memory.
+	// The screenshot is encoded as one more job, it's usually one of the slower ones.
+	const size_t screenshot_job = entries->size();
+	std::vector<size_t> jobs;
+	if (compression_method != ZIP_CM_STORE)
+	{
+		jobs.resize(entries->size());
+		std::iota(jobs.begin(), jobs.end(), 0);
+		std::sort(jobs.begin(), jobs.end(), [entries](size_t lhs, size_t rhs) {
+			return ((*entries)[lhs].size > (*entries)[rhs].size);
+		});
+	}
+	if (screenshot)
+		jobs.insert(jobs.begin(), screenshot_job);
+
+	const u32 num_threads = std::min<u32>(static_cast<u32>(jobs.size()),
+		std::clamp<u32>(std::thread::hardware_concurrency() / 2, 1, SAVESTATE_MAX_COMPRESS_THREADS));
+	std::atomic<size_t> next_job{0};
+	bool screenshot_result = false;
+	const auto worker = [&]() {
+		for (;;)
+		{
+			const size_t job = next_job.fetch_add(1, std::memory_order_relaxed);
+			if (job >= jobs.size())
+				break;
+
+			if (jobs[job] == screenshot_job)
+			{
+				screenshot_result = SaveState_CompressScreenshot(screenshot, screenshot_data);
+				continue;
+			}
+
+			SaveStateCompressedEntry& entry = (*entries)[jobs[job]];
+			entry.crc = static_cast<u32>(crc32_z(crc32_z(0, nullptr, 0), entry.data, entry.size));
+			entry.result = (compression_method == ZIP_CM_ZSTD) ?
+							   SaveState_CompressEntryZstd(&entry, compression_level, num_threads) :
+							   SaveState_CompressEntryDeflate(&entry, compression_level);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (u32 i = 1; i < num_threads; i++)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread& thread : threads)
+		thread.join();
+
+	for (SaveStateCompressedEntry& entry : *entries)
+	{
+		if (!entry.result)
+			return false;
+
+		zip_source_t* const zs = (compression_method != ZIP_CM_STORE) ?
+									 zip_source_function(zf, SaveState_CompressedEntrySourceCallback, &entry) :
+									 zip_source_buffer(zf, entry.data, entry.size, 0);
 		if (!zs)
 			return false;
 
-		const s64 fi = zip_file_add(zf, entry.GetFilename().c_str(), zs, ZIP_FL_ENC_UTF_8);
+		const s64 fi = zip_file_add(zf, entry.filename, zs, ZIP_FL_ENC_UTF_8);
 		if (fi < 0)
 		{
 			zip_source_free(zs);
 			return false;
 		}
 
-		zip_set_file_compression(zf, fi, compression, compression_level);
+		// Precompressed entries take the method from the source.
+		if (compression_method == ZIP_CM_STORE)
+			zip_set_file_compression(zf, fi, ZIP_CM_STORE, 0);
 	}
 
 	if (screenshot)
 	{
-		if (!SaveState_CompressScreenshot(screenshot, zf))
+		if (!screenshot_result)
 			return false;
+
+		zip_source_t* const zs = zip_source_buffer(zf, screenshot_data->data(), screenshot_data->size(), 0);
+		if (!zs)
+			return false;
+
+		const s64 file_index = zip_file_add(zf, EntryFilename_Screenshot, zs, 0);
+		if (file_index < 0)
+		{
+			zip_source_free(zs);
+			return false;
+		}
+
+		// png is already compressed, no point doing it twice
+		zip_set_file_compression(zf, file_index, ZIP_CM_STORE, 0);
 	}
 
 	return true;
@@ -1048,7 +1296,9 @@ bool SaveState_ZipToDisk(
 	}
 
 	// discard zip file if we fail saving something
-	if (!SaveState_AddToZip(zf, srclist.get(), screenshot.get()))
+	std::vector<SaveStateCompressedEntry> entries;
+	std::vector<u8> screenshot_data;
+	if (!SaveState_AddToZip(zf, srclist.get(), screenshot.get(), &entries, &screenshot_data))
 	{
 		Error::SetStringFmt(error,
 			TRANSLATE_FS("SaveState", "Failed to save state to zip file '{}'."), filename);
@@ -1056,7 +1306,7 @@ bool SaveState_ZipToDisk(
 		return false;
 	}
 
-	// force the zip to close, this is the expensive part with libzip.
+	// entries are already compressed, so this is just writing them out.
 	if (zip_close(zf) != 0)
 	{
 		Error::SetStringFmt(error,
@@ -1223,7 +1473,70 @@ bool SaveState_UnzipFromDisk(const std::string& filename, Error* error)
 		}
 
 		auto zff = zip_fopen_index_managed(zf.get(), entryIndices[i], 0);
-		if (!zff || !SavestateEntries[i]->FreezeIn(zff.get()))
+		ZipSavestateEntryReader reader(zff.get());
+		if (!zff || !SavestateEntries[i]->FreezeIn(&reader))
+		{
+			Error::SetString(error, fmt::format("Save state corruption in {}.", SavestateEntries[i]->GetFilename()));
+			VMManager::Reset();
+			return false;
+		}
+	}
+
+	PostLoadPrep();
+	return true;
+}
+
+static const ArchiveEntry* FindEntryInList(const ArchiveEntryList& list, const char* name)
+{
+	for (size_t i = 0; i < list.GetLength(); i++)
+	{
+		if (list[i].GetFilename() == name)
+			return &list[i];
+	}
+
+	return nullptr;
+}
+
+bool SaveState_LoadFromMemory(const ArchiveEntryList& srclist, Error* error)
+{
+	const ArchiveEntry* internals = FindEntryInList(srclist, EntryFilename_InternalStructures);
+	const ArchiveEntry* entries[std::size(SavestateEntries)];
+	bool allPresent = (internals != nullptr);
+	for (u32 i = 0; i < std::size(SavestateEntries); i++)
+	{
+		entries[i] = FindEntryInList(srclist, SavestateEntries[i]->GetFilename());
+		allPresent = allPresent && (entries[i] || !SavestateEntries[i]->IsRequired());
+	}
+	if (!allPresent)
+	{
+		Error::SetString(error, "Some required components were not found or are incomplete.");
+		return false;
+	}
+
+	PreLoadPrep();
+
+	const u8* internals_ptr = srclist.GetPtr(internals->GetDataIndex());
+	const std::vector<u8> internals_data(internals_ptr, internals_ptr + internals->GetDataSize());
+	memLoadingState state(internals_data);
+	if (!state.FreezeBios() || !state.FreezeInternals(error))
+	{
+		if (!error->IsValid())
+			Error::SetString(error, "Save state corruption in internal structures.");
+
+		VMManager::Reset();
+		return false;
+	}
+
+	for (u32 i = 0; i < std::size(SavestateEntries); ++i)
+	{
+		if (!entries[i])
+		{
+			SavestateEntries[i]->FreezeIn(nullptr);
+			continue;
+		}
+
+		MemorySavestateEntryReader reader(srclist.GetPtr(entries[i]->GetDataIndex()), entries[i]->GetDataSize());
+		if (!SavestateEntries[i]->FreezeIn(&reader))
 		{
 			Error::SetString(error, fmt::format("Save state corruption in {}.", SavestateEntries[i]->GetFilename()));
 			VMManager::Reset();
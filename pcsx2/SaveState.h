@@ -53,12 +53,14 @@ class ArchiveEntryList;
 // Wrappers to generate a save state compatible across all frontends.
 // These functions assume that the caller has paused the core thread.
 extern std::unique_ptr<ArchiveEntryList> SaveState_DownloadState(Error* error);
+extern bool SaveState_DownloadState(ArchiveEntryList* destlist, Error* error); // reuses the list's buffer
 extern std::unique_ptr<SaveStateScreenshotData> SaveState_SaveScreenshot();
 extern bool SaveState_ZipToDisk(
 	std::unique_ptr<ArchiveEntryList> srclist, std::unique_ptr<SaveStateScreenshotData> screenshot,
 	const char* filename, Error* error);
 extern bool SaveState_ReadScreenshot(const std::string& filename, u32* out_width, u32* out_height, std::vector<u32>* out_pixels);
 extern bool SaveState_UnzipFromDisk(const std::string& filename, Error* error);
+extern bool SaveState_LoadFromMemory(const ArchiveEntryList& srclist, Error* error);
 
 // --------------------------------------------------------------------------------------
 //  SaveStateBase class
@@ -315,6 +317,12 @@ public:
 		return *this;
 	}
 
+	// Removes all entries, but keeps the buffer allocated.
+	void Clear()
+	{
+		m_list.clear();
+	}
+
 	size_t GetLength() const
 	{
 		return m_list.size();
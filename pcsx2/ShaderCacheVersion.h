@@ -3,4 +3,4 @@
 
 /// Version number for GS and other shaders. Increment whenever any of the contents of the
 /// shaders change, to invalidate the cache.
-static constexpr u32 SHADER_CACHE_VERSION = 109; // Last changed in PR 14795
+static constexpr u32 SHADER_CACHE_VERSION = 110;
@@ -5,6 +5,7 @@
 #include "BuildVersion.h"
 #include "CDVD/CDVD.h"
 #include "CDVD/IsoReader.h"
+#include "CDVD/ThreadedFileReader.h"
 #include "Counters.h"
 #include "DEV9/DEV9.h"
 #include "DebugTools/DebugInterface.h"
@@ -29,6 +30,7 @@
 #include "PerformanceMetrics.h"
 #include "R3000A.h"
 #include "R5900.h"
+#include "Rewind.h"
 #include "Recording/InputRecording.h"
 #include "Recording/InputRecordingControls.h"
 #include "SIO/Memcard/MemoryCardFile.h"
@@ -1186,6 +1188,11 @@ void VMManager::HandleELFChange(bool verbose_patches_if_changed)
 	Console.WriteLn(Color_StrongOrange, fmt::format("ELF changed, active CRC {:08X} ({})", crc_to_report, s_elf_path));
 	Patch::ReloadPatches(s_disc_serial, crc_to_report, false, false, false, verbose_patches_if_changed);
 	ApplyCoreSettings();
+
+#ifdef _M_X86
+	recSetBlockListGame(s_disc_serial, crc_to_report);
+	mVUSetProgramListGame(s_disc_serial, crc_to_report);
+#endif
 }
 
 void VMManager::UpdateELFInfo(std::string elf_path)
@@ -1677,6 +1684,13 @@ void VMManager::Shutdown(bool save_resume_state)
 	if (g_InputRecording.isActive())
 		g_InputRecording.stop();
 
+	Rewind::Shutdown();
+
+#ifdef _M_X86
+	recSetBlockListGame({}, 0);
+	mVUSetProgramListGame({}, 0);
+#endif
+
 	SaveSessionTime(s_disc_serial);
 	s_elf_override = {};
 	ClearELFInfo();
@@ -1787,6 +1801,8 @@ void VMManager::Reset()
 	vu1Thread.Reset();
 	MTGS::WaitGS();
 
+	Rewind::Reset();
+
 	const bool elf_was_changed = (s_current_crc != 0);
 	ClearELFInfo();
 	if (elf_was_changed)
@@ -1903,6 +1919,9 @@ bool VMManager::DoLoadState(const char* filename, Error* error)
 
 	Host::OnSaveStateLoading(filename);
 
+	// Anything captured before the load belongs to a different timeline.
+	Rewind::Reset();
+
 	if (!SaveState_UnzipFromDisk(filename, error))
 		return false;
 
@@ -2116,6 +2135,53 @@ bool VMManager::LoadStateFromSlot(s32 slot, bool backup, Error* error)
 	return true;
 }
 
+bool VMManager::RewindState(Error* error)
+{
+	if (!EmuConfig.Savestate.RewindEnable)
+	{
+		Error::SetString(error, TRANSLATE_STR("VMManager", "Rewind is not enabled."));
+		return false;
+	}
+
+	if (Achievements::IsHardcoreModeActive())
+	{
+		Error::SetString(error,
+			TRANSLATE_STR("VMManager", "Cannot rewind while RetroAchievements Hardcore Mode is active."));
+		return false;
+	}
+
+	if (GSDumpReplayer::IsReplayingDump())
+	{
+		Error::SetString(error, TRANSLATE_STR("VMManager", "Cannot rewind while replaying a GS dump."));
+		return false;
+	}
+
+	if (g_InputRecording.isActive())
+	{
+		Error::SetString(error, TRANSLATE_STR("VMManager", "Cannot rewind while an input recording is active."));
+		return false;
+	}
+
+	if (MemcardBusy::IsBusy())
+	{
+		Error::SetString(error,
+			TRANSLATE_STR("VMManager",
+				"The memory card is busy, so the rewind operation has been cancelled to prevent data loss."));
+		return false;
+	}
+
+	u32 frames_rewound;
+	if (!Rewind::LoadPreviousState(&frames_rewound, error))
+		return false;
+
+	MTGS::PresentCurrentFrame();
+	MemcardBusy::CheckSaveStateDependency();
+
+	Host::AddIconOSDMessage("RewindState", ICON_FA_BACKWARD,
+		fmt::format(TRANSLATE_FS("VMManager", "Rewound {} frames."), frames_rewound), Host::OSD_QUICK_DURATION);
+	return true;
+}
+
 void VMManager::SaveState(
 	const char* filename, bool zip_on_thread, bool backup_old_state, std::function<void(const std::string&)> error_callback)
 {
@@ -2759,6 +2825,9 @@ void VMManager::Execute()
 
 	// Execute until we're asked to stop.
 	Cpu->Execute();
+
+	// Now that the CPU is at a safe point, take any rewind state it stopped for.
+	Rewind::CaptureIfDue();
 }
 
 void VMManager::IdlePollUpdate()
@@ -2919,6 +2988,10 @@ void VMManager::Internal::VSyncOnCPUThread()
 
 	Achievements::FrameUpdate();
 
+	Rewind::OnVSync();
+
+	PINEServer::VSync();
+
 	PollDiscordPresence();
 }
 
@@ -2961,6 +3034,13 @@ void VMManager::CheckForCPUConfigChanges(const Pcsx2Config& old_config)
 	if (EmuConfig.Cpu.Recompiler.EnableFastmem != old_config.Cpu.Recompiler.EnableFastmem)
 		vtlb_ResetFastmem();
 
+#ifdef _M_X86
+	if (EmuConfig.Cpu.Recompiler.PrecompileEEBlocks != old_config.Cpu.Recompiler.PrecompileEEBlocks)
+		recSetBlockListGame(s_disc_serial, HasBootedELF() ? s_current_crc : 0);
+	if (EmuConfig.Cpu.Recompiler.PrecompileVUPrograms != old_config.Cpu.Recompiler.PrecompileVUPrograms)
+		mVUSetProgramListGame(s_disc_serial, HasBootedELF() ? s_current_crc : 0);
+#endif
+
 	// did we toggle recompilers?
 	if (EmuConfig.Cpu.CpusChanged(old_config.Cpu))
 	{
@@ -3098,6 +3178,13 @@ void VMManager::CheckForMiscConfigChanges(const Pcsx2Config& old_config)
 			ShutdownDiscordPresence();
 	}
 
+	// Free the buffer straight away, rather than waiting for the VM to shut down.
+	if (!EmuConfig.Savestate.RewindEnable && old_config.Savestate.RewindEnable)
+		Rewind::Shutdown();
+
+	if (EmuConfig.CdvdCacheSize != old_config.CdvdCacheSize)
+		ThreadedFileReader::SetCacheSize(EmuConfig.CdvdCacheSize);
+
 	if (HasValidVM() && (EmuConfig.EnableThreadPinning != old_config.EnableThreadPinning ||
 							(s_thread_affinities_set && EmuConfig.Speedhacks.vuThread != old_config.Speedhacks.vuThread)))
 	{
@@ -158,6 +158,10 @@ public:
 	void ResumeXGkick() override;
 };
 
+// Selects the game whose microprograms are remembered and precompiled by microVU.
+// The previous game's list is saved. Passing a zero CRC saves the list without selecting a new one.
+extern void mVUSetProgramListGame(const std::string& serial, u32 crc);
+
 extern InterpVU0 CpuIntVU0;
 extern InterpVU1 CpuIntVU1;
 
@@ -13,6 +13,9 @@ typedef void (*nVifrecCall)(uptr dest, uptr src);
 extern void _nVifUnpack(int idx, const u8* data, uint mode, bool isFill);
 extern void dVifReset(int idx);
 extern void dVifRelease(int idx);
+extern void dVifResetArena(int idx, u8* start, size_t size);
+extern void dVifReleaseArena(int idx);
+extern void dVifReserve(int idx);
 extern void VifUnpackSSE_Init();
 
 _vifT extern void dVifUnpack(const u8* data, bool isFill);
@@ -28,11 +31,21 @@ struct nVifStruct
 	// (templates are used for most or all VIF indexing)
 	u32                     idx;
 
-	u8*                     recWritePtr; // current write pos into the reserve
-	u8*                     recEndPtr;
+	u8*                     recWritePtr;    // current write pos into the reserve
+	u8*                     recEndPtr;      // end of the current segment
+	u8*                     recStartPtr;    // start of the reserve
+	u8*                     recLimitPtr;    // end of the reserve, blocks can run past the last segment up to here
+	u32                     recSegmentSize;
+	u32                     recSegment;     // segment recWritePtr is in
+	const vifStruct*        recVif;         // vif struct the compiled blocks work on
 
 	HashBucket              vifBlocks;   // Vif Blocks
 
+	// Statistics for the performance overlay, only written by the thread running this VIF.
+	u32                     lookups;     // unpacks run through the block cache
+	u32                     compiles;    // lookups which missed and compiled a block
+	u32                     evictions;   // blocks dropped to make room for new ones
+
 
 	nVifStruct() = default;
 };
@@ -44,3 +57,10 @@ alignas(16) extern nVifCall nVifUpk[(2 * 2 * 16) * 4]; // ([USN][Masking][Unpack
 alignas(16) extern u32      nVifMask[3][4][4];         // [MaskNumber][CycleNumber][Vector]
 
 static constexpr bool newVifDynaRec = 1; // Use code in Vif_Dynarec.inl
+
+// The code reserve is split into segments which are recycled oldest first, so running out of space
+// only drops the blocks in one segment, rather than the whole cache.
+static constexpr u32 nVifRecSegments = 4;
+
+// Space past the end of a segment that the last block compiled into it may use.
+static constexpr u32 nVifRecSpill = _256kb;
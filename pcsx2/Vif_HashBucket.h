@@ -51,6 +51,10 @@ class HashBucket
 protected:
 	std::array<nVifBlock*, hSize> m_bucket;
 
+	// Statistics, read by the performance overlay.
+	u32 m_count = 0;
+	u32 m_maxChain = 0;
+
 public:
 	HashBucket()
 	{
@@ -94,8 +98,41 @@ public:
 
 		if (size > 3)
 			DevCon.Warning("recVifUnpk: Bucket 0x%04x has %d micro-programs", b, size);
+
+		m_count++;
+		m_maxChain = std::max(m_maxChain, size);
+	}
+
+	// Removes every block matching the predicate, and returns how many were removed.
+	template <typename Pred>
+	u32 remove_if(Pred pred)
+	{
+		u32 removed = 0;
+		m_maxChain = 0;
+
+		for (nVifBlock* chain : m_bucket)
+		{
+			u32 size = 0;
+			for (nVifBlock* chainpos = chain; chainpos->startPtr != 0; chainpos++)
+			{
+				if (pred(*chainpos))
+					removed++;
+				else
+					memcpy(&chain[size++], chainpos, sizeof(nVifBlock));
+			}
+
+			// Keep the empty cell at the end of the chain.
+			memset(&chain[size], 0, sizeof(nVifBlock));
+			m_maxChain = std::max(m_maxChain, size);
+		}
+
+		m_count -= removed;
+		return removed;
 	}
 
+	u32 count() const { return m_count; }
+	u32 max_chain() const { return m_maxChain; }
+
 	u32 bucket_size(const nVifBlock& dataPtr)
 	{
 		nVifBlock* chainpos = m_bucket[dataPtr.hash_key];
@@ -115,6 +152,9 @@ public:
 	{
 		for (auto& bucket : m_bucket)
 			safe_aligned_free(bucket);
+
+		m_count = 0;
+		m_maxChain = 0;
 	}
 
 	void reset()
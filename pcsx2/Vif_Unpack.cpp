@@ -321,6 +321,61 @@ void releaseNewVif(int idx)
 {
 }
 
+void dVifResetArena(int idx, u8* start, size_t size)
+{
+	nVifStruct& v = nVif[idx];
+
+	// Compiled blocks only depend on their key and on the vif struct they work on, so they are
+	// kept across resets and state loads, unless MTVU has been toggled since they were compiled.
+	const vifStruct* vif = idx ? (THREAD_VU1 ? &vu1Thread.vif : &vif1) : &vif0;
+	if (v.recStartPtr == start && v.recVif == vif)
+		return;
+
+	v.vifBlocks.reset();
+	v.recStartPtr = start;
+	v.recLimitPtr = start + size;
+	v.recSegmentSize = static_cast<u32>((size - nVifRecSpill) / nVifRecSegments);
+	v.recSegment = 0;
+	v.recWritePtr = start;
+	v.recEndPtr = start + v.recSegmentSize;
+	v.recVif = vif;
+}
+
+void dVifReleaseArena(int idx)
+{
+	nVifStruct& v = nVif[idx];
+	v.vifBlocks.clear();
+	v.recStartPtr = nullptr;
+	v.recVif = nullptr;
+}
+
+void dVifReserve(int idx)
+{
+	nVifStruct& v = nVif[idx];
+	if (v.recWritePtr < v.recEndPtr) [[likely]]
+		return;
+
+	// Move on to the next segment, wrapping around once the last one is full. Blocks compiled at
+	// the end of the previous segment may already run into this one, so only wrapping resets the
+	// write position.
+	v.recSegment = (v.recSegment + 1) % nVifRecSegments;
+	u8* const segmentStart = v.recStartPtr + v.recSegment * v.recSegmentSize;
+	if (v.recSegment == 0)
+		v.recWritePtr = segmentStart;
+	v.recEndPtr = segmentStart + v.recSegmentSize;
+
+	// Drop the blocks compiled here last time around, and those the last block of this segment
+	// could run over at the start of the next one.
+	const uptr evictStart = reinterpret_cast<uptr>(segmentStart);
+	const uptr evictEnd = reinterpret_cast<uptr>(v.recEndPtr) + nVifRecSpill;
+	const u32 evicted = v.vifBlocks.remove_if([evictStart, evictEnd](const nVifBlock& block) {
+		return (block.startPtr >= evictStart && block.startPtr < evictEnd);
+	});
+	v.evictions += evicted;
+
+	DevCon.WriteLn("nVif%d: Recycling code segment %u, dropped %u blocks.", idx, v.recSegment, evicted);
+}
+
 static __fi u8* getVUptr(uint idx, int offset)
 {
 	return (u8*)(vuRegs[idx].Mem + (offset & (idx ? 0x3ff0 : 0xff0)));
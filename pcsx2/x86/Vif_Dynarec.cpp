@@ -8,17 +8,14 @@
 
 void dVifReset(int idx)
 {
-	nVif[idx].vifBlocks.reset();
-
 	const size_t offset = idx ? HostMemoryMap::VIF1recOffset : HostMemoryMap::VIF0recOffset;
 	const size_t size = idx ? HostMemoryMap::VIF1recSize : HostMemoryMap::VIF0recSize;
-	nVif[idx].recWritePtr = SysMemory::GetCodePtr(offset);
-	nVif[idx].recEndPtr = nVif[idx].recWritePtr + (size - _256kb);
+	dVifResetArena(idx, SysMemory::GetCodePtr(offset), size);
 }
 
 void dVifRelease(int idx)
 {
-	nVif[idx].vifBlocks.clear();
+	dVifReleaseArena(idx);
 }
 
 VifUnpackSSE_Dynarec::VifUnpackSSE_Dynarec(const nVifStruct& vif_, const nVifBlock& vifBlock_)
@@ -424,13 +421,9 @@ _vifT __fi nVifBlock* dVifCompile(nVifBlock& block, bool isFill)
 {
 	nVifStruct& v = nVif[idx];
 
-	// Check size before the compilation
-	if (v.recWritePtr >= v.recEndPtr)
-	{
-		DevCon.WriteLn("nVif Recompiler Cache Reset! [0x%016" PRIXPTR " > 0x%016" PRIXPTR "]",
-			v.recWritePtr, v.recEndPtr);
-		dVifReset(idx);
-	}
+	// Make room for the block, recycling the oldest segment if this one is full
+	dVifReserve(idx);
+	v.compiles++;
 
 	// Compile the block now
 	xSetTextPtr(nullptr);
@@ -487,6 +480,7 @@ _vifT __fi void dVifUnpack(const u8* data, bool isFill)
 	//);
 
 	// Seach in cache before trying to compile the block
+	v.lookups++;
 	nVifBlock* b = v.vifBlocks.find(block);
 	if (!b) [[unlikely]]
 		b = dVifCompile<idx>(block, isFill);
@@ -3,6 +3,7 @@
 
 #include "Common.h"
 #include "CDVD/CDVD.h"
+#include "Counters.h"
 #include "DebugTools/Breakpoints.h"
 #include "Elfheader.h"
 #include "GS.h"
@@ -18,9 +19,21 @@
 #include "x86/iR5900Analysis.h"
 
 #include "common/AlignedMalloc.h"
+#include "common/Error.h"
 #include "common/FastJmp.h"
+#include "common/FileSystem.h"
 #include "common/HeapArray.h"
+#include "common/Path.h"
 #include "common/Perf.h"
+#include "common/Timer.h"
+
+#include "fmt/format.h"
+
+#define XXH_STATIC_LINKING_ONLY 1
+#define XXH_INLINE_ALL 1
+#include "xxhash.h"
+
+#include <unordered_map>
 
 // Only for MOVQ workaround.
 #include "common/emitter/internal.h"
@@ -93,6 +106,24 @@ u32 s_nEndBlock = 0; // what pc the current block ends
 u32 s_branchTo;
 static bool s_nBlockFF;
 
+// Blocks compiled by the current game, kept between sessions. See recSetBlockListGame().
+struct BlockListEntry
+{
+	u32 startpc;
+	u32 size; // in instructions
+	u64 hash; // of the guest code
+};
+static_assert(sizeof(BlockListEntry) == 16);
+
+static std::string s_block_list_path;
+static std::vector<BlockListEntry> s_block_list;
+static std::unordered_map<u32, u32> s_block_list_lookup;
+static u32 s_block_list_pos = 0;
+static u32 s_block_list_last_frame = 0;
+static u32 s_block_list_pass_frame = 0;
+static bool s_block_list_burst = false;
+static bool s_block_list_dirty = false;
+
 // save states for branches
 GPR_reg64 s_saveConstRegs[32];
 static u32 s_saveHasConstReg = 0, s_saveFlushedConstReg = 0;
@@ -104,6 +135,8 @@ static void iBranchTest(u32 newpc = 0xffffffff);
 static void ClearRecLUT(BASEBLOCK* base, int count);
 static u32 scaleblockcycles();
 static void recExitExecution();
+static void recRecordBlock(u32 startpc, u32 size);
+static void recPrewarmBlocksForFrame();
 
 #ifdef TRACE_BLOCKS
 static void pauseAAA()
@@ -399,6 +432,10 @@ static void recEventTest()
 {
 	_cpuEventTest_Shared();
 
+	// We're between blocks here, so it's safe to compile more.
+	if (!s_block_list.empty() && (s_block_list_burst || s_block_list_last_frame != g_FrameCount))
+		recPrewarmBlocksForFrame();
+
 	if (eeRecExitRequested)
 	{
 		eeRecExitRequested = false;
@@ -678,6 +715,10 @@ static void recResetRaw()
 
 	memset(manual_page, 0, sizeof(manual_page));
 	memset(manual_counter, 0, sizeof(manual_counter));
+
+	// Everything has to be compiled again, so start from the top of the block list.
+	s_block_list_pos = 0;
+	s_block_list_burst = true;
 }
 
 void recShutdown()
@@ -2699,6 +2740,9 @@ StartRecomp:
 		}
 
 		memcpy(&recRAMCopy[HWADDR(startpc) / 4], PSM(startpc), pc - startpc);
+
+		if (!s_block_list_path.empty())
+			recRecordBlock(startpc, s_pCurBlockEx->size);
 	}
 
 	s_pCurBlock->SetFnptr((uptr)recPtr);
@@ -2765,6 +2809,227 @@ StartRecomp:
 	s_pCurBlockEx = nullptr;
 }
 
+// =====================================================================================================
+//  Block List
+// =====================================================================================================
+// Compiled code can't be kept between sessions, since it's full of absolute addresses, backpatched
+// fastmem accesses and links to other blocks. Instead, we remember where each game's blocks start,
+// along with a hash of their guest code. When the game is booted again, or the recompiler is reset
+// (e.g. by loading a state), any block whose code still matches is compiled ahead of time, rather
+// than stalling the first time it's executed.
+
+static constexpr u32 BLOCK_LIST_MAGIC = 0x4C424545; // EEBL
+static constexpr u32 BLOCK_LIST_VERSION = 1;
+static constexpr u32 BLOCK_LIST_MAX_ENTRIES = 128 * 1024;
+
+// Prewarming is spread over frames, so it doesn't cause the stutter it's meant to avoid.
+static constexpr u32 BLOCK_LIST_CHECKS_PER_FRAME = 1024;
+static constexpr u32 BLOCK_LIST_COMPILES_PER_FRAME = 64;
+
+// Except for straight after a reset, where we're going to have to compile a lot of blocks anyway.
+static constexpr float BLOCK_LIST_BURST_TIME_MS = 50.0f;
+
+// Code can be loaded after the last pass (e.g. overlays), so the list is checked again periodically.
+static constexpr u32 BLOCK_LIST_RESCAN_FRAMES = 600;
+
+struct BlockListHeader
+{
+	u32 magic;
+	u32 version;
+	u32 ram_size;
+	u32 num_entries;
+};
+
+static u64 recHashBlockCode(u32 startpc, u32 size)
+{
+	return XXH64(PSM(HWADDR(startpc)), size * 4, 0);
+}
+
+static void recRecordBlock(u32 startpc, u32 size)
+{
+	const u64 hash = recHashBlockCode(startpc, size);
+	const auto it = s_block_list_lookup.find(startpc);
+	if (it != s_block_list_lookup.end())
+	{
+		BlockListEntry& entry = s_block_list[it->second];
+		if (entry.size != size || entry.hash != hash)
+		{
+			entry.size = size;
+			entry.hash = hash;
+			s_block_list_dirty = true;
+		}
+
+		return;
+	}
+
+	if (s_block_list.size() >= BLOCK_LIST_MAX_ENTRIES)
+		return;
+
+	s_block_list_lookup.emplace(startpc, static_cast<u32>(s_block_list.size()));
+	s_block_list.push_back({startpc, size, hash});
+	s_block_list_dirty = true;
+}
+
+static bool recPrewarmBlock(const BlockListEntry& entry)
+{
+	// Skip anything already compiled, or on pages which aren't currently mapped.
+	if (PC_GETBLOCK(entry.startpc)->GetFnptr() != (uptr)JITCompile)
+		return false;
+
+	const u32 hwaddr = HWADDR(entry.startpc);
+	if (hwaddr >= Ps2MemSize::ExposedRam || (Ps2MemSize::ExposedRam - hwaddr) < (entry.size * 4))
+		return false;
+
+	// These blocks have side effects when they're compiled, so they have to wait until they're executed.
+	if (hwaddr == VMManager::Internal::GetCurrentELFEntryPoint() || hwaddr == EELOAD_START ||
+		(g_eeloadMain && hwaddr == HWADDR(g_eeloadMain)) || (g_eeloadExec && hwaddr == HWADDR(g_eeloadExec)))
+	{
+		return false;
+	}
+
+	if (recHashBlockCode(entry.startpc, entry.size) != entry.hash)
+		return false;
+
+	recRecompile(entry.startpc);
+	return true;
+}
+
+static void recPrewarmBlocks(u32 max_checks, u32 max_compiles, float max_time_ms)
+{
+	Common::Timer timer;
+	u32 checks = 0;
+	u32 compiles = 0;
+
+	while (s_block_list_pos < s_block_list.size() && checks < max_checks && compiles < max_compiles)
+	{
+		// Leave room in the code buffer for blocks which are actually executed, since filling it
+		// would force a reset. Compiling can also request a reset, which can't happen from here.
+		if (eeRecNeedsReset || (recPtr - SysMemory::GetEERec()) >= ((recPtrEnd - SysMemory::GetEERec()) / 2))
+		{
+			s_block_list_pos = static_cast<u32>(s_block_list.size());
+			break;
+		}
+
+		// Compiling can add to the list, so take a copy of the entry.
+		const BlockListEntry entry = s_block_list[s_block_list_pos++];
+		compiles += static_cast<u32>(recPrewarmBlock(entry));
+		checks++;
+
+		if ((checks % 64) == 0 && timer.GetTimeMilliseconds() >= max_time_ms)
+			break;
+	}
+
+	if (s_block_list_pos >= s_block_list.size())
+		s_block_list_pass_frame = g_FrameCount;
+
+	if (compiles > 0)
+	{
+		eeRecPerfLog.Write("Prewarmed %u of %u checked blocks in %.2f ms", compiles, checks,
+			timer.GetTimeMilliseconds());
+	}
+}
+
+static void recPrewarmBlocksForFrame()
+{
+	s_block_list_last_frame = g_FrameCount;
+
+	if (EmuConfig.Gamefixes.GoemonTlbHack)
+		return;
+
+	if (std::exchange(s_block_list_burst, false))
+	{
+		recPrewarmBlocks(std::numeric_limits<u32>::max(), std::numeric_limits<u32>::max(), BLOCK_LIST_BURST_TIME_MS);
+		return;
+	}
+
+	if (s_block_list_pos >= s_block_list.size())
+	{
+		if ((g_FrameCount - s_block_list_pass_frame) < BLOCK_LIST_RESCAN_FRAMES)
+			return;
+
+		s_block_list_pos = 0;
+	}
+
+	recPrewarmBlocks(BLOCK_LIST_CHECKS_PER_FRAME, BLOCK_LIST_COMPILES_PER_FRAME, std::numeric_limits<float>::max());
+}
+
+static void recSaveBlockList()
+{
+	if (!s_block_list_dirty || s_block_list_path.empty())
+		return;
+
+	s_block_list_dirty = false;
+
+	const BlockListHeader header = {BLOCK_LIST_MAGIC, BLOCK_LIST_VERSION, Ps2MemSize::ExposedRam,
+		static_cast<u32>(s_block_list.size())};
+	std::vector<u8> data(sizeof(header) + s_block_list.size() * sizeof(BlockListEntry));
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), s_block_list.data(), s_block_list.size() * sizeof(BlockListEntry));
+
+	Error error;
+	if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(s_block_list_path)).c_str(), false, &error) ||
+		!FileSystem::WriteBinaryFile(s_block_list_path.c_str(), data.data(), data.size()))
+	{
+		Console.ErrorFmt("(EE) Failed to save block list to '{}': {}", s_block_list_path, error.GetDescription());
+		return;
+	}
+
+	DevCon.WriteLnFmt("(EE) Saved {} blocks to '{}'", s_block_list.size(), Path::GetFileName(s_block_list_path));
+}
+
+static void recLoadBlockList()
+{
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(s_block_list_path.c_str());
+	if (!data.has_value())
+		return;
+
+	BlockListHeader header;
+	if (data->size() < sizeof(header))
+		return;
+
+	std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != BLOCK_LIST_MAGIC || header.version != BLOCK_LIST_VERSION ||
+		header.ram_size != Ps2MemSize::ExposedRam || header.num_entries > BLOCK_LIST_MAX_ENTRIES ||
+		data->size() != (sizeof(header) + header.num_entries * sizeof(BlockListEntry)))
+	{
+		Console.WarningFmt("(EE) Ignoring invalid block list '{}'", Path::GetFileName(s_block_list_path));
+		return;
+	}
+
+	s_block_list.resize(header.num_entries);
+	std::memcpy(s_block_list.data(), data->data() + sizeof(header), header.num_entries * sizeof(BlockListEntry));
+	for (u32 i = 0; i < header.num_entries; i++)
+		s_block_list_lookup.emplace(s_block_list[i].startpc, i);
+
+	Console.WriteLnFmt("(EE) Loaded {} blocks from '{}'", header.num_entries, Path::GetFileName(s_block_list_path));
+}
+
+void recSetBlockListGame(const std::string& serial, u32 crc)
+{
+	std::string path;
+	if (EmuConfig.Cpu.Recompiler.PrecompileEEBlocks && crc != 0)
+	{
+		path = Path::Combine(Path::Combine(EmuFolders::Cache, "eeblocks"),
+			fmt::format("{}_{:08X}.bin", serial.empty() ? std::string_view("ELF") : std::string_view(serial), crc));
+	}
+
+	if (path == s_block_list_path)
+		return;
+
+	recSaveBlockList();
+
+	s_block_list_path = std::move(path);
+	s_block_list.clear();
+	s_block_list_lookup.clear();
+	s_block_list_dirty = false;
+	if (s_block_list_path.empty())
+		return;
+
+	recLoadBlockList();
+	s_block_list_pos = 0;
+	s_block_list_burst = true;
+}
+
 R5900cpu recCpu = {
 	recReserve,
 	recShutdown,
@@ -4,8 +4,24 @@
 #include "microVU.h"
 
 #include "common/AlignedMalloc.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
 #include "common/Perf.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
+
+#include "fmt/format.h"
+
+#define XXH_STATIC_LINKING_ONLY 1
+#define XXH_INLINE_ALL 1
+#include "xxhash.h"
+
+#include <unordered_map>
+
+static void mVUrecordProgs(microVU& mVU);
+static void mVUresetProgramList(microVU& mVU);
+static void mVUprintSearchStats(microVU& mVU);
 
 //------------------------------------------------------------------
 // Micro VU - Main Functions
@@ -54,6 +70,13 @@ void mVUreset(microVU& mVU, bool resetReserve)
 	memset(&mVU.prog.lpState, 0, sizeof(mVU.prog.lpState));
 	mVU.profiler.Reset(mVU.index);
 
+	// Remember the programs before they're thrown away, they'll be compiled again ahead of time
+	mVUrecordProgs(mVU);
+	mVUresetProgramList(mVU);
+	mVUprintSearchStats(mVU);
+	std::memset(&mVU.prog.stats, 0, sizeof(mVU.prog.stats));
+	std::memset(mVU.prog.microHash, 0, sizeof(mVU.prog.microHash));
+
 	// Program Variables
 	mVU.prog.cleared  =  1;
 	mVU.prog.isSame   = -1;
@@ -85,6 +108,8 @@ void mVUreset(microVU& mVU, bool resetReserve)
 // Free Allocated Resources
 void mVUclose(microVU& mVU)
 {
+	mVUprintSearchStats(mVU);
+
 	// Delete Programs and Block Managers
 	for (u32 i = 0; i < (mVU.progSize / 2); i++)
 	{
@@ -101,6 +126,13 @@ void mVUclose(microVU& mVU)
 // Clears Block Data in specified range
 __fi void mVUclear(mV, u32 addr, u32 size)
 {
+	// Only hashes covering the written memory need to be recalculated
+	for (microRangesHash& hash : mVU.prog.microHash)
+	{
+		if (hash.valid && (static_cast<s32>(addr) < hash.end) && (static_cast<s32>(addr + size) > hash.start))
+			hash.valid = false;
+	}
+
 	if (!mVU.prog.cleared)
 	{
 		mVU.prog.cleared = 1; // Next execution searches/creates a new microprogram
@@ -162,6 +194,7 @@ __ri void mVUcacheProg(microVU& mVU, microProgram& prog)
 		else
 			memcpy(prog.data, mVU.regs().Micro, 0x4000);
 	}
+	prog.hashValid = false;
 	mVUdumpProg(mVU, prog);
 }
 
@@ -190,6 +223,68 @@ u64 mVUrangesHash(microVU& mVU, microProgram& prog)
 	return hash.v64;
 }
 
+// Hashes the data covered by a set of ranges
+static u64 mVUhashRangesData(const u8* data, const std::deque<microRange>& ranges)
+{
+	XXH3_state_t state;
+	XXH3_64bits_reset(&state);
+	for (const microRange& range : ranges)
+	{
+		if ((range.start >= 0) && (range.end > range.start))
+			XXH3_64bits_update(&state, data + range.start, range.end - range.start);
+	}
+	return XXH3_64bits_digest(&state);
+}
+
+// Updates the program's hashes, if it's been recompiled since they were generated
+static void mVUupdateProgHash(microProgram& prog)
+{
+	if (prog.hashValid)
+		return;
+
+	u64 hash = 0;
+	for (const microRange& range : *prog.ranges)
+		hash = XXH3_64bits_withSeed(&range, sizeof(range), hash);
+
+	prog.rangesHash = hash;
+	prog.dataHash = mVUhashRangesData(reinterpret_cast<const u8*>(prog.data), *prog.ranges);
+	prog.hashValid = true;
+}
+
+// Gets the hash of mVU.regs().Micro over the program's ranges (reusing it if another program has the same ranges)
+static u64 mVUgetMicroHash(microVU& mVU, const microProgram& prog)
+{
+	for (const microRangesHash& hash : mVU.prog.microHash)
+	{
+		if (hash.valid && hash.rangesHash == prog.rangesHash)
+			return hash.microHash;
+	}
+
+	microRangesHash& hash = mVU.prog.microHash[mVU.prog.microHashNext];
+	mVU.prog.microHashNext = (mVU.prog.microHashNext + 1) % mVUrangesHashCacheSize;
+	hash.rangesHash = prog.rangesHash;
+	hash.microHash = mVUhashRangesData(mVU.regs().Micro, *prog.ranges);
+	hash.start = static_cast<s32>(mVU.microMemSize);
+	hash.end = 0;
+	for (const microRange& range : *prog.ranges)
+	{
+		hash.start = std::min(hash.start, range.start);
+		hash.end = std::max(hash.end, range.end);
+	}
+	hash.valid = true;
+	return hash.microHash;
+}
+
+static void mVUprintSearchStats(microVU& mVU)
+{
+	const microSearchStats& stats = mVU.prog.stats;
+	if (!stats.searches)
+		return;
+	DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta,
+		"microVU%d: %u searches, %u hash compares, %u full compares, %u collisions, %u rehashes, %u misses",
+		mVU.index, stats.searches, stats.hashCompares, stats.fullCompares, stats.collisions, stats.rehashes, stats.misses);
+}
+
 // Prints the ratio of unique programs to total programs
 void mVUprintUniqueRatio(microVU& mVU)
 {
@@ -240,6 +335,54 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog)
 	return true;
 }
 
+// Compare Cached microProgram to mVU.regs().Micro, by hash first so mismatches are cheap
+__fi bool mVUcmpProgHash(microVU& mVU, microProgram& prog)
+{
+	if (doWholeProgCompare)
+		return mVUcmpProg(mVU, prog);
+
+	mVUupdateProgHash(prog);
+	mVU.prog.stats.hashCompares++;
+	if (prog.dataHash != mVUgetMicroHash(mVU, prog))
+		return false;
+
+	mVU.prog.stats.fullCompares++;
+	if (mVUcmpProg(mVU, prog))
+		return true;
+
+	mVU.prog.stats.collisions++;
+	return false;
+}
+
+// Finds the Cached Micro Program matching mVU.regs().Micro, and moves it to the front of the list
+static microProgram* mVUfindProg(microVU& mVU, microProgramList& list)
+{
+	for (int pass = 0; pass < 2; pass++)
+	{
+		// Micro memory can be written without going through mVUclear() (e.g. the wrapped part of a split MPG),
+		// so a stale hash could hide a match. Check again with fresh hashes before a new program is made.
+		if (pass)
+		{
+			if (doWholeProgCompare || list.empty())
+				break;
+			mVU.prog.stats.rehashes++;
+			std::memset(mVU.prog.microHash, 0, sizeof(mVU.prog.microHash));
+		}
+
+		for (auto it = list.begin(); it != list.end(); ++it)
+		{
+			if (mVUcmpProgHash(mVU, *it[0]))
+			{
+				microProgram* prog = it[0];
+				list.erase(it);
+				list.push_front(prog);
+				return prog;
+			}
+		}
+	}
+	return nullptr;
+}
+
 // Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
 _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 {
@@ -249,28 +392,23 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 
 	if (!quick.prog) // If null, we need to search for new program
 	{
-		for (auto it = list->begin(); it != list->end(); ++it)
+		mVU.prog.stats.searches++;
+		if (microProgram* prog = mVUfindProg(mVU, *list))
 		{
-			bool b = mVUcmpProg(mVU, *it[0]);
+			quick.block = prog->block[startPC / 8];
+			quick.prog  = prog;
 
-			if (b)
+			// Sanity check, in case for some reason the program compilation aborted half way through (JALR for example)
+			if (quick.block == nullptr)
 			{
-				quick.block = it[0]->block[startPC / 8];
-				quick.prog  = it[0];
-				list->erase(it);
-				list->push_front(quick.prog);
-
-				// Sanity check, in case for some reason the program compilation aborted half way through (JALR for example)
-				if (quick.block == nullptr)
-				{
-					void* entryPoint = mVUblockFetch(mVU, startPC, pState);
-					return entryPoint;
-				}
-				return mVUentryGet(mVU, quick.block, startPC, pState);
+				void* entryPoint = mVUblockFetch(mVU, startPC, pState);
+				return entryPoint;
 			}
+			return mVUentryGet(mVU, quick.block, startPC, pState);
 		}
 
 		// If cleared and program not found, make a new program instance
+		mVU.prog.stats.misses++;
 		mVU.prog.cleared = 0;
 		mVU.prog.isSame  = 1;
 		mVU.prog.cur     = mVUcreateProg(mVU, mVU.regs().start_pc/8);
@@ -298,6 +436,446 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 	return mVUentryGet(mVU, quick.block, startPC, pState);
 }
 
+//------------------------------------------------------------------
+// Micro VU - Program List
+//------------------------------------------------------------------
+// Compiled programs can't be kept between sessions, since they're full of absolute addresses and
+// links to other blocks. Instead, we remember the micro memory each of a game's programs was
+// compiled from, along with the pipeline state each of its blocks was entered with. When the game
+// is booted again, or the VU is reset (e.g. by loading a state), the programs are compiled ahead
+// of time from that copy of micro memory, so mVUsearchProg() finds them when the game uploads them.
+
+static constexpr u32 PROGRAM_LIST_MAGIC = 0x5055564D; // MVUP
+static constexpr u32 PROGRAM_LIST_VERSION = 1;
+static constexpr u32 PROGRAM_LIST_MAX_PROGRAMS = 4096; // per VU
+
+// Programs are compiled one at a time as the VU is started, so it doesn't cause the stutter it's meant to avoid.
+static constexpr u32 PROGRAM_LIST_COMPILES_PER_EXECUTE = 1;
+
+// Except for the first start after a reset, where we're going to have to compile a lot of programs anyway.
+static constexpr float PROGRAM_LIST_BURST_TIME_MS = 50.0f;
+
+struct alignas(16) microProgramListBlock
+{
+	microRegInfo pState; // Pipeline state the block was entered with
+	u32 pc;
+};
+
+struct microProgramListEntry
+{
+	u32 startPC;
+	u64 hash;
+	std::vector<microRange> ranges;
+	std::vector<u8> data; // Micro memory covered by each range, back to back
+	std::vector<microProgramListBlock> blocks;
+};
+
+struct microProgramListState
+{
+	std::vector<microProgramListEntry> entries;
+	std::unordered_map<u64, u32> lookup;
+	std::unique_ptr<u8[]> image; // Micro memory the current program is compiled from
+	u32 pos;
+	bool enabled;
+	bool burst;
+	bool dirty;
+};
+
+struct microProgramListHeader
+{
+	u32 magic;
+	u32 version;
+	u32 reginfo_size;
+	u32 num_programs[2];
+	u32 reserved;
+	u64 checksum; // of everything after the header
+};
+
+struct microProgramListEntryHeader
+{
+	u32 startPC;
+	u32 num_ranges;
+	u32 num_blocks;
+	u32 data_size;
+};
+
+static std::string s_program_list_path;
+static microProgramListState s_program_list[2];
+
+static u64 mVUhashProgramListEntry(const microProgramListEntry& entry)
+{
+	XXH64_state_t state;
+	XXH64_reset(&state, entry.startPC);
+	XXH64_update(&state, entry.ranges.data(), entry.ranges.size() * sizeof(microRange));
+	XXH64_update(&state, entry.data.data(), entry.data.size());
+	return XXH64_digest(&state);
+}
+
+static void mVUrecordProg(microVU& mVU, const microProgram& prog)
+{
+	microProgramListState& list = s_program_list[mVU.index];
+
+	microProgramListEntry entry;
+	entry.startPC = prog.startPC * 8;
+	for (const microRange& range : *prog.ranges)
+	{
+		// Programs which were abandoned part way through compiling can have open ranges.
+		if (range.start < 0 || range.end <= range.start || range.end > static_cast<s32>(mVU.microMemSize))
+			return;
+
+		entry.ranges.push_back(range);
+		entry.data.insert(entry.data.end(), reinterpret_cast<const u8*>(prog.data) + range.start,
+			reinterpret_cast<const u8*>(prog.data) + range.end);
+	}
+
+	for (u32 i = 0; i < (mVU.progSize / 2); i++)
+	{
+		if (!prog.block[i])
+			continue;
+
+		prog.block[i]->forEachBlock([&entry, i](const microBlock& block) {
+			entry.blocks.push_back({block.pState, i * 8});
+		});
+	}
+
+	if (entry.ranges.empty() || entry.blocks.empty())
+		return;
+
+	entry.hash = mVUhashProgramListEntry(entry);
+
+	const auto it = list.lookup.find(entry.hash);
+	if (it != list.lookup.end())
+	{
+		// Blocks are compiled as they're reached, so the same program may have been entered in more ways this time.
+		microProgramListEntry& existing = list.entries[it->second];
+		if (entry.blocks.size() > existing.blocks.size())
+		{
+			existing.blocks = std::move(entry.blocks);
+			list.dirty = true;
+		}
+
+		return;
+	}
+
+	if (list.entries.size() >= PROGRAM_LIST_MAX_PROGRAMS)
+		return;
+
+	list.lookup.emplace(entry.hash, static_cast<u32>(list.entries.size()));
+	list.entries.push_back(std::move(entry));
+	list.dirty = true;
+}
+
+static void mVUrecordProgs(microVU& mVU)
+{
+	if (!s_program_list[mVU.index].enabled)
+		return;
+
+	for (u32 i = 0; i < (mVU.progSize / 2); i++)
+	{
+		if (!mVU.prog.prog[i])
+			continue;
+
+		for (const microProgram* prog : *mVU.prog.prog[i])
+			mVUrecordProg(mVU, *prog);
+	}
+}
+
+static void mVUresetProgramList(microVU& mVU)
+{
+	// Everything has to be compiled again, so start from the top of the list.
+	microProgramListState& list = s_program_list[mVU.index];
+	list.pos = 0;
+	list.burst = true;
+}
+
+// Compiles a remembered program, with mVU.regs().Micro pointing at the list's image.
+static void mVUprewarmProg(microVU& mVU, const microProgramListEntry& entry)
+{
+	// Anything outside the program's ranges is never compiled, so it doesn't matter what's there.
+	u8* const image = mVU.regs().Micro;
+	const u8* data = entry.data.data();
+	std::memset(image, 0, mVU.microMemSize);
+	for (const microRange& range : entry.ranges)
+	{
+		std::memcpy(image + range.start, data, range.end - range.start);
+		data += range.end - range.start;
+	}
+
+	// If the game has already uploaded this program, or we compiled part of it earlier, fill in the rest.
+	microProgramList* progs = mVU.prog.prog[entry.startPC / 8];
+	microProgram* prog = nullptr;
+	for (microProgram* it : *progs)
+	{
+		if (mVUcmpProg(mVU, *it))
+		{
+			prog = it;
+			break;
+		}
+	}
+
+	if (!prog)
+	{
+		// Add it to the back of the list, so programs which are actually in use are still found first.
+		prog = mVUcreateProg(mVU, entry.startPC / 8);
+		progs->push_back(prog);
+		mVU.prog.isSame = 1;
+	}
+
+	mVU.prog.cur = prog;
+	mVU.regs().start_pc = entry.startPC;
+	for (const microProgramListBlock& block : entry.blocks)
+		mVUblockFetch(mVU, block.pc, reinterpret_cast<uptr>(&block.pState));
+}
+
+// Called from Execute(), where the VU isn't running and nothing else can touch its micro memory.
+static void mVUprewarmProgs(microVU& mVU)
+{
+	microProgramListState& list = s_program_list[mVU.index];
+	const bool burst = std::exchange(list.burst, false);
+	if (!list.image)
+		list.image = std::make_unique<u8[]>(mVU.microMemSize);
+
+	Common::Timer timer;
+	u32 compiles = 0;
+
+	// Compiling changes the current program and pipeline state, and we don't want the game's micro memory to be compared.
+	const microRegInfo lpState = mVU.prog.lpState;
+	microProgram* const cur = mVU.prog.cur;
+	const int isSame = mVU.prog.isSame;
+	const int cleared = mVU.prog.cleared;
+	const u32 start_pc = mVU.regs().start_pc;
+	u8* const micro = mVU.regs().Micro;
+	mVU.regs().Micro = list.image.get();
+
+	xSetTextPtr(mVU.textPtr());
+	xSetPtr(mVU.prog.x86ptr);
+
+	while (list.pos < list.entries.size())
+	{
+		// Leave room in the cache for programs which haven't been seen before, since filling it would force a reset.
+		if ((xGetPtr() - mVU.prog.x86start) >= ((mVU.prog.x86end - mVU.prog.x86start) / 2))
+		{
+			list.pos = static_cast<u32>(list.entries.size());
+			break;
+		}
+
+		mVUprewarmProg(mVU, list.entries[list.pos++]);
+		compiles++;
+
+		if (burst ? (timer.GetTimeMilliseconds() >= PROGRAM_LIST_BURST_TIME_MS) : (compiles >= PROGRAM_LIST_COMPILES_PER_EXECUTE))
+			break;
+	}
+
+	mVU.prog.x86ptr = x86Ptr;
+
+	mVU.regs().Micro = micro;
+	mVU.regs().start_pc = start_pc;
+	mVU.prog.cleared = cleared;
+	mVU.prog.isSame = isSame;
+	mVU.prog.cur = cur;
+	mVU.prog.lpState = lpState;
+
+	if (compiles > 1)
+	{
+		DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Precompiled %u programs in %.2f ms",
+			mVU.index, compiles, timer.GetTimeMilliseconds());
+	}
+}
+
+static __fi void mVUcheckProgramList(microVU& mVU)
+{
+	const microProgramListState& list = s_program_list[mVU.index];
+	if (list.pos < list.entries.size())
+		mVUprewarmProgs(mVU);
+}
+
+static void mVUsaveProgramList()
+{
+	mVUrecordProgs(microVU0);
+	mVUrecordProgs(microVU1);
+	if (s_program_list_path.empty() || (!s_program_list[0].dirty && !s_program_list[1].dirty))
+		return;
+
+	s_program_list[0].dirty = false;
+	s_program_list[1].dirty = false;
+
+	std::vector<u8> data(sizeof(microProgramListHeader));
+	const auto append = [&data](const void* ptr, size_t size) {
+		data.insert(data.end(), static_cast<const u8*>(ptr), static_cast<const u8*>(ptr) + size);
+	};
+
+	for (const microProgramListState& list : s_program_list)
+	{
+		for (const microProgramListEntry& entry : list.entries)
+		{
+			const microProgramListEntryHeader eheader = {entry.startPC, static_cast<u32>(entry.ranges.size()),
+				static_cast<u32>(entry.blocks.size()), static_cast<u32>(entry.data.size())};
+			append(&eheader, sizeof(eheader));
+			append(entry.ranges.data(), entry.ranges.size() * sizeof(microRange));
+			append(entry.data.data(), entry.data.size());
+			for (const microProgramListBlock& block : entry.blocks)
+			{
+				append(&block.pc, sizeof(block.pc));
+				append(&block.pState, sizeof(block.pState));
+			}
+		}
+	}
+
+	microProgramListHeader header = {};
+	header.magic = PROGRAM_LIST_MAGIC;
+	header.version = PROGRAM_LIST_VERSION;
+	header.reginfo_size = sizeof(microRegInfo);
+	header.num_programs[0] = static_cast<u32>(s_program_list[0].entries.size());
+	header.num_programs[1] = static_cast<u32>(s_program_list[1].entries.size());
+	header.checksum = XXH64(data.data() + sizeof(header), data.size() - sizeof(header), 0);
+	std::memcpy(data.data(), &header, sizeof(header));
+
+	Error error;
+	if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(s_program_list_path)).c_str(), false, &error) ||
+		!FileSystem::WriteBinaryFile(s_program_list_path.c_str(), data.data(), data.size()))
+	{
+		Console.ErrorFmt("(microVU) Failed to save program list to '{}': {}", s_program_list_path, error.GetDescription());
+		return;
+	}
+
+	DevCon.WriteLnFmt("(microVU) Saved {} VU0 and {} VU1 programs to '{}'", header.num_programs[0],
+		header.num_programs[1], Path::GetFileName(s_program_list_path));
+}
+
+static bool mVUparseProgramList(const std::vector<u8>& data)
+{
+	microProgramListHeader header;
+	if (data.size() < sizeof(header))
+		return false;
+
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (header.magic != PROGRAM_LIST_MAGIC || header.version != PROGRAM_LIST_VERSION ||
+		header.reginfo_size != sizeof(microRegInfo) || header.num_programs[0] > PROGRAM_LIST_MAX_PROGRAMS ||
+		header.num_programs[1] > PROGRAM_LIST_MAX_PROGRAMS ||
+		header.checksum != XXH64(data.data() + sizeof(header), data.size() - sizeof(header), 0))
+	{
+		return false;
+	}
+
+	size_t pos = sizeof(header);
+	const auto read = [&data, &pos](void* ptr, size_t size) {
+		if ((data.size() - pos) < size)
+			return false;
+
+		std::memcpy(ptr, data.data() + pos, size);
+		pos += size;
+		return true;
+	};
+
+	for (u32 vu = 0; vu < 2; vu++)
+	{
+		const microVU& mVU = vu ? microVU1 : microVU0;
+		microProgramListState& list = s_program_list[vu];
+		list.entries.resize(header.num_programs[vu]);
+
+		for (microProgramListEntry& entry : list.entries)
+		{
+			microProgramListEntryHeader eheader;
+			if (!read(&eheader, sizeof(eheader)) || eheader.startPC >= mVU.microMemSize || (eheader.startPC & 7) != 0 ||
+				eheader.num_ranges > (mVU.microMemSize / 8) || eheader.num_blocks > (mVU.microMemSize / 8 * 64) ||
+				eheader.data_size > (mVU.microMemSize * eheader.num_ranges))
+			{
+				return false;
+			}
+
+			entry.startPC = eheader.startPC;
+			entry.ranges.resize(eheader.num_ranges);
+			entry.data.resize(eheader.data_size);
+			entry.blocks.resize(eheader.num_blocks);
+			if (!read(entry.ranges.data(), eheader.num_ranges * sizeof(microRange)) ||
+				!read(entry.data.data(), eheader.data_size))
+			{
+				return false;
+			}
+
+			size_t range_size = 0;
+			for (const microRange& range : entry.ranges)
+			{
+				if (range.start < 0 || range.end <= range.start || range.end > static_cast<s32>(mVU.microMemSize))
+					return false;
+
+				range_size += range.end - range.start;
+			}
+			if (range_size != eheader.data_size)
+				return false;
+
+			for (microProgramListBlock& block : entry.blocks)
+			{
+				if (!read(&block.pc, sizeof(block.pc)) || !read(&block.pState, sizeof(block.pState)) ||
+					block.pc >= mVU.microMemSize || (block.pc & 7) != 0)
+				{
+					return false;
+				}
+			}
+
+			entry.hash = mVUhashProgramListEntry(entry);
+			list.lookup.emplace(entry.hash, static_cast<u32>(&entry - list.entries.data()));
+		}
+	}
+
+	return (pos == data.size());
+}
+
+static void mVUloadProgramList()
+{
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(s_program_list_path.c_str());
+	if (!data.has_value())
+		return;
+
+	if (!mVUparseProgramList(data.value()))
+	{
+		Console.WarningFmt("(microVU) Ignoring invalid program list '{}'", Path::GetFileName(s_program_list_path));
+		for (microProgramListState& list : s_program_list)
+		{
+			list.entries.clear();
+			list.lookup.clear();
+		}
+
+		return;
+	}
+
+	Console.WriteLnFmt("(microVU) Loaded {} VU0 and {} VU1 programs from '{}'", s_program_list[0].entries.size(),
+		s_program_list[1].entries.size(), Path::GetFileName(s_program_list_path));
+}
+
+void mVUSetProgramListGame(const std::string& serial, u32 crc)
+{
+	std::string path;
+	if (EmuConfig.Cpu.Recompiler.PrecompileVUPrograms && crc != 0)
+	{
+		path = Path::Combine(Path::Combine(EmuFolders::Cache, "vuprograms"),
+			fmt::format("{}_{:08X}.bin", serial.empty() ? std::string_view("ELF") : std::string_view(serial), crc));
+	}
+
+	if (path == s_program_list_path)
+		return;
+
+	// VU1 could be compiling or precompiling on the MTVU thread.
+	vu1Thread.WaitVU();
+
+	mVUsaveProgramList();
+
+	s_program_list_path = std::move(path);
+	for (microProgramListState& list : s_program_list)
+	{
+		list.entries.clear();
+		list.lookup.clear();
+		list.image.reset();
+		list.pos = 0;
+		list.enabled = !s_program_list_path.empty();
+		list.burst = true;
+		list.dirty = false;
+	}
+
+	if (!s_program_list_path.empty())
+		mVUloadProgramList();
+}
+
 //------------------------------------------------------------------
 // recMicroVU0 / recMicroVU1
 //------------------------------------------------------------------
@@ -356,6 +934,9 @@ void recMicroVU0::Execute(u32 cycles)
 
 	if (!(VU0.VI[REG_VPU_STAT].UL & 1))
 		return;
+
+	mVUcheckProgramList(microVU0);
+
 	VU0.VI[REG_TPC].UL <<= 3;
 
 	((mVUrecCall)microVU0.startFunct)(VU0.VI[REG_TPC].UL, cycles);
@@ -383,6 +964,9 @@ void recMicroVU1::Execute(u32 cycles)
 		if (!(VU0.VI[REG_VPU_STAT].UL & 0x100))
 			return;
 	}
+
+	mVUcheckProgramList(microVU1);
+
 	VU1.VI[REG_TPC].UL <<= 3;
 	((mVUrecCall)microVU1.startFunct)(VU1.VI[REG_TPC].UL, cycles);
 	VU1.VI[REG_TPC].UL >>= 3;
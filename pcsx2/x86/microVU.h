@@ -50,6 +50,9 @@ struct microProgram
 	std::deque<microRange>* ranges;          // The ranges of the microProgram that have already been recompiled
 	u32 startPC; // Start PC of this program
 	int idx;     // Program index
+	u64 rangesHash; // Hash of the ranges themselves (valid if hashValid)
+	u64 dataHash;   // Hash of the cached data covered by the ranges (valid if hashValid)
+	bool hashValid; // Cleared whenever the ranges or the cached data change
 };
 
 typedef std::deque<microProgram*> microProgramList;
@@ -60,6 +63,28 @@ struct microProgramQuick
 	microProgram*      prog;  // The microProgram who is the owner of 'block'
 };
 
+// Hash of the micro memory covered by a set of ranges, shared by all programs with those ranges
+struct microRangesHash
+{
+	u64  rangesHash; // Which set of ranges this is for
+	u64  microHash;  // Hash of mVU.regs().Micro over the ranges
+	s32  start;      // Lowest address covered by the ranges
+	s32  end;        // Highest address covered by the ranges
+	bool valid;      // Cleared when micro memory between start and end is written to
+};
+
+static const uint mVUrangesHashCacheSize = 16;
+
+struct microSearchStats
+{
+	u32 searches;     // Number of times a program list was searched
+	u32 hashCompares; // Number of programs compared by hash
+	u32 fullCompares; // Number of programs compared byte for byte (after matching by hash)
+	u32 collisions;   // Number of full compares which didn't match
+	u32 rehashes;     // Number of searches which had to discard stale micro memory hashes
+	u32 misses;       // Number of searches which didn't find a program, and created a new one
+};
+
 struct microProgManager
 {
 	microIR<mProgSize> IRinfo;             // IR information
@@ -74,6 +99,9 @@ struct microProgManager
 	u8*                x86start;           // Start of program's rec-cache
 	u8*                x86end;             // Limit of program's rec-cache
 	microRegInfo       lpState;            // Pipeline state from where program left off (useful for continuing execution)
+	microRangesHash    microHash[mVUrangesHashCacheSize]; // Recently used hashes of micro memory
+	u32                microHashNext;      // Next entry in microHash to replace
+	microSearchStats   stats;              // Program search counters, reported on reset
 };
 
 static const uint mVUcacheSafeZone =  3; // Safe-Zone for program recompilation (in megabytes)
@@ -209,6 +237,14 @@ public:
 		}
 		return thisBlock;
 	}
+	template <typename F>
+	void forEachBlock(F&& func) const
+	{
+		for (const microBlockLink* linkI = qBlockList; linkI != nullptr; linkI = linkI->next)
+			func(linkI->block);
+		for (const microBlockLink* linkI = fBlockList; linkI != nullptr; linkI = linkI->next)
+			func(linkI->block);
+	}
 	__ri microBlock* search(microVU& mVU, microRegInfo* pState)
 	{
 		if (pState->needExactMatch) // Needs Detailed Search (Exact Match of Pipeline State)
@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "DEV9/ATA/HddBlockImage.h"
+
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static constexpr u32 ClusterSize = 1u << HddBlockImage::DefaultClusterBits;
+// Not a multiple of the cluster size, so the last cluster is partial.
+static constexpr u64 DiskSize = 32 * 1024 * 1024 + 3 * 512;
+
+class HddBlockImageTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		const testing::TestInfo* info = testing::UnitTest::GetInstance()->current_test_info();
+		m_dir = Path::Combine(testing::TempDir(), std::string("pcsx2_hdd_block_image_") + info->name());
+		if (FileSystem::DirectoryExists(m_dir.c_str()))
+			FileSystem::RecursiveDeleteDirectory(m_dir.c_str());
+		ASSERT_TRUE(FileSystem::CreateDirectoryPath(m_dir.c_str(), false));
+	}
+
+	void TearDown() override
+	{
+		FileSystem::RecursiveDeleteDirectory(m_dir.c_str());
+	}
+
+	std::string GetPath(const char* name) const
+	{
+		return Path::Combine(m_dir, name);
+	}
+
+	static std::vector<u8> MakePattern(size_t size, u32 seed)
+	{
+		std::vector<u8> data(size);
+		for (size_t i = 0; i < size; i++)
+			data[i] = static_cast<u8>((i * 31 + seed) % 251 + 1);
+		return data;
+	}
+
+	static std::vector<u8> ReadAll(HddBlockImage& image)
+	{
+		// Sector sized reads, so sequential reads go through the read ahead.
+		std::vector<u8> data(image.GetSize());
+		for (u64 offset = 0; offset < data.size(); offset += 128 * 512)
+		{
+			const u32 length = static_cast<u32>(std::min<u64>(128 * 512, data.size() - offset));
+			EXPECT_TRUE(image.Read(offset, &data[offset], length));
+		}
+		return data;
+	}
+
+	std::string m_dir;
+};
+
+TEST_F(HddBlockImageTest, CreateEmpty)
+{
+	const std::string path = GetPath("empty.raw");
+	Error error;
+	ASSERT_TRUE(HddBlockImage::Create(path, DiskSize, &error)) << error.GetDescription();
+
+	// Only the header and L1 table are written.
+	EXPECT_LE(FileSystem::GetPathFileSize(path.c_str()), static_cast<s64>(2 * ClusterSize));
+	EXPECT_EQ(HddBlockImage::GetImageSize(path).value_or(0), DiskSize);
+
+	std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(path, true, &error);
+	ASSERT_TRUE(image) << error.GetDescription();
+	EXPECT_EQ(image->GetSize(), DiskSize);
+
+	const std::vector<u8> data = ReadAll(*image);
+	EXPECT_EQ(std::count(data.begin(), data.end(), 0), static_cast<ptrdiff_t>(data.size()));
+
+	// Reads past the end of the disk fail.
+	u8 sector[512];
+	EXPECT_FALSE(image->Read(DiskSize - 256, sector, sizeof(sector)));
+
+	// Creating over an existing file fails.
+	EXPECT_FALSE(HddBlockImage::Create(path, DiskSize, nullptr));
+}
+
+TEST_F(HddBlockImageTest, WriteRead)
+{
+	const std::string path = GetPath("write.raw");
+	ASSERT_TRUE(HddBlockImage::Create(path, DiskSize, nullptr));
+
+	std::vector<u8> expected(DiskSize, 0);
+	{
+		std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(path, false, nullptr);
+		ASSERT_TRUE(image);
+
+		// Unaligned, across several clusters.
+		const std::vector<u8> first = MakePattern(3 * ClusterSize + 1024, 1);
+		const u64 firstOffset = 5 * ClusterSize - 512;
+		ASSERT_TRUE(image->Write(firstOffset, first.data(), static_cast<u32>(first.size())));
+		std::memcpy(&expected[firstOffset], first.data(), first.size());
+
+		// Overwrite part of an allocated cluster.
+		const std::vector<u8> second = MakePattern(4096, 2);
+		const u64 secondOffset = 6 * ClusterSize + 8192;
+		ASSERT_TRUE(image->Write(secondOffset, second.data(), static_cast<u32>(second.size())));
+		std::memcpy(&expected[secondOffset], second.data(), second.size());
+
+		// The partial cluster at the end of the disk.
+		const std::vector<u8> last = MakePattern(1024, 3);
+		const u64 lastOffset = DiskSize - last.size();
+		ASSERT_TRUE(image->Write(lastOffset, last.data(), static_cast<u32>(last.size())));
+		std::memcpy(&expected[lastOffset], last.data(), last.size());
+
+		EXPECT_TRUE(ReadAll(*image) == expected);
+	}
+
+	const s64 fileSize = FileSystem::GetPathFileSize(path.c_str());
+
+	std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(path, false, nullptr);
+	ASSERT_TRUE(image);
+	EXPECT_TRUE(ReadAll(*image) == expected);
+
+	// Zeros written to unallocated clusters don't allocate them.
+	const std::vector<u8> zeros(4 * ClusterSize, 0);
+	ASSERT_TRUE(image->Write(100 * ClusterSize, zeros.data(), static_cast<u32>(zeros.size())));
+	image.reset();
+	EXPECT_EQ(FileSystem::GetPathFileSize(path.c_str()), fileSize);
+
+	// Read only images can't be written.
+	image = HddBlockImage::Open(path, true, nullptr);
+	ASSERT_TRUE(image);
+	EXPECT_FALSE(image->Write(0, zeros.data(), 512));
+}
+
+TEST_F(HddBlockImageTest, Overlay)
+{
+	// Raw base, with a block allocated overlay on it, and a second overlay on that.
+	const std::string basePath = GetPath("base.raw");
+	const std::vector<u8> baseData = MakePattern(DiskSize, 4);
+	ASSERT_TRUE(FileSystem::WriteBinaryFile(basePath.c_str(), baseData.data(), baseData.size()));
+
+	const std::string overlayPath = GetPath("overlay.raw");
+	Error error;
+	ASSERT_TRUE(HddBlockImage::CreateOverlay(overlayPath, basePath, &error)) << error.GetDescription();
+	EXPECT_EQ(HddBlockImage::GetImageSize(overlayPath).value_or(0), DiskSize);
+
+	std::vector<u8> expected = baseData;
+	{
+		std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(overlayPath, false, &error);
+		ASSERT_TRUE(image) << error.GetDescription();
+		EXPECT_TRUE(ReadAll(*image) == baseData);
+
+		// The rest of the cluster is copied from the base.
+		const std::vector<u8> data(1024, 0);
+		const u64 offset = 10 * ClusterSize + 2048;
+		ASSERT_TRUE(image->Write(offset, data.data(), static_cast<u32>(data.size())));
+		std::memcpy(&expected[offset], data.data(), data.size());
+
+		EXPECT_TRUE(ReadAll(*image) == expected);
+	}
+
+	const std::string secondPath = GetPath("second.raw");
+	ASSERT_TRUE(HddBlockImage::CreateOverlay(secondPath, overlayPath, nullptr));
+	{
+		std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(secondPath, false, &error);
+		ASSERT_TRUE(image) << error.GetDescription();
+		EXPECT_TRUE(ReadAll(*image) == expected);
+
+		const std::vector<u8> data = MakePattern(ClusterSize, 5);
+		ASSERT_TRUE(image->Write(0, data.data(), static_cast<u32>(data.size())));
+		std::vector<u8> secondExpected = expected;
+		std::memcpy(&secondExpected[0], data.data(), data.size());
+
+		EXPECT_TRUE(ReadAll(*image) == secondExpected);
+	}
+
+	// Neither base is modified by writes to the overlays.
+	std::optional<std::vector<u8>> base = FileSystem::ReadBinaryFile(basePath.c_str());
+	ASSERT_TRUE(base.has_value());
+	EXPECT_TRUE(base.value() == baseData);
+
+	std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(overlayPath, true, nullptr);
+	ASSERT_TRUE(image);
+	EXPECT_TRUE(ReadAll(*image) == expected);
+}
+
+TEST_F(HddBlockImageTest, Convert)
+{
+	// Mostly zeros, with data in a few places.
+	const std::string rawPath = GetPath("source.raw");
+	std::vector<u8> rawData(DiskSize, 0);
+	const std::vector<u8> pattern = MakePattern(3 * ClusterSize, 6);
+	std::memcpy(&rawData[ClusterSize / 2], pattern.data(), pattern.size());
+	std::memcpy(&rawData[DiskSize - 512], pattern.data(), 512);
+	ASSERT_TRUE(FileSystem::WriteBinaryFile(rawPath.c_str(), rawData.data(), rawData.size()));
+
+	const std::string path = GetPath("converted.raw");
+	u64 lastProgress = 0;
+	Error error;
+	ASSERT_TRUE(HddBlockImage::ConvertRawImage(rawPath, path, [&lastProgress](u64 current, u64 total) {
+		EXPECT_GT(current, lastProgress);
+		EXPECT_EQ(total, DiskSize);
+		lastProgress = current;
+		return true;
+	}, &error)) << error.GetDescription();
+	EXPECT_EQ(lastProgress, DiskSize);
+
+	// Zero clusters are left unallocated.
+	EXPECT_LT(FileSystem::GetPathFileSize(path.c_str()), static_cast<s64>(16 * ClusterSize));
+	EXPECT_EQ(HddBlockImage::GetImageSize(path).value_or(0), DiskSize);
+
+	std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(path, true, &error);
+	ASSERT_TRUE(image) << error.GetDescription();
+	EXPECT_TRUE(ReadAll(*image) == rawData);
+
+	// Canceling removes the partial image.
+	const std::string canceledPath = GetPath("canceled.raw");
+	EXPECT_FALSE(HddBlockImage::ConvertRawImage(rawPath, canceledPath, [](u64, u64) { return false; }, nullptr));
+	EXPECT_FALSE(FileSystem::FileExists(canceledPath.c_str()));
+}
+
+TEST_F(HddBlockImageTest, RejectsBaseCycle)
+{
+	// Two overlays which are each other's base.
+	const std::string firstPath = GetPath("first.raw");
+	const std::string secondPath = GetPath("second.raw");
+	ASSERT_TRUE(HddBlockImage::Create(secondPath, DiskSize, nullptr));
+	ASSERT_TRUE(HddBlockImage::CreateOverlay(firstPath, secondPath, nullptr));
+	ASSERT_TRUE(FileSystem::DeleteFilePath(secondPath.c_str()));
+	ASSERT_TRUE(HddBlockImage::CreateOverlay(secondPath, firstPath, nullptr));
+
+	EXPECT_FALSE(HddBlockImage::Open(firstPath, false, nullptr));
+}
+
+TEST_F(HddBlockImageTest, RejectsInvalidL2Entry)
+{
+	const std::string path = GetPath("corrupt.raw");
+	ASSERT_TRUE(HddBlockImage::Create(path, DiskSize, nullptr));
+	{
+		std::unique_ptr<HddBlockImage> image = HddBlockImage::Open(path, false, nullptr);
+		ASSERT_TRUE(image);
+		const std::vector<u8> data = MakePattern(ClusterSize, 7);
+		ASSERT_TRUE(image->Write(0, data.data(), static_cast<u32>(data.size())));
+	}
+
+	std::optional<std::vector<u8>> file = FileSystem::ReadBinaryFile(path.c_str());
+	ASSERT_TRUE(file.has_value());
+
+	HddBlockImage::Header header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	u64 l2Offset;
+	std::memcpy(&l2Offset, &(*file)[header.l1Offset], sizeof(l2Offset));
+	ASSERT_NE(l2Offset, 0u);
+
+	// Point the first cluster past the end of the file.
+	const u64 badOffset = file->size() + ClusterSize;
+	std::memcpy(&(*file)[l2Offset], &badOffset, sizeof(badOffset));
+	ASSERT_TRUE(FileSystem::WriteBinaryFile(path.c_str(), file->data(), file->size()));
+	EXPECT_FALSE(HddBlockImage::Open(path, true, nullptr));
+
+	// And at an unaligned offset.
+	const u64 unalignedOffset = l2Offset + 512;
+	std::memcpy(&(*file)[l2Offset], &unalignedOffset, sizeof(unalignedOffset));
+	ASSERT_TRUE(FileSystem::WriteBinaryFile(path.c_str(), file->data(), file->size()));
+	EXPECT_FALSE(HddBlockImage::Open(path, true, nullptr));
+}
+
+TEST_F(HddBlockImageTest, RejectsInvalidHeader)
+{
+	const std::string path = GetPath("corrupt.raw");
+	ASSERT_TRUE(HddBlockImage::Create(path, DiskSize, nullptr));
+	EXPECT_FALSE(HddBlockImage::Create(GetPath("huge.raw"), HddBlockImage::MaxDiskSize + 512, nullptr));
+
+	std::optional<std::vector<u8>> file = FileSystem::ReadBinaryFile(path.c_str());
+	ASSERT_TRUE(file.has_value());
+
+	HddBlockImage::Header header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	const auto writeHeader = [&path, &file](const HddBlockImage::Header& hdr) {
+		std::memcpy(file->data(), &hdr, sizeof(hdr));
+		return FileSystem::WriteBinaryFile(path.c_str(), file->data(), file->size());
+	};
+
+	// Larger than LBA48 can address, with a matching L1 table size.
+	HddBlockImage::Header bad = header;
+	bad.diskSize = HddBlockImage::MaxDiskSize + 512;
+	const u64 clusters = (bad.diskSize + ClusterSize - 1) / ClusterSize;
+	bad.l1Entries = static_cast<u32>((clusters + ClusterSize / sizeof(u64) - 1) / (ClusterSize / sizeof(u64)));
+	ASSERT_TRUE(writeHeader(bad));
+	EXPECT_FALSE(HddBlockImage::Open(path, true, nullptr));
+
+	// L1 table past the end of the file.
+	bad = header;
+	bad.l1Offset = file->size() + ClusterSize;
+	ASSERT_TRUE(writeHeader(bad));
+	EXPECT_FALSE(HddBlockImage::Open(path, true, nullptr));
+
+	bad.l1Offset = ~static_cast<u64>(ClusterSize - 1);
+	ASSERT_TRUE(writeHeader(bad));
+	EXPECT_FALSE(HddBlockImage::Open(path, true, nullptr));
+
+	ASSERT_TRUE(writeHeader(header));
+	EXPECT_TRUE(HddBlockImage::Open(path, true, nullptr));
+}
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2002-2026 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "../MultiISATest.h"
+#include "pcsx2/IPU/IPU_Kernels.h"
+#include "pcsx2/IPU/yuv2rgb.h"
+#include "common/Timer.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <stdlib.h>
+
+MULTI_ISA_UNSHARED_START
+
+/// Coefficients like the VLC decoder produces, sparse and with some DC only rows, or anything at all for odd seeds.
+static void GetTestBlock(unsigned int seed, s16* block)
+{
+	srand(seed);
+
+	for (int i = 0; i < 64; i++)
+	{
+		if (seed & 1)
+			block[i] = static_cast<s16>(rand());
+		else
+			block[i] = ((i & 7) == 0 || (rand() & 3) == 0) ? static_cast<s16>((rand() & 0xfff) - 0x800) : 0;
+	}
+
+	if (!(seed & 1))
+	{
+		const int dc_row = seed % 8;
+		for (int i = 1; i < 8; i++)
+			block[dc_row * 8 + i] = 0;
+	}
+}
+
+static void GetTestBytes(unsigned int seed, void* data, size_t size)
+{
+	srand(seed);
+
+	u8* bytes = static_cast<u8*>(data);
+	for (size_t i = 0; i < size; i++)
+		bytes[i] = static_cast<u8>(rand());
+}
+
+MULTI_ISA_TEST(IPUKernelTest, IDCTMatchesReference)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	for (unsigned int seed = 0; seed < 1024; seed++)
+	{
+		alignas(16) s16 expected[64];
+		alignas(16) s16 actual[64];
+		GetTestBlock(seed, expected);
+		std::memcpy(actual, expected, sizeof(actual));
+
+		IDCT_Block_reference(expected);
+		IDCT_Block(actual);
+
+		for (int i = 0; i < 64; i++)
+			EXPECT_EQ(expected[i], actual[i]) << "coefficient " << i << ", seed " << seed;
+	}
+}
+
+MULTI_ISA_TEST(IPUKernelTest, YUV2RGBMatchesReference)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	for (unsigned int seed = 0; seed < 64; seed++)
+	{
+		alignas(32) macroblock_8 mb8;
+		alignas(32) macroblock_rgb32 expected;
+		alignas(32) macroblock_rgb32 actual;
+		GetTestBytes(seed, &mb8, sizeof(mb8));
+
+		yuv2rgb_reference(mb8, expected);
+		yuv2rgb(mb8, actual);
+
+		EXPECT_EQ(std::memcmp(&expected, &actual, sizeof(actual)), 0) << "seed " << seed;
+	}
+}
+
+MULTI_ISA_TEST(IPUKernelTest, ThresholdMatchesReference)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	static constexpr u16 thresholds[][2] = {
+		{0, 0}, {0, 0x40}, {0x40, 0}, {0x20, 0x80}, {0x80, 0x20}, {1, 0xff}, {0x100, 0x1ff}, {0x1ff, 0x100},
+	};
+
+	for (unsigned int seed = 0; seed < 64; seed++)
+	{
+		for (const u16* thresh : thresholds)
+		{
+			for (int sgn = 0; sgn < 2; sgn++)
+			{
+				// The reference writes past the macroblock when a threshold and sgn are both set.
+				struct alignas(32)
+				{
+					macroblock_rgb32 rgb32;
+					macroblock_rgb32 overrun;
+				} expected;
+				alignas(32) macroblock_rgb32 actual;
+				GetTestBytes(seed, &expected.rgb32, sizeof(expected.rgb32));
+				std::memcpy(&actual, &expected.rgb32, sizeof(actual));
+
+				ipu_threshold_reference(expected.rgb32, sgn, thresh);
+				ipu_threshold(actual, sgn, thresh);
+
+				EXPECT_EQ(std::memcmp(&expected.rgb32, &actual, sizeof(actual)), 0)
+					<< "seed " << seed << ", thresh " << thresh[0] << "/" << thresh[1] << ", sgn " << sgn;
+			}
+		}
+	}
+}
+
+MULTI_ISA_TEST(IPUKernelTest, VQMatchesReference)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	for (unsigned int seed = 0; seed < 64; seed++)
+	{
+		alignas(32) macroblock_rgb16 rgb16;
+		rgb16_t vqclut[16];
+		GetTestBytes(seed, &rgb16, sizeof(rgb16));
+		GetTestBytes(seed + 1, vqclut, sizeof(vqclut));
+
+		// Duplicate entries, to check ties go to the lower index.
+		vqclut[seed % 16] = vqclut[(seed + 5) % 16];
+
+		u8 expected[16 * 16 / 2];
+		u8 actual[16 * 16 / 2];
+		ipu_vq_reference(rgb16, expected, vqclut);
+		ipu_vq(rgb16, actual, vqclut);
+
+		EXPECT_EQ(std::memcmp(expected, actual, sizeof(actual)), 0) << "seed " << seed;
+	}
+}
+
+/// Timings for the kernels against the scalar code, run with --gtest_also_run_disabled_tests.
+MULTI_ISA_TEST(IPUKernelTest, DISABLED_Benchmark)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	static constexpr int iterations = 100000;
+
+	const auto time = [](const char* name, const auto& reference, const auto& vector) {
+		Common::Timer timer;
+		for (int i = 0; i < iterations; i++)
+			reference();
+		const double reference_ns = timer.GetTimeNanosecondsAndReset() / iterations;
+		for (int i = 0; i < iterations; i++)
+			vector();
+		const double vector_ns = timer.GetTimeNanoseconds() / iterations;
+
+		std::printf("%-10s reference %8.1fns  vector %8.1fns  (%.2fx)\n", name, reference_ns, vector_ns, reference_ns / vector_ns);
+	};
+
+	alignas(16) s16 source_block[64];
+	alignas(16) s16 block[64];
+	GetTestBlock(0, source_block);
+	time("IDCT",
+		[&]() { std::memcpy(block, source_block, sizeof(block)); IDCT_Block_reference(block); },
+		[&]() { std::memcpy(block, source_block, sizeof(block)); IDCT_Block(block); });
+
+	alignas(32) macroblock_8 mb8;
+	alignas(32) macroblock_rgb32 rgb32;
+	GetTestBytes(0, &mb8, sizeof(mb8));
+	time("YUV2RGB", [&]() { yuv2rgb_reference(mb8, rgb32); }, [&]() { yuv2rgb(mb8, rgb32); });
+
+	static constexpr u16 thresh[2] = {0x20, 0x80};
+	time("Threshold", [&]() { ipu_threshold_reference(rgb32, 0, thresh); }, [&]() { ipu_threshold(rgb32, 0, thresh); });
+
+	alignas(32) macroblock_rgb16 rgb16;
+	rgb16_t vqclut[16];
+	u8 indx4[16 * 16 / 2];
+	GetTestBytes(0, &rgb16, sizeof(rgb16));
+	GetTestBytes(1, vqclut, sizeof(vqclut));
+	time("VQ", [&]() { ipu_vq_reference(rgb16, indx4, vqclut); }, [&]() { ipu_vq(rgb16, indx4, vqclut); });
+}
+
+MULTI_ISA_UNSHARED_END
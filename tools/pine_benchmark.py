@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+
+# PCSX2 - PS2 Emulator for PCs
+# Copyright (C) 2002-2026 PCSX2 Dev Team
+#
+# PCSX2 is free software: you can redistribute it and/or modify it under the terms
+# of the GNU General Public License as published by the Free Software Found-
+# ation, either version 3 of the License, or (at your option) any later version.
+#
+# PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+# without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+# PURPOSE.  See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with PCSX2.
+# If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the latency of reading EE memory over PINE, comparing one MsgRead32 per
+# word with MsgReadRange, subscriptions and the shared memory window.
+# Run it with PINE enabled and a game running:
+#   pine_benchmark.py [--slot 28011] [--address 0x100000] [--size 65536] [--iterations 200]
+
+# pylint: disable=missing-function-docstring
+
+import argparse
+import mmap
+import os
+import socket
+import struct
+import sys
+import time
+
+MSG_READ32 = 0x02
+MSG_READ_RANGE = 0x10
+MSG_SUBSCRIBE = 0x12
+MSG_SHARED_MEMORY = 0x13
+
+IPC_OK = 0x00
+IPC_PUSH = 0x01
+
+DEFAULT_SLOT = 28011
+
+
+def connect(slot):
+    if sys.platform == "win32":
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.connect(("127.0.0.1", slot))
+        return sock
+
+    if sys.platform == "darwin":
+        runtime_dir = os.environ.get("TMPDIR", "/tmp")
+    else:
+        runtime_dir = os.environ.get("XDG_RUNTIME_DIR", "/tmp")
+    path = os.path.join(runtime_dir, "pcsx2.sock")
+    if slot != DEFAULT_SLOT:
+        path += f".{slot}"
+
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(path)
+    return sock
+
+
+def recv_exact(sock, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("PINE closed the connection")
+        data += chunk
+    return bytes(data)
+
+
+def recv_message(sock):
+    size = struct.unpack("<I", recv_exact(sock, 4))[0]
+    body = recv_exact(sock, size - 4)
+    return body[0], body[1:]
+
+
+def call(sock, commands):
+    sock.sendall(struct.pack("<I", len(commands) + 4) + commands)
+    code, data = recv_message(sock)
+    # pushes for a subscription can arrive before the reply
+    while code == IPC_PUSH:
+        code, data = recv_message(sock)
+    if code != IPC_OK:
+        raise RuntimeError("PINE command failed")
+    return data
+
+
+def bench(name, iterations, fn, size):
+    fn()
+    start = time.perf_counter()
+    for _ in range(iterations):
+        fn()
+    elapsed = (time.perf_counter() - start) / iterations
+    print(f"{name:<24} {elapsed * 1e6:10.1f}us  {size / elapsed / 1e6:10.1f}MB/s")
+
+
+def bench_read32(sock, args):
+    commands = b"".join(struct.pack("<BI", MSG_READ32, args.address + i) for i in range(0, args.size, 4))
+    bench("MsgRead32 batch", args.iterations, lambda: call(sock, commands), args.size)
+
+
+def bench_read_range(sock, args):
+    commands = struct.pack("<BII", MSG_READ_RANGE, args.address, args.size)
+    bench("MsgReadRange", args.iterations, lambda: call(sock, commands), args.size)
+
+
+def bench_subscribe(sock, args):
+    call(sock, struct.pack("<BIII", MSG_SUBSCRIBE, 1, args.address, args.size))
+
+    # frames per push, and how late the last push arrives after the previous one
+    frames = []
+    intervals = []
+    last_time = None
+    while len(frames) < min(args.iterations, 120):
+        code, data = recv_message(sock)
+        if code != IPC_PUSH:
+            continue
+        now = time.perf_counter()
+        frames.append(struct.unpack("<I", data[:4])[0])
+        if last_time is not None:
+            intervals.append(now - last_time)
+        last_time = now
+
+    call(sock, struct.pack("<BI", MSG_SUBSCRIBE, 0))
+
+    dropped = sum(b - a - 1 for a, b in zip(frames, frames[1:]))
+    print(f"{'MsgSubscribe':<24} {sum(intervals) / len(intervals) * 1e3:10.2f}ms between pushes, "
+          f"{dropped} of {frames[-1] - frames[0]} frames dropped")
+
+
+def bench_shared_memory(sock, args):
+    sock.sendall(struct.pack("<IB", 5, MSG_SHARED_MEMORY))
+    if sys.platform == "win32":
+        code, data = recv_message(sock)
+        fd = None
+    else:
+        msg, fds, _, _ = socket.recv_fds(sock, 4096, 1)
+        code, data = msg[4], msg[5:]
+        fd = fds[0] if fds else None
+
+    if code != IPC_OK:
+        print(f"{'MsgSharedMemory':<24} not supported on this platform")
+        return
+
+    ram_size, offset, name_size = struct.unpack("<IQI", data[:16])
+    name = data[16:16 + name_size - 1].decode()
+    if fd is not None:
+        view = mmap.mmap(fd, ram_size, mmap.MAP_SHARED, mmap.PROT_READ, offset=offset)
+        os.close(fd)
+    else:
+        view = mmap.mmap(-1, ram_size, tagname=name, access=mmap.ACCESS_READ, offset=offset)
+
+    bench("MsgSharedMemory", args.iterations, lambda: view[args.address:args.address + args.size], args.size)
+    view.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measures PINE memory read latency.")
+    parser.add_argument("--slot", type=int, default=DEFAULT_SLOT)
+    parser.add_argument("--address", type=lambda x: int(x, 0), default=0x100000)
+    parser.add_argument("--size", type=lambda x: int(x, 0), default=0x10000)
+    parser.add_argument("--iterations", type=int, default=200)
+    args = parser.parse_args()
+
+    with connect(args.slot) as sock:
+        bench_read32(sock, args)
+        bench_read_range(sock, args)
+        bench_subscribe(sock, args)
+        bench_shared_memory(sock, args)
+
+
+if __name__ == "__main__":
+    main()